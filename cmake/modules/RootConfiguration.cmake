@@ -477,6 +477,13 @@ if(veccore)
 else()
   set(hasveccore undef)
 endif()
+# only the builtin VDT installs its headers with the ROOT ones, where the
+# users of RConfigure.h (e.g. Math/GenVector/FastMath.h) can find them
+if(builtin_vdt)
+  set(hasvdt define)
+else()
+  set(hasvdt undef)
+endif()
 if(cxx11)
   set(cxxversion cxx11)
   set(usec++11 define)
@@ -66,6 +66,12 @@ public:
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
+   // Per branch events, only monitored by TTreePerfStats.
+   virtual void BasketReadEvent(TObject * /*branch*/, Int_t /*len*/, Double_t /*start*/, Bool_t /*cached*/) {}
+   virtual void BasketUnzipEvent(TObject * /*branch*/, Double_t /*start*/, Int_t /*complen*/, Int_t /*objlen*/) {}
+   virtual void BasketUnstreamEvent(TObject * /*branch*/, Double_t /*start*/) {}
+   virtual void BasketPrefetchEvent(TObject * /*branch*/, Int_t /*len*/) {}
+
    virtual void SetBytesRead(Long64_t num) = 0;
    virtual Long64_t GetBytesRead() const = 0;
    virtual void SetNumEvents(Long64_t num) = 0;
@@ -170,6 +170,7 @@
 #pragma link C++ class TSVDUnfold+;
 #pragma link C++ class TEfficiency+;
 #pragma link C++ class TKDE+;
+#pragma link C++ class TQuantileSketch-;
 
 
 #pragma link C++ typedef THnSparseD;
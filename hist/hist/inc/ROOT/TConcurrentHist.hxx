@@ -0,0 +1,99 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentHist
+#define ROOT_TConcurrentHist
+
+#include "TH1.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ROOT {
+
+/**
+ * \class ROOT::TConcurrentHist
+ * \brief A 1D or 2D histogram which can be filled concurrently from many threads.
+ * \ingroup Hist
+ *
+ * The bin contents are kept in a small number of shards of atomic counters.
+ * As in ROOT::TThreadedObject, each thread gets a slot of the histogram at
+ * its first fill; the thread of slot i fills the shard i % nShards, so that
+ * threads contend only when there are more filling threads than shards and
+ * never for a lock. Unlike ROOT::TThreadedObject, the memory used does not
+ * grow with the number of threads but with the number of shards (by default
+ * the number of hardware threads, at most 8).
+ *
+ * Snapshot() returns at any time a regular histogram of the type of the
+ * model (e.g. TH1D or TH2D) with the current contents, without stopping
+ * the fillers: the entries being filled during the snapshot may or may not
+ * be included.
+ *
+ * ~~~{.cpp}
+ * ROOT::TConcurrentHist h(TH1D("h", "h", 100, -5, 5));
+ * ROOT::TThreadExecutor pool;
+ * pool.Foreach([&h](int seed) {
+ *    TRandom3 r(seed);
+ *    for (int i = 0; i < 1000000; ++i) h.Fill(r.Gaus());
+ * }, ROOT::TSeqI(8));
+ * auto result = h.Snapshot();
+ * ~~~
+ *
+ * The axes of the model cannot be extended; the model must be a TH1 or a TH2
+ * (profiles and TH2Poly are not supported).
+ */
+class TConcurrentHist {
+private:
+   /// Bin contents and statistics filled by a group of threads.
+   struct Shard {
+      std::unique_ptr<std::atomic<Double_t>[]> fContent; ///< Sum of weights per bin
+      std::unique_ptr<std::atomic<Double_t>[]> fSumw2;   ///< Sum of squares of weights per bin
+      std::atomic<Double_t> fStats[TH1::kNstat];        ///< Sums of weights as in TH1::GetStats
+      std::atomic<Long64_t> fEntries;                    ///< Number of entries
+   };
+
+   std::unique_ptr<TH1> fModel;                  ///< Empty histogram defining the binning
+   Int_t fDimension;                             ///< 1 or 2
+   Int_t fNcells;                                ///< Number of bins including under/overflows
+   std::vector<std::unique_ptr<Shard>> fShards;  ///< Shards of the bin storage
+   std::atomic<Bool_t> fWeighted;                ///< True once a weight different from 1 was filled
+   ULong64_t fId;                                ///< Unique identifier, used by the threads to cache their slot
+   std::map<std::thread::id, UInt_t> fThrIDSlotMap; ///< Slot of each thread which filled the histogram
+   std::mutex fThrIDSlotMutex;                      ///< Protects fThrIDSlotMap
+
+   UInt_t GetThisSlotNumber();
+   Shard &GetShard();
+   void Add(Shard &shard, Int_t bin, Double_t w, Bool_t inRange, Double_t x, Double_t y);
+
+public:
+   TConcurrentHist(const TH1 &model, UInt_t nShards = 0);
+   TConcurrentHist(const TConcurrentHist &) = delete;
+   TConcurrentHist &operator=(const TConcurrentHist &) = delete;
+   ~TConcurrentHist();
+
+   void Fill(Double_t x, Double_t w = 1.);
+   void Fill(Double_t x, Double_t y, Double_t w);
+   void FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride = 1);
+   void FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride = 1);
+
+   Int_t GetDimension() const { return fDimension; }
+   UInt_t GetNShards() const { return fShards.size(); }
+   const TH1 *GetModel() const { return fModel.get(); }
+   void Reset();
+   std::unique_ptr<TH1> Snapshot(const char *name = nullptr) const;
+};
+
+} // namespace ROOT
+
+#endif
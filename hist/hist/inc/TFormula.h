@@ -19,6 +19,7 @@
 #include "TObjArray.h"
 #include "TMethodCall.h"
 #include "TInterpreter.h"
+#include <atomic>
 #include <vector>
 #include <list>
 #include <map>
@@ -91,16 +92,24 @@ private:
    std::vector<Double_t>  fClingVariables;       //!  cached variables
    std::vector<Double_t>  fClingParameters;      //  parameter values
    Bool_t            fReadyToExecute;       //! trasient to force initialization
-   Bool_t            fClingInitialized;  //!  transient to force re-initialization
+   std::atomic<Bool_t> fClingInitialized{false}; //!  transient to force re-initialization (read without lock)
    Bool_t            fAllParametersSetted;    // flag to control if all parameters are setted
    TMethodCall*      fMethod;        //! pointer to methocall
    TString           fClingName;     //! unique name passed to Cling to define the function ( double clingName(double*x, double*p) )
 
-   TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
+   std::atomic<TInterpreter::CallFuncIFacePtr_t::Generic_t> fFuncPtr{nullptr}; //!  function pointer (read without lock)
    void *   fLambdaPtr;                                    //!  pointer to the lambda function
+   TInterpreter::CallFuncIFacePtr_t::Generic_t fBatchFuncPtr = nullptr; //!  function pointer evaluating many points
+   std::atomic<Bool_t> fBatchPrepared{false};              //!  flag set once fBatchFuncPtr has been looked for (read without lock by EvalParN)
+   std::atomic<Bool_t> fClingPending{false};               //!  function queued for a lazy compilation in Cling (read without lock)
+   TInterpreter::CallFuncIFacePtr_t::Generic_t fGradFuncPtr = nullptr; //!  function pointer computing the gradient wrt the parameters
+   std::atomic<Bool_t> fGradPrepared{false};               //!  flag set once fGradFuncPtr has been looked for (read without lock)
 
    void     InputFormulaIntoCling();
    Bool_t   PrepareEvalMethod();
+   void     PrepareBatchEvalMethod();
+   void     PrepareGradientMethod();
+   Bool_t   CompilePendingFormula();
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -170,6 +179,8 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParN(Int_t n, const Double_t *x, Double_t *result, const Double_t *params=0) const;
+   Bool_t         GenerateGradientPar();
    TString        GetExpFormula(Option_t *option="") const;
    const TObject *GetLinearPart(Int_t i) const;
    Int_t          GetNdim() const {return fNdim;}
@@ -184,7 +195,8 @@ public:
    Double_t       GetVariable(const char *name) const;
    Int_t          GetVarNumber(const char *name) const;
    TString        GetVarName(Int_t ivar) const;
-   Bool_t         IsValid() const { return fReadyToExecute && fClingInitialized; }
+   void           GradientPar(const Double_t *x, Double_t *result, const Double_t *params=0);
+   Bool_t         IsValid() const { return fReadyToExecute && (fClingInitialized || fClingPending); }
    Bool_t         IsLinear() const { return TestBit(kLinear); }
    void           Print(Option_t *option = "") const;
    void           SetName(const char* name);
@@ -203,6 +215,11 @@ public:
    void           SetVariable(const TString &name, Double_t value);
    void           SetVariables(const std::pair<TString,Double_t> *vars, const Int_t size);
 
+   static void        SetLazyCompilation(Bool_t lazy = kTRUE);
+   static Bool_t      GetLazyCompilation();
+   static void        SetCompilationCacheDir(const char *dir);
+   static const char *GetCompilationCacheDir();
+
    ClassDef(TFormula,10)
 };
 #endif
@@ -104,6 +104,8 @@ private:
                    const TObjArray* axes, Bool_t keepTargetAxis) const;
    TObject* ProjectionAny(Int_t ndim, const Int_t* dim,
                           Bool_t wantNDim, Option_t* option = "") const;
+   virtual Bool_t FillProjection(TH1* hist, Int_t ndim, const Int_t* dim,
+                                 Bool_t keepTargetAxis, Bool_t wantErrors) const;
    Bool_t PrintBin(Long64_t idx, Int_t* coord, Option_t* options) const;
    void AddInternal(const THnBase* h, Double_t c, Bool_t rebinned);
    THnBase* RebinBase(Int_t group) const;
@@ -152,6 +154,8 @@ private:
       return bin;
    }
 
+   virtual void FillN(Int_t n, const Double_t *x, const Double_t *w = 0);
+
    virtual void FillBin(Long64_t bin, Double_t w) = 0;
 
    void SetBinEdges(Int_t idim, const Double_t* bins);
@@ -59,6 +59,8 @@ protected:
    virtual Double_t GetBinErrorSqUnchecked(Int_t bin) const { Double_t err = GetBinError(bin); return err*err; }
 
 private:
+   void FillN(Int_t, const Double_t *, const Double_t *, const Double_t *, Int_t)
+      { MayNotUse("FillN(Int_t, Double_t*, Double_t*, Double_t*, Int_t)"); }
    Double_t *GetB()  {return &fBinEntries.fArray[0];}
    Double_t *GetB2() {return (fBinSumw2.fN ? &fBinSumw2.fArray[0] : 0 ); }
    Double_t *GetW()  {return &fArray[0];}
@@ -103,6 +105,7 @@ public:
    virtual Int_t     Fill(const char *namex, Double_t y, Double_t z);
    virtual Int_t     Fill(const char *namex, const char *namey, Double_t z);
    virtual Int_t     Fill(Double_t x, Double_t y, Double_t z, Double_t w);
+   virtual void      FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride=1);
    virtual Double_t  GetBinContent(Int_t bin) const;
    virtual Double_t  GetBinContent(Int_t binx, Int_t biny) const {return GetBinContent(GetBin(binx,biny));}
    virtual Double_t  GetBinContent(Int_t binx, Int_t biny, Int_t) const {return GetBinContent(GetBin(binx,biny));}
@@ -69,6 +69,8 @@ protected:
                                           bool originalRange, bool useUF, bool useOF) const;
 
 private:
+   void FillN(Int_t, const Double_t *, const Double_t *, const Double_t *, const Double_t *, Int_t)
+      { MayNotUse("FillN(Int_t, Double_t*, Double_t*, Double_t*, Double_t*, Int_t)"); }
    Double_t *GetB()  {return &fBinEntries.fArray[0];}
    Double_t *GetB2() {return (fBinSumw2.fN ? &fBinSumw2.fArray[0] : 0 ); }
    Double_t *GetW()  {return &fArray[0];}
@@ -0,0 +1,63 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TQuantileSketch
+#define ROOT_TQuantileSketch
+
+#include "TNamed.h"
+
+#include <vector>
+
+class TCollection;
+
+class TQuantileSketch : public TNamed {
+
+private:
+   Double_t              fCompression;  // compression parameter (the number of centroids is about fCompression)
+   std::vector<Double_t> fMeans;        // means of the centroids, in increasing order
+   std::vector<Double_t> fWeights;      // weights of the centroids
+   Long64_t              fEntries;      // number of entries
+   Double_t              fTsumw;        // total sum of weights
+   Double_t              fTsumwx;       // total sum of weight*X
+   Double_t              fTsumwx2;      // total sum of weight*X*X
+   Double_t              fMin;          // minimum value filled
+   Double_t              fMax;          // maximum value filled
+   std::vector<Double_t> fBufferX;      //! values not yet merged in the centroids
+   std::vector<Double_t> fBufferW;      //! weights of the values not yet merged in the centroids
+
+   void  AddToBuffer(Double_t x, Double_t w);
+
+public:
+   TQuantileSketch();
+   TQuantileSketch(const char *name, const char *title, Double_t compression = 100);
+   virtual ~TQuantileSketch() {}
+
+   void            Add(const TQuantileSketch &sketch);
+   void            Compress();
+   void            Fill(Double_t x, Double_t w = 1.);
+   void            FillN(Int_t n, const Double_t *x, const Double_t *w = 0, Int_t stride = 1);
+   Double_t        GetCompression() const { return fCompression; }
+   Long64_t        GetEntries() const { return fEntries; }
+   Double_t        GetMax() const { return fMax; }
+   Double_t        GetMean() const { return (fTsumw != 0) ? fTsumwx / fTsumw : 0; }
+   Double_t        GetMin() const { return fMin; }
+   Int_t           GetNcentroids() { Compress(); return fMeans.size(); }
+   Double_t        GetQuantile(Double_t prob);
+   Int_t           GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum = 0);
+   Double_t        GetStdDev() const;
+   Double_t        GetSumOfWeights() const { return fTsumw; }
+   virtual Long64_t Merge(TCollection *list);
+   virtual void    Print(Option_t *option = "") const;
+   virtual void    Reset(Option_t *option = "");
+
+   ClassDef(TQuantileSketch, 1) // Mergeable streaming estimate of the quantiles of a distribution (t-digest)
+};
+
+#endif
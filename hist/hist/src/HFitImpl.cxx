@@ -233,12 +233,22 @@ TFitResultPtr HFit::Fit(FitObject * h1, TF1 *f1 , Foption_t & fitOption , const
 
    // set the fit function
    // if option grad is specified use gradient
+   // use it also when the gradient of the formula can be computed analytically, except for
+   // the data with errors on the coordinates or asymmetric errors, the chi2 with expected errors
+   // (option P), the weighted (option WL) and the not-extended likelihood fits and the multi-process
+   // evaluation, whose gradient is not computed
+   bool analyticGradient = fitOption.ExecPolicy != ROOT::Fit::ExecutionPolicy::kMultiprocess &&
+                           !fitOption.PChi2 && (fitOption.Like & 2) != 2 && (fitOption.Like & 4) != 4 &&
+                           !fitdata->HaveCoordErrors() && !fitdata->HaveAsymErrors() &&
+                           f1->HasAnalyticGradientPar();
    if ( (linear || fitOption.Gradient) )
       fitter->SetFunction(ROOT::Math::WrappedMultiTF1(*f1));
 #ifdef R__HAS_VECCORE      
    else if(f1->IsVectorized())
       fitter->SetFunction(static_cast<const ROOT::Math::IParamMultiFunctionTempl<ROOT::Double_v> &>(ROOT::Math::WrappedMultiTF1Templ<ROOT::Double_v>(*f1)));
 #endif
+   else if (analyticGradient)
+      fitter->SetFunction(ROOT::Math::WrappedMultiTF1(*f1));
    else
       fitter->SetFunction(static_cast<const ROOT::Math::IParamMultiFunction &>(ROOT::Math::WrappedMultiTF1(*f1) ) );
 
@@ -703,10 +713,10 @@ void ROOT::Fit::FitOptionsMake(EFitObjectType type, const char *option, Foption_
             opt.ReplaceAll("WIDTH","");
       }
 
-      // if (opt.Contains("MULTIPROC")) {
-      //    fitOption.ExecPolicy = ROOT::Fit::kMultiprocess;
-      //    opt.ReplaceAll("MULTIPROC","");
-      // }
+      if (opt.Contains("MULTIPROC")) {
+         fitOption.ExecPolicy = ROOT::Fit::ExecutionPolicy::kMultiprocess;
+         opt.ReplaceAll("MULTIPROC","");
+      }
 
       if (opt.Contains("MULTITHREAD")) {
          fitOption.ExecPolicy = ROOT::Fit::ExecutionPolicy::kMultithread;
@@ -827,7 +837,12 @@ TFitResultPtr ROOT::Fit::UnBinFit(ROOT::Fit::UnBinData * data, TF1 * fitfunc, Fo
    // set the fit function
    // if option grad is specified use gradient
    // need to create a wrapper for an automatic  normalized TF1 ???
-   if ( fitOption.Gradient ) {
+   // use it also when the gradient of the formula can be computed analytically, except for
+   // the extended fits and the multi-process evaluation, which do not support it
+   bool analyticGradient = fitOption.ExecPolicy != ROOT::Fit::ExecutionPolicy::kMultiprocess &&
+                           (fitOption.Like & 1) != 1 && (int) dim == fitfunc->GetNdim() &&
+                           fitfunc->HasAnalyticGradientPar();
+   if ( fitOption.Gradient || analyticGradient ) {
       assert ( (int) dim == fitfunc->GetNdim() );
       fitter->SetFunction(ROOT::Math::WrappedMultiTF1(*fitfunc) );
    }
@@ -24,6 +24,7 @@
 #include "TROOT.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "Math/Types.h"
 #include <time.h>
 #include <cassert>
 
@@ -420,6 +421,52 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bin numbers corresponding to the n abscissas x[i*stride] and
+/// store them in bins[i].
+///
+/// Identical to calling TAxis::FindFixBin for each value, but for fixed bin
+/// sizes the computation is done on ROOT::Double_v vectors and the
+/// underflows/overflows (including NaN) are selected with masks.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   if (fXbins.fN) {
+      for (Int_t i = 0; i < n; ++i) bins[i] = FindFixBin(x[i*stride]);
+      return;
+   }
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   const Double_t nbins = fNbins;
+   const Double_t width = fXmax - fXmin;
+   Int_t i = 0;
+#ifdef R__HAS_VECCORE
+   using ROOT::Double_v;
+   const Int_t vecSize = vecCore::VectorSize<Double_v>();
+   for (; i + vecSize <= n; i += vecSize) {
+      Double_v xv;
+      if (stride == 1) {
+         vecCore::Load<Double_v>(xv, x + i);
+      } else {
+         for (Int_t j = 0; j < vecSize; ++j) vecCore::Set(xv, j, x[(i+j)*stride]);
+      }
+      // Same expression as in FindFixBin; -1 and fNbins give the
+      // underflow and overflow bins once 1 is added below.
+      Double_v fbin = nbins*(xv-xmin)/width;
+      vecCore::MaskedAssign(fbin, xv < xmin, Double_v(-1.));
+      vecCore::MaskedAssign(fbin, !(xv < xmax), Double_v(nbins));
+      for (Int_t j = 0; j < vecSize; ++j) bins[i+j] = 1 + int(vecCore::Get(fbin, j));
+   }
+#endif
+   for (; i < n; ++i) {
+      Double_t xi = x[i*stride];
+      Double_t fbin = nbins*(xi-xmin)/width;
+      if (xi < xmin) fbin = -1;
+      if (!(xi < xmax)) fbin = nbins;
+      bins[i] = 1 + int(fbin);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
@@ -0,0 +1,269 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TConcurrentHist.hxx"
+
+#include "TArrayD.h"
+#include "TError.h"
+#include "TH2.h"
+#include "TMath.h"
+
+#include <thread>
+
+namespace {
+
+/// Add v to a with a compare-and-swap loop (no fetch_add for doubles before C++20).
+inline void AtomicAdd(std::atomic<Double_t> &a, Double_t v)
+{
+   Double_t old = a.load(std::memory_order_relaxed);
+   while (!a.compare_exchange_weak(old, old + v, std::memory_order_relaxed)) {
+   }
+}
+
+/// Counter giving a unique identifier to each TConcurrentHist.
+std::atomic<ULong64_t> gNextId(0);
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a concurrent histogram with the binning of model, a TH1 or TH2.
+/// The content of model is not copied.
+/// If nShards is 0, it is set to the number of hardware threads, at most 8.
+
+ROOT::TConcurrentHist::TConcurrentHist(const TH1 &model, UInt_t nShards) : fDimension(model.GetDimension()), fWeighted(kFALSE), fId(gNextId++)
+{
+   if (fDimension > 2 || model.InheritsFrom("TProfile") || model.InheritsFrom("TProfile2D") ||
+       model.InheritsFrom("TH2Poly")) {
+      ::Error("TConcurrentHist::TConcurrentHist", "histogram %s of class %s is not supported, only TH1 and TH2",
+              model.GetName(), model.ClassName());
+      fDimension = 0;
+   }
+   fModel.reset(static_cast<TH1 *>(model.Clone()));
+   fModel->SetDirectory(nullptr);
+   fModel->Reset();
+   if (fModel->CanExtendAllAxes()) {
+      ::Warning("TConcurrentHist::TConcurrentHist", "the axes of %s cannot be extended concurrently, disabling it",
+                model.GetName());
+      fModel->SetCanExtend(TH1::kNoAxis);
+   }
+   fNcells = fModel->GetNcells();
+
+   if (nShards == 0)
+      nShards = TMath::Max(1U, TMath::Min(8U, std::thread::hardware_concurrency()));
+   fShards.resize(nShards);
+   for (auto &shard : fShards) {
+      shard.reset(new Shard);
+      shard->fContent.reset(new std::atomic<Double_t>[fNcells]);
+      shard->fSumw2.reset(new std::atomic<Double_t>[fNcells]);
+   }
+   Reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+ROOT::TConcurrentHist::~TConcurrentHist() = default;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the slot of the calling thread in this histogram: the threads get
+/// consecutive slots in the order of their first fill.
+
+UInt_t ROOT::TConcurrentHist::GetThisSlotNumber()
+{
+   std::lock_guard<std::mutex> lock(fThrIDSlotMutex);
+   auto it = fThrIDSlotMap.emplace(std::this_thread::get_id(), fThrIDSlotMap.size()).first;
+   return it->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the shard of the calling thread.
+/// The slot of the last histogram filled by the thread is cached, so that the
+/// map of the slots is used only when a thread changes histogram.
+
+ROOT::TConcurrentHist::Shard &ROOT::TConcurrentHist::GetShard()
+{
+   thread_local ULong64_t lastId = -1;
+   thread_local UInt_t lastSlot = 0;
+   if (lastId != fId) {
+      lastSlot = GetThisSlotNumber();
+      lastId = fId;
+   }
+   return *fShards[lastSlot % fShards.size()];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add an entry of weight w in bin, and in the statistics if inRange.
+
+void ROOT::TConcurrentHist::Add(Shard &shard, Int_t bin, Double_t w, Bool_t inRange, Double_t x, Double_t y)
+{
+   if (w != 1. && !fWeighted.load(std::memory_order_relaxed))
+      fWeighted = kTRUE;
+   AtomicAdd(shard.fContent[bin], w);
+   AtomicAdd(shard.fSumw2[bin], w * w);
+   shard.fEntries.fetch_add(1, std::memory_order_relaxed);
+   if (!inRange)
+      return;
+   AtomicAdd(shard.fStats[0], w);
+   AtomicAdd(shard.fStats[1], w * w);
+   AtomicAdd(shard.fStats[2], w * x);
+   AtomicAdd(shard.fStats[3], w * x * x);
+   if (fDimension == 2) {
+      AtomicAdd(shard.fStats[4], w * y);
+      AtomicAdd(shard.fStats[5], w * y * y);
+      AtomicAdd(shard.fStats[6], w * x * y);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 1D histogram with x and weight w. Can be called from any thread.
+
+void ROOT::TConcurrentHist::Fill(Double_t x, Double_t w)
+{
+   if (fDimension != 1) {
+      ::Error("TConcurrentHist::Fill", "wrong number of coordinates for a %dD histogram", fDimension);
+      return;
+   }
+   const TAxis &xaxis = *fModel->GetXaxis();
+   Int_t bin = xaxis.FindFixBin(x);
+   Bool_t inRange = TH1::GetStatOverflows() || (bin > 0 && bin <= xaxis.GetNbins());
+   Add(GetShard(), bin, w, inRange, x, 0.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 2D histogram with x, y and weight w. Can be called from any thread.
+
+void ROOT::TConcurrentHist::Fill(Double_t x, Double_t y, Double_t w)
+{
+   if (fDimension != 2) {
+      ::Error("TConcurrentHist::Fill", "wrong number of coordinates for a %dD histogram", fDimension);
+      return;
+   }
+   const TAxis &xaxis = *fModel->GetXaxis();
+   const TAxis &yaxis = *fModel->GetYaxis();
+   Int_t binx = xaxis.FindFixBin(x);
+   Int_t biny = yaxis.FindFixBin(y);
+   Bool_t inRange = TH1::GetStatOverflows() ||
+                    (binx > 0 && binx <= xaxis.GetNbins() && biny > 0 && biny <= yaxis.GetNbins());
+   Add(GetShard(), biny * (xaxis.GetNbins() + 2) + binx, w, inRange, x, y);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 1D histogram with an array of values and weights, see TH1::FillN.
+/// If w is null each entry has a weight of 1.
+
+void ROOT::TConcurrentHist::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
+{
+   if (fDimension != 1) {
+      ::Error("TConcurrentHist::FillN", "wrong number of coordinates for a %dD histogram", fDimension);
+      return;
+   }
+   Shard &shard = GetShard();
+   const TAxis &xaxis = *fModel->GetXaxis();
+   const Int_t nbins = xaxis.GetNbins();
+   const Bool_t statOverflows = TH1::GetStatOverflows();
+   const Int_t kBlock = 256;
+   Int_t bins[kBlock];
+   for (Int_t first = 0; first < ntimes; first += kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes - first);
+      const Double_t *xb = x + first * stride;
+      xaxis.FindFixBins(n, xb, bins, stride);
+      for (Int_t i = 0; i < n; ++i) {
+         Bool_t inRange = statOverflows || (bins[i] > 0 && bins[i] <= nbins);
+         Add(shard, bins[i], w ? w[(first + i) * stride] : 1., inRange, xb[i * stride], 0.);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 2D histogram with arrays of values and weights, see TH2::FillN.
+/// If w is null each entry has a weight of 1.
+
+void ROOT::TConcurrentHist::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
+{
+   if (fDimension != 2) {
+      ::Error("TConcurrentHist::FillN", "wrong number of coordinates for a %dD histogram", fDimension);
+      return;
+   }
+   Shard &shard = GetShard();
+   const TAxis &xaxis = *fModel->GetXaxis();
+   const TAxis &yaxis = *fModel->GetYaxis();
+   const Int_t nbinsx = xaxis.GetNbins();
+   const Int_t nbinsy = yaxis.GetNbins();
+   const Bool_t statOverflows = TH1::GetStatOverflows();
+   const Int_t kBlock = 256;
+   Int_t binx[kBlock], biny[kBlock];
+   for (Int_t first = 0; first < ntimes; first += kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes - first);
+      const Double_t *xb = x + first * stride;
+      const Double_t *yb = y + first * stride;
+      xaxis.FindFixBins(n, xb, binx, stride);
+      yaxis.FindFixBins(n, yb, biny, stride);
+      for (Int_t i = 0; i < n; ++i) {
+         Bool_t inRange =
+            statOverflows || (binx[i] > 0 && binx[i] <= nbinsx && biny[i] > 0 && biny[i] <= nbinsy);
+         Add(shard, biny[i] * (nbinsx + 2) + binx[i], w ? w[(first + i) * stride] : 1., inRange, xb[i * stride],
+             yb[i * stride]);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the contents. Must not be called while other threads are filling.
+
+void ROOT::TConcurrentHist::Reset()
+{
+   for (auto &shard : fShards) {
+      for (Int_t i = 0; i < fNcells; ++i) {
+         shard->fContent[i] = 0.;
+         shard->fSumw2[i] = 0.;
+      }
+      for (auto &stat : shard->fStats)
+         stat = 0.;
+      shard->fEntries = 0;
+   }
+   fWeighted = kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a histogram of the class of the model with the current contents.
+/// It can be called while other threads are filling; the entries filled
+/// concurrently may be partially accounted (e.g. in the bin content but not
+/// yet in the statistics).
+
+std::unique_ptr<TH1> ROOT::TConcurrentHist::Snapshot(const char *name) const
+{
+   std::unique_ptr<TH1> h(static_cast<TH1 *>(fModel->Clone(name ? name : fModel->GetName())));
+   h->SetDirectory(nullptr);
+   h->Reset();
+   Bool_t weighted = fWeighted || h->GetSumw2N();
+   if (weighted && !h->GetSumw2N())
+      h->Sumw2();
+
+   Double_t stats[TH1::kNstat] = {0};
+   Long64_t entries = 0;
+   for (Int_t i = 0; i < fNcells; ++i) {
+      Double_t content = 0, sumw2 = 0;
+      for (const auto &shard : fShards) {
+         content += shard->fContent[i].load(std::memory_order_relaxed);
+         sumw2 += shard->fSumw2[i].load(std::memory_order_relaxed);
+      }
+      h->SetBinContent(i, content);
+      if (weighted)
+         h->GetSumw2()->fArray[i] = sumw2;
+   }
+   for (const auto &shard : fShards) {
+      for (Int_t j = 0; j < TH1::kNstat; ++j)
+         stats[j] += shard->fStats[j].load(std::memory_order_relaxed);
+      entries += shard->fEntries.load(std::memory_order_relaxed);
+   }
+   h->PutStats(stats);
+   h->SetEntries(entries);
+   return h;
+}
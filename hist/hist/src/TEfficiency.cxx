@@ -2300,6 +2300,73 @@ void TEfficiency::FillWeighted(Bool_t bPassed,Double_t weight,Double_t x,Double_
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// This function is used for filling the two histograms with n events at once.
+///
+/// \param[in] n number of events
+/// \param[in] bPassed array of flags whether the events passed the selection
+/// \param[in] x array of x-values
+/// \param[in] y array of y-values (use default=0 for 1-D efficiencies)
+/// \param[in] z array of z-values (use default=0 for 2-D or 1-D efficiencies)
+/// \param[in] w array of weights (use default=0 for unweighted events)
+///
+/// The events are forwarded in blocks to the FillN methods of the total and
+/// passed histograms, which compute the bins of a whole block at once for
+/// axes with a fixed range. The result is the same as calling
+/// TEfficiency::Fill (or TEfficiency::FillWeighted if w is given) for each
+/// event.
+///
+/// Note: - this function will call SetUseWeightedEvents if weights are given
+///         and it was not called by the user before
+
+void TEfficiency::FillN(Int_t n,const Bool_t* bPassed,const Double_t* x,const Double_t* y,const Double_t* z,const Double_t* w)
+{
+   if (n <= 0) return;
+   const Int_t dim = GetDimension();
+   if (!x || (dim > 1 && !y) || (dim > 2 && !z)) {
+      Error("FillN","missing coordinate array for a %d-dimensional efficiency",dim);
+      return;
+   }
+   if (w && !TestBit(kUseWeights)) {
+      Info("FillN","call SetUseWeightedEvents() manually to ensure correct storage of sum of weights squared");
+      SetUseWeightedEvents();
+   }
+
+   // the events which passed are copied in contiguous blocks
+   const Int_t kBlock = 256;
+   Double_t px[kBlock], py[kBlock], pz[kBlock], pw[kBlock];
+   for (Int_t first = 0; first < n; first += kBlock) {
+      const Int_t nb = TMath::Min(kBlock, n - first);
+      const Double_t *xb = x + first;
+      const Double_t *yb = (dim > 1) ? y + first : 0;
+      const Double_t *zb = (dim > 2) ? z + first : 0;
+      const Double_t *wb = w ? w + first : 0;
+      Int_t np = 0;
+      for (Int_t i = 0; i < nb; ++i) {
+         if (!bPassed[first + i]) continue;
+         px[np] = xb[i];
+         if (yb) py[np] = yb[i];
+         if (zb) pz[np] = zb[i];
+         if (wb) pw[np] = wb[i];
+         ++np;
+      }
+      switch(dim) {
+         case 1:
+            fTotalHistogram->FillN(nb,xb,wb);
+            if (np) fPassedHistogram->FillN(np,px,wb ? pw : 0);
+            break;
+         case 2:
+            ((TH2*)(fTotalHistogram))->FillN(nb,xb,yb,wb);
+            if (np) ((TH2*)(fPassedHistogram))->FillN(np,px,py,wb ? pw : 0);
+            break;
+         case 3:
+            ((TH3*)(fTotalHistogram))->FillN(nb,xb,yb,zb,wb);
+            if (np) ((TH3*)(fPassedHistogram))->FillN(np,px,py,pz,wb ? pw : 0);
+            break;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the global bin number containing the given values
 ///
@@ -1399,6 +1399,66 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate function on n points with given parameters.
+///
+/// Coordinate j of point i is x[i * GetNdim() + j]; the n function values
+/// are written in result. If params is null the internal parameter values
+/// are used.
+///
+/// Functions defined by a formula are evaluated with TFormula::EvalParN,
+/// which loops on the points in compiled (and where possible vectorized)
+/// code; functions defined by a vectorized functor are evaluated
+/// ROOT::Double_v by ROOT::Double_v. The other kinds of functions are
+/// evaluated point by point with EvalPar.
+
+void TF1::EvalParN(Int_t n, const Double_t *x, Double_t *result, const Double_t *params)
+{
+   if (n <= 0) return;
+
+   if (fType == EFType::kFormula) {
+      assert(fFormula);
+      fFormula->EvalParN(n, x, result, params);
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i)
+            result[i] /= fNormIntegral;
+      }
+      return;
+   }
+
+   Int_t i = 0;
+#ifdef R__HAS_VECCORE
+   if (fType == EFType::kTemplVec && fFunctor) {
+      if (!params) params = (Double_t *)fParams->GetParameters();
+      const Int_t vsize = vecCore::VectorSize<ROOT::Double_v>();
+      std::vector<ROOT::Double_v> d(fNdim);
+      for (; i + vsize <= n; i += vsize) {
+         for (Int_t j = 0; j < fNdim; ++j) {
+            for (Int_t l = 0; l < vsize; ++l)
+               vecCore::Set(d[j], l, x[(i + l) * fNdim + j]);
+         }
+         ROOT::Double_v res = ((TF1FunctorPointerImpl<ROOT::Double_v> *)fFunctor)->fImpl(d.data(), params);
+         if (fNormalized && fNormIntegral != 0)
+            res = res / fNormIntegral;
+         vecCore::Store(res, result + i);
+      }
+   }
+#endif
+
+   if (fType == EFType::kInterpreted) {
+      // the arguments of the method call must point to the current point
+      const Double_t *pars = (params) ? params : GetParameters();
+      for (; i < n; ++i) {
+         InitArgs(x + i * fNdim, pars);
+         result[i] = EvalPar(x + i * fNdim, pars);
+      }
+      return;
+   }
+
+   for (; i < n; ++i)
+      result[i] = EvalPar(x + i * fNdim, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
@@ -2308,9 +2368,17 @@ TAxis *TF1::GetZaxis() const
 /// Method is the same as in Derivative() function
 ///
 /// If a parameter is fixed, the gradient on this parameter = 0
+///
+/// For formula functions whose expression can be differentiated (see
+/// HasAnalyticGradientPar) the derivative is computed analytically and eps is not used.
 
 Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
 {
+   if (ipar >= 0 && ipar < GetNpar() && HasAnalyticGradientPar()) {
+      std::vector<Double_t> grad(GetNpar());
+      GradientPar(x, grad.data(), eps);
+      return grad[ipar];
+   }
    return GradientParTempl<Double_t>(ipar, x, eps);
 }
 
@@ -2327,12 +2395,36 @@ Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
 /// Method is the same as in Derivative() function
 ///
 /// If a parameter is fixed, the gradient on this parameter = 0
+///
+/// For formula functions whose expression can be differentiated (see
+/// HasAnalyticGradientPar) the gradient is computed analytically and eps is not used.
 
 void TF1::GradientPar(const Double_t *x, Double_t *grad, Double_t eps)
 {
+   if (HasAnalyticGradientPar()) {
+      fFormula->GradientPar(x, grad);
+      for (Int_t ipar = 0; ipar < GetNpar(); ipar++) {
+         Double_t al, bl;
+         GetParLimits(ipar, al, bl);
+         if (al * bl != 0 && al >= bl) grad[ipar] = 0;
+      }
+      return;
+   }
    GradientParTempl<Double_t>(x, grad, eps);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the gradient with respect to the parameters is computed
+/// analytically by GradientPar. This is the case for the functions defined by
+/// a formula (not normalized) whose expression can be differentiated by
+/// TFormula::GenerateGradientPar. The fitting code uses then the gradient
+/// automatically.
+
+Bool_t TF1::HasAnalyticGradientPar()
+{
+   return fType == EFType::kFormula && fFormula && !fNormalized && fFormula->GenerateGradientPar();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize parameters addresses.
 
@@ -2950,10 +3042,21 @@ TH1   *TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
-   InitArgs(xv, parameters);
-   for (i = 1; i <= fNpx; i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i, EvalPar(xv, parameters));
+   if (fType == EFType::kInterpreted) {
+      InitArgs(xv, parameters);
+      for (i = 1; i <= fNpx; i++) {
+         xv[0] = histogram->GetBinCenter(i);
+         histogram->SetBinContent(i, EvalPar(xv, parameters));
+      }
+   } else {
+      // evaluate all the bin centers in a single call
+      std::vector<Double_t> centers(fNpx);
+      std::vector<Double_t> values(fNpx);
+      for (i = 1; i <= fNpx; i++)
+         centers[i - 1] = histogram->GetBinCenter(i);
+      EvalParN(fNpx, centers.data(), values.data(), parameters);
+      for (i = 1; i <= fNpx; i++)
+         histogram->SetBinContent(i, values[i - 1]);
    }
 
    // Copy Function attributes to histogram attributes.
@@ -163,6 +163,14 @@ Double_t TF12::EvalPar(const Double_t *x, const Double_t *params)
    return fF2->EvalPar(xx,params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate this function on n points, one by one with EvalPar.
+
+void TF12::EvalParN(Int_t n, const Double_t *x, Double_t *result, const Double_t *params)
+{
+   for (Int_t i = 0; i < n; ++i) result[i] = EvalPar(x + i, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
@@ -24,10 +24,20 @@
 #include "TInterpreter.h"
 #include "TFormula.h"
 #include "TRegexp.h"
+#include "TSystem.h"
+#include "TMD5.h"
 #include <cassert>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -156,6 +166,641 @@ static const TString gNamePrefix = "TFormula__";
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
 
+// static map of the functions evaluating a formula on many points, keyed by the Cling input
+// of the scalar function. A null pointer records that the batch function could not be built
+static std::unordered_map<std::string,  void *> gClingBatchFunctions = std::unordered_map<std::string,  void * >();
+
+// static map of the functions computing the gradient with respect to the parameters, keyed by the
+// Cling input of the scalar function. A null pointer records that the gradient could not be generated
+static std::unordered_map<std::string,  void *> gClingGradFunctions = std::unordered_map<std::string,  void * >();
+
+// lazy compilation: the functions are queued at construction and all the queued
+// functions are passed to Cling together when one of them is first evaluated
+static Bool_t gLazyCompilation = kFALSE;
+static TString gCompilationCacheDir;
+
+struct TFormulaPendingFunction {
+   std::string fExpression; // key in gClingFunctions
+   std::string fCode;       // function definition passed to Cling
+   std::string fName;       // function name
+   std::string fPrototype;  // function arguments
+};
+static std::vector<TFormulaPendingFunction> gPendingFunctions;
+static std::unordered_set<std::string> gPendingExpressions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the expression of the function built by TFormula::ProcessFormula
+/// for Cling, i.e. what is between "{ return " and " ; }".
+
+static std::string GetClingExpression(const TString &clingInput)
+{
+   std::string input = clingInput.Data();
+   const std::string begin = "{ return ";
+   const std::string end = " ; }";
+   std::size_t ibegin = input.find(begin);
+   std::size_t iend = input.rfind(end);
+   if (ibegin == std::string::npos || iend == std::string::npos || iend < ibegin + begin.size()) return "";
+   return input.substr(ibegin + begin.size(), iend - ibegin - begin.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take an exclusive lock on the given file, which is created if needed, so
+/// that several processes sharing the compilation cache do not write and
+/// build the same macro at the same time. Return the descriptor to pass to
+/// UnlockCompilationCache, or -1 if the lock could not be taken.
+
+static Int_t LockCompilationCache(const char *lockFile)
+{
+#ifndef WIN32
+   Int_t fd = open(lockFile, O_WRONLY | O_CREAT, 0644);
+   if (fd < 0) return -1;
+   if (lockf(fd, F_LOCK, 0) != 0) {
+      close(fd);
+      return -1;
+   }
+   return fd;
+#else
+   (void)lockFile;
+   return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the lock taken by LockCompilationCache.
+
+static void UnlockCompilationCache(Int_t fd)
+{
+#ifndef WIN32
+   lockf(fd, F_ULOCK, 0);
+   close(fd);
+#else
+   (void)fd;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the given functions with ACLiC in the compilation cache directory.
+/// The name of the macro is built from the MD5 digest of its content, so that
+/// a library built by a previous process for the same functions is loaded
+/// without being rebuilt. The macro is written in a temporary file renamed
+/// into place, and the writing and the build are done holding a lock file,
+/// so processes sharing the directory never see a partial macro or library.
+/// Return false if the compilation failed, e.g. because the code uses
+/// functions known only to the interpreter. A failure is recorded in a
+/// marker file next to the macro, so that the following processes do not
+/// run the compiler again for the same code.
+
+static Bool_t LoadCompilationCache(const std::string &code)
+{
+   std::string source = std::string("// TFormula function compiled for ROOT ") + gROOT->GetVersion() + "\n"
+                        "#include \"TMath.h\"\n"
+                        "#include \"Math/SpecFuncMathCore.h\"\n"
+                        "#include \"Math/PdfFuncMathCore.h\"\n"
+                        "#include \"Math/ProbFuncMathCore.h\"\n" + code + "\n";
+   TString dir = gCompilationCacheDir;
+   gSystem->ExpandPathName(dir);
+   if (gSystem->AccessPathName(dir) && gSystem->mkdir(dir, kTRUE) != 0) {
+      Warning("TFormula::LoadCompilationCache", "Cannot create directory %s", dir.Data());
+      return kFALSE;
+   }
+   TMD5 md5;
+   md5.Update((const UChar_t *)source.data(), source.size());
+   md5.Final();
+   TString name = TString::Format("%s/TFormulaCache_%s", dir.Data(), md5.AsString());
+   TString macro = name + ".C";
+
+   Int_t lock = LockCompilationCache(name + ".lock");
+   if (lock < 0) {
+      Warning("TFormula::LoadCompilationCache", "Cannot lock %s.lock", name.Data());
+      return kFALSE;
+   }
+   TString failed = name + ".failed";
+   if (!gSystem->AccessPathName(failed)) {
+      UnlockCompilationCache(lock);
+      return kFALSE;
+   }
+   Bool_t ok = kTRUE;
+   if (gSystem->AccessPathName(macro)) {
+      TString tmp = "TFormulaCache_";
+      FILE *out = gSystem->TempFileName(tmp, dir);
+      ok = out != nullptr;
+      if (ok) {
+         ok = fwrite(source.data(), 1, source.size(), out) == source.size();
+         ok = (fclose(out) == 0) && ok;
+         ok = ok && gSystem->Chmod(tmp, 0644) == 0 && gSystem->Rename(tmp, macro) == 0;
+         if (!ok) gSystem->Unlink(tmp);
+      }
+      if (!ok) Warning("TFormula::LoadCompilationCache", "Cannot write %s", macro.Data());
+   }
+   // ACLiC does not rebuild the library if it is more recent than the macro
+   if (ok && gSystem->CompileMacro(macro, "kO") != 1) {
+      ok = kFALSE;
+      FILE *marker = fopen(failed, "w");
+      if (marker) fclose(marker);
+   }
+   UnlockCompilationCache(lock);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Pass all the queued functions to Cling in a single declaration (or load
+/// them from the compilation cache) and store their pointers in
+/// gClingFunctions. Invalid functions are not stored.
+/// Must be called with gROOTMutex held.
+
+static void CompilePendingFunctions()
+{
+   if (gPendingFunctions.empty()) return;
+   std::vector<TFormulaPendingFunction> pending;
+   pending.swap(gPendingFunctions);
+   gPendingExpressions.clear();
+
+   // the queued functions are compiled in a single cached library. If ACLiC cannot compile
+   // one of them, each function is compiled in its own library: the failed builds are
+   // remembered, so this happens only in the first process queuing these functions.
+   // The functions which are not loaded from the compilation cache are declared to Cling together
+   std::vector<const TFormulaPendingFunction *> toDeclare;
+   if (!gCompilationCacheDir.IsNull()) {
+      std::string all;
+      for (auto &func : pending) {
+         all += func.fCode;
+         all += "\n";
+      }
+      if (pending.size() == 1 || !LoadCompilationCache(all)) {
+         for (auto &func : pending) {
+            if (!LoadCompilationCache(func.fCode)) toDeclare.push_back(&func);
+         }
+      }
+   } else {
+      for (auto &func : pending) toDeclare.push_back(&func);
+   }
+   std::string code;
+   for (auto func : toDeclare) {
+      code += func->fCode;
+      code += "\n";
+   }
+
+   if (!toDeclare.empty() && !gCling->Declare(code.c_str())) {
+      // one of the functions is invalid: declare them one by one
+      for (auto func : toDeclare) gCling->Declare(func->fCode.c_str());
+   }
+
+   for (auto &func : pending) {
+      TMethodCall method;
+      method.InitWithPrototype(func.fName.c_str(), func.fPrototype.c_str());
+      if (!method.IsValid()) continue;
+      TInterpreter::CallFuncIFacePtr_t faceptr = gCling->CallFunc_IFacePtr(method.GetCallFunc());
+      gClingFunctions.insert(std::make_pair(func.fExpression, (void *)faceptr.fGeneric));
+   }
+}
+
+#ifdef R__HAS_VECCORE
+
+// TMath functions which have a vectorized version in vecCore::math
+static const char *gVectorizableFunctions[] = {"Exp", "Log", "Log10", "Sqrt", "Sin", "Cos", "Tan",
+                                               "ASin", "ACos", "ATan", "Abs", "Power"};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Declare to Cling the overloads used by the vectorized formula expressions.
+/// They forward to vecCore::math for ROOT::Double_v and to TMath for scalars,
+/// so that sub-expressions depending only on the parameters stay scalar.
+/// Return false if the declaration failed.
+
+static Bool_t DeclareVectorizedFunctions()
+{
+   static Bool_t declared = false;
+   static Bool_t tried = false;
+   if (tried) return declared;
+   tried = true;
+
+   TString code = "#include \"Math/Types.h\"\n"
+                  "#include \"TMath.h\"\n"
+                  "namespace ROOT { namespace Internal { namespace TFormulaVec {\n";
+   for (auto name : gVectorizableFunctions) {
+      if (TString(name) == "Power") {
+         code += "inline ROOT::Double_v Power(const ROOT::Double_v &x, const ROOT::Double_v &y)"
+                 " { return vecCore::math::Pow(x, y); }\n"
+                 "inline Double_t Power(Double_t x, Double_t y) { return TMath::Power(x, y); }\n";
+         continue;
+      }
+      code += TString::Format("inline ROOT::Double_v %s(const ROOT::Double_v &x) { return vecCore::math::%s(x); }\n"
+                              "inline Double_t %s(Double_t x) { return TMath::%s(x); }\n",
+                              name, name, name, name);
+   }
+   code += "} } }\n";
+   declared = gCling->Declare(code);
+   return declared;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the Cling expression of a formula in an expression valid for
+/// x[i] of type ROOT::Double_v. Only numbers, x[i], p[i], the arithmetic
+/// operators and the functions in gVectorizableFunctions are accepted;
+/// return false for anything else (e.g. comparisons or user functions).
+
+static Bool_t GetVectorizedExpression(const std::string &expr, std::string &vecExpr)
+{
+   vecExpr.clear();
+   const size_t n = expr.size();
+   size_t i = 0;
+   while (i < n) {
+      const char c = expr[i];
+      if (isspace(c) || strchr("+-*/(),", c)) {
+         vecExpr += c;
+         ++i;
+      } else if (isdigit(c) || c == '.') {
+         size_t j = i;
+         bool isInteger = true;
+         while (j < n && (isdigit(expr[j]) || expr[j] == '.')) {
+            if (expr[j] == '.') isInteger = false;
+            ++j;
+         }
+         if (j < n && (expr[j] == 'e' || expr[j] == 'E')) {
+            isInteger = false;
+            ++j;
+            if (j < n && (expr[j] == '+' || expr[j] == '-')) ++j;
+            while (j < n && isdigit(expr[j])) ++j;
+         }
+         vecExpr.append(expr, i, j - i);
+         // integer literals would need a conversion to ROOT::Double_v
+         if (isInteger) vecExpr += '.';
+         i = j;
+      } else if (isalpha(c) || c == '_') {
+         size_t j = i;
+         while (j < n && (isalnum(expr[j]) || expr[j] == '_' || expr[j] == ':')) ++j;
+         std::string name = expr.substr(i, j - i);
+         if ((name == "x" || name == "p") && j < n && expr[j] == '[') {
+            size_t k = j + 1;
+            while (k < n && isdigit(expr[k])) ++k;
+            if (k == j + 1 || k >= n || expr[k] != ']') return false;
+            vecExpr.append(expr, i, k + 1 - i);
+            i = k + 1;
+         } else if (name.compare(0, 7, "TMath::") == 0 && j < n && expr[j] == '(') {
+            std::string func = name.substr(7);
+            Bool_t found = false;
+            for (auto vfunc : gVectorizableFunctions)
+               if (func == vfunc) found = true;
+            if (!found) return false;
+            vecExpr += "ROOT::Internal::TFormulaVec::" + func;
+            i = j;
+         } else {
+            return false;
+         }
+      } else {
+         return false;
+      }
+   }
+   return true;
+}
+
+#endif
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Helper class building the code of the gradient of a formula expression with
+/// respect to the parameters p[i], by reverse mode automatic differentiation.
+/// The Cling expression is parsed in a list of nodes (children before their
+/// parent); the generated code computes first the value of every node and then
+/// propagates the derivative of the result (the adjoint) from the root back to
+/// the parameters, so that the cost does not depend on the number of parameters.
+/// Only the arithmetic operators, the comparisons, the ternary operator and the
+/// elementary functions of TMath (or std) can depend on the parameters; any other
+/// function is accepted only if its arguments do not depend on them.
+
+class TFormulaGradientBuilder {
+public:
+   TFormulaGradientBuilder(const std::string &expr) : fExpr(expr), fPos(0), fError(kFALSE) {}
+
+   Bool_t Build(Int_t npar, std::string &code);
+
+private:
+   struct Node {
+      std::string fOp;          // operator or function name, empty for the leaves
+      std::string fText;        // code of the leaves
+      std::vector<Int_t> fArgs; // children
+      Int_t fPar = -1;          // parameter index of a p[i] leaf
+      Bool_t fDepends = kFALSE; // true if the node depends on the parameters
+   };
+
+   std::string fExpr;
+   size_t fPos;
+   Bool_t fError;
+   std::vector<Node> fNodes;
+   std::vector<std::string> fValues; // code of the value of each node
+
+   Int_t AddNode(const std::string &op, const std::vector<Int_t> &args);
+   void SkipSpaces();
+   Bool_t Match(const char *token);
+   Int_t ParseTernary();
+   Int_t ParseBinary(Int_t level);
+   Int_t ParseUnary();
+   Int_t ParsePrimary();
+   Bool_t GetPartial(Int_t inode, size_t iarg, std::string &partial) const;
+   void AddAdjoint(Int_t inode, const std::string &value, std::string &code) const;
+};
+
+Int_t TFormulaGradientBuilder::AddNode(const std::string &op, const std::vector<Int_t> &args)
+{
+   if (fError) return -1;
+   Node node;
+   node.fOp = op;
+   node.fArgs = args;
+   for (auto arg : args) {
+      if (arg < 0) {
+         fError = kTRUE;
+         return -1;
+      }
+      node.fDepends |= fNodes[arg].fDepends;
+   }
+   fNodes.push_back(node);
+   return fNodes.size() - 1;
+}
+
+void TFormulaGradientBuilder::SkipSpaces()
+{
+   while (fPos < fExpr.size() && isspace(fExpr[fPos])) ++fPos;
+}
+
+Bool_t TFormulaGradientBuilder::Match(const char *token)
+{
+   SkipSpaces();
+   size_t n = strlen(token);
+   if (fExpr.compare(fPos, n, token) != 0) return kFALSE;
+   // do not split the operators made of two characters
+   if (n == 1 && fPos + 1 < fExpr.size()) {
+      char next = fExpr[fPos + 1];
+      if ((token[0] == '<' || token[0] == '>' || token[0] == '!') && next == '=') return kFALSE;
+      if ((token[0] == '<' || token[0] == '>' || token[0] == '&' || token[0] == '|') && next == token[0])
+         return kFALSE;
+   }
+   fPos += n;
+   return kTRUE;
+}
+
+Int_t TFormulaGradientBuilder::ParseTernary()
+{
+   Int_t cond = ParseBinary(0);
+   if (!Match("?")) return cond;
+   Int_t a = ParseTernary();
+   if (!Match(":")) {
+      fError = kTRUE;
+      return -1;
+   }
+   Int_t b = ParseTernary();
+   return AddNode("?", {cond, a, b});
+}
+
+// binary operators in order of increasing precedence
+static const std::vector<std::vector<std::string>> gGradientOperators = {
+   {"||"}, {"&&"}, {"==", "!="}, {"<=", ">=", "<", ">"}, {"+", "-"}, {"*", "/"}};
+
+Int_t TFormulaGradientBuilder::ParseBinary(Int_t level)
+{
+   if (level == (Int_t)gGradientOperators.size()) return ParseUnary();
+   Int_t lhs = ParseBinary(level + 1);
+   while (!fError) {
+      std::string op;
+      for (auto &candidate : gGradientOperators[level])
+         if (Match(candidate.c_str())) {
+            op = candidate;
+            break;
+         }
+      if (op.empty()) break;
+      Int_t rhs = ParseBinary(level + 1);
+      lhs = AddNode(op, {lhs, rhs});
+   }
+   return lhs;
+}
+
+Int_t TFormulaGradientBuilder::ParseUnary()
+{
+   if (Match("-")) return AddNode("neg", {ParseUnary()});
+   if (Match("+")) return ParseUnary();
+   if (Match("!")) return AddNode("!", {ParseUnary()});
+   return ParsePrimary();
+}
+
+Int_t TFormulaGradientBuilder::ParsePrimary()
+{
+   SkipSpaces();
+   if (fError || fPos >= fExpr.size()) {
+      fError = kTRUE;
+      return -1;
+   }
+   if (Match("(")) {
+      Int_t inode = ParseTernary();
+      if (!Match(")")) fError = kTRUE;
+      return inode;
+   }
+   const size_t begin = fPos;
+   const char c = fExpr[fPos];
+   Node leaf;
+   if (isdigit(c) || c == '.') {
+      while (fPos < fExpr.size() && (isalnum(fExpr[fPos]) || fExpr[fPos] == '.' ||
+                                     ((fExpr[fPos] == '+' || fExpr[fPos] == '-') &&
+                                      (fExpr[fPos - 1] == 'e' || fExpr[fPos - 1] == 'E'))))
+         ++fPos;
+   } else if (isalpha(c) || c == '_') {
+      while (fPos < fExpr.size() && (isalnum(fExpr[fPos]) || fExpr[fPos] == '_' || fExpr[fPos] == ':')) ++fPos;
+      std::string name = fExpr.substr(begin, fPos - begin);
+      if (Match("[")) {
+         // x[i] or p[i]
+         SkipSpaces();
+         const size_t ibegin = fPos;
+         while (fPos < fExpr.size() && isdigit(fExpr[fPos])) ++fPos;
+         std::string index = fExpr.substr(ibegin, fPos - ibegin);
+         if (index.empty() || !Match("]") || (name != "x" && name != "p")) {
+            fError = kTRUE;
+            return -1;
+         }
+         if (name == "p") {
+            leaf.fPar = std::atoi(index.c_str());
+            leaf.fDepends = kTRUE;
+         }
+         leaf.fText = name + "[" + index + "]";
+         fNodes.push_back(leaf);
+         return fNodes.size() - 1;
+      }
+      if (Match("(")) {
+         std::vector<Int_t> args;
+         if (!Match(")")) {
+            do {
+               args.push_back(ParseTernary());
+            } while (!fError && Match(","));
+            if (!Match(")")) fError = kTRUE;
+         }
+         return AddNode(name, args);
+      }
+   } else {
+      fError = kTRUE;
+      return -1;
+   }
+   leaf.fText = fExpr.substr(begin, fPos - begin);
+   fNodes.push_back(leaf);
+   return fNodes.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the code of the partial derivative of a function node with respect to
+/// its argument iarg (empty if null), or false if the function is not known.
+
+Bool_t TFormulaGradientBuilder::GetPartial(Int_t inode, size_t iarg, std::string &partial) const
+{
+   const Node &node = fNodes[inode];
+   std::string name = node.fOp;
+   if (name.compare(0, 7, "TMath::") == 0)
+      name = name.substr(7);
+   else if (name.compare(0, 5, "std::") == 0)
+      name = name.substr(5);
+   std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+   const size_t nargs = node.fArgs.size();
+   const std::string &u = fValues[node.fArgs[0]];
+   const std::string &f = fValues[inode];
+   if (nargs == 1) {
+      if (name == "exp") partial = f;
+      else if (name == "log") partial = "(1./" + u + ")";
+      else if (name == "log10") partial = "(1./(" + u + "*TMath::Ln10()))";
+      else if (name == "sqrt") partial = "(0.5/" + f + ")";
+      else if (name == "sin") partial = "TMath::Cos(" + u + ")";
+      else if (name == "cos") partial = "(-TMath::Sin(" + u + "))";
+      else if (name == "tan") partial = "(1.+" + f + "*" + f + ")";
+      else if (name == "sinh") partial = "TMath::CosH(" + u + ")";
+      else if (name == "cosh") partial = "TMath::SinH(" + u + ")";
+      else if (name == "tanh") partial = "(1.-" + f + "*" + f + ")";
+      else if (name == "asin") partial = "(1./TMath::Sqrt(1.-" + u + "*" + u + "))";
+      else if (name == "acos") partial = "(-1./TMath::Sqrt(1.-" + u + "*" + u + "))";
+      else if (name == "atan") partial = "(1./(1.+" + u + "*" + u + "))";
+      else if (name == "abs" || name == "fabs") partial = "TMath::Sign(1.," + u + ")";
+      else if (name == "sq") partial = "(2.*" + u + ")";
+      else if (name == "floor" || name == "ceil") partial = "";
+      else return kFALSE;
+      return kTRUE;
+   }
+   if (nargs != 2) return kFALSE;
+   const std::string &w = fValues[node.fArgs[1]];
+   if (name == "power" || name == "pow")
+      partial = (iarg == 0) ? "(" + w + "*TMath::Power(" + u + "," + w + "-1.))" : "(" + f + "*TMath::Log(" + u + "))";
+   else if (name == "atan2")
+      partial = ((iarg == 0) ? "(" + w : "(-" + u) + "/(" + u + "*" + u + "+" + w + "*" + w + "))";
+   else if (name == "min")
+      partial = (iarg == 0) ? "(" + u + "<=" + w + " ? 1. : 0.)" : "(" + u + "<=" + w + " ? 0. : 1.)";
+   else if (name == "max")
+      partial = (iarg == 0) ? "(" + u + ">=" + w + " ? 1. : 0.)" : "(" + u + ">=" + w + " ? 0. : 1.)";
+   else
+      return kFALSE;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the code propagating the given contribution to the adjoint of a node,
+/// which is directly the gradient for a parameter.
+
+void TFormulaGradientBuilder::AddAdjoint(Int_t inode, const std::string &value, std::string &code) const
+{
+   if (fNodes[inode].fPar >= 0)
+      code += "   grad[" + std::to_string(fNodes[inode].fPar) + "] += " + value + ";\n";
+   else
+      code += "   a" + std::to_string(inode) + " += " + value + ";\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the body of the function computing the gradient of the expression
+/// with respect to the npar parameters (in grad). Return false if the expression
+/// cannot be differentiated.
+
+Bool_t TFormulaGradientBuilder::Build(Int_t npar, std::string &code)
+{
+   Int_t root = ParseTernary();
+   SkipSpaces();
+   if (fError || root < 0 || fPos != fExpr.size()) return kFALSE;
+
+   code = "   for (Int_t i = 0; i < " + std::to_string(npar) + "; ++i) grad[i] = 0;\n";
+
+   // values of the nodes
+   fValues.resize(fNodes.size());
+   for (size_t i = 0; i < fNodes.size(); ++i) {
+      const Node &node = fNodes[i];
+      if (node.fPar >= npar) return kFALSE;
+      if (node.fOp.empty()) {
+         fValues[i] = node.fText;
+         continue;
+      }
+      std::string value;
+      const auto &args = node.fArgs;
+      if (node.fOp == "neg")
+         value = "(-" + fValues[args[0]] + ")";
+      else if (node.fOp == "!")
+         value = "(!" + fValues[args[0]] + ")";
+      else if (node.fOp == "?")
+         value = "(" + fValues[args[0]] + " ? " + fValues[args[1]] + " : " + fValues[args[2]] + ")";
+      else if (args.size() == 2 && !isalpha(node.fOp[0]) && node.fOp[0] != '_')
+         value = "(" + fValues[args[0]] + " " + node.fOp + " " + fValues[args[1]] + ")";
+      else {
+         value = node.fOp + "(";
+         for (size_t j = 0; j < args.size(); ++j) value += ((j > 0) ? "," : "") + fValues[args[j]];
+         value += ")";
+      }
+      fValues[i] = "v" + std::to_string(i);
+      code += "   const Double_t " + fValues[i] + " = " + value + ";\n";
+   }
+   if (!fNodes[root].fDepends) return kTRUE;
+   if (fNodes[root].fPar >= 0) {
+      code += "   grad[" + std::to_string(fNodes[root].fPar) + "] = 1;\n";
+      return kTRUE;
+   }
+
+   // adjoints of the nodes depending on the parameters, propagated from the root
+   for (size_t i = 0; i < fNodes.size(); ++i)
+      if (fNodes[i].fDepends && fNodes[i].fPar < 0)
+         code += "   Double_t a" + std::to_string(i) + " = " + ((Int_t)i == root ? "1" : "0") + ";\n";
+
+   for (Int_t i = root; i >= 0; --i) {
+      const Node &node = fNodes[i];
+      if (!node.fDepends || node.fOp.empty()) continue;
+      const std::string adj = "a" + std::to_string(i);
+      const auto &args = node.fArgs;
+      // the adjoints are propagated only from the nodes with a non null adjoint: the nodes of the
+      // branch of a ternary operator which is not taken keep a null adjoint, and their partial
+      // derivatives, which can be infinite or NaN (e.g. sqrt of a negative number), must not be used
+      std::string step;
+      if (node.fOp == "neg") {
+         AddAdjoint(args[0], "-" + adj, step);
+      } else if (node.fOp == "+" || node.fOp == "-") {
+         if (fNodes[args[0]].fDepends) AddAdjoint(args[0], adj, step);
+         if (fNodes[args[1]].fDepends) AddAdjoint(args[1], (node.fOp == "-" ? "-" : "") + adj, step);
+      } else if (node.fOp == "*") {
+         if (fNodes[args[0]].fDepends) AddAdjoint(args[0], adj + "*" + fValues[args[1]], step);
+         if (fNodes[args[1]].fDepends) AddAdjoint(args[1], adj + "*" + fValues[args[0]], step);
+      } else if (node.fOp == "/") {
+         if (fNodes[args[0]].fDepends) AddAdjoint(args[0], adj + "/" + fValues[args[1]], step);
+         if (fNodes[args[1]].fDepends)
+            AddAdjoint(args[1], "-" + adj + "*" + fValues[i] + "/" + fValues[args[1]], step);
+      } else if (node.fOp == "?") {
+         // the condition has a null derivative
+         std::string branch[2];
+         for (Int_t j = 0; j < 2; ++j)
+            if (fNodes[args[j + 1]].fDepends) AddAdjoint(args[j + 1], adj, branch[j]);
+         step += "   if (" + fValues[args[0]] + ") {\n" + branch[0] + "   } else {\n" + branch[1] + "   }\n";
+      } else if (!isalpha(node.fOp[0]) && node.fOp[0] != '_') {
+         // comparisons and logical operators have a null derivative
+         continue;
+      } else {
+         for (size_t j = 0; j < args.size(); ++j) {
+            if (!fNodes[args[j]].fDepends) continue;
+            std::string partial;
+            if (!GetPartial(i, j, partial)) return kFALSE;
+            if (!partial.empty()) AddAdjoint(args[j], adj + "*" + partial, step);
+         }
+      }
+      if (!step.empty()) code += "   if (" + adj + " != 0) {\n" + step + "   }\n";
+   }
+   return kTRUE;
+}
+
+} // end anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 Bool_t TFormula::IsOperator(const char c)
 {
@@ -592,6 +1237,68 @@ Int_t TFormula::Compile(const char *expression)
    return (ret) ? 0 : 1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the lazy compilation of the formulas created afterwards.
+///
+/// By default the C++ function of a formula is compiled by Cling when the
+/// formula is created (or read from a file). With lazy compilation the
+/// functions are only queued, and all the queued functions are compiled
+/// together, in a single Cling transaction, the first time one of them is
+/// evaluated. This reduces significantly the time needed to create many
+/// formulas, e.g. when reading many TF1 from a file, and avoids compiling
+/// formulas which are never evaluated.
+/// The drawback is that an expression which is not valid C++ is only
+/// reported when the formula is first evaluated: IsValid() returns true
+/// for a formula waiting to be compiled.
+
+void TFormula::SetLazyCompilation(Bool_t lazy)
+{
+   R__LOCKGUARD(gROOTMutex);
+   gLazyCompilation = lazy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the formulas are compiled lazily (see SetLazyCompilation).
+
+Bool_t TFormula::GetLazyCompilation()
+{
+   return gLazyCompilation;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the directory where the functions compiled lazily are cached.
+///
+/// When set, the functions queued by the lazy compilation (see
+/// SetLazyCompilation) and compiled together on the first evaluation are
+/// written in a single macro in this directory, named after the MD5 digest
+/// of its content, and compiled with ACLiC. A following process creating the
+/// same formulas loads the existing library instead of compiling it again.
+/// Several processes can share the directory. Since the library is built for
+/// a given set of formulas, the cache is effective for programs creating the
+/// same formulas at each run; create them with the lazy compilation enabled,
+/// so that they end up in one library instead of one per formula.
+///
+/// If the compilation fails (e.g. a formula uses a function defined only in
+/// the interpreter), the functions are compiled each in its own library and
+/// those which still fail are passed to Cling. The failure is recorded in a
+/// file `<macro>.failed`, so that the next processes do not run the compiler
+/// again for the same code; remove these files to retry the compilation
+/// (e.g. after fixing the compiler setup). An empty string disables the cache.
+
+void TFormula::SetCompilationCacheDir(const char *dir)
+{
+   R__LOCKGUARD(gROOTMutex);
+   gCompilationCacheDir = dir;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the directory used to cache the compiled functions.
+
+const char *TFormula::GetCompilationCacheDir()
+{
+   return gCompilationCacheDir.Data();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TFormula::Copy(TObject &obj) const
 {
@@ -638,7 +1345,7 @@ void TFormula::Copy(TObject &obj) const
 
    fnew.fClingInput = fClingInput;
    fnew.fReadyToExecute = fReadyToExecute;
-   fnew.fClingInitialized = fClingInitialized;
+   fnew.fClingInitialized = fClingInitialized.load();
    fnew.fAllParametersSetted = fAllParametersSetted;
    fnew.fClingName = fClingName;
 
@@ -662,7 +1369,12 @@ void TFormula::Copy(TObject &obj) const
       fnew.fMethod  = m;
    }
 
-   fnew.fFuncPtr = fFuncPtr;
+   fnew.fFuncPtr = fFuncPtr.load();
+   fnew.fBatchFuncPtr = fBatchFuncPtr;
+   fnew.fBatchPrepared = fBatchPrepared.load();
+   fnew.fGradFuncPtr = fGradFuncPtr;
+   fnew.fGradPrepared = fGradPrepared.load();
+   fnew.fClingPending = fClingPending.load();
 
 }
 
@@ -687,6 +1399,11 @@ void TFormula::Clear(Option_t * )
    fReadyToExecute = false;
    fClingInitialized = false;
    fAllParametersSetted = false;
+   fBatchFuncPtr = nullptr;
+   fBatchPrepared = false;
+   fGradFuncPtr = nullptr;
+   fGradPrepared = false;
+   fClingPending = false;
    fFuncs.clear();
    fVars.clear();
    fParams.clear();
@@ -755,6 +1472,155 @@ bool TFormula::PrepareEvalMethod()
    return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the function of a formula queued with lazy compilation, together
+/// with all the other queued functions. Return false (and invalidate the
+/// formula) if the function could not be compiled.
+
+Bool_t TFormula::CompilePendingFormula()
+{
+   R__LOCKGUARD(gROOTMutex);
+   if (!fClingPending) return fClingInitialized;
+
+   std::string expr = GetClingExpression(fClingInput);
+   auto funcit = gClingFunctions.find(expr);
+   if (funcit == gClingFunctions.end()) {
+      CompilePendingFunctions();
+      funcit = gClingFunctions.find(expr);
+   }
+   // the evaluation functions check fClingPending, then fClingInitialized and fFuncPtr without
+   // taking the lock: fClingPending must be cleared last. A formula which failed to compile
+   // stays not initialized, which makes it invalid.
+   if (funcit == gClingFunctions.end()) {
+      Error("Eval", "Formula \"%s\" is invalid: compilation of %s failed", GetExpFormula().Data(), fClingName.Data());
+      fClingPending.store(false, std::memory_order_release);
+      return false;
+   }
+   fFuncPtr.store((TInterpreter::CallFuncIFacePtr_t::Generic_t)funcit->second, std::memory_order_release);
+   fClingInitialized.store(true, std::memory_order_release);
+   fClingPending.store(false, std::memory_order_release);
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build in Cling the function used by EvalParN, which evaluates the formula
+/// expression on an array of points in a single call:
+///
+///     void <clingname>_batch(Int_t n, Double_t *xx, Double_t *p, Double_t *result)
+///
+/// When VecCore is available and the expression contains only operations
+/// which have a vectorized version, a ROOT::Double_v version
+/// (<clingname>_vbatch) is built instead. The function pointer is cached per
+/// expression; fBatchFuncPtr stays null if the function could not be built.
+
+void TFormula::PrepareBatchEvalMethod()
+{
+   R__LOCKGUARD(gROOTMutex);
+   if (fBatchPrepared) return;
+
+   std::string input = fClingInput.Data();
+   auto funcit = gClingBatchFunctions.find(input);
+   if (funcit != gClingBatchFunctions.end()) {
+      fBatchFuncPtr = (TInterpreter::CallFuncIFacePtr_t::Generic_t)funcit->second;
+      fBatchPrepared = true;
+      return;
+   }
+
+   // extract the expression from the scalar function built in ProcessFormula
+   std::string expr = GetClingExpression(fClingInput);
+   TInterpreter::CallFuncIFacePtr_t::Generic_t funcPtr = nullptr;
+   if (!expr.empty()) {
+      Int_t ndim = fNdim;
+      TString batchName;
+      Bool_t declared = false;
+#ifdef R__HAS_VECCORE
+      std::string vecExpr;
+      if (vecCore::VectorSize<ROOT::Double_v>() > 1 && GetVectorizedExpression(expr, vecExpr) &&
+          DeclareVectorizedFunctions()) {
+         batchName = fClingName + "_vbatch";
+         TString code = TString::Format(
+            "void %s(Int_t n, Double_t *xx, Double_t *p, Double_t *result) {\n"
+            "   const Int_t vsize = vecCore::VectorSize<ROOT::Double_v>();\n"
+            "   Int_t i = 0;\n"
+            "   for (; i + vsize <= n; i += vsize) {\n"
+            "      ROOT::Double_v x[%d];\n"
+            "      for (Int_t d = 0; d < %d; ++d)\n"
+            "         for (Int_t l = 0; l < vsize; ++l) vecCore::Set(x[d], l, xx[(i + l) * %d + d]);\n"
+            "      ROOT::Double_v r = %s;\n"
+            "      vecCore::Store(r, result + i);\n"
+            "   }\n"
+            "   for (; i < n; ++i) { Double_t *x = xx + i * %d; result[i] = %s; }\n"
+            "}\n",
+            batchName.Data(), std::max(ndim, 1), ndim, ndim, vecExpr.c_str(), ndim, expr.c_str());
+         declared = gCling->Declare(code);
+      }
+#endif
+      if (!declared) {
+         batchName = fClingName + "_batch";
+         TString code = TString::Format(
+            "void %s(Int_t n, Double_t *xx, Double_t *p, Double_t *result) {\n"
+            "   for (Int_t i = 0; i < n; ++i) { Double_t *x = xx + i * %d; result[i] = %s; }\n"
+            "}\n",
+            batchName.Data(), ndim, expr.c_str());
+         declared = gCling->Declare(code);
+      }
+      if (declared) {
+         TMethodCall method;
+         method.InitWithPrototype(batchName, "Int_t,Double_t*,Double_t*,Double_t*");
+         if (method.IsValid())
+            funcPtr = gCling->CallFunc_IFacePtr(method.GetCallFunc()).fGeneric;
+      }
+   }
+
+   gClingBatchFunctions.insert(std::make_pair(input, (void *)funcPtr));
+   // fBatchPrepared is set last: EvalParN reads fBatchFuncPtr once it is true, without taking the lock
+   fBatchFuncPtr = funcPtr;
+   fBatchPrepared = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build in Cling the function computing the gradient of the formula with
+/// respect to the parameters, generated by differentiating the expression
+/// (see TFormulaGradientBuilder):
+///
+///     void <clingname>_grad(Double_t *x, Double_t *p, Double_t *grad)
+///
+/// The function pointer is cached per expression; fGradFuncPtr stays null if
+/// the expression cannot be differentiated.
+
+void TFormula::PrepareGradientMethod()
+{
+   R__LOCKGUARD(gROOTMutex);
+   if (fGradPrepared) return;
+
+   std::string input = fClingInput.Data();
+   auto funcit = gClingGradFunctions.find(input);
+   if (funcit != gClingGradFunctions.end()) {
+      fGradFuncPtr = (TInterpreter::CallFuncIFacePtr_t::Generic_t)funcit->second;
+      fGradPrepared = true;
+      return;
+   }
+
+   std::string expr = GetClingExpression(fClingInput);
+   TInterpreter::CallFuncIFacePtr_t::Generic_t funcPtr = nullptr;
+   std::string body;
+   if (!expr.empty() && fNpar > 0 && TFormulaGradientBuilder(expr).Build(fNpar, body)) {
+      TString gradName = fClingName + "_grad";
+      TString code = TString::Format("void %s(Double_t *x, Double_t *p, Double_t *grad) {\n%s}\n", gradName.Data(),
+                                     body.c_str());
+      if (gCling->Declare(code)) {
+         TMethodCall method;
+         method.InitWithPrototype(gradName, "Double_t*,Double_t*,Double_t*");
+         if (method.IsValid())
+            funcPtr = gCling->CallFunc_IFacePtr(method.GetCallFunc()).fGeneric;
+      }
+   }
+
+   gClingGradFunctions.insert(std::make_pair(input, (void *)funcPtr));
+   fGradFuncPtr = funcPtr;
+   fGradPrepared = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///    Inputs formula, transfered to C++ code into Cling
 
@@ -2205,6 +3071,12 @@ void TFormula::ProcessFormula(TString &formula)
 
          fClingInput = TString::Format("Double_t %s(%s){ return %s ; }", fClingName.Data(), argumentsPrototype.Data(),
                                        inputFormula.c_str());
+         // the batch function is built on demand by EvalParN
+         fBatchFuncPtr = nullptr;
+         fBatchPrepared = false;
+         fGradFuncPtr = nullptr;
+         fGradPrepared = false;
+         fClingPending = false;
 
          // this is not needed (maybe can be re-added in case of recompilation of identical expressions
          // // check in case of a change if need to re-initialize
@@ -2215,13 +3087,27 @@ void TFormula::ProcessFormula(TString &formula)
          //       fClingInitialized = false;
          // }
 
-         if (inputIntoCling) {
+         // with lazy compilation queue the function, unless it uses names
+         // which have not been matched and might need Cling to be resolved
+         Bool_t allFunctorsMatched = true;
+         for (auto &fun : fFuncs) {
+            if (!fun.fFound) allFunctorsMatched = false;
+         }
+         if (inputIntoCling && gLazyCompilation && allFunctorsMatched) {
+            TString prototype = TString::Format("%s%s%s", (hasVariables ? "Double_t*" : ""), (hasBoth ? "," : ""),
+                                                (hasParameters ? "Double_t*" : ""));
+            if (gPendingExpressions.insert(inputFormula).second) {
+               gPendingFunctions.push_back(
+                  {inputFormula, fClingInput.Data(), fClingName.Data(), prototype.Data()});
+            }
+            fClingPending = true;
+         } else if (inputIntoCling) {
             InputFormulaIntoCling();
             if (fClingInitialized) {
                // if Cling has been succesfully initialized
                // dave function ptr in the static map
                R__LOCKGUARD(gROOTMutex);
-               gClingFunctions.insert(std::make_pair(inputFormula, (void *)fFuncPtr));
+               gClingFunctions.insert(std::make_pair(inputFormula, (void *)fFuncPtr.load()));
             }
 
          } else {
@@ -2233,7 +3119,7 @@ void TFormula::ProcessFormula(TString &formula)
 
    // IN case of a Cling Error check components wich are not found in Cling
    // check that all formula components arematched otherwise emit an error
-   if (!fClingInitialized) {
+   if (!fClingInitialized && !fClingPending) {
       Bool_t allFunctorsMatched = true;
       for(list<TFormulaFunction>::iterator it = fFuncs.begin(); it != fFuncs.end(); it++)
          {
@@ -2252,7 +3138,7 @@ void TFormula::ProcessFormula(TString &formula)
    }
 
    // clean up un-used default variables in case formula is valid
-   if (fClingInitialized && fReadyToExecute) {
+   if ((fClingInitialized || fClingPending) && fReadyToExecute) {
       auto itvar = fVars.begin();
       do {
          if (!itvar->second.fFound) {
@@ -2941,6 +3827,75 @@ Double_t TFormula::EvalPar(const Double_t *x,const Double_t *params) const
    return DoEval(x, params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula on n points in a single call.
+///
+/// The coordinates are stored point after point: coordinate j of point i is
+/// x[i * GetNdim() + j]. The n values are written in result. If params is
+/// null the current parameter values are used.
+///
+/// The first call builds in Cling a function looping on the points (see
+/// PrepareBatchEvalMethod), which avoids the overhead of the interpreter call
+/// for every point and, for expressions made of arithmetic operations and
+/// elementary functions, is vectorized using ROOT::Double_v.
+/// Formulas based on lambda expressions are evaluated point by point.
+
+void TFormula::EvalParN(Int_t n, const Double_t *x, Double_t *result, const Double_t *params) const
+{
+   if (n <= 0) return;
+   if (fClingPending.load(std::memory_order_acquire)) const_cast<TFormula *>(this)->CompilePendingFormula();
+   if (fReadyToExecute && fClingInitialized.load(std::memory_order_acquire) && !TestBit(TFormula::kLambda)) {
+      if (!fBatchPrepared) const_cast<TFormula *>(this)->PrepareBatchEvalMethod();
+      if (fBatchFuncPtr) {
+         Int_t npoints = n;
+         double *vars = const_cast<double *>(x);
+         double *pars = (params) ? const_cast<double *>(params) : const_cast<double *>(fClingParameters.data());
+         double *values = result;
+         void *args[4] = {&npoints, &vars, &pars, &values};
+         (*fBatchFuncPtr)(0, 4, args, nullptr);
+         return;
+      }
+   }
+   for (Int_t i = 0; i < n; ++i)
+      result[i] = DoEval((x) ? x + i * fNdim : nullptr, params);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Generate the code computing the gradient of the formula with respect to the
+/// parameters, by automatic differentiation of the expression compiled by Cling.
+/// Return false if the gradient is not available, e.g. when the formula is built
+/// from a lambda or uses functions of the parameters which cannot be differentiated
+/// (only the arithmetic operators and the elementary functions like exp, log,
+/// sqrt, pow or the trigonometric functions are supported).
+
+Bool_t TFormula::GenerateGradientPar()
+{
+   if (fClingPending.load(std::memory_order_acquire)) CompilePendingFormula();
+   if (!fReadyToExecute || !fClingInitialized.load(std::memory_order_acquire) || TestBit(TFormula::kLambda) || fNpar <= 0) return false;
+   if (!fGradPrepared) PrepareGradientMethod();
+   return fGradFuncPtr != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the gradient of the formula with respect to the parameters at the
+/// point x. The result array must have at least GetNpar() elements.
+/// If params is null the current parameter values are used.
+/// The gradient is computed with the code generated by GenerateGradientPar.
+
+void TFormula::GradientPar(const Double_t *x, Double_t *result, const Double_t *params)
+{
+   if (!GenerateGradientPar()) {
+      Error("GradientPar", "The gradient of the formula %s with respect to the parameters is not available",
+            GetExpFormula().Data());
+      return;
+   }
+   double *vars = (x) ? const_cast<double *>(x) : fClingVariables.data();
+   double *pars = (params) ? const_cast<double *>(params) : fClingParameters.data();
+   double *grad = result;
+   void *args[3] = {&vars, &pars, &grad};
+   (*fGradFuncPtr)(0, 3, args, nullptr);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets first 4  variables (e.g. x, y, z, t) and evaluate formula.
 
@@ -3005,8 +3960,10 @@ Double_t TFormula::DoEval(const double * x, const double * params) const
       double * p = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
       return fptr(v, p);
    }
+   if (fClingPending.load(std::memory_order_acquire) && !const_cast<TFormula *>(this)->CompilePendingFormula())
+      return TMath::QuietNaN();
    // this is needed when reading from a file
-   if (!fClingInitialized) {
+   if (!fClingInitialized.load(std::memory_order_acquire)) {
       Error("Eval","Formula is invalid or not properly initialized - try calling TFormula::Compile");
       return TMath::QuietNaN();
 #ifdef EVAL_IS_NOT_CONST
@@ -3020,14 +3977,15 @@ Double_t TFormula::DoEval(const double * x, const double * params) const
 
    Double_t result = 0;
    void* args[2];
+   auto funcPtr = fFuncPtr.load(std::memory_order_acquire);
    double * vars = (x) ? const_cast<double*>(x) : const_cast<double*>(fClingVariables.data());
    args[0] = &vars;
    if (fNpar <= 0)
-      (*fFuncPtr)(0, 1, args, &result);
+      (*funcPtr)(0, 1, args, &result);
    else {
       double * pars = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
       args[1] = &pars;
-      (*fFuncPtr)(0, 2, args, &result);
+      (*funcPtr)(0, 2, args, &result);
    }
    return result;
 }
@@ -25,6 +25,7 @@
 #include "TSystem.h"
 #include <stdlib.h>
 #include <cassert>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -1166,22 +1167,26 @@ TH2D *TGraph2D::GetHistogram(Option_t *option)
    Double_t dx = (hxmax - hxmin) / fNpx;
    Double_t dy = (hymax - hymin) / fNpy;
 
-   Double_t x, y, z;
-
+   // bin centres, in the order the histogram is filled
+   const Int_t ncells = fNpx * fNpy;
+   std::vector<Double_t> x(ncells), y(ncells), z(ncells);
    for (Int_t ix = 1; ix <= fNpx; ix++) {
-      x  = hxmin + (ix - 0.5) * dx;
       for (Int_t iy = 1; iy <= fNpy; iy++) {
-         y  = hymin + (iy - 0.5) * dy;
-         // do interpolation
-         if (oldInterp)
-            z  = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x, y);
-         else
-            z  = ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(x, y);
-
-         fHistogram->Fill(x, y, z);
+         Int_t k = (ix - 1) * fNpy + (iy - 1);
+         x[k] = hxmin + (ix - 0.5) * dx;
+         y[k] = hymin + (iy - 0.5) * dy;
       }
    }
 
+   // do interpolation
+   if (oldInterp) {
+      for (Int_t k = 0; k < ncells; k++) z[k] = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x[k], y[k]);
+   } else {
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(ncells, x.data(), y.data(), z.data());
+   }
+
+   for (Int_t k = 0; k < ncells; k++) fHistogram->Fill(x[k], y[k], z[k]);
+
 
    if (fMinimum != -1111) fHistogram->SetMinimum(fMinimum);
    if (fMaximum != -1111) fHistogram->SetMaximum(fMaximum);
@@ -1293,6 +1298,34 @@ Double_t TGraph2D::Interpolate(Double_t x, Double_t y)
    return TMath::QuietNaN();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Finds the z values z[i] of the n points (x[i], y[i]), as Interpolate(x,y).
+///
+/// The Delaunay triangles are found once. With the default interpolation
+/// (TGraphDelaunay2D) the triangle containing each point is located with
+/// a grid index over the triangles and, if implicit multi-threading is
+/// enabled (ROOT::EnableImplicitMT()), the points are interpolated in
+/// parallel.
+
+void TGraph2D::Interpolate(Int_t n, const Double_t *x, const Double_t *y, Double_t *z)
+{
+   if (n <= 0) return;
+   if (fNpoints <= 0) {
+      Error("Interpolate", "Empty TGraph2D");
+      for (Int_t i = 0; i < n; i++) z[i] = 0;
+      return;
+   }
+
+   // make sure fDelaunay is set
+   Interpolate(x[0], y[0]);
+
+   if (fDelaunay && fDelaunay->IsA() == TGraphDelaunay2D::Class()) {
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(n, x, y, z);
+   } else {
+      for (Int_t i = 0; i < n; i++) z[i] = Interpolate(x[i], y[i]);
+   }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Paints this 2D graph with its current attributes
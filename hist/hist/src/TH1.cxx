@@ -3249,6 +3249,10 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// If the axis cannot be extended, the bin numbers are computed by blocks
+/// with TAxis::FindFixBins and the statistics are accumulated without
+/// branching on the underflow/overflow bins.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3257,6 +3261,45 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+
+   if (!fXaxis.CanExtend()) {
+      // must be called before AddBinContent, see TH1::Fill
+      if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<ntimes;i++) {
+            if (w[i*stride] != 1.0) { Sumw2(); break; }
+         }
+      }
+      const Int_t kBlock = 256;
+      Int_t bins[kBlock];
+      Double_t tsumw = 0, tsumw2 = 0, tsumwx = 0, tsumwx2 = 0;
+      for (Int_t first=0;first<ntimes;first+=kBlock) {
+         Int_t n = TMath::Min(kBlock, ntimes-first);
+         const Double_t *xb = x + first*stride;
+         const Double_t *wb = w ? w + first*stride : 0;
+         fXaxis.FindFixBins(n, xb, bins, stride);
+         for (i=0;i<n;i++) {
+            bin = bins[i];
+            if (wb) ww = wb[i*stride];
+            if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+            AddBinContent(bin, ww);
+            // the underflow/overflow entries (possibly infinite or NaN)
+            // are accounted in the statistics with a zero weight
+            Bool_t inRange = fgStatOverflows || (bin > 0 && bin <= nbins);
+            Double_t z = inRange ? ww : 0.;
+            Double_t xi = inRange ? xb[i*stride] : 0.;
+            tsumw   += z;
+            tsumw2  += z*z;
+            tsumwx  += z*xi;
+            tsumwx2 += z*xi*xi;
+         }
+      }
+      fTsumw   += tsumw;
+      fTsumw2  += tsumw2;
+      fTsumwx  += tsumwx;
+      fTsumwx2 += tsumwx2;
+      return;
+   }
+
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       bin =fXaxis.FindBin(x[i]);
@@ -4052,6 +4095,15 @@ Bool_t TH1::GetDefaultSumw2()
    return fgDefaultSumw2;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if the underflows/overflows are used in the statistics.
+/// see TH1::StatOverflows.
+
+Bool_t TH1::GetStatOverflows()
+{
+   return fgStatOverflows;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the current number of entries.
 
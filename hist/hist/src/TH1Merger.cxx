@@ -8,7 +8,14 @@
 #include "TError.h"
 #include "THashList.h"
 #include "TClass.h"
+#include "TMath.h"
+#include "TROOT.h"
 #include <iostream>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 
 Bool_t TH1Merger::AxesHaveLimits(const TH1 * h) {
@@ -418,7 +425,9 @@ Bool_t TH1Merger::SameAxesMerge() {
    }
    fH0->GetStats(totstats);
    Double_t nentries = fH0->GetEntries();
-   
+
+   // histograms to be merged: skip the empty ones
+   std::vector<const TH1*> hists;
    TIter next(&fInputList); 
    while (TH1* hist=(TH1*)next()) {
       // process only if the histogram has limits; otherwise it was processed before
@@ -435,18 +444,35 @@ Bool_t TH1Merger::SameAxesMerge() {
       for (Int_t i=0; i<TH1::kNstat; i++)
          totstats[i] += stats[i];
       nentries += hist->GetEntries();
+      hists.push_back(hist);
+   }
 
+   // For double precision histograms the bin arrays are added directly,
+   // in parallel by blocks of histograms when implicit MT is enabled.
+   TArrayD *content0 = dynamic_cast<TArrayD*>(fH0);
+   if (content0 && content0->fN == fH0->fNcells) {
+      Double_t *sumw2 = fH0->fSumw2.fN ? fH0->fSumw2.fArray : nullptr;
+#ifdef R__USE_IMT
+      if (!ParallelSameAxesMerge(hists, content0->fArray, sumw2))
+#endif
+      {
+         for (auto hist : hists)
+            AddCells(hist, content0->fArray, sumw2);
+      }
+   } else {
+      for (auto hist : hists) {
          //Int_t nx = hist->GetXaxis()->GetNbins();
          // loop on bins of the histogram and do the merge
-      for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
+         for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
 
-         Double_t cu = hist->RetrieveBinContent(ibin);
-         Double_t e1sq = TMath::Abs(cu);
-         if (fH0->fSumw2.fN) e1sq= hist->GetBinErrorSqUnchecked(ibin);
+            Double_t cu = hist->RetrieveBinContent(ibin);
+            Double_t e1sq = TMath::Abs(cu);
+            if (fH0->fSumw2.fN) e1sq= hist->GetBinErrorSqUnchecked(ibin);
 
-         fH0->AddBinContent(ibin,cu);
-         if (fH0->fSumw2.fN) fH0->fSumw2.fArray[ibin] += e1sq;
+            fH0->AddBinContent(ibin,cu);
+            if (fH0->fSumw2.fN) fH0->fSumw2.fArray[ibin] += e1sq;
 
+         }
       }
    }
    //copy merged stats
@@ -456,6 +482,67 @@ Bool_t TH1Merger::SameAxesMerge() {
    return kTRUE;
 }
 
+/**
+   Add the bin contents of hist to content and, if sumw2 is not null, its
+   sum of squares of weights to sumw2 (the content if it has no Sumw2).
+   The loops are on contiguous arrays when hist stores doubles, so that
+   they can be vectorized by the compiler.
+ */
+void TH1Merger::AddCells(const TH1 *hist, Double_t *content, Double_t *sumw2) {
+   const Int_t ncells = hist->fNcells;
+   const TArrayD *histContent = dynamic_cast<const TArrayD*>(hist);
+   if (histContent && histContent->fN == ncells) {
+      const Double_t *src = histContent->fArray;
+      for (Int_t ibin = 0; ibin < ncells; ibin++) content[ibin] += src[ibin];
+      if (sumw2 && !hist->fSumw2.fN)
+         for (Int_t ibin = 0; ibin < ncells; ibin++) sumw2[ibin] += src[ibin];
+   } else {
+      for (Int_t ibin = 0; ibin < ncells; ibin++) content[ibin] += hist->RetrieveBinContent(ibin);
+      if (sumw2 && !hist->fSumw2.fN)
+         for (Int_t ibin = 0; ibin < ncells; ibin++) sumw2[ibin] += hist->RetrieveBinContent(ibin);
+   }
+   if (sumw2 && hist->fSumw2.fN) {
+      const Double_t *src = hist->fSumw2.fArray;
+      for (Int_t ibin = 0; ibin < ncells; ibin++) sumw2[ibin] += src[ibin];
+   }
+}
+
+#ifdef R__USE_IMT
+/**
+   Merge the histograms with the same axes in parallel: the list is split in
+   blocks which are summed into separate arrays by the threads of the
+   implicit MT pool, and the partial sums are then added to the output.
+   Returns false (and does nothing) if implicit MT is disabled or if the
+   merge is too small to benefit from it.
+ */
+Bool_t TH1Merger::ParallelSameAxesMerge(const std::vector<const TH1*> &hists, Double_t *content, Double_t *sumw2) {
+   if (!ROOT::IsImplicitMTEnabled()) return kFALSE;
+   const UInt_t nhists = hists.size();
+   const Int_t ncells = fH0->fNcells;
+   // below about a million bins to add the overhead of the tasks dominates
+   if (nhists < 4 || Double_t(nhists) * ncells < 1.e6) return kFALSE;
+
+   const UInt_t nblocks = TMath::Min(nhists / 2, TMath::Max(1U, ROOT::GetImplicitMTPoolSize()));
+   const Int_t width = sumw2 ? 2 * ncells : ncells;
+   auto mergeBlock = [&](UInt_t iblock) {
+      std::vector<Double_t> partial(width, 0.);
+      Double_t *partialSumw2 = sumw2 ? partial.data() + ncells : nullptr;
+      for (UInt_t i = iblock * nhists / nblocks; i < (iblock + 1) * nhists / nblocks; ++i)
+         AddCells(hists[i], partial.data(), partialSumw2);
+      return partial;
+   };
+   ROOT::TThreadExecutor pool;
+   auto partials = pool.Map(mergeBlock, ROOT::TSeqU(nblocks));
+   for (const auto &partial : partials) {
+      const Double_t *src = partial.data();
+      for (Int_t ibin = 0; ibin < ncells; ibin++) content[ibin] += src[ibin];
+      if (sumw2)
+         for (Int_t ibin = 0; ibin < ncells; ibin++) sumw2[ibin] += src[ncells + ibin];
+   }
+   return kTRUE;
+}
+#endif
+
 
 /**
    Merged histogram when axis can be different. 
@@ -14,6 +14,8 @@
 #include "TH1.h"
 #include "TList.h"
 
+#include <vector>
+
 class TH1Merger {
 
 public: 
@@ -75,6 +77,12 @@ private:
 
    Bool_t SameAxesMerge();
 
+   static void AddCells(const TH1 *hist, Double_t *content, Double_t *sumw2);
+
+#ifdef R__USE_IMT
+   Bool_t ParallelSameAxesMerge(const std::vector<const TH1*> &hists, Double_t *content, Double_t *sumw2);
+#endif
+
    Bool_t DifferentAxesMerge();
 
    Bool_t LabelMerge();
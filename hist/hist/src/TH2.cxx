@@ -527,6 +527,8 @@ Int_t TH2::Fill(Double_t x, const char *namey, Double_t w)
 ///     weights is automatically triggered and the sum of the squares of weights is incremented
 ///     by w[i]^2 in the bin corresponding to x[i],y[i].
 ///   - If w is NULL each entry is assumed a weight=1
+///   - If the axes cannot be extended, the bin numbers are computed by blocks
+///     of entries (see TAxis::FindFixBins)
 ///
 /// NB: function only valid for a TH2x object
 
@@ -552,6 +554,10 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    }
 
    Double_t ww = 1;
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      DoFillNFixed((ntimes-ifirst)/stride, x+ifirst, y+ifirst, w ? w+ifirst : 0, stride);
+      return;
+   }
    for (i=ifirst;i<ntimes;i+=stride) {
       fEntries++;
       binx = fXaxis.FindBin(x[i]);
@@ -580,6 +586,63 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Internal method of FillN for axes that cannot be extended: the bin
+/// numbers are computed by blocks with TAxis::FindFixBins and the statistics
+/// are accumulated without branching on the underflow/overflow bins.
+
+void TH2::DoFillNFixed(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   fEntries += ntimes;
+   // must be called before AddBinContent, see TH2::Fill
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+   const Int_t nbinsx = fXaxis.GetNbins();
+   const Int_t nbinsy = fYaxis.GetNbins();
+   const Int_t kBlock = 256;
+   Int_t binx[kBlock], biny[kBlock];
+   Double_t ww = 1;
+   Double_t tsumw = 0, tsumw2 = 0, tsumwx = 0, tsumwx2 = 0, tsumwy = 0, tsumwy2 = 0, tsumwxy = 0;
+   for (Int_t first=0;first<ntimes;first+=kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes-first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xb, binx, stride);
+      fYaxis.FindFixBins(n, yb, biny, stride);
+      for (i=0;i<n;i++) {
+         Int_t bin = biny[i]*(nbinsx+2) + binx[i];
+         if (wb) ww = wb[i*stride];
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         // the underflow/overflow entries (possibly infinite or NaN)
+         // are accounted in the statistics with a zero weight
+         Bool_t inRange = fgStatOverflows || (binx[i] > 0 && binx[i] <= nbinsx && biny[i] > 0 && biny[i] <= nbinsy);
+         Double_t z  = inRange ? ww : 0.;
+         Double_t xi = inRange ? xb[i*stride] : 0.;
+         Double_t yi = inRange ? yb[i*stride] : 0.;
+         tsumw   += z;
+         tsumw2  += z*z;
+         tsumwx  += z*xi;
+         tsumwx2 += z*xi*xi;
+         tsumwy  += z*yi;
+         tsumwy2 += z*yi*yi;
+         tsumwxy += z*xi*yi;
+      }
+   }
+   fTsumw   += tsumw;
+   fTsumw2  += tsumw2;
+   fTsumwx  += tsumwx;
+   fTsumwx2 += tsumwx2;
+   fTsumwy  += tsumwy;
+   fTsumwy2 += tsumwy2;
+   fTsumwxy += tsumwxy;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
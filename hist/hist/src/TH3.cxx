@@ -376,6 +376,121 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///   - If the axes cannot be extended, the bin numbers are computed by blocks
+///     of entries (see TAxis::FindFixBins) and the statistics are accumulated
+///     without branching on the underflow/overflow bins.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i++) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         Int_t k = i*stride;
+         BufferFill(x[k],y[k],z[k],w ? w[k] : 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   if (fXaxis.CanExtend() || fYaxis.CanExtend() || fZaxis.CanExtend()) {
+      for (i=ifirst;i<ntimes;i++) {
+         Int_t k = i*stride;
+         Fill(x[k],y[k],z[k],w ? w[k] : 1.);
+      }
+      return;
+   }
+
+   x += ifirst*stride;
+   y += ifirst*stride;
+   z += ifirst*stride;
+   if (w) w += ifirst*stride;
+   ntimes -= ifirst;
+
+   fEntries += ntimes;
+   // must be called before AddBinContent, see TH3::Fill
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+   const Int_t nbinsx = fXaxis.GetNbins();
+   const Int_t nbinsy = fYaxis.GetNbins();
+   const Int_t nbinsz = fZaxis.GetNbins();
+   const Int_t kBlock = 256;
+   Int_t binx[kBlock], biny[kBlock], binz[kBlock];
+   Double_t ww = 1;
+   Double_t tsumw = 0, tsumw2 = 0, tsumwx = 0, tsumwx2 = 0, tsumwy = 0, tsumwy2 = 0, tsumwxy = 0;
+   Double_t tsumwz = 0, tsumwz2 = 0, tsumwxz = 0, tsumwyz = 0;
+   for (Int_t first=0;first<ntimes;first+=kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes-first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *zb = z + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xb, binx, stride);
+      fYaxis.FindFixBins(n, yb, biny, stride);
+      fZaxis.FindFixBins(n, zb, binz, stride);
+      for (i=0;i<n;i++) {
+         Int_t bin = binx[i] + (nbinsx+2)*(biny[i] + (nbinsy+2)*binz[i]);
+         if (wb) ww = wb[i*stride];
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         // the underflow/overflow entries (possibly infinite or NaN)
+         // are accounted in the statistics with a zero weight
+         Bool_t inRange = fgStatOverflows || (binx[i] > 0 && binx[i] <= nbinsx &&
+                                              biny[i] > 0 && biny[i] <= nbinsy &&
+                                              binz[i] > 0 && binz[i] <= nbinsz);
+         Double_t u  = inRange ? ww : 0.;
+         Double_t xi = inRange ? xb[i*stride] : 0.;
+         Double_t yi = inRange ? yb[i*stride] : 0.;
+         Double_t zi = inRange ? zb[i*stride] : 0.;
+         tsumw   += u;
+         tsumw2  += u*u;
+         tsumwx  += u*xi;
+         tsumwx2 += u*xi*xi;
+         tsumwy  += u*yi;
+         tsumwy2 += u*yi*yi;
+         tsumwxy += u*xi*yi;
+         tsumwz  += u*zi;
+         tsumwz2 += u*zi*zi;
+         tsumwxz += u*xi*zi;
+         tsumwyz += u*yi*zi;
+      }
+   }
+   fTsumw   += tsumw;
+   fTsumw2  += tsumw2;
+   fTsumwx  += tsumwx;
+   fTsumwx2 += tsumwx2;
+   fTsumwy  += tsumwy;
+   fTsumwy2 += tsumwy2;
+   fTsumwxy += tsumwxy;
+   fTsumwz  += tsumwz;
+   fTsumwz2 += tsumwz2;
+   fTsumwxz += tsumwxz;
+   fTsumwyz += tsumwyz;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
 ///
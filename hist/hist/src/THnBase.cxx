@@ -24,6 +24,7 @@
 #include "THnSparse.h"
 #include "TMath.h"
 #include "TRandom.h"
+#include "TROOT.h"
 #include "TVirtualPad.h"
 
 #include "HFitInterface.h"
@@ -32,6 +33,13 @@
 #include "Math/MinimizerOptions.h"
 #include "Math/WrappedMultiTF1.h"
 
+#include <memory>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 
 /** \class THnBase
     \ingroup Hist
@@ -324,6 +332,20 @@ THnBase* THnBase::CreateHnAny(const char* name, const char* title,
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the n points stored in x, each of them consisting
+/// of GetNdimensions() consecutive coordinates, i.e. point i starts at
+/// x[i * GetNdimensions()]. The weight of point i is w[i], or 1 if w is NULL.
+/// Equivalent to calling Fill() for each point; derived classes can
+/// implement it more efficiently.
+
+void THnBase::FillN(Int_t n, const Double_t *x, const Double_t *w /*= 0*/)
+{
+   for (Int_t i = 0; i < n; ++i)
+      Fill(x + (Long64_t)i * fNdimensions, w ? w[i] : 1.);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill the THnBase with the bins of hist that have content
 /// or error != 0.
@@ -520,61 +542,51 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    Bool_t haveErrors = GetCalculateErrors();
    Bool_t wantErrors = haveErrors || (option && (strchr(option, 'E') || strchr(option, 'e')));
 
-   Int_t* bins  = new Int_t[ndim];
-   Long64_t myLinBin = 0;
+   Bool_t haveSkippedBin = kFALSE;
+   if (wantNDim) {
+      Int_t* bins  = new Int_t[ndim];
+      Long64_t myLinBin = 0;
 
-   THnIter iter(this, kTRUE /*use axis range*/);
+      THnIter iter(this, kTRUE /*use axis range*/);
 
-   while ((myLinBin = iter.Next()) >= 0) {
-      Double_t v = GetBinContent(myLinBin);
+      while ((myLinBin = iter.Next()) >= 0) {
+         Double_t v = GetBinContent(myLinBin);
 
-      for (Int_t d = 0; d < ndim; ++d) {
-         bins[d] = iter.GetCoord(dim[d]);
-         if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
-            Int_t binOffset = GetAxis(dim[d])->GetFirst();
-            // Don't subtract even more if underflow is alreday included:
-            if (binOffset > 0) --binOffset;
-            bins[d] -= binOffset;
+         for (Int_t d = 0; d < ndim; ++d) {
+            bins[d] = iter.GetCoord(dim[d]);
+            if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+               Int_t binOffset = GetAxis(dim[d])->GetFirst();
+               // Don't subtract even more if underflow is alreday included:
+               if (binOffset > 0) --binOffset;
+               bins[d] -= binOffset;
+            }
          }
-      }
 
-      Long64_t targetLinBin = -1;
-      if (!wantNDim) {
-         if (ndim == 1) targetLinBin = bins[0];
-         else if (ndim == 2) targetLinBin = hist->GetBin(bins[0], bins[1]);
-         else if (ndim == 3) targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
-      } else {
-         targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
-      }
+         Long64_t targetLinBin = hn->GetBin(bins, kTRUE /*allocate*/);
 
-      if (wantErrors) {
-         Double_t err2 = 0.;
-         if (haveErrors) {
-            err2 = GetBinError2(myLinBin);
-         } else {
-            err2 = v;
-         }
-         if (wantNDim) {
+         if (wantErrors) {
+            Double_t err2 = 0.;
+            if (haveErrors) {
+               err2 = GetBinError2(myLinBin);
+            } else {
+               err2 = v;
+            }
             hn->AddBinError2(targetLinBin, err2);
-         } else {
-            Double_t preverr = hist->GetBinError(targetLinBin);
-            hist->SetBinError(targetLinBin, TMath::Sqrt(preverr * preverr + err2));
          }
-      }
 
-      // only _after_ error calculation, or sqrt(v) is taken into account!
-      if (wantNDim)
+         // only _after_ error calculation, or sqrt(v) is taken into account!
          hn->AddBinContent(targetLinBin, v);
-      else
-         hist->AddBinContent(targetLinBin, v);
-   }
+      }
 
-   delete [] bins;
+      delete [] bins;
+   } else {
+      haveSkippedBin = FillProjection(hist, ndim, dim, keepTargetAxis, wantErrors);
+   }
 
    if (wantNDim) {
       hn->SetEntries(fEntries);
    } else {
-      if (!iter.HaveSkippedBin()) {
+      if (!haveSkippedBin) {
          hist->SetEntries(fEntries);
       } else {
          // re-compute the entries
@@ -602,6 +614,48 @@ TObject* THnBase::ProjectionAny(Int_t ndim, const Int_t* dim,
    return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the content of all bins within the axis ranges to the 1, 2 or 3
+/// dimensional histogram "hist", keeping only the axes in dim. Errors are
+/// propagated if "wantErrors"; they are accumulated directly in hist's sum
+/// of squares of weights instead of going through TH1::SetBinError() for
+/// each bin.
+/// Return whether bins were skipped because they were outside the axis ranges.
+
+Bool_t THnBase::FillProjection(TH1* hist, Int_t ndim, const Int_t* dim,
+                               Bool_t keepTargetAxis, Bool_t wantErrors) const
+{
+   const Bool_t haveErrors = GetCalculateErrors();
+   Int_t bins[3] = {0, 0, 0};
+   Int_t binOffset[3] = {0, 0, 0};
+   for (Int_t d = 0; d < ndim; ++d) {
+      if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+         binOffset[d] = GetAxis(dim[d])->GetFirst();
+         // Don't subtract even more if underflow is alreday included:
+         if (binOffset[d] > 0) --binOffset[d];
+      }
+   }
+
+   Long64_t myLinBin = 0;
+   THnIter iter(this, kTRUE /*use axis range*/);
+
+   while ((myLinBin = iter.Next()) >= 0) {
+      Double_t v = GetBinContent(myLinBin);
+
+      for (Int_t d = 0; d < ndim; ++d)
+         bins[d] = iter.GetCoord(dim[d]) - binOffset[d];
+      Int_t targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
+
+      if (wantErrors) {
+         if (!hist->GetSumw2N()) hist->Sumw2();
+         hist->GetSumw2()->fArray[targetLinBin] += haveErrors ? GetBinError2(myLinBin) : v;
+      }
+      hist->AddBinContent(targetLinBin, v);
+   }
+
+   return iter.HaveSkippedBin();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Scale contents and errors of this histogram by c:
 /// this = this * c
@@ -717,6 +771,10 @@ void THnBase::RebinnedAdd(const THnBase* h, Double_t c)
 ////////////////////////////////////////////////////////////////////////////////
 /// Merge this with a list of THnBase's. All THnBase's provided
 /// in the list must have the same bin layout!
+///
+/// If implicit multi-threading is enabled and the list is large, the list
+/// is split in blocks which are merged in parallel into empty copies of
+/// this histogram; these partial sums are then added to this.
 
 Long64_t THnBase::Merge(TCollection* list)
 {
@@ -724,25 +782,48 @@ Long64_t THnBase::Merge(TCollection* list)
    if (list->IsEmpty()) return (Long64_t)GetEntries();
 
    Long64_t sumNbins = GetNbins();
+   std::vector<const THnBase*> hists;
    TIter iter(list);
    const TObject* addMeObj = 0;
    while ((addMeObj = iter())) {
       const THnBase* addMe = dynamic_cast<const THnBase*>(addMeObj);
-      if (addMe) {
+      if (!addMe) {
+         Error("Merge", "Object named %s is not THnBase! Skipping it.",
+               addMeObj->GetName());
+      } else {
          sumNbins += addMe->GetNbins();
+         hists.push_back(addMe);
       }
    }
    Reserve(sumNbins);
 
-   iter.Reset();
-   while ((addMeObj = iter())) {
-      const THnBase* addMe = dynamic_cast<const THnBase*>(addMeObj);
-      if (!addMe)
-         Error("Merge", "Object named %s is not THnBase! Skipping it.",
-               addMeObj->GetName());
-      else
-         Add(addMe);
+#ifdef R__USE_IMT
+   const UInt_t nhists = hists.size();
+   if (ROOT::IsImplicitMTEnabled() && nhists >= 4 && sumNbins >= 100000) {
+      const UInt_t nblocks = TMath::Min(nhists / 2, TMath::Max(1U, ROOT::GetImplicitMTPoolSize()));
+      // The partial histograms are created here, not in the tasks.
+      std::vector<std::unique_ptr<THnBase>> partials;
+      for (UInt_t iblock = 0; iblock < nblocks; ++iblock) {
+         partials.emplace_back(CloneEmpty(GetName(), GetTitle(), &fAxes, kTRUE));
+         Long64_t nbins = 0;
+         for (UInt_t i = iblock * nhists / nblocks; i < (iblock + 1) * nhists / nblocks; ++i)
+            nbins += hists[i]->GetNbins();
+         partials.back()->Reserve(nbins);
+      }
+      auto mergeBlock = [&](UInt_t iblock) {
+         for (UInt_t i = iblock * nhists / nblocks; i < (iblock + 1) * nhists / nblocks; ++i)
+            partials[iblock]->Add(hists[i]);
+      };
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(mergeBlock, ROOT::TSeqU(nblocks));
+      for (const auto &partial : partials)
+         Add(partial.get());
+      return (Long64_t)GetEntries();
    }
+#endif
+
+   for (auto addMe : hists)
+      Add(addMe);
    return (Long64_t)GetEntries();
 }
 
@@ -16,6 +16,10 @@
 #include "TClass.h"
 #include "TDataMember.h"
 #include "TDataType.h"
+#include "TH1.h"
+#include "TMathBase.h"
+
+#include <cstring>
 
 namespace {
 //______________________________________________________________________________
@@ -571,14 +575,18 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the transient member fBins,
+an open addressing hash table of (hash, linear index + 1) pairs with linear
+probing. Its size is a power of two, kept at least twice the number of filled
+bins. The slot is determined by a mix of all bits of the hash; the table is
+probed until an empty slot or an entry with the same hash is found. For the
+latter, the coordinates of the entry are compared to the coordinates passed
+to GetBin() if the compact bin coordinates are larger than 8 bytes: these two
+coordinates can have the same hash, which is extremely unlikely but possible.
+The probing then continues until the matching bin is found.
+
+Many points can be filled at once with FillN(), which looks up the bins
+of a block of points axis by axis before filling them.
 */
 
 
@@ -650,37 +658,74 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
    fCompactCoord = new THnSparseCompactBinCoord(fNdimensions, nbins);
 }
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Mix all bits of the hash of a bin, such that the slots in the bin
+   /// index are well distributed even if the hash is the compact coordinate
+   /// itself (where only the lowest bits change between neighboring bins).
+
+   inline ULong64_t MixBinHash(ULong64_t hash)
+   {
+      hash ^= hash >> 33;
+      hash *= 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 33;
+      hash *= 0xc4ceb9fe1a85ec53ULL;
+      hash ^= hash >> 33;
+      return hash;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bin with linear index idx and the given hash to the bin index.
+/// The bin must not be in the index yet, and the index must have an empty slot.
+
+void THnSparse::AddBinIndex(ULong64_t hash, Long64_t idx)
+{
+   const ULong64_t mask = fBins.size() - 1;
+   ULong64_t slot = MixBinHash(hash) & mask;
+   while (fBins[slot].second)
+      slot = (slot + 1) & mask;
+   fBins[slot].first = hash;
+   fBins[slot].second = idx + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Grow the bin index such that it can hold at least nbins bins while
+/// staying at most half full; re-insert the bins already indexed.
+
+void THnSparse::ExpandBinIndex(Long64_t nbins)
+{
+   size_t size = 16;
+   while ((Long64_t)size < 2 * nbins)
+      size *= 2;
+   if (size <= fBins.size())
+      return;
+
+   std::vector<std::pair<ULong64_t, Long64_t> > oldBins(size, std::make_pair(0ULL, 0LL));
+   oldBins.swap(fBins);
+   for (size_t i = 0, n = oldBins.size(); i < n; ++i)
+      if (oldBins[i].second)
+         AddBinIndex(oldBins[i].first, oldBins[i].second - 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///We have been streamed; set up fBins
 
-void THnSparse::FillExMap()
+void THnSparse::FillBinIndex()
 {
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   fBins.clear();
+   ExpandBinIndex(GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
-      }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         AddBinIndex(compactCoord.GetHashFromBuffer(buf), idx);
    }
 }
 
@@ -688,12 +733,10 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
-   }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   if (fBins.empty()) {
+      FillBinIndex();
    }
+   ExpandBinIndex(nbins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -737,6 +780,49 @@ Long64_t THnSparse::GetBin(const Int_t* coord, Bool_t allocate /*= kTRUE*/)
    return GetBinIndexForCurrentBin(allocate);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the n points stored in x, each of them consisting
+/// of GetNdimensions() consecutive coordinates; the weight of point i is w[i],
+/// or 1 if w is NULL. See THnBase::FillN().
+///
+/// The points are processed in blocks: the bin coordinates of all points of
+/// a block are determined axis by axis (see TAxis::FindFixBins()), before
+/// the filled bins are looked up and incremented. The bin index is grown
+/// once per block instead of while filling.
+
+void THnSparse::FillN(Int_t n, const Double_t *x, const Double_t *w /*= 0*/)
+{
+   for (Int_t d = 0; d < fNdimensions; ++d) {
+      if (GetAxis(d)->GetParent()) {
+         // Axes that might be extended need the full TAxis::FindBin().
+         THnBase::FillN(n, x, w);
+         return;
+      }
+   }
+
+   const Int_t kBlockSize = 256;
+   std::vector<Int_t> blockBins((size_t)kBlockSize * fNdimensions);
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   Int_t *coord = cc->GetCoord();
+
+   for (Int_t first = 0; first < n; first += kBlockSize) {
+      const Int_t nblock = TMath::Min(kBlockSize, n - first);
+      const Double_t* xblock = x + (Long64_t)first * fNdimensions;
+      for (Int_t d = 0; d < fNdimensions; ++d)
+         GetAxis(d)->FindFixBins(nblock, xblock + d, &blockBins[d * kBlockSize], fNdimensions);
+
+      Reserve(GetNbins() + nblock);
+      for (Int_t i = 0; i < nblock; ++i) {
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xblock + (Long64_t)i * fNdimensions, wi);
+         for (Int_t d = 0; d < fNdimensions; ++d)
+            coord[d] = blockBins[d * kBlockSize + i];
+         cc->UpdateCoord();
+         FillBin(GetBinIndexForCurrentBin(kTRUE), wi);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the content of the filled bin number "idx".
 /// If coord is non-null, it will contain the bin's coordinates for each axis
@@ -791,19 +877,24 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
    ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
+   if (fBins.empty())
+      FillBinIndex();
+   const ULong64_t mask = fBins.size() - 1;
+   ULong64_t slot = MixBinHash(hash) & mask;
+   // Coordinates of up to 8 bytes are their own hash (see
+   // THnSparseCompactBinCoord::GetHash()): a matching hash is a matching bin,
+   // and the chunk's coordinate buffer need not be touched.
+   const Bool_t perfectHash = cc->GetBufferSize() <= 8;
+   while (Long64_t linidx = fBins[slot].second) {
       // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
-
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
-
-      linidx = nextlinidx;
+      if (fBins[slot].first == hash) {
+         if (perfectHash)
+            return linidx - 1;
+         THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
+         if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
+            return linidx - 1; // we store idx+1, 0 is "empty slot"
+      }
+      slot = (slot + 1) & mask;
    }
    if (!allocate) return -1;
 
@@ -820,19 +911,98 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 
    // store translation between hash and bin
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
+   if (2 * GetNbins() > (Long64_t)fBins.size()) {
+      ExpandBinIndex(GetNbins());
+      AddBinIndex(hash, newidx);
    } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
+      // slot is the empty slot that ended the probing above
+      fBins[slot].first = hash;
+      fBins[slot].second = newidx + 1;
    }
    return newidx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the content of all filled bins within the axis ranges to the 1, 2 or
+/// 3 dimensional histogram "hist", keeping only the axes in dim; see
+/// THnBase::FillProjection().
+///
+/// Instead of going through a bin iterator and the per-bin accessors this
+/// walks the chunks directly, decoding the compact coordinates and reading
+/// content and errors from the chunk arrays. Chunks without bins are skipped.
+
+Bool_t THnSparse::FillProjection(TH1* hist, Int_t ndim, const Int_t* dim,
+                                 Bool_t keepTargetAxis, Bool_t wantErrors) const
+{
+   const Bool_t haveErrors = GetCalculateErrors();
+   Int_t bins[3] = {0, 0, 0};
+   Int_t binOffset[3] = {0, 0, 0};
+   for (Int_t d = 0; d < ndim; ++d) {
+      if (!keepTargetAxis && GetAxis(dim[d])->TestBit(TAxis::kAxisRange)) {
+         binOffset[d] = GetAxis(dim[d])->GetFirst();
+         // Don't subtract even more if underflow is alreday included:
+         if (binOffset[d] > 0) --binOffset[d];
+      }
+   }
+
+   // Only the axes with a range need to be checked for each bin.
+   std::vector<Int_t> rangeDim;
+   std::vector<Int_t> rangeFirst;
+   std::vector<Int_t> rangeLast;
+   for (Int_t d = 0; d < fNdimensions; ++d) {
+      TAxis *axis = GetAxis(d);
+      if (!axis->TestBit(TAxis::kAxisRange)) continue;
+      rangeDim.push_back(d);
+      rangeFirst.push_back(axis->GetFirst());
+      rangeLast.push_back(axis->GetLast());
+   }
+   const size_t nRange = rangeDim.size();
+
+   THnSparseCoordCompression compactCoord(*GetCompactCoord());
+   std::vector<Int_t> coord(fNdimensions);
+   Bool_t haveSkippedBin = kFALSE;
+
+   const Int_t nchunks = GetNChunks();
+   for (Int_t iChunk = 0; iChunk < nchunks; ++iChunk) {
+      const THnSparseArrayChunk* chunk = GetChunk(iChunk);
+      const Int_t nentries = chunk->GetEntries();
+      if (!nentries) continue;
+
+      const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
+      const Char_t* buf = chunk->fCoordinates;
+      for (Int_t i = 0; i < nentries; ++i, buf += singleCoordSize) {
+         compactCoord.SetCoordFromBuffer(buf, &coord[0]);
+
+         Bool_t inRange = kTRUE;
+         for (size_t r = 0; r < nRange; ++r) {
+            const Int_t c = coord[rangeDim[r]];
+            if (c < rangeFirst[r] || c > rangeLast[r]) {
+               inRange = kFALSE;
+               break;
+            }
+         }
+         if (!inRange) {
+            haveSkippedBin = kTRUE;
+            continue;
+         }
+
+         for (Int_t d = 0; d < ndim; ++d)
+            bins[d] = coord[dim[d]] - binOffset[d];
+         Int_t targetLinBin = hist->GetBin(bins[0], bins[1], bins[2]);
+
+         const Double_t v = chunk->fContent->GetAt(i);
+         if (wantErrors) {
+            if (!hist->GetSumw2N()) hist->Sumw2();
+            hist->GetSumw2()->fArray[targetLinBin]
+               += (haveErrors && chunk->fSumw2) ? chunk->fSumw2->GetAt(i) : v;
+         }
+         hist->AddBinContent(targetLinBin, v);
+      }
+   }
+
+   return haveSkippedBin;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return THnSparseCompactBinCoord object.
 
@@ -881,7 +1051,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(std::pair<ULong64_t, Long64_t>) * fBins.size() /* bin index */;
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -963,8 +1133,7 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   std::vector<std::pair<ULong64_t, Long64_t> >().swap(fBins);
    fBinContent.Delete();
    ResetBase(option);
 }
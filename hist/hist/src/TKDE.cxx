@@ -22,6 +22,16 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ The evaluation of the density can be changed with SetEvaluation(). By default (TKDE::kExact)
+ the kernels of all data points (or bins) are summed for each evaluation; if implicit
+ multithreading is enabled (ROOT::EnableImplicitMT()) the sum, or the evaluation of many
+ points with GetValues(), is split among threads. With TKDE::kFFT and the fixed iteration,
+ the data are binned linearly on a fine grid and convolved with the kernel using FFT
+ (TVirtualFFT, which needs the fftw plugin); the density is then interpolated on the grid.
+ The grid spacing is chosen from the targeted relative accuracy. User defined kernels, whose
+ support is not known, are always evaluated exactly. For the adaptive iteration
+ the FFT is only used for the pilot estimate from which the adaptive bandwidths are computed.
  */
 
 
@@ -41,8 +51,14 @@
 #include "TF1.h"
 #include "TH1.h"
 #include "TCanvas.h"
+#include "TROOT.h"
+#include "TVirtualFFT.h"
 #include "TKDE.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 
 ClassImp(TKDE);
 
@@ -50,10 +66,20 @@ class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   Double_t fGridMin;  // Position of the first point of the FFT evaluation grid
+   Double_t fGridStep; // Spacing of the FFT evaluation grid
+   std::vector<Double_t> fGridValues; // Density at the FFT evaluation grid points; empty if not used
+   Double_t Sum(Double_t x, UInt_t first, UInt_t last) const;
+   Double_t Interpolate(Double_t x) const;
+   Double_t GetSumOfCounts() const;
+   Bool_t UseImplicitMT(Double_t nKernelEvals) const;
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void ComputeGrid();
+   void ClearGrid() { fGridValues.clear(); }
    Double_t operator()(Double_t x) const;
+   void Evaluate(UInt_t n, const Double_t* x, Double_t* values) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
    const std::vector<Double_t> & GetAdaptiveWeights() const;
@@ -139,6 +165,8 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fAdaptiveBandwidthFactor = 1.;
    fRho = rho;
    fWeightSize = 0;
+   fEvaluation = kExact;
+   fAccuracy = 1.E-4;
    fCanonicalBandwidths = std::vector<Double_t>(kTotalKernels, 0.0);
    fKernelSigmas2 = std::vector<Double_t>(kTotalKernels, -1.0);
    fSettedOptions = std::vector<Bool_t>(4, kFALSE);
@@ -413,6 +441,24 @@ void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    SetKernel();
 }
 
+void TKDE::SetEvaluation(EEvaluation eval, Double_t accuracy) {
+   // Sets the evaluation of the density: exact kernel sum (kExact) or interpolation of the
+   // FFT convolution of the binned data (kFFT). "accuracy" is the targeted relative accuracy of
+   // the FFT evaluation with respect to the exact one; it determines the grid spacing, which is
+   // the bandwidth times sqrt(accuracy).
+   if (eval != kExact && eval != kFFT) {
+      Warning("SetEvaluation", "Illegal evaluation type input - use default value !");
+      eval = kExact;
+   }
+   if (!(accuracy > 0. && accuracy < 1.)) {
+      Warning("SetEvaluation", "Accuracy must be in ]0, 1[ - use default value !");
+      accuracy = 1.E-4;
+   }
+   fEvaluation = eval;
+   fAccuracy = accuracy;
+   SetKernel();
+}
+
 // private methods
 
 void TKDE::SetUseBins() {
@@ -548,8 +594,14 @@ void TKDE::SetKernel() {
    weight *= fRho * fCanonicalBandwidths[fKernelType] / fCanonicalBandwidths[kGaussian];
    if (fKernel) delete fKernel;
    fKernel = new TKernel(weight, this);
+   // With the adaptive iteration the grid serves the pilot estimate only.
+   // The support of a user defined kernel is not known: it is always evaluated exactly.
+   if (fEvaluation == kFFT && fKernelType != kUserDefined) {
+      fKernel->ComputeGrid();
+   }
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
+      fKernel->ClearGrid();
    }
 }
 
@@ -672,6 +724,14 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValues(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Returns in values[i] the kernel density estimate at x[i], for i < n.
+   // With the exact evaluation, the points are split among threads if implicit
+   // multithreading is enabled.
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   fKernel->Evaluate(n, x, values);
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -694,7 +754,9 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
+fWeights(fNWeights, weight),
+fGridMin(0.),
+fGridStep(0.)
 {}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
@@ -704,11 +766,14 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    unsigned int n = fKDE->fData.size();
    assert( n == weights.size() );
    bool useDataWeights = (fKDE->fBinCount.size() == n); 
+   // pilot estimate at all data points, from the FFT grid or (possibly multithreaded) exact
+   std::vector<Double_t> pilot(n);
+   Evaluate(n, &fKDE->fData[0], &pilot[0]);
    Double_t f = 0.0;
    for (unsigned int i = 0; i < n; ++i) { 
 //   for (; weight != weights.end(); ++weight, ++data, ++dataW) {
       if (useDataWeights && fKDE->fBinCount[i] <= 0) continue;  // skip negative or null weights
-      f = (*fKDE->fKernel)(fKDE->fData[i]);
+      f = pilot[i];
       if (f <= 0)
          fKDE->Warning("ComputeAdativeWeights","function value is zero or negative for x = %f w = %f",
                        fKDE->fData[i],(useDataWeights) ? fKDE->fBinCount[i] : 1.);
@@ -902,18 +967,14 @@ const std::vector<Double_t> & TKDE::TKernel::GetAdaptiveWeights() const {
    return fWeights;
 }
 
-Double_t TKDE::TKernel::operator()(Double_t x) const {
-   // The internal class's unary function: returns the kernel density estimate
+Double_t TKDE::TKernel::Sum(Double_t x, UInt_t first, UInt_t last) const {
+   // Returns the (not normalized) sum of the kernels of the data points [first, last) at x
    Double_t result(0.0);
    UInt_t n = fKDE->fData.size();
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
-   Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
-   // double dmin = 1.E10;
-   // double xmin,bmin,wmin; 
-   for (UInt_t i = 0; i < n; ++i) {
+   for (UInt_t i = first; i < last; ++i) {
       Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
-      //printf("data point %i  %f  count %f weight % f result % f\n",i,fKDE->fData[i],binCount,fWeights[i], result);
       result += binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - fKDE->fData[i]) / fWeights[i]);
       if (fKDE->fAsymLeft) {
          result -= binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - (2. * fKDE->fXMin - fKDE->fData[i])) / fWeights[i]);
@@ -921,24 +982,198 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
       if (fKDE->fAsymRight) {
          result -= binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - (2. * fKDE->fXMax - fKDE->fData[i])) / fWeights[i]);
       }
-      // if ( TMath::IsNaN(result) ) {
-      //    printf("event %i count %f  weight %f  data % f x %f \n",i,binCount,fWeights[i],fKDE->fData[i],x );
-      // }
-      // if ( result <= 0 ) {
-      //    printf("event %i count %f  weight %f  data % f x %f \n",i,binCount,fWeights[i],fKDE->fData[i],x );
-      // }
-      // if (std::abs(x -  fKDE->fData[i]) < dmin ) {
-      //    xmin = x;
-      //    bmin = binCount;
-      //    wmin = fWeights[i];
-      //    dmin = std::abs(x -  fKDE->fData[i]);
-      // }
+   }
+   return result;
+}
+
+Double_t TKDE::TKernel::GetSumOfCounts() const {
+   // Returns the normalization of the kernel sum
+   Bool_t useBins = (fKDE->fBinCount.size() == fKDE->fData.size());
+   return (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+}
+
+Bool_t TKDE::TKernel::UseImplicitMT(Double_t nKernelEvals) const {
+   // Whether the exact evaluation of nKernelEvals kernels is worth splitting among threads.
+   // User defined kernels are not assumed to be thread safe.
+#ifdef R__USE_IMT
+   const Double_t kMinKernelEvals = 100000.;
+   return ROOT::IsImplicitMTEnabled() && fKDE->fKernelType != kUserDefined && nKernelEvals >= kMinKernelEvals;
+#else
+   (void)nKernelEvals;
+   return kFALSE;
+#endif
+}
+
+Double_t TKDE::TKernel::operator()(Double_t x) const {
+   // The internal class's unary function: returns the kernel density estimate
+   if (!fGridValues.empty()) return Interpolate(x);
+   UInt_t n = fKDE->fData.size();
+   Double_t result(0.0);
+#ifdef R__USE_IMT
+   if (UseImplicitMT(n)) {
+      const UInt_t kChunkSize = 10000;
+      const UInt_t nChunks = (n + kChunkSize - 1) / kChunkSize;
+      auto sumChunk = [&](UInt_t iChunk) {
+         return Sum(x, iChunk * kChunkSize, std::min(n, (iChunk + 1) * kChunkSize));
+      };
+      ROOT::TThreadExecutor pool;
+      std::vector<Double_t> partials = pool.Map(sumChunk, ROOT::TSeqU(nChunks));
+      result = std::accumulate(partials.begin(), partials.end(), 0.0);
+   } else
+#endif
+   {
+      result = Sum(x, 0, n);
    }
    if ( TMath::IsNaN(result) ) {
       fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
-    //xmin % f , %f, %f \n",result,x,xmin,bmin,wmin );
    }
-   return result / nSum;
+   return result / GetSumOfCounts();
+}
+
+void TKDE::TKernel::Evaluate(UInt_t n, const Double_t* x, Double_t* values) const {
+   // Returns in values the kernel density estimates at the n points x
+   if (!fGridValues.empty()) {
+      for (UInt_t i = 0; i < n; ++i) values[i] = Interpolate(x[i]);
+      return;
+   }
+   const UInt_t nData = fKDE->fData.size();
+   const Double_t nSum = GetSumOfCounts();
+#ifdef R__USE_IMT
+   if (UseImplicitMT((Double_t)n * nData) && n > 1) {
+      // each task evaluates enough points to amortize its scheduling
+      const UInt_t chunkSize = std::max(1U, 100000U / std::max(1U, nData));
+      const UInt_t nChunks = (n + chunkSize - 1) / chunkSize;
+      auto evalChunk = [&](UInt_t iChunk) {
+         const UInt_t last = std::min(n, (iChunk + 1) * chunkSize);
+         for (UInt_t i = iChunk * chunkSize; i < last; ++i)
+            values[i] = Sum(x[i], 0, nData) / nSum;
+      };
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(evalChunk, ROOT::TSeqU(nChunks));
+   } else
+#endif
+   {
+      for (UInt_t i = 0; i < n; ++i)
+         values[i] = (*this)(x[i]);
+      return;
+   }
+   for (UInt_t i = 0; i < n; ++i) {
+      if ( TMath::IsNaN(values[i]) ) {
+         fKDE->Warning("Evaluate","Result is NaN for  x %f \n",x[i]);
+      }
+   }
+}
+
+Double_t TKDE::TKernel::Interpolate(Double_t x) const {
+   // Returns the density at x interpolated linearly between the FFT grid points.
+   // Outside of the grid all kernels vanish.
+   const Double_t t = (x - fGridMin) / fGridStep;
+   const UInt_t nGrid = fGridValues.size();
+   if (!(t >= 0.) || t > nGrid - 1) return 0.;
+   UInt_t j = (UInt_t) t;
+   if (j >= nGrid - 1) return fGridValues[nGrid - 1];
+   const Double_t frac = t - j;
+   return (1. - frac) * fGridValues[j] + frac * fGridValues[j + 1];
+}
+
+void TKDE::TKernel::ComputeGrid() {
+   // Computes the density with the fixed bandwidth on a grid covering the support of all
+   // kernels, as the convolution of the linearly binned data with the sampled kernel.
+   // The relative error of the linear binning and of the interpolation is of the order of
+   // (grid spacing / bandwidth)^2, hence the spacing is the bandwidth times sqrt(accuracy).
+   // The convolution is done using FFT if available, or directly on the grid otherwise.
+   fGridValues.clear();
+   const std::vector<Double_t>& data = fKDE->fData;
+   const UInt_t n = data.size();
+   const Double_t h = fWeights.empty() ? 0. : fWeights[0];
+   if (n == 0 || !(h > 0.)) return;
+   const Bool_t useBins = (fKDE->fBinCount.size() == n);
+
+   // kernel support in units of the bandwidth; the Gaussian kernel is cut at 9 sigma
+   const Double_t support = (fKDE->fKernelType == kGaussian) ? 9. : 1.;
+   const Double_t dataMin = *std::min_element(data.begin(), data.end());
+   const Double_t dataMax = *std::max_element(data.begin(), data.end());
+   Double_t xmin = dataMin;
+   Double_t xmax = dataMax;
+   if (fKDE->fAsymLeft) xmin = std::min(xmin, 2. * fKDE->fXMin - dataMax);
+   if (fKDE->fAsymRight) xmax = std::max(xmax, 2. * fKDE->fXMax - dataMin);
+   xmin -= support * h;
+   xmax += support * h;
+
+   const Double_t kMaxGridPoints = 4194304.; // 2^22
+   Double_t nGridD = std::ceil((xmax - xmin) / (h * std::sqrt(fKDE->fAccuracy))) + 1.;
+   if (nGridD > kMaxGridPoints) {
+      fKDE->Warning("ComputeGrid", "Accuracy %g needs too many grid points; using %g points",
+                    fKDE->fAccuracy, kMaxGridPoints);
+      nGridD = kMaxGridPoints;
+   }
+   const Int_t nGrid = (Int_t) std::max(nGridD, 2.);
+   const Double_t step = (xmax - xmin) / (nGrid - 1);
+   const Int_t nKernel = (Int_t) std::ceil(support * h / step); // kernel half width in grid points
+   if (nKernel < 2) {
+      fKDE->Warning("ComputeGrid", "The bandwidth is too small compared to the data range for the FFT evaluation; using the exact evaluation");
+      return;
+   }
+
+   // length of the (zero padded) convolution, large enough to avoid wrap around
+   Int_t nFFT = 1;
+   while (nFFT < nGrid + nKernel + 1) nFFT *= 2;
+
+   std::vector<Double_t> binned(nFFT, 0.);
+   auto deposit = [&](Double_t pos, Double_t count) {
+      const Double_t t = (pos - xmin) / step;
+      Int_t j = std::min(std::max((Int_t) t, 0), nGrid - 2);
+      const Double_t frac = t - j;
+      binned[j] += count * (1. - frac);
+      binned[j + 1] += count * frac;
+   };
+   for (UInt_t i = 0; i < n; ++i) {
+      const Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
+      deposit(data[i], binCount);
+      if (fKDE->fAsymLeft) deposit(2. * fKDE->fXMin - data[i], -binCount);
+      if (fKDE->fAsymRight) deposit(2. * fKDE->fXMax - data[i], -binCount);
+   }
+
+   // kernel sampled at the grid spacing, k[m] at index m modulo nFFT
+   std::vector<Double_t> kernel(nFFT, 0.);
+   for (Int_t m = -nKernel; m <= nKernel; ++m) {
+      kernel[(m + nFFT) % nFFT] = (*fKDE->fKernelFunction)(m * step / h) / h;
+   }
+
+   const Double_t nSum = GetSumOfCounts();
+   fGridValues.resize(nGrid);
+   TVirtualFFT *fftData = TVirtualFFT::FFT(1, &nFFT, "R2C K");
+   TVirtualFFT *fftKernel = fftData ? TVirtualFFT::FFT(1, &nFFT, "R2C K") : 0;
+   TVirtualFFT *fftInverse = fftKernel ? TVirtualFFT::FFT(1, &nFFT, "C2R K") : 0;
+   if (fftInverse) {
+      fftData->SetPoints(&binned[0]);
+      fftKernel->SetPoints(&kernel[0]);
+      fftData->Transform();
+      fftKernel->Transform();
+      Double_t re1, im1, re2, im2;
+      for (Int_t i = 0; i <= nFFT / 2; ++i) {
+         fftData->GetPointComplex(i, re1, im1);
+         fftKernel->GetPointComplex(i, re2, im2);
+         fftInverse->SetPoint(i, re1 * re2 - im1 * im2, re1 * im2 + re2 * im1);
+      }
+      fftInverse->Transform();
+      // the backward transform is not normalized
+      for (Int_t j = 0; j < nGrid; ++j)
+         fGridValues[j] = fftInverse->GetPointReal(j) / nFFT / nSum;
+   } else {
+      fKDE->Warning("ComputeGrid", "Cannot use FFT, probably FFTW package is not available. Convolving directly on the grid");
+      for (Int_t j = 0; j < nGrid; ++j) {
+         Double_t sum = 0.;
+         for (Int_t m = std::max(-nKernel, j - nGrid + 1); m <= std::min(nKernel, j); ++m)
+            sum += binned[j - m] * kernel[(m + nFFT) % nFFT];
+         fGridValues[j] = sum / nSum;
+      }
+   }
+   delete fftData;
+   delete fftKernel;
+   delete fftInverse;
+   fGridMin = xmin;
+   fGridStep = step;
 }
 
 UInt_t TKDE::Index(Double_t x) const {
@@ -351,10 +351,7 @@ Int_t TProfile::BufferEmpty(Int_t action)
    }
 
    fBuffer = 0;
-
-   for (Int_t i=0;i<nbentries;i++) {
-      Fill(buffer[3*i+2],buffer[3*i+3],buffer[3*i+1]);
-   }
+   FillN(nbentries,&buffer[2],&buffer[3],&buffer[1],3);
    fBuffer = buffer;
 
    if (action > 0) { delete [] fBuffer; fBuffer = 0; fBufferSize = 0;}
@@ -749,6 +746,11 @@ Int_t TProfile::Fill(const char *namex, Double_t y, Double_t w)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill a Profile histogram with weights.
+///
+/// When the axis cannot be extended the entries are processed in blocks:
+/// the bins of a block are computed at once with TAxis::FindFixBins and the
+/// bin arrays and the statistics are updated directly, without going
+/// through the virtual Fill and AddBinContent for each entry.
 
 void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
@@ -770,6 +772,11 @@ void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const D
          return;
    }
 
+   if (!fXaxis.CanExtend()) {
+      DoFillNFixed((ntimes-ifirst)/stride, x+ifirst, y+ifirst, w ? w+ifirst : 0, stride);
+      return;
+   }
+
    for (i=ifirst;i<ntimes;i+=stride) {
       if (fYmin != fYmax) {
          if (y[i] <fYmin || y[i]> fYmax || TMath::IsNaN(y[i])) continue;
@@ -778,7 +785,7 @@ void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const D
       Double_t u = (w) ? w[i] : 1; // (w[i] > 0 ? w[i] : -w[i]);
       fEntries++;
       bin =fXaxis.FindBin(x[i]);
-      AddBinContent(bin, u*y[i]);
+      fArray[bin] += u*y[i];
       fSumw2.fArray[bin] += u*y[i]*y[i];
       if (!fBinSumw2.fN && u != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();  // must be called before accumulating the entries
       if (fBinSumw2.fN)  fBinSumw2.fArray[bin] += u*u;
@@ -795,6 +802,64 @@ void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const D
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Internal method used by TProfile::FillN when the axis has a fixed range.
+/// The arrays are addressed with the given stride and are not buffered.
+
+void TProfile::DoFillNFixed(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   const Bool_t checkRange = (fYmin != fYmax);
+   // must be called before accumulating the entries, see TProfile::Fill
+   if (w && !fBinSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         Double_t yi = y[i*stride];
+         if (checkRange && (yi < fYmin || yi > fYmax || TMath::IsNaN(yi))) continue;
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+   const Bool_t hasBinSumw2 = (fBinSumw2.fN > 0);
+   const Int_t nbinsx = fXaxis.GetNbins();
+   const Int_t kBlock = 256;
+   Int_t bins[kBlock];
+   Double_t u = 1;
+   Long64_t nentries = 0;
+   Double_t tsumw = 0, tsumw2 = 0, tsumwx = 0, tsumwx2 = 0, tsumwy = 0, tsumwy2 = 0;
+   for (Int_t first=0;first<ntimes;first+=kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes-first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xb, bins, stride);
+      for (i=0;i<n;i++) {
+         Double_t yi = yb[i*stride];
+         if (checkRange && (yi < fYmin || yi > fYmax || TMath::IsNaN(yi))) continue;
+         if (wb) u = wb[i*stride];
+         Int_t bin = bins[i];
+         nentries++;
+         fArray[bin] += u*yi;
+         fSumw2.fArray[bin] += u*yi*yi;
+         if (hasBinSumw2) fBinSumw2.fArray[bin] += u*u;
+         fBinEntries.fArray[bin] += u;
+         if (!fgStatOverflows && (bin == 0 || bin > nbinsx)) continue;
+         Double_t xi = xb[i*stride];
+         tsumw   += u;
+         tsumw2  += u*u;
+         tsumwx  += u*xi;
+         tsumwx2 += u*xi*xi;
+         tsumwy  += u*yi;
+         tsumwy2 += u*yi*yi;
+      }
+   }
+   fEntries += nentries;
+   fTsumw   += tsumw;
+   fTsumw2  += tsumw2;
+   fTsumwx  += tsumwx;
+   fTsumwx2 += tsumwx2;
+   fTsumwy  += tsumwy;
+   fTsumwy2 += tsumwy2;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return bin content of a Profile histogram.
 
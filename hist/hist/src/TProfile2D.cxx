@@ -309,9 +309,7 @@ Int_t TProfile2D::BufferEmpty(Int_t action)
    }
 
    fBuffer = 0;
-   for (Int_t i=0;i<nbentries;i++) {
-      Fill(buffer[4*i+2],buffer[4*i+3],buffer[4*i+4],buffer[4*i+1]);
-   }
+   FillN(nbentries,&buffer[2],&buffer[3],&buffer[4],&buffer[1],4);
    fBuffer = buffer;
 
    if (action > 0) { delete [] fBuffer; fBuffer = 0; fBufferSize = 0;}
@@ -772,6 +770,109 @@ Int_t TProfile2D::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a Profile2D histogram with the arrays x, y, z and the weights w.
+///
+/// If w is null, all entries have a weight of one. The arrays are read
+/// with the given stride. When no axis can be extended the bins are
+/// computed per block of entries with TAxis::FindFixBins and the bin arrays
+/// and the statistics are updated directly, without the virtual Fill and
+/// AddBinContent calls done for each entry by TProfile2D::Fill.
+
+void TProfile2D::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         BufferFill(x[i], y[i], z[i], w ? w[i] : 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   if (fXaxis.CanExtend() || fYaxis.CanExtend()) {
+      for (i=ifirst;i<ntimes;i+=stride) {
+         if (w) Fill(x[i], y[i], z[i], w[i]);
+         else   Fill(x[i], y[i], z[i]);
+      }
+      return;
+   }
+
+   ntimes = (ntimes-ifirst)/stride;
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+
+   const Bool_t checkRange = (fZmin != fZmax);
+   // must be called before accumulating the entries, see TProfile2D::Fill
+   if (w && !fBinSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<ntimes;i++) {
+         Double_t zi = z[i*stride];
+         if (checkRange && (zi < fZmin || zi > fZmax || TMath::IsNaN(zi))) continue;
+         if (w[i*stride] != 1.0) { Sumw2(); break; }
+      }
+   }
+   const Bool_t hasBinSumw2 = (fBinSumw2.fN > 0);
+   const Int_t nbinsx = fXaxis.GetNbins();
+   const Int_t nbinsy = fYaxis.GetNbins();
+   const Int_t kBlock = 256;
+   Int_t binx[kBlock], biny[kBlock];
+   Double_t u = 1;
+   Long64_t nentries = 0;
+   Double_t tsumw = 0, tsumw2 = 0, tsumwx = 0, tsumwx2 = 0, tsumwy = 0, tsumwy2 = 0, tsumwxy = 0;
+   Double_t tsumwz = 0, tsumwz2 = 0;
+   for (Int_t first=0;first<ntimes;first+=kBlock) {
+      Int_t n = TMath::Min(kBlock, ntimes-first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *zb = z + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xb, binx, stride);
+      fYaxis.FindFixBins(n, yb, biny, stride);
+      for (i=0;i<n;i++) {
+         Double_t zi = zb[i*stride];
+         if (checkRange && (zi < fZmin || zi > fZmax || TMath::IsNaN(zi))) continue;
+         if (wb) u = wb[i*stride];
+         Int_t bin = biny[i]*(nbinsx+2) + binx[i];
+         nentries++;
+         fArray[bin] += u*zi;
+         fSumw2.fArray[bin] += u*zi*zi;
+         if (hasBinSumw2) fBinSumw2.fArray[bin] += u*u;
+         fBinEntries.fArray[bin] += u;
+         if (!fgStatOverflows && (binx[i] == 0 || binx[i] > nbinsx || biny[i] == 0 || biny[i] > nbinsy)) continue;
+         Double_t xi = xb[i*stride];
+         Double_t yi = yb[i*stride];
+         tsumw   += u;
+         tsumw2  += u*u;
+         tsumwx  += u*xi;
+         tsumwx2 += u*xi*xi;
+         tsumwy  += u*yi;
+         tsumwy2 += u*yi*yi;
+         tsumwxy += u*xi*yi;
+         tsumwz  += u*zi;
+         tsumwz2 += u*zi*zi;
+      }
+   }
+   fEntries += nentries;
+   fTsumw   += tsumw;
+   fTsumw2  += tsumw2;
+   fTsumwx  += tsumwx;
+   fTsumwx2 += tsumwx2;
+   fTsumwy  += tsumwy;
+   fTsumwy2 += tsumwy2;
+   fTsumwxy += tsumwxy;
+   fTsumwz  += tsumwz;
+   fTsumwz2 += tsumwz2;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return bin content of a Profile2D histogram.
 
@@ -0,0 +1,329 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TQuantileSketch.h"
+
+#include "TBuffer.h"
+#include "TCollection.h"
+#include "TMath.h"
+
+#include <algorithm>
+#include <utility>
+
+ClassImp(TQuantileSketch);
+
+/** \class TQuantileSketch
+    \ingroup Hist
+
+Streaming estimate of the quantiles of a distribution, which can be filled
+with an unlimited number of values in a fixed amount of memory and merged.
+
+The class implements the merging t-digest of T. Dunning and O. Ertl
+("Computing extremely accurate quantiles using t-digests").
+The distribution is summarized by a sorted list of centroids (mean and
+weight). The size of the centroids is limited by a scale function which
+makes them small close to the tails, so that the relative accuracy of the
+quantiles is best for probabilities close to 0 and 1. The number of
+centroids is of the order of the compression parameter (100 by default);
+a larger compression gives more accurate quantiles.
+
+The filled values are collected in a buffer, which is merged with the
+centroids when it is full or when the quantiles are requested. Merging two
+sketches (TQuantileSketch::Merge, used by hadd, TThreadedObject and the
+TDataFrame QuantileSketch action) merges their centroids, the result does
+not depend on the number of pieces the data were split in, apart from
+the approximation of the sketch.
+
+~~~ {.cpp}
+TQuantileSketch s("s", "resolution", 200);
+for (Long64_t i = 0; i < n; ++i) s.Fill(x[i]);
+Double_t prob[3] = {0.05, 0.5, 0.95};
+Double_t q[3];
+s.GetQuantiles(3, q, prob);
+~~~
+
+Compared to TH1::GetQuantiles no binning has to be chosen in advance, and
+compared to TMath::Quantiles the data do not need to be kept and sorted.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor.
+
+TQuantileSketch::TQuantileSketch()
+   : fCompression(100), fEntries(0), fTsumw(0), fTsumwx(0), fTsumwx2(0), fMin(0), fMax(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+///
+/// \param[in] name name of the object
+/// \param[in] title title of the object
+/// \param[in] compression compression parameter, the number of centroids
+///            kept is of the order of compression (minimum 10)
+
+TQuantileSketch::TQuantileSketch(const char *name, const char *title, Double_t compression)
+   : TNamed(name, title), fCompression(TMath::Max(compression, 10.)), fEntries(0), fTsumw(0), fTsumwx(0),
+     fTsumwx2(0), fMin(0), fMax(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add a value to the buffer, merging the buffer in the centroids when full.
+
+void TQuantileSketch::AddToBuffer(Double_t x, Double_t w)
+{
+   fBufferX.push_back(x);
+   fBufferW.push_back(w);
+   if (fBufferX.size() >= 5 * fCompression + 100) Compress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the content of another sketch to this one.
+
+void TQuantileSketch::Add(const TQuantileSketch &sketch)
+{
+   if (sketch.fTsumw <= 0) return;
+   if (fTsumw <= 0) {
+      fMin = sketch.fMin;
+      fMax = sketch.fMax;
+   } else {
+      fMin = TMath::Min(fMin, sketch.fMin);
+      fMax = TMath::Max(fMax, sketch.fMax);
+   }
+   fEntries += sketch.fEntries;
+   fTsumw += sketch.fTsumw;
+   fTsumwx += sketch.fTsumwx;
+   fTsumwx2 += sketch.fTsumwx2;
+
+   for (UInt_t i = 0; i < sketch.fMeans.size(); ++i) AddToBuffer(sketch.fMeans[i], sketch.fWeights[i]);
+   for (UInt_t i = 0; i < sketch.fBufferX.size(); ++i) AddToBuffer(sketch.fBufferX[i], sketch.fBufferW[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the buffered values in the centroids.
+///
+/// All the centroids and buffered values are sorted and merged in a single
+/// pass. Consecutive values are merged in a centroid as long as its weight
+/// stays below the limit given by the scale function
+/// k(q) = compression / Z * log(q / (1 - q)), Z = 4 log(n / compression) + 24,
+/// i.e. as long as the centroid spans at most a unit interval in k. The
+/// limit is proportional to q (1 - q): values in the far tails stay alone.
+
+void TQuantileSketch::Compress()
+{
+   if (fBufferX.empty()) return;
+
+   std::vector<std::pair<Double_t, Double_t>> points;
+   points.reserve(fMeans.size() + fBufferX.size());
+   for (UInt_t i = 0; i < fMeans.size(); ++i) points.emplace_back(fMeans[i], fWeights[i]);
+   for (UInt_t i = 0; i < fBufferX.size(); ++i) points.emplace_back(fBufferX[i], fBufferW[i]);
+   fBufferX.clear();
+   fBufferW.clear();
+   std::sort(points.begin(), points.end());
+
+   Double_t total = 0;
+   for (auto &p : points) total += p.second;
+
+   // maximum weight fraction of a centroid at cumulative probability q
+   const Double_t normalizer =
+      fCompression / (4 * TMath::Log(TMath::Max(total / fCompression, 1.)) + 24);
+   auto maxsize = [&](Double_t q) { return q * (1 - q) / normalizer; };
+
+   fMeans.clear();
+   fWeights.clear();
+   Double_t wsofar = 0;
+   Double_t mean = points[0].first;
+   Double_t weight = points[0].second;
+   for (UInt_t i = 1; i < points.size(); ++i) {
+      const Double_t x = points[i].first;
+      const Double_t w = points[i].second;
+      const Double_t q0 = wsofar / total;
+      const Double_t q2 = (wsofar + weight + w) / total;
+      if (weight + w <= total * TMath::Min(maxsize(q0), maxsize(q2))) {
+         weight += w;
+         mean += (x - mean) * w / weight;
+      } else {
+         fMeans.push_back(mean);
+         fWeights.push_back(weight);
+         wsofar += weight;
+         mean = x;
+         weight = w;
+      }
+   }
+   fMeans.push_back(mean);
+   fWeights.push_back(weight);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the sketch with value x and weight w.
+/// NaN values and non positive weights are ignored.
+
+void TQuantileSketch::Fill(Double_t x, Double_t w)
+{
+   if (!(w > 0) || TMath::IsNaN(x)) return;
+   if (fTsumw <= 0) {
+      fMin = x;
+      fMax = x;
+   } else {
+      if (x < fMin) fMin = x;
+      if (x > fMax) fMax = x;
+   }
+   fEntries++;
+   fTsumw += w;
+   fTsumwx += w * x;
+   fTsumwx2 += w * x * x;
+   AddToBuffer(x, w);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the sketch with the n values x[i*stride], with weights w[i*stride]
+/// (weight 1 if w is null).
+
+void TQuantileSketch::FillN(Int_t n, const Double_t *x, const Double_t *w, Int_t stride)
+{
+   for (Int_t i = 0; i < n; ++i) Fill(x[i * stride], (w) ? w[i * stride] : 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the estimate of the quantile of probability prob (0 <= prob <= 1).
+///
+/// The quantiles are linearly interpolated between the means of the
+/// centroids, each centroid being centered on its half weight; below the
+/// first and above the last centroid the interpolation uses the minimum and
+/// maximum filled values. Return NaN if the sketch is empty.
+
+Double_t TQuantileSketch::GetQuantile(Double_t prob)
+{
+   Compress();
+   if (fMeans.empty() || prob < 0 || prob > 1) return TMath::QuietNaN();
+
+   Double_t total = 0;
+   for (auto w : fWeights) total += w;
+   const Double_t index = prob * total;
+   const UInt_t n = fMeans.size();
+
+   const Double_t whalf0 = 0.5 * fWeights[0];
+   if (index <= whalf0) {
+      if (whalf0 <= 0) return fMin;
+      return fMin + (fMeans[0] - fMin) * index / whalf0;
+   }
+   const Double_t whalfn = 0.5 * fWeights[n - 1];
+   if (index >= total - whalfn) {
+      if (whalfn <= 0) return fMax;
+      return fMax - (fMax - fMeans[n - 1]) * (total - index) / whalfn;
+   }
+
+   Double_t cum = whalf0;
+   for (UInt_t i = 0; i + 1 < n; ++i) {
+      const Double_t dw = 0.5 * (fWeights[i] + fWeights[i + 1]);
+      if (cum + dw >= index) return fMeans[i] + (fMeans[i + 1] - fMeans[i]) * (index - cum) / dw;
+      cum += dw;
+   }
+   return fMax;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the quantiles q[i] of the probabilities probSum[i], with the same
+/// interface as TH1::GetQuantiles. If probSum is null, the nprobSum
+/// quantiles of the equidistant probabilities i/(nprobSum-1) are computed.
+/// Return the number of quantiles computed.
+
+Int_t TQuantileSketch::GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum)
+{
+   if (nprobSum <= 0) return 0;
+   for (Int_t i = 0; i < nprobSum; ++i) {
+      Double_t prob;
+      if (probSum) prob = probSum[i];
+      else prob = (nprobSum > 1) ? Double_t(i) / (nprobSum - 1) : 0.5;
+      q[i] = GetQuantile(prob);
+   }
+   return nprobSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the standard deviation of the filled values.
+
+Double_t TQuantileSketch::GetStdDev() const
+{
+   if (fTsumw <= 0) return 0;
+   Double_t mean = fTsumwx / fTsumw;
+   Double_t var = fTsumwx2 / fTsumw - mean * mean;
+   return (var > 0) ? TMath::Sqrt(var) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the sketches in list into this one.
+/// Return the number of entries of the merged sketch, -1 in case of error.
+
+Long64_t TQuantileSketch::Merge(TCollection *list)
+{
+   if (!list) return 0;
+   TIter next(list);
+   while (TObject *obj = next()) {
+      TQuantileSketch *sketch = dynamic_cast<TQuantileSketch *>(obj);
+      if (!sketch) {
+         Error("Merge", "Attempt to merge object of class: %s to a %s", obj->ClassName(), ClassName());
+         return -1;
+      }
+      Add(*sketch);
+   }
+   Compress();
+   return fEntries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the sketch statistics. With option "all" print also the centroids.
+
+void TQuantileSketch::Print(Option_t *option) const
+{
+   Printf("TQuantileSketch %s\t%s\tcompression = %g", GetName(), GetTitle(), fCompression);
+   Printf("  entries = %lld  sum of weights = %g  mean = %g  std dev = %g  min = %g  max = %g", fEntries, fTsumw,
+          GetMean(), GetStdDev(), fMin, fMax);
+   Printf("  centroids = %d  buffered values = %d", Int_t(fMeans.size()), Int_t(fBufferX.size()));
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("all")) {
+      for (UInt_t i = 0; i < fMeans.size(); ++i) Printf("  %6d  mean = %-14g  weight = %g", i, fMeans[i], fWeights[i]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the sketch content.
+
+void TQuantileSketch::Reset(Option_t *)
+{
+   fMeans.clear();
+   fWeights.clear();
+   fBufferX.clear();
+   fBufferW.clear();
+   fEntries = 0;
+   fTsumw = 0;
+   fTsumwx = 0;
+   fTsumwx2 = 0;
+   fMin = 0;
+   fMax = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class TQuantileSketch.
+/// The buffered values are merged in the centroids before writing.
+
+void TQuantileSketch::Streamer(TBuffer &b)
+{
+   if (b.IsReading()) {
+      b.ReadClassBuffer(TQuantileSketch::Class(), this);
+      fBufferX.clear();
+      fBufferW.clear();
+   } else {
+      Compress();
+      b.WriteClassBuffer(TQuantileSketch::Class(), this);
+   }
+}
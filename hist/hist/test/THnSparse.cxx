@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include "THnSparse.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TRandom3.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+   const Int_t kNdim = 3;
+   const Int_t kNpoints = 20000;
+
+   THnSparseD* CreateSparse(const char* name) {
+      Int_t bins[kNdim] = {100, 50, 200};
+      Double_t xmin[kNdim] = {-5., 0., -10.};
+      Double_t xmax[kNdim] = {5., 1., 10.};
+      THnSparseD* hs = new THnSparseD(name, name, kNdim, bins, xmin, xmax, 1024);
+      hs->Sumw2();
+      return hs;
+   }
+
+   void FillPoints(std::vector<Double_t>& x, std::vector<Double_t>& w) {
+      TRandom3 rnd(42);
+      x.resize(kNpoints * kNdim);
+      w.resize(kNpoints);
+      for (Int_t i = 0; i < kNpoints; ++i) {
+         x[i * kNdim] = rnd.Gaus(0., 3.);      // with under- and overflows
+         x[i * kNdim + 1] = rnd.Uniform();
+         x[i * kNdim + 2] = rnd.Uniform(-12., 12.);
+         w[i] = rnd.Uniform(0.5, 2.);
+      }
+   }
+}
+
+// Filling many bins, growing the bin index and looking up the bins again
+TEST(THnSparse, GetBin) {
+   std::unique_ptr<THnSparseD> hs(CreateSparse("hs"));
+   std::vector<Double_t> x, w;
+   FillPoints(x, w);
+
+   for (Int_t i = 0; i < kNpoints; ++i)
+      hs->Fill(&x[i * kNdim], w[i]);
+
+   Int_t coord[kNdim];
+   for (Long64_t bin = 0; bin < hs->GetNbins(); ++bin) {
+      hs->GetBinContent(bin, coord);
+      EXPECT_EQ(bin, hs->GetBin(coord, kFALSE /*allocate*/));
+   }
+
+   Int_t notFilled[kNdim] = {3, 51, 0}; // overflow of axis 1 cannot be filled
+   Double_t content = hs->GetBinContent(notFilled);
+   Long64_t nbins = hs->GetNbins();
+   EXPECT_DOUBLE_EQ(0., content);
+   EXPECT_EQ(nbins, hs->GetNbins());
+}
+
+// FillN must give the same result as Fill for each point
+TEST(THnSparse, FillN) {
+   std::unique_ptr<THnSparseD> hFill(CreateSparse("hFill"));
+   std::unique_ptr<THnSparseD> hFillN(CreateSparse("hFillN"));
+   std::vector<Double_t> x, w;
+   FillPoints(x, w);
+
+   for (Int_t i = 0; i < kNpoints; ++i)
+      hFill->Fill(&x[i * kNdim], w[i]);
+   hFillN->FillN(kNpoints, &x[0], &w[0]);
+
+   EXPECT_EQ(hFill->GetNbins(), hFillN->GetNbins());
+   EXPECT_DOUBLE_EQ(hFill->GetEntries(), hFillN->GetEntries());
+   EXPECT_DOUBLE_EQ(hFill->GetWeightSum(), hFillN->GetWeightSum());
+
+   Int_t coord[kNdim];
+   for (Long64_t bin = 0; bin < hFill->GetNbins(); ++bin) {
+      Double_t v = hFill->GetBinContent(bin, coord);
+      Long64_t binN = hFillN->GetBin(coord, kFALSE /*allocate*/);
+      ASSERT_GE(binN, 0);
+      EXPECT_DOUBLE_EQ(v, hFillN->GetBinContent(binN));
+      EXPECT_DOUBLE_EQ(hFill->GetBinError2(bin), hFillN->GetBinError2(binN));
+   }
+}
+
+// Projections must match histograms filled with the same points
+TEST(THnSparse, Projection) {
+   std::unique_ptr<THnSparseD> hs(CreateSparse("hs"));
+   TH1D h1("h1", "h1", 100, -5., 5.);
+   TH2D h2("h2", "h2", 200, -10., 10., 100, -5., 5.);
+   h1.Sumw2();
+   h2.Sumw2();
+   std::vector<Double_t> x, w;
+   FillPoints(x, w);
+
+   hs->FillN(kNpoints, &x[0], &w[0]);
+   for (Int_t i = 0; i < kNpoints; ++i) {
+      h1.Fill(x[i * kNdim], w[i]);
+      h2.Fill(x[i * kNdim + 2], x[i * kNdim], w[i]);
+   }
+
+   std::unique_ptr<TH1D> p1(hs->Projection(0));
+   for (Int_t bin = 0; bin <= h1.GetNbinsX() + 1; ++bin) {
+      EXPECT_NEAR(h1.GetBinContent(bin), p1->GetBinContent(bin), 1E-10);
+      EXPECT_NEAR(h1.GetBinError(bin), p1->GetBinError(bin), 1E-10);
+   }
+   EXPECT_DOUBLE_EQ(hs->GetEntries(), p1->GetEntries());
+
+   std::unique_ptr<TH2D> p2(hs->Projection(0, 2));
+   for (Int_t bin = 0; bin < h2.GetNcells(); ++bin) {
+      EXPECT_NEAR(h2.GetBinContent(bin), p2->GetBinContent(bin), 1E-10);
+      EXPECT_NEAR(h2.GetBinError(bin), p2->GetBinError(bin), 1E-10);
+   }
+
+   // With a range on a non-projected axis, skipping bins.
+   hs->GetAxis(1)->SetRange(1, 25);
+   TH1D h1r("h1r", "h1r", 100, -5., 5.);
+   h1r.Sumw2();
+   for (Int_t i = 0; i < kNpoints; ++i)
+      if (x[i * kNdim + 1] < 0.5)
+         h1r.Fill(x[i * kNdim], w[i]);
+   std::unique_ptr<TH1D> p1r(hs->Projection(0));
+   for (Int_t bin = 0; bin <= h1r.GetNbinsX() + 1; ++bin) {
+      EXPECT_NEAR(h1r.GetBinContent(bin), p1r->GetBinContent(bin), 1E-10);
+      EXPECT_NEAR(h1r.GetBinError(bin), p1r->GetBinError(bin), 1E-10);
+   }
+}
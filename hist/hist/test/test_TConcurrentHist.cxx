@@ -0,0 +1,62 @@
+#include "ROOT/TConcurrentHist.hxx"
+#include "TH1D.h"
+#include "TH2D.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+TEST(TConcurrentHist, FillFromThreads)
+{
+   ROOT::TConcurrentHist h(TH1D("h", "h", 10, 0, 10), 3);
+   EXPECT_EQ(3u, h.GetNShards());
+
+   const int nThreads = 4;
+   const int nFills = 10000;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < nThreads; ++t) {
+      threads.emplace_back([&h, t]() {
+         for (int i = 0; i < nFills; ++i)
+            h.Fill((i + t) % 12 - 0.5);
+      });
+   }
+   // A snapshot can be taken while filling
+   auto partial = h.Snapshot("partial");
+   EXPECT_LE(partial->GetEntries(), nThreads * nFills);
+   for (auto &thread : threads)
+      thread.join();
+
+   TH1D ref("ref", "ref", 10, 0, 10);
+   for (int t = 0; t < nThreads; ++t)
+      for (int i = 0; i < nFills; ++i)
+         ref.Fill((i + t) % 12 - 0.5);
+
+   auto result = h.Snapshot();
+   ASSERT_TRUE(dynamic_cast<TH1D *>(result.get()));
+   EXPECT_EQ(ref.GetEntries(), result->GetEntries());
+   for (int i = 0; i < ref.GetNcells(); ++i)
+      EXPECT_DOUBLE_EQ(ref.GetBinContent(i), result->GetBinContent(i));
+   EXPECT_DOUBLE_EQ(ref.GetMean(), result->GetMean());
+   EXPECT_DOUBLE_EQ(ref.GetStdDev(), result->GetStdDev());
+}
+
+TEST(TConcurrentHist, Weighted2D)
+{
+   ROOT::TConcurrentHist h(TH2D("h2", "h2", 4, 0, 4, 5, 0, 5));
+   TH2D ref("ref2", "ref2", 4, 0, 4, 5, 0, 5);
+   for (int i = 0; i < 100; ++i) {
+      double x = (i % 6) - 0.5, y = (i % 7) - 0.5, w = 0.1 * (i % 3 + 1);
+      h.Fill(x, y, w);
+      ref.Fill(x, y, w);
+   }
+   auto result = h.Snapshot();
+   for (int i = 0; i < ref.GetNcells(); ++i) {
+      EXPECT_NEAR(ref.GetBinContent(i), result->GetBinContent(i), 1e-12);
+      EXPECT_NEAR(ref.GetBinError(i), result->GetBinError(i), 1e-12);
+   }
+   EXPECT_NEAR(ref.GetCorrelationFactor(), static_cast<TH2 *>(result.get())->GetCorrelationFactor(), 1e-12);
+
+   h.Reset();
+   EXPECT_EQ(0, h.Snapshot()->GetEntries());
+}
@@ -0,0 +1,92 @@
+#include "TGraph2D.h"
+#include "TH2.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+// Test that the batch interpolation agrees with the point by point one and
+// is exact for a linear function inside the convex hull
+TEST(TGraph2D, InterpolateN)
+{
+   TRandom3 r(3);
+   const Int_t np = 2000;
+   TGraph2D g(np);
+   for (Int_t i = 0; i < np; ++i) {
+      Double_t x = r.Uniform(-1, 1);
+      Double_t y = r.Uniform(0, 2);
+      g.SetPoint(i, x, y, 2 * x - 3 * y + 1);
+   }
+
+   const Int_t n = 5000;
+   std::vector<Double_t> x(n), y(n), z(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = r.Uniform(-0.9, 0.9);
+      y[i] = r.Uniform(0.1, 1.9);
+   }
+   g.Interpolate(n, x.data(), y.data(), z.data());
+   for (Int_t i = 0; i < n; ++i) {
+      EXPECT_NEAR(2 * x[i] - 3 * y[i] + 1, z[i], 1.E-9);
+      EXPECT_EQ(g.Interpolate(x[i], y[i]), z[i]);
+   }
+
+   // points outside the convex hull get the margin value
+   Double_t xo = 5, yo = 5, zo;
+   g.Interpolate(1, &xo, &yo, &zo);
+   EXPECT_EQ(0., zo);
+}
+
+// Test the histogram built from the interpolation
+TEST(TGraph2D, GetHistogram)
+{
+   TGraph2D g;
+   Int_t k = 0;
+   for (Int_t i = 0; i <= 20; ++i)
+      for (Int_t j = 0; j <= 20; ++j) g.SetPoint(k++, i * 0.1, j * 0.1, i * 0.1 + j * 0.2);
+   g.SetNpx(30);
+   g.SetNpy(30);
+   TH2D *h = g.GetHistogram();
+   ASSERT_TRUE(h != nullptr);
+   for (Int_t ix = 2; ix < 30; ++ix) {
+      for (Int_t iy = 2; iy < 30; ++iy) {
+         Double_t x = h->GetXaxis()->GetBinCenter(ix);
+         Double_t y = h->GetYaxis()->GetBinCenter(iy);
+         if (x < 0 || x > 2 || y < 0 || y > 2) continue;
+         EXPECT_NEAR(x + 2 * y, h->GetBinContent(ix, iy), 1.E-9);
+      }
+   }
+}
+
+#ifdef R__USE_IMT
+// Test that the batch interpolation in parallel chunks with the implicit
+// multi-threading gives the same results as the serial one
+TEST(TGraph2D, InterpolateNIMT)
+{
+   TRandom3 r(5);
+   const Int_t np = 2000;
+   TGraph2D g(np);
+   for (Int_t i = 0; i < np; ++i) {
+      Double_t x = r.Uniform(-1, 1);
+      Double_t y = r.Uniform(0, 2);
+      g.SetPoint(i, x, y, x * x - 2 * y * x + 1);
+   }
+
+   // enough points for several chunks, some of them outside the convex hull
+   const Int_t n = 20000;
+   std::vector<Double_t> x(n), y(n), zSerial(n), zParallel(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = r.Uniform(-1.1, 1.1);
+      y[i] = r.Uniform(-0.1, 2.1);
+   }
+   g.Interpolate(n, x.data(), y.data(), zSerial.data());
+
+   ROOT::EnableImplicitMT(4);
+   g.Interpolate(n, x.data(), y.data(), zParallel.data());
+   ROOT::DisableImplicitMT();
+
+   for (Int_t i = 0; i < n; ++i)
+      EXPECT_EQ(zSerial[i], zParallel[i]);
+}
+#endif
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "TKDE.h"
+#include "TRandom3.h"
+#include "TMath.h"
+
+#include <vector>
+
+namespace {
+   std::vector<Double_t> GenerateData(UInt_t n) {
+      TRandom3 rnd(4357);
+      std::vector<Double_t> data(n);
+      for (UInt_t i = 0; i < n; ++i)
+         data[i] = (i % 3) ? rnd.Gaus(0., 1.) : rnd.Gaus(3., 0.5);
+      return data;
+   }
+}
+
+// GetValues must give the same result as evaluating each point
+TEST(TKDE, GetValues) {
+   std::vector<Double_t> data = GenerateData(2000);
+   TKDE kde(data.size(), &data[0], -5., 6., "KernelType:Gaussian;Iteration:Adaptive;Mirror:noMirror;Binning:Unbinned");
+
+   std::vector<Double_t> x(200), values(200);
+   for (UInt_t i = 0; i < x.size(); ++i)
+      x[i] = -5. + 11. * i / x.size();
+   kde.GetValues(x.size(), &x[0], &values[0]);
+   for (UInt_t i = 0; i < x.size(); ++i)
+      EXPECT_NEAR(kde(x[i]), values[i], 1E-12 * kde(x[i]) + 1E-15);
+}
+
+// The FFT evaluation must reproduce the exact one within the requested accuracy
+TEST(TKDE, FFT) {
+   std::vector<Double_t> data = GenerateData(20000);
+   const char* opts[] = {
+      "KernelType:Gaussian;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned",
+      "KernelType:Epanechnikov;Iteration:Fixed;Mirror:noMirror;Binning:ForcedBinning",
+      "KernelType:Biweight;Iteration:Fixed;Mirror:MirrorAsymBoth;Binning:Unbinned"
+   };
+   for (const char* opt : opts) {
+      TKDE kde(data.size(), &data[0], -4., 5., opt);
+      std::vector<Double_t> x(100), exact(100), fft(100);
+      for (UInt_t i = 0; i < x.size(); ++i)
+         x[i] = -3.5 + 8. * i / x.size();
+      kde.GetValues(x.size(), &x[0], &exact[0]);
+
+      kde.SetEvaluation(TKDE::kFFT, 1.E-5);
+      EXPECT_EQ(TKDE::kFFT, kde.GetEvaluation());
+      kde.GetValues(x.size(), &x[0], &fft[0]);
+      Double_t maxExact = 0.;
+      for (UInt_t i = 0; i < x.size(); ++i)
+         maxExact = std::max(maxExact, exact[i]);
+      for (UInt_t i = 0; i < x.size(); ++i)
+         EXPECT_NEAR(exact[i], fft[i], 1E-3 * maxExact) << opt << " at x = " << x[i];
+
+      kde.SetEvaluation(TKDE::kExact);
+      EXPECT_DOUBLE_EQ(exact[50], kde(x[50]));
+   }
+}
+
+// A user defined kernel is evaluated exactly with kFFT, since its support is not known:
+// this wide Gaussian is far from negligible 9 bandwidths away from the data
+TEST(TKDE, FFTUserDefinedKernel) {
+   std::vector<Double_t> data = GenerateData(5000);
+   auto kernel = [](Double_t u) { return TMath::Gaus(u, 0., 5., kTRUE); };
+   TKDE kde("userkde", kernel, data.size(), &data[0], -4., 5.,
+            "KernelType:UserDefined;Iteration:Fixed;Mirror:noMirror;Binning:Unbinned");
+   std::vector<Double_t> x(50), exact(50), fft(50);
+   for (UInt_t i = 0; i < x.size(); ++i)
+      x[i] = -3.5 + 8. * i / x.size();
+   kde.GetValues(x.size(), &x[0], &exact[0]);
+
+   kde.SetEvaluation(TKDE::kFFT, 1.E-5);
+   kde.GetValues(x.size(), &x[0], &fft[0]);
+   for (UInt_t i = 0; i < x.size(); ++i)
+      EXPECT_DOUBLE_EQ(exact[i], fft[i]) << "at x = " << x[i];
+}
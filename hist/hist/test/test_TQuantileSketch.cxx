@@ -0,0 +1,71 @@
+#include "TQuantileSketch.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+// Test the quantiles of a gaussian sample against the exact ones
+TEST(TQuantileSketch, Quantiles)
+{
+   const Int_t n = 200000;
+   std::vector<Double_t> x(n);
+   TRandom3 r(1);
+   for (auto &v : x) v = r.Gaus();
+
+   TQuantileSketch s("s", "s");
+   s.FillN(n, x.data());
+   EXPECT_EQ(n, s.GetEntries());
+   EXPECT_LT(s.GetNcentroids(), 500);
+
+   std::sort(x.begin(), x.end());
+   const Double_t prob[] = {0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999};
+   Double_t q[7];
+   EXPECT_EQ(7, s.GetQuantiles(7, q, prob));
+   for (Int_t i = 0; i < 7; ++i) {
+      // compare the ranks of the estimated and exact quantiles
+      Double_t rank = (std::lower_bound(x.begin(), x.end(), q[i]) - x.begin()) / Double_t(n);
+      EXPECT_NEAR(prob[i], rank, 0.01 * TMath::Min(prob[i], 1 - prob[i]) + 2.E-4);
+   }
+   EXPECT_EQ(x.front(), s.GetQuantile(0));
+   EXPECT_EQ(x.back(), s.GetQuantile(1));
+}
+
+// Test that merging sketches is equivalent to filling a single one
+TEST(TQuantileSketch, Merge)
+{
+   TRandom3 r(2);
+   TQuantileSketch all("all", "all");
+   TQuantileSketch parts[4];
+   TList list;
+   for (Int_t i = 0; i < 100000; ++i) {
+      Double_t v = r.Exp(1.);
+      all.Fill(v);
+      parts[i % 4].Fill(v, 1.);
+   }
+   for (Int_t i = 1; i < 4; ++i) list.Add(&parts[i]);
+   EXPECT_EQ(100000, parts[0].Merge(&list));
+   EXPECT_NEAR(all.GetMean(), parts[0].GetMean(), 1.E-10);
+   EXPECT_EQ(all.GetMax(), parts[0].GetMax());
+   for (Double_t p : {0.01, 0.5, 0.99})
+      EXPECT_NEAR(all.GetQuantile(p), parts[0].GetQuantile(p), 0.01 * all.GetQuantile(p));
+}
+
+// Test the empty sketch and the weights
+TEST(TQuantileSketch, Weights)
+{
+   TQuantileSketch s("s", "s");
+   EXPECT_TRUE(TMath::IsNaN(s.GetQuantile(0.5)));
+   s.Fill(1., 3.);
+   s.Fill(2., 1.);
+   s.Fill(5., 0.); // ignored
+   EXPECT_EQ(2, s.GetEntries());
+   EXPECT_DOUBLE_EQ(4., s.GetSumOfWeights());
+   EXPECT_DOUBLE_EQ(1.25, s.GetMean());
+   EXPECT_DOUBLE_EQ(1., s.GetQuantile(0.2));
+   s.Reset();
+   EXPECT_EQ(0, s.GetEntries());
+}
@@ -0,0 +1,182 @@
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TEfficiency.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+#include "TRandom3.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// The block filling of FillN must give the same result as filling entry by entry,
+// including underflows, overflows and NaN.
+
+static void ExpectSameHistograms(const TH1 &h1, const TH1 &h2)
+{
+   ASSERT_EQ(h1.GetNcells(), h2.GetNcells());
+   for (Int_t i = 0; i < h1.GetNcells(); ++i) {
+      EXPECT_DOUBLE_EQ(h1.GetBinContent(i), h2.GetBinContent(i));
+      EXPECT_DOUBLE_EQ(h1.GetBinError(i), h2.GetBinError(i));
+   }
+   EXPECT_DOUBLE_EQ(h1.GetEntries(), h2.GetEntries());
+   Double_t s1[TH1::kNstat], s2[TH1::kNstat];
+   h1.GetStats(s1);
+   h2.GetStats(s2);
+   for (Int_t i = 0; i < TH1::kNstat; ++i)
+      EXPECT_NEAR(s1[i], s2[i], 1e-9 * (1 + std::abs(s1[i])));
+}
+
+static std::vector<Double_t> MakeValues(Int_t n, TRandom &r)
+{
+   std::vector<Double_t> v(n);
+   for (auto &x : v)
+      x = r.Uniform(-1.2, 1.2);
+   v[3] = -1.;
+   v[7] = 1.;
+   v[11] = std::numeric_limits<Double_t>::quiet_NaN();
+   return v;
+}
+
+TEST(FillN, TH1D)
+{
+   TRandom3 r(1);
+   const Int_t n = 1001;
+   auto x = MakeValues(n, r);
+   std::vector<Double_t> w(n);
+   for (auto &ww : w)
+      ww = r.Uniform(0, 2);
+
+   TH1D h1("h1", "", 20, -1, 1), h2("h2", "", 20, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      h1.Fill(x[i], w[i]);
+   h2.FillN(n, x.data(), w.data());
+   ExpectSameHistograms(h1, h2);
+
+   TH1D h3("h3", "", 20, -1, 1), h4("h4", "", 20, -1, 1);
+   for (Int_t i = 0; i < n; i += 2)
+      h3.Fill(x[i]);
+   h4.FillN((n + 1) / 2, x.data(), nullptr, 2);
+   ExpectSameHistograms(h3, h4);
+}
+
+TEST(FillN, TH2D)
+{
+   TRandom3 r(2);
+   const Int_t n = 777;
+   auto x = MakeValues(n, r);
+   auto y = MakeValues(n, r);
+   std::vector<Double_t> w(n);
+   for (auto &ww : w)
+      ww = r.Uniform(0, 2);
+
+   TH2D h1("h1", "", 10, -1, 1, 12, -1, 1), h2("h2", "", 10, -1, 1, 12, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      h1.Fill(x[i], y[i], w[i]);
+   h2.FillN(n, x.data(), y.data(), w.data());
+   ExpectSameHistograms(h1, h2);
+}
+
+TEST(FillN, TH3D)
+{
+   TRandom3 r(3);
+   const Int_t n = 555;
+   auto x = MakeValues(n, r);
+   auto y = MakeValues(n, r);
+   auto z = MakeValues(n, r);
+
+   TH3D h1("h1", "", 5, -1, 1, 6, -1, 1, 7, -1, 1), h2("h2", "", 5, -1, 1, 6, -1, 1, 7, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      h1.Fill(x[i], y[i], z[i]);
+   h2.FillN(n, x.data(), y.data(), z.data(), nullptr);
+   ExpectSameHistograms(h1, h2);
+}
+
+TEST(FillN, TProfile)
+{
+   TRandom3 r(4);
+   const Int_t n = 1003;
+   auto x = MakeValues(n, r);
+   std::vector<Double_t> y(n), w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      y[i] = r.Gaus(x[i], 1);
+      w[i] = r.Uniform(0, 2);
+   }
+
+   TProfile p1("p1", "", 20, -1, 1, -2, 2), p2("p2", "", 20, -1, 1, -2, 2);
+   for (Int_t i = 0; i < n; ++i)
+      p1.Fill(x[i], y[i], w[i]);
+   p2.FillN(n, x.data(), y.data(), w.data());
+   ExpectSameHistograms(p1, p2);
+   for (Int_t i = 0; i < p1.GetNcells(); ++i)
+      EXPECT_DOUBLE_EQ(p1.GetBinEntries(i), p2.GetBinEntries(i));
+
+   TProfile p3("p3", "", 20, -1, 1), p4("p4", "", 20, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      p3.Fill(x[i], y[i]);
+   p4.FillN(n, x.data(), y.data(), nullptr);
+   ExpectSameHistograms(p3, p4);
+}
+
+TEST(FillN, TProfile2D)
+{
+   TRandom3 r(5);
+   const Int_t n = 999;
+   auto x = MakeValues(n, r);
+   auto y = MakeValues(n, r);
+   std::vector<Double_t> z(n), w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      z[i] = r.Gaus(0, 1);
+      w[i] = r.Uniform(0, 2);
+   }
+
+   TProfile2D p1("p1", "", 10, -1, 1, 12, -1, 1), p2("p2", "", 10, -1, 1, 12, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      p1.Fill(x[i], y[i], z[i], w[i]);
+   p2.FillN(n, x.data(), y.data(), z.data(), w.data());
+   ExpectSameHistograms(p1, p2);
+   for (Int_t i = 0; i < p1.GetNcells(); ++i)
+      EXPECT_DOUBLE_EQ(p1.GetBinEntries(i), p2.GetBinEntries(i));
+
+   // buffered profile, emptied through FillN
+   TProfile2D p3("p3", "", 10, -1, 1, 12, -1, 1), p4("p4", "", 10, -1, 1, 12, -1, 1);
+   p4.SetBuffer(100);
+   for (Int_t i = 0; i < n; ++i) {
+      p3.Fill(x[i], y[i], z[i]);
+      p4.Fill(x[i], y[i], z[i]);
+   }
+   p4.BufferEmpty(1);
+   ExpectSameHistograms(p3, p4);
+}
+
+TEST(FillN, TEfficiency)
+{
+   TRandom3 r(6);
+   const Int_t n = 1234;
+   auto x = MakeValues(n, r);
+   std::unique_ptr<Bool_t[]> pass(new Bool_t[n]);
+   std::vector<Double_t> w(n);
+   for (Int_t i = 0; i < n; ++i) {
+      pass[i] = r.Rndm() < 0.5 + 0.4 * std::tanh(x[i]);
+      w[i] = r.Uniform(0.5, 1.5);
+   }
+
+   TEfficiency e1("e1", "", 20, -1, 1), e2("e2", "", 20, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      e1.Fill(pass[i], x[i]);
+   e2.FillN(n, pass.get(), x.data());
+   ExpectSameHistograms(*e1.GetTotalHistogram(), *e2.GetTotalHistogram());
+   ExpectSameHistograms(*e1.GetPassedHistogram(), *e2.GetPassedHistogram());
+
+   auto y = MakeValues(n, r);
+   TEfficiency e3("e3", "", 10, -1, 1, 8, -1, 1), e4("e4", "", 10, -1, 1, 8, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      e3.FillWeighted(pass[i], w[i], x[i], y[i]);
+   e4.FillN(n, pass.get(), x.data(), y.data(), nullptr, w.data());
+   ExpectSameHistograms(*e3.GetTotalHistogram(), *e4.GetTotalHistogram());
+   ExpectSameHistograms(*e3.GetPassedHistogram(), *e4.GetPassedHistogram());
+}
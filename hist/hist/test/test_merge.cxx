@@ -0,0 +1,235 @@
+#include "gtest/gtest.h"
+
+#include "TH1.h"
+#include "TH2.h"
+#include "THn.h"
+#include "THnSparse.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TRandom3.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// The merge of a list of histograms is compared with and without implicit multi-threading,
+// which splits large lists in blocks merged in parallel. All the values are filled at bin
+// centers with integer weights, so that the sums are exact whatever their order: the
+// results must be identical.
+
+static const Int_t kNHists = 7;
+
+template <class HIST>
+static HIST *MergeWithIMT(const HIST &h0, TList &list, Bool_t imt, const char *name)
+{
+   auto merged = static_cast<HIST *>(h0.Clone(name));
+#ifdef R__USE_IMT
+   if (imt)
+      ROOT::EnableImplicitMT(4);
+#else
+   (void)imt;
+#endif
+   merged->Merge(&list);
+#ifdef R__USE_IMT
+   if (imt)
+      ROOT::DisableImplicitMT();
+#endif
+   return merged;
+}
+
+static void ExpectSameHist(const TH1 &a, const TH1 &b)
+{
+   ASSERT_EQ(a.GetNcells(), b.GetNcells());
+   for (Int_t iaxis = 0; iaxis < a.GetDimension(); ++iaxis) {
+      const TAxis *axa = iaxis == 0 ? a.GetXaxis() : (iaxis == 1 ? a.GetYaxis() : a.GetZaxis());
+      const TAxis *axb = iaxis == 0 ? b.GetXaxis() : (iaxis == 1 ? b.GetYaxis() : b.GetZaxis());
+      EXPECT_EQ(axa->GetNbins(), axb->GetNbins());
+      EXPECT_EQ(axa->GetXmin(), axb->GetXmin());
+      EXPECT_EQ(axa->GetXmax(), axb->GetXmax());
+   }
+   for (Int_t ibin = 0; ibin < a.GetNcells(); ++ibin) {
+      ASSERT_EQ(a.GetBinContent(ibin), b.GetBinContent(ibin)) << "bin " << ibin;
+      ASSERT_EQ(a.GetBinError(ibin), b.GetBinError(ibin)) << "bin " << ibin;
+   }
+   EXPECT_EQ(a.GetEntries(), b.GetEntries());
+   Double_t statsa[TH1::kNstat] = {0};
+   Double_t statsb[TH1::kNstat] = {0};
+   a.GetStats(statsa);
+   b.GetStats(statsb);
+   for (Int_t i = 0; i < TH1::kNstat; ++i)
+      EXPECT_EQ(statsa[i], statsb[i]) << "stat " << i;
+}
+
+// Same axes, double precision: the bin arrays are added by blocks in parallel
+// (kNHists-1 histograms of 200002 cells, above the threshold of a million bins)
+TEST(Merge, TH1DSameAxes)
+{
+   TH1::AddDirectory(kFALSE);
+   TRandom3 rnd(11);
+   const Int_t nbins = 200000;
+   std::vector<std::unique_ptr<TH1D>> hists;
+   TList list;
+   for (Int_t k = 0; k < kNHists; ++k) {
+      hists.emplace_back(new TH1D(("h1_" + std::to_string(k)).c_str(), "", nbins, 0, nbins));
+      hists.back()->Sumw2();
+      for (Int_t i = 0; i < 20000; ++i)
+         hists.back()->Fill(rnd.Integer(nbins + 2) - 0.5, 1 + rnd.Integer(3));
+      if (k > 0)
+         list.Add(hists.back().get());
+   }
+
+   std::unique_ptr<TH1D> serial(MergeWithIMT(*hists[0], list, kFALSE, "serial"));
+   std::unique_ptr<TH1D> parallel(MergeWithIMT(*hists[0], list, kTRUE, "parallel"));
+   ExpectSameHist(*serial, *parallel);
+
+   // the merge is the sum of the histograms
+   Double_t entries = 0;
+   for (auto &h : hists)
+      entries += h->GetEntries();
+   EXPECT_EQ(entries, serial->GetEntries());
+   for (Int_t ibin : {0, 1, 17, nbins / 2, nbins + 1}) {
+      Double_t sum = 0;
+      for (auto &h : hists)
+         sum += h->GetBinContent(ibin);
+      EXPECT_EQ(sum, serial->GetBinContent(ibin));
+   }
+}
+
+// Same axes, with inputs storing floats and inputs without Sumw2 (error = content)
+TEST(Merge, TH2MixedTypes)
+{
+   TH1::AddDirectory(kFALSE);
+   TRandom3 rnd(12);
+   const Int_t nbins = 500;
+   TH2D h0("h2_0", "", nbins, 0, nbins, nbins, 0, nbins);
+   h0.Sumw2();
+   std::vector<std::unique_ptr<TH2>> hists;
+   TList list;
+   for (Int_t k = 1; k < kNHists; ++k) {
+      const std::string name = "h2_" + std::to_string(k);
+      if (k % 2)
+         hists.emplace_back(new TH2F(name.c_str(), "", nbins, 0, nbins, nbins, 0, nbins));
+      else
+         hists.emplace_back(new TH2D(name.c_str(), "", nbins, 0, nbins, nbins, 0, nbins));
+      if (k != 2)
+         hists.back()->Sumw2();
+      list.Add(hists.back().get());
+   }
+   for (Int_t i = 0; i < 50000; ++i) {
+      h0.Fill(rnd.Integer(nbins) + 0.5, rnd.Integer(nbins) + 0.5, 1 + rnd.Integer(3));
+      for (auto &h : hists) {
+         // no weights for the histogram without Sumw2
+         const Double_t w = h->GetSumw2N() ? 1 + rnd.Integer(3) : 1;
+         h->Fill(rnd.Integer(nbins) + 0.5, rnd.Integer(nbins) + 0.5, w);
+      }
+   }
+
+   std::unique_ptr<TH2D> serial(MergeWithIMT(h0, list, kFALSE, "serial"));
+   std::unique_ptr<TH2D> parallel(MergeWithIMT(h0, list, kTRUE, "parallel"));
+   ExpectSameHist(*serial, *parallel);
+}
+
+// Extendable axes: the histograms have different ranges, the merge extends the axes
+TEST(Merge, TH1ExtendableAxes)
+{
+   TH1::AddDirectory(kFALSE);
+   TRandom3 rnd(13);
+   std::vector<std::unique_ptr<TH1D>> hists;
+   TList list;
+   for (Int_t k = 0; k < kNHists; ++k) {
+      hists.emplace_back(new TH1D(("he_" + std::to_string(k)).c_str(), "", 100, 0, 100));
+      hists.back()->SetCanExtend(TH1::kAllAxes);
+      hists.back()->Sumw2();
+      for (Int_t i = 0; i < 10000; ++i)
+         hists.back()->Fill(100 * k + rnd.Integer(100) + 0.5, 1 + rnd.Integer(3));
+      if (k > 0)
+         list.Add(hists.back().get());
+   }
+
+   std::unique_ptr<TH1D> serial(MergeWithIMT(*hists[0], list, kFALSE, "serial"));
+   std::unique_ptr<TH1D> parallel(MergeWithIMT(*hists[0], list, kTRUE, "parallel"));
+   EXPECT_GE(serial->GetXaxis()->GetXmax(), 100. * kNHists);
+   ExpectSameHist(*serial, *parallel);
+}
+
+static void ExpectSameStats(const THnBase &a, const THnBase &b)
+{
+   EXPECT_EQ(a.GetEntries(), b.GetEntries());
+   EXPECT_EQ(a.GetSumw(), b.GetSumw());
+   EXPECT_EQ(a.GetSumw2(), b.GetSumw2());
+   for (Int_t d = 0; d < a.GetNdimensions(); ++d) {
+      EXPECT_EQ(a.GetSumwx(d), b.GetSumwx(d));
+      EXPECT_EQ(a.GetSumwx2(d), b.GetSumwx2(d));
+   }
+}
+
+// Fill a n-dim histogram at bin centers
+static void FillHn(THnBase &h, TRandom &rnd, Int_t nbins, Int_t nentries)
+{
+   std::vector<Double_t> x(h.GetNdimensions());
+   for (Int_t i = 0; i < nentries; ++i) {
+      for (auto &xi : x)
+         xi = rnd.Integer(nbins) + 0.5;
+      h.Fill(x.data(), 1 + rnd.Integer(3));
+   }
+}
+
+// THnD above the parallel threshold (1e5 bins)
+TEST(Merge, THnD)
+{
+   TRandom3 rnd(14);
+   const Int_t nbins = 50;
+   Int_t bins[3] = {nbins, nbins, nbins};
+   Double_t xmin[3] = {0, 0, 0};
+   Double_t xmax[3] = {nbins, nbins, nbins};
+   std::vector<std::unique_ptr<THnD>> hists;
+   TList list;
+   for (Int_t k = 0; k < kNHists; ++k) {
+      hists.emplace_back(new THnD(("hn_" + std::to_string(k)).c_str(), "", 3, bins, xmin, xmax));
+      hists.back()->Sumw2();
+      FillHn(*hists.back(), rnd, nbins, 20000);
+      if (k > 0)
+         list.Add(hists.back().get());
+   }
+
+   std::unique_ptr<THnD> serial(MergeWithIMT(*hists[0], list, kFALSE, "serial"));
+   std::unique_ptr<THnD> parallel(MergeWithIMT(*hists[0], list, kTRUE, "parallel"));
+   ASSERT_EQ(serial->GetNbins(), parallel->GetNbins());
+   for (Long64_t i = 0; i < serial->GetNbins(); ++i) {
+      ASSERT_EQ(serial->GetBinContent(i), parallel->GetBinContent(i)) << "bin " << i;
+      ASSERT_EQ(serial->GetBinError2(i), parallel->GetBinError2(i)) << "bin " << i;
+   }
+   ExpectSameStats(*serial, *parallel);
+}
+
+// THnSparse: the bins are not allocated in the same order, compare them by coordinates
+TEST(Merge, THnSparse)
+{
+   TRandom3 rnd(15);
+   const Int_t nbins = 100;
+   Int_t bins[4] = {nbins, nbins, nbins, nbins};
+   Double_t xmin[4] = {0, 0, 0, 0};
+   Double_t xmax[4] = {nbins, nbins, nbins, nbins};
+   std::vector<std::unique_ptr<THnSparseD>> hists;
+   TList list;
+   for (Int_t k = 0; k < kNHists; ++k) {
+      hists.emplace_back(new THnSparseD(("hs_" + std::to_string(k)).c_str(), "", 4, bins, xmin, xmax));
+      hists.back()->Sumw2();
+      FillHn(*hists.back(), rnd, nbins, 30000);
+      if (k > 0)
+         list.Add(hists.back().get());
+   }
+
+   std::unique_ptr<THnSparseD> serial(MergeWithIMT(*hists[0], list, kFALSE, "serial"));
+   std::unique_ptr<THnSparseD> parallel(MergeWithIMT(*hists[0], list, kTRUE, "parallel"));
+   ASSERT_EQ(serial->GetNbins(), parallel->GetNbins());
+   Int_t coord[4];
+   for (Long64_t i = 0; i < serial->GetNbins(); ++i) {
+      const Double_t content = serial->GetBinContent(i, coord);
+      const Long64_t j = parallel->GetBin(coord, kFALSE);
+      ASSERT_GE(j, 0) << "bin " << i;
+      ASSERT_EQ(content, parallel->GetBinContent(j)) << "bin " << i;
+      ASSERT_EQ(serial->GetBinError2(i), parallel->GetBinError2(j)) << "bin " << i;
+   }
+   ExpectSameStats(*serial, *parallel);
+}
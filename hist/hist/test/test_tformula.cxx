@@ -0,0 +1,326 @@
+#include "TFormula.h"
+#include "TF1.h"
+#include "TF2.h"
+#include "TMath.h"
+#include "TH1.h"
+#include "TFitResult.h"
+#include "TInterpreter.h"
+#include "TROOT.h"
+#include "TSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+// Test that evaluating many points at once gives the same result as EvalPar,
+// for a vectorizable expression and for one which is not
+TEST(TFormula, EvalParN)
+{
+   TFormula f1("f1", "[0]*exp(-0.5*((x-[1])/[2])^2) + sqrt(abs(x))");
+   TFormula f2("f2", "[0]*TMath::Erf(x) + [1]*x*x");
+   f1.SetParameters(2., 0.5, 1.5);
+   f2.SetParameters(3., -1.);
+
+   const int n = 37;
+   std::vector<double> x(n), y1(n), y2(n);
+   for (int i = 0; i < n; ++i) x[i] = -3. + 0.17 * i;
+
+   f1.EvalParN(n, x.data(), y1.data());
+   f2.EvalParN(n, x.data(), y2.data());
+   for (int i = 0; i < n; ++i) {
+      EXPECT_NEAR(f1.EvalPar(&x[i]), y1[i], 1.E-12 * TMath::Abs(y1[i]) + 1.E-14);
+      EXPECT_DOUBLE_EQ(f2.EvalPar(&x[i]), y2[i]);
+   }
+
+   // parameters passed explicitly
+   double p[3] = {1., -1., 0.5};
+   f1.EvalParN(n, x.data(), y1.data(), p);
+   for (int i = 0; i < n; ++i) EXPECT_NEAR(f1.EvalPar(&x[i], p), y1[i], 1.E-12 * TMath::Abs(y1[i]) + 1.E-14);
+
+   // the batch function is shared by copies
+   TFormula f3(f1);
+   std::vector<double> y3(n);
+   f3.EvalParN(n, x.data(), y3.data(), p);
+   for (int i = 0; i < n; ++i) EXPECT_DOUBLE_EQ(y1[i], y3[i]);
+}
+
+// Test batch evaluation of multi-dimensional functions and of normalized TF1
+TEST(TF1, EvalParN)
+{
+   TF2 f("f", "[0]*x*y + sin(y) - [1]", -1, 1, -1, 1);
+   f.SetParameters(2., 0.25);
+   const int n = 11;
+   std::vector<double> xy(2 * n), y(n);
+   for (int i = 0; i < n; ++i) {
+      xy[2 * i] = -1. + 0.2 * i;
+      xy[2 * i + 1] = 1. - 0.15 * i;
+   }
+   f.EvalParN(n, xy.data(), y.data());
+   for (int i = 0; i < n; ++i) EXPECT_NEAR(f.EvalPar(&xy[2 * i]), y[i], 1.E-12);
+
+   TF1 g("g", "gaus", -5, 5);
+   g.SetParameters(1., 0., 1.);
+   g.SetNormalized(true);
+   std::vector<double> x(n), v(n);
+   for (int i = 0; i < n; ++i) x[i] = -5. + i;
+   g.EvalParN(n, x.data(), v.data());
+   for (int i = 0; i < n; ++i) EXPECT_NEAR(g.EvalPar(&x[i]), v[i], 1.E-12);
+}
+
+// Test that formulas compiled lazily are compiled together on first evaluation
+TEST(TFormula, LazyCompilation)
+{
+   TFormula::SetLazyCompilation(true);
+   TFormula f1("lazy1", "[0]+[1]*x*x*x+sin(x)");
+   TFormula f2("lazy2", "x*y*[0]+4.25");
+   TFormula::SetLazyCompilation(false);
+
+   EXPECT_TRUE(f1.IsValid());
+   EXPECT_TRUE(f2.IsValid());
+   f1.SetParameters(1., 2.);
+   f2.SetParameter(0, 3.);
+   EXPECT_NEAR(f1.Eval(0.5), 1. + 2. * 0.125 + TMath::Sin(0.5), 1.E-12);
+   EXPECT_NEAR(f2.Eval(2., 0.5), 3. + 4.25, 1.E-12);
+
+   // a copy of a formula waiting to be compiled
+   TFormula::SetLazyCompilation(true);
+   TFormula f3("lazy3", "[0]*x+cos(x)");
+   TFormula::SetLazyCompilation(false);
+   TFormula f4(f3);
+   f4.SetParameter(0, 2.);
+   EXPECT_NEAR(f4.Eval(1.), 2. + TMath::Cos(1.), 1.E-12);
+}
+
+// Test the concurrent first evaluations of a formula waiting to be compiled: only one thread
+// compiles it, the others must see it either pending or completely initialized
+TEST(TFormula, LazyCompilationThreads)
+{
+   ROOT::EnableThreadSafety();
+   for (int k = 0; k < 5; ++k) {
+      TFormula::SetLazyCompilation(true);
+      TFormula f(TString::Format("lazymt%d", k), TString::Format("[0]*x+%d*sin(x)", k + 2));
+      TFormula::SetLazyCompilation(false);
+
+      const int nthreads = 4;
+      std::vector<double> results(nthreads);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nthreads; ++t) {
+         threads.emplace_back([&f, &results, t]() {
+            double x = 0.5;
+            double p = 3.;
+            results[t] = f.EvalPar(&x, &p);
+         });
+      }
+      for (auto &th : threads) th.join();
+      for (int t = 0; t < nthreads; ++t)
+         EXPECT_NEAR(3. * 0.5 + (k + 2) * TMath::Sin(0.5), results[t], 1.E-12) << "thread " << t;
+   }
+}
+
+// Return the names of the files in dir ending with the given suffix
+static std::vector<TString> ListFiles(const TString &dir, const char *suffix)
+{
+   std::vector<TString> files;
+   void *dirp = gSystem->OpenDirectory(dir);
+   if (!dirp) return files;
+   while (const char *entry = gSystem->GetDirEntry(dirp)) {
+      if (TString(entry).EndsWith(suffix)) files.push_back(dir + "/" + entry);
+   }
+   gSystem->FreeDirectory(dirp);
+   return files;
+}
+
+// Test that the functions compiled together are cached in a single library, which is loaded
+// without being rebuilt. When one of them cannot be compiled by ACLiC, the functions are
+// compiled one by one, the failures are recorded and the invalid one is declared to Cling.
+TEST(TFormula, CompilationCache)
+{
+   TString dir = TString::Format("%s/tformula_cache_%d", gSystem->TempDirectory(), gSystem->GetPid());
+   TFormula::SetCompilationCacheDir(dir);
+   EXPECT_EQ(dir, TString(TFormula::GetCompilationCacheDir()));
+
+   // a batch of valid functions: one macro and one library
+   TFormula::SetLazyCompilation(true);
+   TFormula f1("cache1", "[0]*x*x+exp(-x)+0.375");
+   TFormula f2("cache2", "x*[0]-2.5");
+   TFormula::SetLazyCompilation(false);
+   f1.SetParameter(0, 2.);
+   f2.SetParameter(0, 4.);
+   EXPECT_NEAR(f1.Eval(1.5), 2. * 2.25 + TMath::Exp(-1.5) + 0.375, 1.E-12);
+   EXPECT_NEAR(f2.Eval(1.5), 4. * 1.5 - 2.5, 1.E-12);
+   EXPECT_EQ(1u, ListFiles(dir, ".C").size());
+   EXPECT_EQ(1u, ListFiles(dir, TString::Format("_C.%s", gSystem->GetSoExt())).size());
+
+   // a batch with a function invalid for ACLiC: the batch and then each function are compiled
+   gInterpreter->Declare("double tformula_cache_interpreted(double x) { return 3. * x; }");
+   TFormula::SetLazyCompilation(true);
+   TFormula f3("cache3", "tformula_cache_interpreted(x)+[0]");
+   TFormula f4("cache4", "x*x*[0]+0.125");
+   TFormula::SetLazyCompilation(false);
+   f3.SetParameter(0, 1.);
+   f4.SetParameter(0, 3.);
+   // the invalid function falls back to Cling
+   EXPECT_TRUE(f3.IsValid());
+   EXPECT_NEAR(f3.Eval(1.5), 3. * 1.5 + 1., 1.E-12);
+   EXPECT_NEAR(f4.Eval(1.5), 3. * 2.25 + 0.125, 1.E-12);
+   TFormula::SetCompilationCacheDir("");
+
+   // the failed builds of the second batch and of f3 are recorded, no temporary file is left
+   std::vector<TString> macros = ListFiles(dir, ".C");
+   EXPECT_EQ(4u, macros.size());
+   EXPECT_EQ(2u, ListFiles(dir, ".failed").size());
+   for (auto &file : ListFiles(dir, "")) {
+      TString name = gSystem->BaseName(file);
+      EXPECT_FALSE(name.BeginsWith("TFormulaCache_") && !name.Contains(".")) << "temporary file " << name;
+   }
+   std::vector<TString> libs = ListFiles(dir, TString::Format("_C.%s", gSystem->GetSoExt()));
+   ASSERT_EQ(2u, libs.size());
+
+   // a second load of the cached macros does not rebuild the libraries
+   std::vector<Long_t> modtimes;
+   for (auto &lib : libs) {
+      FileStat_t st;
+      ASSERT_EQ(0, gSystem->GetPathInfo(lib, st));
+      modtimes.push_back(st.fMtime);
+   }
+   gSystem->Sleep(1100);
+   for (auto &macro : macros) {
+      TString lib = macro;
+      lib.ReplaceAll(".C", TString::Format("_C.%s", gSystem->GetSoExt()));
+      if (gSystem->AccessPathName(lib)) continue;
+      EXPECT_EQ(1, gSystem->CompileMacro(macro, "kO"));
+   }
+   for (size_t i = 0; i < libs.size(); ++i) {
+      FileStat_t st;
+      ASSERT_EQ(0, gSystem->GetPathInfo(libs[i], st));
+      EXPECT_EQ(modtimes[i], st.fMtime);
+   }
+
+   for (auto &file : ListFiles(dir, "")) {
+      if (!file.EndsWith("/.") && !file.EndsWith("/..")) gSystem->Unlink(file);
+   }
+   gSystem->Unlink(dir);
+}
+
+// Test the gradient with respect to the parameters generated by differentiating the expression
+TEST(TFormula, GradientPar)
+{
+   TF1 f1("gradf1", "[0]*exp(-0.5*((x-[1])/[2])^2) + [3]*sqrt(abs(x*[4])) + (x > [1] ? log([4]*x*x+1) : [3])", -5, 5);
+   f1.SetParameters(2., 0.5, 1.5, 0.3, 2.);
+   ASSERT_TRUE(f1.GetFormula()->GenerateGradientPar());
+   ASSERT_TRUE(f1.HasAnalyticGradientPar());
+
+   // compare with the numerical derivatives of a function which cannot be differentiated
+   TF1 f2("gradf2", "[0]*exp(-0.5*((x-[1])/[2])^2) + [3]*sqrt(abs(x*[4])) + (x > [1] ? log([4]*x*x+1) : [3])"
+                    " + 0*TMath::Landau(x,[0],[2])", -5, 5);
+   f2.SetParameters(2., 0.5, 1.5, 0.3, 2.);
+   EXPECT_FALSE(f2.HasAnalyticGradientPar());
+
+   double grad1[5], grad2[5];
+   for (double x = -2.95; x < 3; x += 0.5) {
+      f1.GradientPar(&x, grad1);
+      f2.GradientPar(&x, grad2, 1.E-4);
+      for (int i = 0; i < 5; ++i) {
+         EXPECT_NEAR(grad1[i], grad2[i], 1.E-6 * (1. + TMath::Abs(grad1[i])));
+         EXPECT_DOUBLE_EQ(grad1[i], f1.GradientPar(i, &x));
+      }
+   }
+
+   // the gradient is zero for the fixed parameters
+   f1.FixParameter(1, 0.5);
+   double x = 0.7;
+   f1.GradientPar(&x, grad1);
+   EXPECT_EQ(0., grad1[1]);
+}
+
+// Test that the nodes of the branch of a ternary operator which is not taken do not
+// contribute to the gradient, also when their derivatives are not finite
+TEST(TFormula, GradientParTernary)
+{
+   TF1 f1("gradt1", "x > 0 ? sqrt([0]*x) : [1]", -5, 5);
+   TF1 f2("gradt2", "x != 0 ? [0]/x + log([1]*x*x) : [0]", -5, 5);
+   f1.SetParameters(2., 3.);
+   f2.SetParameters(2., 3.);
+   ASSERT_TRUE(f1.HasAnalyticGradientPar());
+   ASSERT_TRUE(f2.HasAnalyticGradientPar());
+
+   double grad[2];
+   double x = -1.;
+   f1.GradientPar(&x, grad);
+   EXPECT_EQ(0., grad[0]);
+   EXPECT_EQ(1., grad[1]);
+   x = 2.;
+   f1.GradientPar(&x, grad);
+   EXPECT_DOUBLE_EQ(0.5 * x / sqrt(2. * x), grad[0]);
+   EXPECT_EQ(0., grad[1]);
+
+   x = 0.;
+   f2.GradientPar(&x, grad);
+   EXPECT_EQ(1., grad[0]);
+   EXPECT_EQ(0., grad[1]);
+   x = -0.5;
+   f2.GradientPar(&x, grad);
+   EXPECT_DOUBLE_EQ(1. / x, grad[0]);
+   EXPECT_DOUBLE_EQ(1. / 3., grad[1]);
+}
+
+// Test that the chi2 fits with expected errors (option P), whose gradient is not computed,
+// give the same result for the functions with and without analytic gradient
+TEST(TFormula, GradientParPearsonChi2Fit)
+{
+   TH1D h("hgradpchi2", "", 40, -4, 4);
+   for (int i = 1; i <= h.GetNbinsX(); ++i) {
+      double x = h.GetBinCenter(i);
+      h.SetBinContent(i, TMath::Nint(100. * TMath::Exp(-0.5 * (x - 0.3) * (x - 0.3) / 1.44)) + i % 3);
+   }
+
+   TF1 f1("gradpf1", "[0]*exp(-0.5*((x-[1])/[2])^2)", -4, 4);
+   TF1 f2("gradpf2", "[0]*exp(-0.5*((x-[1])/[2])^2) + 0*TMath::Landau(x,[0],[2])", -4, 4);
+   ASSERT_TRUE(f1.HasAnalyticGradientPar());
+   ASSERT_FALSE(f2.HasAnalyticGradientPar());
+
+   for (const char *option : {"P Q N S", "Q N S"}) {
+      f1.SetParameters(80., 0., 1.);
+      f2.SetParameters(80., 0., 1.);
+      TFitResultPtr r1 = h.Fit(&f1, option);
+      TFitResultPtr r2 = h.Fit(&f2, option);
+      ASSERT_EQ(0, r1->Status());
+      ASSERT_EQ(0, r2->Status());
+      EXPECT_NEAR(r1->Chi2(), r2->Chi2(), 1.E-6 * r2->Chi2());
+      for (int i = 0; i < 3; ++i)
+         EXPECT_NEAR(r1->Parameter(i), r2->Parameter(i), 1.E-4 * (1. + TMath::Abs(r2->Parameter(i))));
+   }
+}
+
+// Test that the weighted likelihood fits (option WL), whose gradient is not computed, give the
+// same result for the functions with and without analytic gradient
+TEST(TFormula, GradientParWeightedLikelihoodFit)
+{
+   TH1D h("hgradwl", "", 40, -4, 4);
+   h.Sumw2();
+   for (int i = 1; i <= h.GetNbinsX(); ++i) {
+      double x = h.GetBinCenter(i);
+      int n = TMath::Nint(100. * TMath::Exp(-0.5 * (x - 0.3) * (x - 0.3) / 1.44)) + i % 3;
+      // entries with different weights in each bin
+      for (int j = 0; j < n; ++j)
+         h.Fill(x, 0.5 + 0.25 * ((i + j) % 4));
+   }
+
+   TF1 f1("gradwlf1", "[0]*exp(-0.5*((x-[1])/[2])^2)", -4, 4);
+   TF1 f2("gradwlf2", "[0]*exp(-0.5*((x-[1])/[2])^2) + 0*TMath::Landau(x,[0],[2])", -4, 4);
+   ASSERT_TRUE(f1.HasAnalyticGradientPar());
+   ASSERT_FALSE(f2.HasAnalyticGradientPar());
+
+   f1.SetParameters(80., 0., 1.);
+   f2.SetParameters(80., 0., 1.);
+   TFitResultPtr r1 = h.Fit(&f1, "WL Q N S");
+   TFitResultPtr r2 = h.Fit(&f2, "WL Q N S");
+   ASSERT_EQ(0, r1->Status());
+   ASSERT_EQ(0, r2->Status());
+   EXPECT_NEAR(r1->MinFcnValue(), r2->MinFcnValue(), 1.E-6 * TMath::Abs(r2->MinFcnValue()));
+   for (int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(r1->Parameter(i), r2->Parameter(i), 1.E-4 * (1. + TMath::Abs(r2->Parameter(i))));
+      EXPECT_NEAR(r1->ParError(i), r2->ParError(i), 1.E-3 * r2->ParError(i));
+   }
+}
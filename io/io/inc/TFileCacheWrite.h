@@ -16,6 +16,12 @@
 
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+class TFileCacheWriteFlusher;
+}
+}
+
 class TFileCacheWrite : public TObject {
 
 protected:
@@ -25,20 +31,29 @@ protected:
    TFile        *fFile;           ///< Pointer to file
    char         *fBuffer;         ///< [fBufferSize] buffer of contiguous prefetched blocks
    Bool_t        fRecursive;      ///< flag to avoid recursive calls
+   char         *fFlushBuffer;    ///<! buffer being written to the file in the background
+   Long64_t      fFlushSeek;      ///<! seek value of fFlushBuffer
+   Int_t         fFlushNtot;      ///<! size of the data in fFlushBuffer
+   ROOT::Internal::TFileCacheWriteFlusher *fFlusher; ///<! background writer, if asynchronous writing is enabled
 
 private:
    TFileCacheWrite(const TFileCacheWrite &);            //cannot be copied
    TFileCacheWrite& operator=(const TFileCacheWrite &);
 
+   Bool_t FlushAsync();
+   Bool_t WaitFlush();
+
 public:
    TFileCacheWrite();
    TFileCacheWrite(TFile *file, Int_t buffersize);
    virtual ~TFileCacheWrite();
    virtual Bool_t      Flush();
-   virtual Int_t       GetBytesInCache() const { return fNtot; }
+   virtual Int_t       GetBytesInCache() const { return fNtot + fFlushNtot; }
+   virtual Bool_t      IsAsyncWriting() const { return fFlusher != 0; }
    virtual void        Print(Option_t *option="") const;
    virtual Int_t       ReadBuffer(char *buf, Long64_t pos, Int_t len);
    virtual Int_t       WriteBuffer(const char *buf, Long64_t pos, Int_t len);
+   virtual Bool_t      SetAsyncWriting(Bool_t async = kTRUE);
    virtual void        SetFile(TFile *file);
 
    ClassDef(TFileCacheWrite,1)  //TFile cache when writing
@@ -965,6 +965,10 @@ void TFile::Close(Option_t *option)
       fFree->Delete();
    }
 
+   // Make sure no buffer is still being written in the background, even if
+   // the file is not writable anymore (see TFileCacheWrite::SetAsyncWriting()).
+   if (fCacheWrite) fCacheWrite->SetAsyncWriting(kFALSE);
+
    if (IsOpen()) {
       SysClose(fD);
       fD = -1;
@@ -2100,6 +2104,8 @@ Int_t TFile::ReOpen(Option_t *mode)
          return -1;
       }
       SetWritable(kTRUE);
+      // a background writer must use the new file descriptor
+      if (fCacheWrite) fCacheWrite->SetFile(this);
 
       fFree = new TList;
       if (fSeekFree > fBEGIN)
@@ -4143,6 +4149,10 @@ TFile *TFile::Open(const char *url, Option_t *options, const char *ftitle,
    if (type != kLocal && type != kFile &&
        f && f->IsWritable() && !f->IsRaw()) {
       new TFileCacheWrite(f, 1);
+   } else if (f && f->IsWritable() && !f->IsRaw() && !f->GetCacheWrite() &&
+              gEnv->GetValue("TFile.AsyncWriting", 0)) {
+      // the write cache of local files writes its buffers in the background
+      new TFileCacheWrite(f, 1);
    }
 
    return f;
@@ -23,14 +23,137 @@ TXNetFile and TWebFile (via TFile::WriteBuffers()).
 
 The write cache is automatically created when writing a remote file
 (created in TFile::Open()).
+
+For local files, the cache can be used to decouple the producer from the
+disk: with SetAsyncWriting() (or the rootrc variable TFile.AsyncWriting,
+in which case TFile::Open() also creates the cache for local files) two
+buffers are used in turn, and a full buffer is written to the file by a
+background thread while the next one is being filled.
 */
 
 
+#include "TEnv.h"
 #include "TFile.h"
 #include "TFileCacheWrite.h"
 
+#ifndef WIN32
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#endif
+
 ClassImp(TFileCacheWrite);
 
+#ifndef WIN32
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TFileCacheWriteFlusher
+/// Writes the buffers handed over by a TFileCacheWrite to a file descriptor
+/// in a background thread, one buffer at a time.
+///
+/// Positional writes are used, so the file offset used by the TFile in the
+/// main thread is not affected.
+
+class TFileCacheWriteFlusher {
+private:
+   std::mutex              fMutex;
+   std::condition_variable fCondition;
+   Int_t                   fFd;
+   const char             *fBuffer = nullptr; ///< Buffer to be written
+   Long64_t                fPos = 0;          ///< Position in the file
+   Int_t                   fLen = 0;          ///< Number of bytes to be written
+   Bool_t                  fPending = kFALSE; ///< True while a buffer is being written
+   Bool_t                  fStop = kFALSE;    ///< True when the thread has to terminate
+   Int_t                   fErrno = 0;        ///< errno of the last failed write, 0 if none
+   std::thread             fThread;
+
+   void Run()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (true) {
+         fCondition.wait(lock, [this] { return fPending || fStop; });
+         if (!fPending)
+            return;
+         const char *buf = fBuffer;
+         Long64_t pos = fPos;
+         Int_t len = fLen;
+         lock.unlock();
+         Int_t err = 0;
+         while (len > 0) {
+            ssize_t siz = ::pwrite(fFd, buf, len, pos);
+            if (siz < 0) {
+               if (errno == EINTR)
+                  continue;
+               err = errno;
+               break;
+            }
+            buf += siz;
+            pos += siz;
+            len -= siz;
+         }
+         lock.lock();
+         fErrno = err;
+         fPending = kFALSE;
+         fCondition.notify_all();
+      }
+   }
+
+public:
+   TFileCacheWriteFlusher(Int_t fd) : fFd(fd), fThread(&TFileCacheWriteFlusher::Run, this) {}
+
+   ~TFileCacheWriteFlusher()
+   {
+      {
+         std::unique_lock<std::mutex> lock(fMutex);
+         fCondition.wait(lock, [this] { return !fPending; });
+         fStop = kTRUE;
+      }
+      fCondition.notify_all();
+      fThread.join();
+   }
+
+   /// Start writing len bytes of buf at position pos; the previous write
+   /// must have been waited for.
+   void Start(const char *buf, Long64_t pos, Int_t len)
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fBuffer = buf;
+         fPos = pos;
+         fLen = len;
+         fPending = kTRUE;
+      }
+      fCondition.notify_all();
+   }
+
+   /// Wait for the current write, return 0 or the errno of the failure.
+   Int_t Wait()
+   {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock, [this] { return !fPending; });
+      return fErrno;
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+#else
+namespace ROOT {
+namespace Internal {
+// Asynchronous writing is not supported on Windows.
+class TFileCacheWriteFlusher {
+public:
+   void Start(const char *, Long64_t, Int_t) {}
+   Int_t Wait() { return 0; }
+};
+} // namespace Internal
+} // namespace ROOT
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor.
 
@@ -42,6 +165,10 @@ TFileCacheWrite::TFileCacheWrite() : TObject()
    fFile        = 0;
    fBuffer      = 0;
    fRecursive   = kFALSE;
+   fFlushBuffer = 0;
+   fFlushSeek   = 0;
+   fFlushNtot   = 0;
+   fFlusher     = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,8 +187,13 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
    fFile        = file;
    fRecursive   = kFALSE;
    fBuffer      = new char[fBufferSize];
+   fFlushBuffer = 0;
+   fFlushSeek   = 0;
+   fFlushNtot   = 0;
+   fFlusher     = 0;
    if (file) file->SetCacheWrite(this);
    if (gDebug > 0) Info("TFileCacheWrite","Creating a write cache with buffersize=%d bytes",buffersize);
+   if (gEnv->GetValue("TFile.AsyncWriting", 0)) SetAsyncWriting(kTRUE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -69,6 +201,7 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
 
 TFileCacheWrite::~TFileCacheWrite()
 {
+   SetAsyncWriting(kFALSE);
    delete [] fBuffer;
 }
 
@@ -78,6 +211,7 @@ TFileCacheWrite::~TFileCacheWrite()
 
 Bool_t TFileCacheWrite::Flush()
 {
+   if (WaitFlush()) return kTRUE;
    if (!fNtot) return kFALSE;
    fFile->Seek(fSeekStart);
    //printf("Flushing buffer at fSeekStart=%lld, fNtot=%d\n",fSeekStart,fNtot);
@@ -96,6 +230,8 @@ void TFileCacheWrite::Print(Option_t *option) const
    TString opt = option;
    printf("Write cache for file %s\n",fFile->GetName());
    printf("Size of write cache: %d bytes to be written at %lld\n",fNtot,fSeekStart);
+   if (fFlusher)
+      printf("Asynchronous writing: %d bytes being written at %lld\n",fFlushNtot,fFlushSeek);
    opt.ToLower();
 }
 
@@ -107,6 +243,15 @@ void TFileCacheWrite::Print(Option_t *option) const
 
 Int_t TFileCacheWrite::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 {
+   if (fFlushNtot && pos < fFlushSeek+fFlushNtot && pos+len > fFlushSeek) {
+      // The data is (partially) in the buffer being written; the buffer is
+      // not modified while in flight, so it can be read from.
+      if (pos >= fFlushSeek && pos+len <= fFlushSeek+fFlushNtot) {
+         memcpy(buf,fFlushBuffer+pos-fFlushSeek,len);
+         return 0;
+      }
+      if (WaitFlush()) return -1;
+   }
    if (pos < fSeekStart || pos+len > fSeekStart+fNtot) return -1;
    memcpy(buf,fBuffer+pos-fSeekStart,len);
    return 0;
@@ -126,12 +271,13 @@ Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 
    if (fSeekStart + fNtot != pos) {
       //we must flush the current cache
-      if (Flush()) return -1; //failure
+      if (FlushAsync()) return -1; //failure
    }
    if (fNtot + len >= fBufferSize) {
-      if (Flush()) return -1; //failure
+      if (FlushAsync()) return -1; //failure
       if (len >= fBufferSize) {
          //buffer larger than the cache itself: direct write to file
+         if (WaitFlush()) return -1; //keep the order of the writes
          fRecursive = kTRUE;
          fFile->Seek(pos); // Flush may have changed this
          if (fFile->WriteBuffer(buf,len)) return -1;  // failure
@@ -152,5 +298,86 @@ Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 
 void TFileCacheWrite::SetFile(TFile *file)
 {
+   Bool_t async = IsAsyncWriting();
+   SetAsyncWriting(kFALSE);
    fFile = file;
+   if (async) SetAsyncWriting(kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the writing of full buffers in a background thread.
+///
+/// When enabled, a second buffer of the same size is allocated: once the
+/// current buffer is full (or a non contiguous write is requested), it is
+/// handed over to a background thread writing it to the file, while the
+/// following writes go to the other buffer. Flush() still returns only once
+/// all the data has been written.
+///
+/// This is only supported for local files (plain TFile) on POSIX systems.
+/// Returns kTRUE if asynchronous writing is enabled after the call.
+
+Bool_t TFileCacheWrite::SetAsyncWriting(Bool_t async)
+{
+#ifndef WIN32
+   if (async) {
+      if (fFlusher) return kTRUE;
+      if (!fFile || fFile->IsA() != TFile::Class() || fFile->GetArchiveOffset() || fFile->GetFd() < 0) {
+         if (gDebug > 0) Info("SetAsyncWriting", "asynchronous writing is only supported for local files");
+         return kFALSE;
+      }
+      fFlushBuffer = new char[fBufferSize];
+      fFlusher = new ROOT::Internal::TFileCacheWriteFlusher(fFile->GetFd());
+      return kTRUE;
+   }
+#endif
+   if (fFlusher) {
+      WaitFlush();
+      delete fFlusher;
+      fFlusher = 0;
+      delete [] fFlushBuffer;
+      fFlushBuffer = 0;
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hand the current buffer over to the background writer and continue with
+/// the other one. Falls back to Flush() if asynchronous writing is disabled.
+/// Returns kTRUE in case of error.
+
+Bool_t TFileCacheWrite::FlushAsync()
+{
+   if (!fFlusher) return Flush();
+   if (!fNtot) return kFALSE;
+   if (WaitFlush()) return kTRUE;
+   char *buffer = fFlushBuffer;
+   fFlushBuffer = fBuffer;
+   fBuffer = buffer;
+   fFlushSeek = fSeekStart;
+   fFlushNtot = fNtot;
+   fNtot = 0;
+   fFlusher->Start(fFlushBuffer, fFlushSeek, fFlushNtot);
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the buffer being written in the background, if any, and update
+/// the statistics of the file.
+/// Returns kTRUE in case of error.
+
+Bool_t TFileCacheWrite::WaitFlush()
+{
+   if (!fFlusher || !fFlushNtot) return kFALSE;
+   Int_t err = fFlusher->Wait();
+   Int_t nbytes = fFlushNtot;
+   fFlushNtot = 0;
+   if (err) {
+      fFile->SetBit(TFile::kWriteError);
+      fFile->SetWritable(kFALSE);
+      Error("WaitFlush", "error writing to file %s: %s", fFile->GetName(), strerror(err));
+      return kTRUE;
+   }
+   fFile->fBytesWrite += nbytes;
+   TFile::fgBytesWrite += nbytes;
+   return kFALSE;
 }
@@ -0,0 +1,241 @@
+#include "TEnv.h"
+#include "TError.h"
+#include "TFile.h"
+#include "TFileCacheWrite.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+#include "gtest/gtest.h"
+
+// The raw writes go well beyond the ROOT structures of the test files (header, keys, streamer info)
+static const Long64_t kRawOffset = 1000000;
+static const Int_t kCacheSize = 100000;
+
+static char PatternByte(Long64_t pos)
+{
+   return (char)((pos * 7 + pos / 251) & 0xFF);
+}
+
+// Writes (position, length) of the tests: small contiguous writes filling several cache
+// buffers, a non contiguous write, a write larger than the cache (written directly)
+// and again small writes
+static std::vector<std::pair<Long64_t, Int_t>> WriteSequence()
+{
+   std::vector<std::pair<Long64_t, Int_t>> seq;
+   Long64_t pos = kRawOffset;
+   for (Int_t i = 0; i < 200; ++i) {
+      const Int_t len = 1000 + (i * 37) % 3000;
+      seq.emplace_back(pos, len);
+      pos += len;
+   }
+   pos += 5000;
+   for (Int_t i = 0; i < 50; ++i) {
+      const Int_t len = 500 + (i * 53) % 2000;
+      seq.emplace_back(pos, len);
+      pos += len;
+   }
+   seq.emplace_back(pos, 3 * kCacheSize);
+   pos += 3 * kCacheSize;
+   for (Int_t i = 0; i < 100; ++i) {
+      const Int_t len = 100 + (i * 71) % 4000;
+      seq.emplace_back(pos, len);
+      pos += len;
+   }
+   return seq;
+}
+
+// Write the sequence through the write cache of the file. The previous write is read back
+// after each write: it is either in the current buffer, in the buffer being written in the
+// background, or already in the file.
+static void WriteRaw(TFile *f, const std::vector<std::pair<Long64_t, Int_t>> &seq)
+{
+   std::vector<char> buf, check;
+   for (size_t i = 0; i < seq.size(); ++i) {
+      const Long64_t pos = seq[i].first;
+      const Int_t len = seq[i].second;
+      buf.resize(len);
+      for (Int_t j = 0; j < len; ++j)
+         buf[j] = PatternByte(pos + j);
+      f->Seek(pos);
+      ASSERT_FALSE(f->WriteBuffer(buf.data(), len)) << "write " << i;
+
+      if (i == 0)
+         continue;
+      const Long64_t prevpos = seq[i - 1].first;
+      const Int_t prevlen = seq[i - 1].second;
+      check.resize(prevlen);
+      ASSERT_FALSE(f->ReadBuffer(check.data(), prevpos, prevlen)) << "read " << i - 1;
+      for (Int_t j = 0; j < prevlen; ++j)
+         ASSERT_EQ(PatternByte(prevpos + j), check[j]) << "read " << i - 1 << " byte " << j;
+   }
+}
+
+// Check the content of the closed file
+static void CheckRaw(const char *filename, const std::vector<std::pair<Long64_t, Int_t>> &seq)
+{
+   FILE *fp = fopen(filename, "rb");
+   ASSERT_NE(nullptr, fp);
+   std::vector<char> buf;
+   for (auto &w : seq) {
+      buf.resize(w.second);
+      ASSERT_EQ(0, fseek(fp, w.first, SEEK_SET));
+      ASSERT_EQ((size_t)w.second, fread(buf.data(), 1, w.second, fp));
+      for (Int_t j = 0; j < w.second; ++j)
+         ASSERT_EQ(PatternByte(w.first + j), buf[j]) << "position " << w.first + j;
+   }
+   fclose(fp);
+}
+
+static TFile *CreateFile(const char *filename, Bool_t async)
+{
+   TFile *f = TFile::Open(filename, "RECREATE");
+   auto cache = new TFileCacheWrite(f, kCacheSize);
+   EXPECT_EQ(async, cache->SetAsyncWriting(async));
+   EXPECT_EQ(async, cache->IsAsyncWriting());
+   return f;
+}
+
+// The buffers written in the background land in the file in the order of the writes,
+// whether the file is explicitly flushed before closing or not
+TEST(TFileCacheWrite, FlushOrdering)
+{
+   const char *filename = "tfilecachewrite_order.root";
+   const auto seq = WriteSequence();
+   Long64_t nbytes[2] = {0, 0};
+   for (Bool_t async : {kFALSE, kTRUE}) {
+      SCOPED_TRACE(async ? "asynchronous" : "synchronous");
+      TFile *f = CreateFile(filename, async);
+      WriteRaw(f, seq);
+      EXPECT_FALSE(f->GetCacheWrite()->Flush());
+      EXPECT_EQ(0, f->GetCacheWrite()->GetBytesInCache());
+      nbytes[async] = f->GetBytesWritten();
+      f->Close();
+      delete f;
+      CheckRaw(filename, seq);
+   }
+   // the background writes are accounted as the synchronous ones
+   EXPECT_EQ(nbytes[0], nbytes[1]);
+   gSystem->Unlink(filename);
+}
+
+// Closing or deleting the file while a buffer is being written in the background
+TEST(TFileCacheWrite, CloseDuringWrite)
+{
+   const char *filename = "tfilecachewrite_close.root";
+   const auto seq = WriteSequence();
+
+   TFile *f = CreateFile(filename, kTRUE);
+   WriteRaw(f, seq);
+   f->Close();
+   EXPECT_FALSE(f->GetCacheWrite()->IsAsyncWriting());
+   delete f;
+   CheckRaw(filename, seq);
+
+   f = CreateFile(filename, kTRUE);
+   WriteRaw(f, seq);
+   delete f;
+   CheckRaw(filename, seq);
+
+   gSystem->Unlink(filename);
+}
+
+// A tree written with TFile.AsyncWriting enabled reads back as written
+TEST(TFileCacheWrite, TreeRoundTrip)
+{
+   const char *filename = "tfilecachewrite_tree.root";
+   const Int_t nentries = 100000;
+   const Int_t asyncWriting = gEnv->GetValue("TFile.AsyncWriting", 0);
+   gEnv->SetValue("TFile.AsyncWriting", 1);
+   {
+      std::unique_ptr<TFile> f(TFile::Open(filename, "RECREATE"));
+      ASSERT_NE(nullptr, f->GetCacheWrite());
+      EXPECT_TRUE(f->GetCacheWrite()->IsAsyncWriting());
+      TTree t("T", "async writing");
+      Int_t i = 0;
+      Double_t x = 0;
+      t.Branch("i", &i, "i/I", 8000);
+      t.Branch("x", &x, "x/D", 8000);
+      for (i = 0; i < nentries; ++i) {
+         x = 0.5 * i;
+         t.Fill();
+      }
+      t.Write();
+   }
+   gEnv->SetValue("TFile.AsyncWriting", asyncWriting);
+
+   std::unique_ptr<TFile> f(TFile::Open(filename));
+   ASSERT_TRUE(f && !f->IsZombie());
+   TTree *t = nullptr;
+   f->GetObject("T", t);
+   ASSERT_NE(nullptr, t);
+   ASSERT_EQ(nentries, t->GetEntries());
+   Int_t i = -1;
+   Double_t x = -1;
+   t->SetBranchAddress("i", &i);
+   t->SetBranchAddress("x", &x);
+   for (Long64_t e = 0; e < nentries; ++e) {
+      t->GetEntry(e);
+      ASSERT_EQ(e, i);
+      ASSERT_EQ(0.5 * e, x);
+   }
+   f.reset();
+   gSystem->Unlink(filename);
+}
+
+#ifndef _WIN32
+// A failed background write is reported when it is waited for, as a failed synchronous
+// write: the file is flagged with kWriteError and is not writable anymore
+TEST(TFileCacheWrite, WriteError)
+{
+   const char *filename = "tfilecachewrite_error.root";
+   const Long64_t limit = kRawOffset + 500000;
+
+   // writes beyond the file size limit fail with EFBIG (instead of raising SIGXFSZ)
+   struct rlimit oldlimit;
+   ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &oldlimit));
+   ASSERT_TRUE(oldlimit.rlim_cur == RLIM_INFINITY || (Long64_t)oldlimit.rlim_cur > limit);
+   auto oldhandler = signal(SIGXFSZ, SIG_IGN);
+   const Int_t level = gErrorIgnoreLevel;
+
+   for (Bool_t async : {kFALSE, kTRUE}) {
+      SCOPED_TRACE(async ? "asynchronous" : "synchronous");
+      TFile *f = CreateFile(filename, async);
+      struct rlimit newlimit = oldlimit;
+      newlimit.rlim_cur = limit;
+      ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &newlimit));
+      gErrorIgnoreLevel = kFatal;
+
+      // the first buffer is beyond the limit; the non contiguous write hands it over
+      // to the background writer (asynchronous) or writes it (synchronous)
+      std::vector<char> buf(30000, 'x');
+      Bool_t error = kFALSE;
+      f->Seek(limit + 100000);
+      error |= f->WriteBuffer(buf.data(), (Int_t)buf.size());
+      f->Seek(limit + 200000);
+      error |= f->WriteBuffer(buf.data(), (Int_t)buf.size());
+      if (f->IsWritable())
+         error |= f->GetCacheWrite()->Flush();
+
+      EXPECT_TRUE(error);
+      EXPECT_TRUE(f->TestBit(TFile::kWriteError));
+      EXPECT_FALSE(f->IsWritable());
+      f->Close();
+      delete f;
+
+      gErrorIgnoreLevel = level;
+      ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &oldlimit));
+      gSystem->Unlink(filename);
+   }
+   signal(SIGXFSZ, oldhandler);
+}
+#endif
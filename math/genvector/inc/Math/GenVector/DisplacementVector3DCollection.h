@@ -0,0 +1,312 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for class DisplacementVector3DCollection
+
+#ifndef ROOT_Math_GenVector_DisplacementVector3DCollection
+#define ROOT_Math_GenVector_DisplacementVector3DCollection  1
+
+#include "Math/GenVector/DisplacementVector3D.h"
+#include "Math/GenVector/Cartesian3D.h"
+#include "Math/GenVector/CylindricalEta3D.h"
+#include "Math/GenVector/FastMath.h"
+#include "Math/GenVector/eta.h"
+#include "Math/GenVector/etaMax.h"
+#include "Math/Math.h"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace ROOT {
+
+  namespace Math {
+
+     template <class CoordSystem, class Tag = DefaultCoordinateSystemTag >
+     class DisplacementVector3DCollection;
+
+     namespace Impl {
+
+    /**
+       Kernels of the vector collections: loops over arrays of coordinates, without
+       function calls other than the mathematical functions (see FastMath.h),
+       which can be vectorized by the compiler.
+       They give the same results as the corresponding functions of the coordinate systems
+       (e.g. PtEtaPhiM4D::Pz() or Cartesian3D::Eta()) for all values, including the
+       special cases (rho = 0).
+    */
+
+        /// compute x, y, z (and the magnitude p if not null) from rho, eta and phi
+        template<typename Scalar>
+        void XYZFromRhoEtaPhi(size_t n, const Scalar * rho, const Scalar * eta, const Scalar * phi,
+                              Scalar * x, Scalar * y, Scalar * z, Scalar * p = 0) {
+           const Scalar emax = etaMax<Scalar>();
+           for (size_t i = 0; i < n; ++i) {
+              Scalar s, c, sh, ch;
+              FastSinCos(phi[i], s, c);
+              FastSinhCosh(eta[i], sh, ch);
+              const Scalar r = rho[i];
+              const Scalar e = eta[i];
+              x[i] = r * c;
+              y[i] = r * s;
+              z[i] = r > 0 ? r * sh : e == 0 ? 0 : e > 0 ? e - emax : e + emax;
+              if (p) p[i] = r > 0 ? r * ch : e > emax ? e - emax : e < -emax ? -e - emax : 0;
+           }
+        }
+
+        /// compute rho, eta and phi from x, y, z (see Eta_FromRhoZ)
+        template<typename Scalar>
+        void RhoEtaPhiFromXYZ(size_t n, const Scalar * x, const Scalar * y, const Scalar * z,
+                              Scalar * rho, Scalar * eta, Scalar * phi) {
+           const Scalar emax = etaMax<Scalar>();
+           const Scalar bigZScaled = std::pow(std::numeric_limits<Scalar>::epsilon(), static_cast<Scalar>(-.25));
+           for (size_t i = 0; i < n; ++i) {
+              const Scalar r = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+              rho[i] = r;
+              phi[i] = (x[i] == Scalar(0) && y[i] == Scalar(0)) ? Scalar(0) : FastAtan2(y[i], x[i]);
+              // the argument of the logarithm and its sign, to compute a single logarithm
+              const Scalar zs = z[i] / (r > 0 ? r : Scalar(1));
+              const bool small = std::fabs(zs) < bigZScaled;
+              const Scalar arg = small ? zs + std::sqrt(zs * zs + Scalar(1))
+                                       : (z[i] > 0 ? Scalar(2) * zs + Scalar(0.5) / zs : -Scalar(2) * zs);
+              const Scalar etaRho = (small || z[i] > 0) ? FastLog(arg) : -FastLog(arg);
+              eta[i] = r > 0 ? etaRho : z[i] == 0 ? Scalar(0) : z[i] > 0 ? z[i] + emax : z[i] - emax;
+           }
+        }
+
+        /// compute Delta R between the vectors i of two collections (see VectorUtil::DeltaR)
+        template<typename Scalar>
+        void DeltaRKernel(size_t n, const Scalar * eta1, const Scalar * phi1, const Scalar * eta2, const Scalar * phi2,
+                          Scalar * result) {
+           for (size_t i = 0; i < n; ++i) {
+              Scalar dphi = phi2[i] - phi1[i];
+              dphi = dphi > M_PI ? dphi - Scalar(2.0 * M_PI) : dphi <= -M_PI ? dphi + Scalar(2.0 * M_PI) : dphi;
+              const Scalar deta = eta2[i] - eta1[i];
+              result[i] = std::sqrt(dphi * dphi + deta * deta);
+           }
+        }
+
+        /// compute Delta R between all the pairs of vectors (i, j) of two collections,
+        /// result[i * n2 + j] is the value for the pair (i, j)
+        template<typename Scalar>
+        void DeltaRPairsKernel(size_t n1, const Scalar * eta1, const Scalar * phi1,
+                               size_t n2, const Scalar * eta2, const Scalar * phi2, Scalar * result) {
+           for (size_t i = 0; i < n1; ++i) {
+              const Scalar e1 = eta1[i];
+              const Scalar p1 = phi1[i];
+              Scalar * row = result + i * n2;
+              for (size_t j = 0; j < n2; ++j) {
+                 Scalar dphi = phi2[j] - p1;
+                 dphi = dphi > M_PI ? dphi - Scalar(2.0 * M_PI) : dphi <= -M_PI ? dphi + Scalar(2.0 * M_PI) : dphi;
+                 const Scalar deta = eta2[j] - e1;
+                 row[j] = std::sqrt(dphi * dphi + deta * deta);
+              }
+           }
+        }
+
+        /// generic conversion of a collection, vector by vector
+        template <class Coords1, class Coords2, class Tag>
+        void ConvertCollection(const DisplacementVector3DCollection<Coords1, Tag> & v1,
+                               DisplacementVector3DCollection<Coords2, Tag> & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           for (size_t i = 0; i < n; ++i) v2.Set(i, v1[i]);
+        }
+
+        /// conversion of a collection from CylindricalEta3D to Cartesian3D coordinates
+        template <class T, class Tag>
+        void ConvertCollection(const DisplacementVector3DCollection<CylindricalEta3D<T>, Tag> & v1,
+                               DisplacementVector3DCollection<Cartesian3D<T>, Tag> & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           XYZFromRhoEtaPhi(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2));
+        }
+
+        /// conversion of a collection from Cartesian3D to CylindricalEta3D coordinates
+        template <class T, class Tag>
+        void ConvertCollection(const DisplacementVector3DCollection<Cartesian3D<T>, Tag> & v1,
+                               DisplacementVector3DCollection<CylindricalEta3D<T>, Tag> & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           RhoEtaPhiFromXYZ(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2));
+           // adjustment of rho for very large eta, as in the constructor of CylindricalEta3D
+           static const T bigEta = T(-0.3) * std::log(std::numeric_limits<T>::epsilon());
+           const T * eta = v2.Coordinates(1);
+           for (size_t i = 0; i < n; ++i) {
+              if (std::fabs(eta[i]) > bigEta) v2.Set(i, v1[i]);
+           }
+        }
+
+     } // end namespace Impl
+
+
+//__________________________________________________________________________________________
+    /**
+     Collection of displacement vectors in 3 dimensions, DisplacementVector3D<CoordSystem, Tag>,
+     stored as a structure of arrays: the three coordinates of the coordinate system
+     (e.g. x, y, z for Cartesian3D or rho, eta, phi for CylindricalEta3D) are each stored in
+     a contiguous array, so that the loops over the collection (the conversions between coordinate
+     systems and the functions of VectorUtil taking collections) can be vectorized.
+
+     The conversions between Cartesian3D and CylindricalEta3D are computed with the functions
+     of FastMath.h, the other ones vector by vector.
+
+     @ingroup GenVector
+    */
+    template <class CoordSystem, class Tag >
+    class DisplacementVector3DCollection {
+
+    public:
+
+       typedef typename CoordSystem::Scalar Scalar;
+       typedef CoordSystem CoordinateType;
+       typedef Tag  CoordinateSystemTag;
+       typedef DisplacementVector3D<CoordSystem, Tag> value_type;
+
+       /**
+          Default constructor: an empty collection
+       */
+       DisplacementVector3DCollection() {}
+
+       /**
+          Construct a collection of n null vectors
+       */
+       explicit DisplacementVector3DCollection(size_t n) { resize(n); }
+
+       /**
+          Construct from a collection using another coordinate system
+       */
+       template <class OtherCoords>
+       explicit DisplacementVector3DCollection(const DisplacementVector3DCollection<OtherCoords, Tag> & v) {
+          Impl::ConvertCollection(v, *this);
+       }
+
+       /**
+          Assign from a collection using another coordinate system
+       */
+       template <class OtherCoords>
+       DisplacementVector3DCollection & operator=(const DisplacementVector3DCollection<OtherCoords, Tag> & v) {
+          Impl::ConvertCollection(v, *this);
+          return *this;
+       }
+
+       /// number of vectors
+       size_t size() const { return fCoord[0].size(); }
+
+       /// true if the collection is empty
+       bool empty() const { return fCoord[0].empty(); }
+
+       /// change the number of vectors, the new ones are null vectors
+       void resize(size_t n) {
+          for (unsigned int k = 0; k < 3; ++k) fCoord[k].resize(n, Scalar(0));
+       }
+
+       /// reserve the memory for n vectors
+       void reserve(size_t n) {
+          for (unsigned int k = 0; k < 3; ++k) fCoord[k].reserve(n);
+       }
+
+       /// remove all vectors
+       void clear() {
+          for (unsigned int k = 0; k < 3; ++k) fCoord[k].clear();
+       }
+
+       /// return the vector i
+       value_type operator[](size_t i) const { return value_type(fCoord[0][i], fCoord[1][i], fCoord[2][i]); }
+
+       /// set the vector i, converting it to the coordinate system of the collection
+       template <class OtherCoords>
+       void Set(size_t i, const DisplacementVector3D<OtherCoords, Tag> & v) {
+          value_type w(v);
+          w.GetCoordinates(fCoord[0][i], fCoord[1][i], fCoord[2][i]);
+       }
+
+       /// add a vector at the end, converting it to the coordinate system of the collection
+       template <class OtherCoords>
+       void push_back(const DisplacementVector3D<OtherCoords, Tag> & v) {
+          value_type w(v);
+          for (unsigned int k = 0; k < 3; ++k) fCoord[k].push_back(Scalar(0));
+          w.GetCoordinates(fCoord[0].back(), fCoord[1].back(), fCoord[2].back());
+       }
+
+       /**
+          Array of the coordinate k (0, 1 or 2) of all vectors, in the order of the
+          coordinate system (e.g. rho, eta, phi for CylindricalEta3D).
+          The values written in the array are not checked (e.g. phi is not restricted to (-pi, pi])
+       */
+       const Scalar * Coordinates(unsigned int k) const { return fCoord[k].data(); }
+       Scalar * Coordinates(unsigned int k) { return fCoord[k].data(); }
+
+    private:
+
+       std::vector<Scalar> fCoord[3];  // arrays of the coordinates
+
+    };
+
+
+     namespace Impl {
+
+        /// pointers to the eta and phi arrays of a collection, converted to CylindricalEta3D if needed
+        template <class T, class Tag>
+        struct EtaPhiArrays3D {
+           explicit EtaPhiArrays3D(const DisplacementVector3DCollection<CylindricalEta3D<T>, Tag> & v) :
+              fEta(v.Coordinates(1)), fPhi(v.Coordinates(2)) {}
+           template <class Coords>
+           explicit EtaPhiArrays3D(const DisplacementVector3DCollection<Coords, Tag> & v) :
+              fConverted(v), fEta(fConverted.Coordinates(1)), fPhi(fConverted.Coordinates(2)) {}
+
+           DisplacementVector3DCollection<CylindricalEta3D<T>, Tag> fConverted;
+           const T * fEta;
+           const T * fPhi;
+        };
+
+     } // end namespace Impl
+
+
+     namespace VectorUtil {
+
+        /**
+           Compute Delta R (see VectorUtil::DeltaR) between the vectors with the same index of
+           two collections of the same size. result must have v1.size() elements.
+        */
+        template <class Coords1, class Coords2, class Tag>
+        void DeltaR(const DisplacementVector3DCollection<Coords1, Tag> & v1,
+                    const DisplacementVector3DCollection<Coords2, Tag> & v2,
+                    typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::EtaPhiArrays3D<Scalar, Tag> a1(v1);
+           Impl::EtaPhiArrays3D<Scalar, Tag> a2(v2);
+           Impl::DeltaRKernel(v1.size(), a1.fEta, a1.fPhi, a2.fEta, a2.fPhi, result);
+        }
+
+        /**
+           Compute Delta R between all the pairs of vectors of two collections.
+           result must have v1.size() * v2.size() elements, result[i * v2.size() + j] is
+           the Delta R between v1[i] and v2[j].
+        */
+        template <class Coords1, class Coords2, class Tag>
+        void DeltaRPairs(const DisplacementVector3DCollection<Coords1, Tag> & v1,
+                         const DisplacementVector3DCollection<Coords2, Tag> & v2,
+                         typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::EtaPhiArrays3D<Scalar, Tag> a1(v1);
+           Impl::EtaPhiArrays3D<Scalar, Tag> a2(v2);
+           Impl::DeltaRPairsKernel(v1.size(), a1.fEta, a1.fPhi, v2.size(), a2.fEta, a2.fPhi, result);
+        }
+
+     } // end namespace VectorUtil
+
+  } // namespace Math
+
+} // namespace ROOT
+
+#endif /* ROOT_Math_GenVector_DisplacementVector3DCollection */
@@ -0,0 +1,89 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the mathematical functions used in the loops over
+// the vector collections (see LorentzVectorCollection)
+
+#ifndef ROOT_Math_GenVector_FastMath
+#define ROOT_Math_GenVector_FastMath  1
+
+#include "RConfigure.h"
+
+#include <cmath>
+
+#ifdef R__HAS_VDT
+#include "vdt/exp.h"
+#include "vdt/log.h"
+#include "vdt/sincos.h"
+#include "vdt/atan2.h"
+#endif
+
+namespace ROOT {
+
+  namespace Math {
+
+     namespace Impl {
+
+    /**
+       Mathematical functions used in the loops over the elements of the vector collections.
+       When ROOT is built with its own VDT (option builtin_vdt) the inlined and vectorizable VDT functions are used,
+       whose precision is of a few units in the last place; otherwise the functions of the
+       standard library are used, giving the same results as the single vector classes.
+    */
+
+#ifdef R__HAS_VDT
+        inline double FastExp(double x) { return vdt::fast_exp(x); }
+        inline float  FastExp(float x)  { return vdt::fast_expf(x); }
+
+        inline double FastLog(double x) { return vdt::fast_log(x); }
+        inline float  FastLog(float x)  { return vdt::fast_logf(x); }
+
+        inline double FastAtan2(double y, double x) { return vdt::fast_atan2(y, x); }
+        inline float  FastAtan2(float y, float x)   { return vdt::fast_atan2f(y, x); }
+
+        inline void FastSinCos(double x, double & s, double & c) { vdt::fast_sincos(x, s, c); }
+        inline void FastSinCos(float x, float & s, float & c)    { vdt::fast_sincosf(x, s, c); }
+
+        template<typename Scalar>
+        inline void FastSinhCosh(Scalar x, Scalar & sh, Scalar & ch) {
+           const Scalar ex = FastExp(x);
+           const Scalar emx = Scalar(1) / ex;
+           sh = Scalar(0.5) * (ex - emx);
+           ch = Scalar(0.5) * (ex + emx);
+        }
+#else
+        template<typename Scalar>
+        inline Scalar FastExp(Scalar x) { return std::exp(x); }
+
+        template<typename Scalar>
+        inline Scalar FastLog(Scalar x) { return std::log(x); }
+
+        template<typename Scalar>
+        inline Scalar FastAtan2(Scalar y, Scalar x) { return std::atan2(y, x); }
+
+        template<typename Scalar>
+        inline void FastSinCos(Scalar x, Scalar & s, Scalar & c) {
+           s = std::sin(x);
+           c = std::cos(x);
+        }
+
+        template<typename Scalar>
+        inline void FastSinhCosh(Scalar x, Scalar & sh, Scalar & ch) {
+           sh = std::sinh(x);
+           ch = std::cosh(x);
+        }
+#endif
+
+     } // end namespace Impl
+
+  } // namespace Math
+
+} // namespace ROOT
+
+#endif /* ROOT_Math_GenVector_FastMath */
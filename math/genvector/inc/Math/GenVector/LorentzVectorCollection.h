@@ -0,0 +1,408 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for class LorentzVectorCollection
+
+#ifndef ROOT_Math_GenVector_LorentzVectorCollection
+#define ROOT_Math_GenVector_LorentzVectorCollection  1
+
+#include "Math/GenVector/LorentzVector.h"
+#include "Math/GenVector/PxPyPzE4D.h"
+#include "Math/GenVector/PtEtaPhiE4D.h"
+#include "Math/GenVector/PtEtaPhiM4D.h"
+#include "Math/GenVector/DisplacementVector3DCollection.h"
+#include "Math/GenVector/GenVector_exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace ROOT {
+
+  namespace Math {
+
+     template <class CoordSystem >
+     class LorentzVectorCollection;
+
+     namespace Impl {
+
+        /// compute the energy from the magnitude of the momentum and the mass (see PtEtaPhiM4D::E)
+        template<typename Scalar>
+        void EFromPM(size_t n, const Scalar * p, const Scalar * m, Scalar * e) {
+           for (size_t i = 0; i < n; ++i) {
+              const Scalar e2 = p[i] * p[i] + (m[i] >= 0 ? m[i] * m[i] : -m[i] * m[i]);
+              e[i] = std::sqrt(e2 > 0 ? e2 : Scalar(0));
+           }
+        }
+
+        /// compute the mass from the momentum and the energy (see PxPyPzE4D::M).
+        /// Return the number of tachyonic vectors, for which the mass is negative
+        template<typename Scalar>
+        size_t MFromXYZE(size_t n, const Scalar * x, const Scalar * y, const Scalar * z, const Scalar * e,
+                         Scalar * m) {
+           size_t nTachyons = 0;
+           for (size_t i = 0; i < n; ++i) {
+              const Scalar mm = e[i] * e[i] - x[i] * x[i] - y[i] * y[i] - z[i] * z[i];
+              const Scalar am = std::sqrt(std::fabs(mm));
+              m[i] = mm >= 0 ? am : -am;
+              nTachyons += mm < 0;
+           }
+           return nTachyons;
+        }
+
+        /// compute the invariant mass of the sum of the vectors i of two collections
+        /// (see VectorUtil::InvariantMass)
+        template<typename Scalar>
+        void InvariantMassKernel(size_t n, const Scalar * x1, const Scalar * y1, const Scalar * z1, const Scalar * e1,
+                                 const Scalar * x2, const Scalar * y2, const Scalar * z2, const Scalar * e2,
+                                 Scalar * result) {
+           for (size_t i = 0; i < n; ++i) {
+              const Scalar ee = e1[i] + e2[i];
+              const Scalar xx = x1[i] + x2[i];
+              const Scalar yy = y1[i] + y2[i];
+              const Scalar zz = z1[i] + z2[i];
+              const Scalar mm2 = ee * ee - xx * xx - yy * yy - zz * zz;
+              const Scalar am = std::sqrt(std::fabs(mm2));
+              result[i] = mm2 < 0 ? -am : am;
+           }
+        }
+
+        /// compute the invariant mass of all the pairs of vectors (i, j) of two collections,
+        /// result[i * n2 + j] is the value for the pair (i, j)
+        template<typename Scalar>
+        void InvariantMassPairsKernel(size_t n1, const Scalar * x1, const Scalar * y1, const Scalar * z1,
+                                      const Scalar * e1, size_t n2, const Scalar * x2, const Scalar * y2,
+                                      const Scalar * z2, const Scalar * e2, Scalar * result) {
+           for (size_t i = 0; i < n1; ++i) {
+              const Scalar xi = x1[i], yi = y1[i], zi = z1[i], ei = e1[i];
+              Scalar * row = result + i * n2;
+              for (size_t j = 0; j < n2; ++j) {
+                 const Scalar ee = ei + e2[j];
+                 const Scalar xx = xi + x2[j];
+                 const Scalar yy = yi + y2[j];
+                 const Scalar zz = zi + z2[j];
+                 const Scalar mm2 = ee * ee - xx * xx - yy * yy - zz * zz;
+                 const Scalar am = std::sqrt(std::fabs(mm2));
+                 row[j] = mm2 < 0 ? -am : am;
+              }
+           }
+        }
+
+        /// boost the vectors (x, y, z, t) by the velocity (bx, by, bz) (see VectorUtil::boost),
+        /// the results can be written in the input arrays
+        template<typename Scalar>
+        void BoostKernel(size_t n, const Scalar * x, const Scalar * y, const Scalar * z, const Scalar * t,
+                         Scalar bx, Scalar by, Scalar bz, Scalar * x2, Scalar * y2, Scalar * z2, Scalar * t2) {
+           const Scalar b2 = bx * bx + by * by + bz * bz;
+           const Scalar gamma = Scalar(1) / std::sqrt(Scalar(1) - b2);
+           const Scalar gamma2 = b2 > 0 ? (gamma - Scalar(1)) / b2 : Scalar(0);
+           for (size_t i = 0; i < n; ++i) {
+              const Scalar bp = bx * x[i] + by * y[i] + bz * z[i];
+              const Scalar ti = t[i];
+              x2[i] = x[i] + gamma2 * bp * bx + gamma * bx * ti;
+              y2[i] = y[i] + gamma2 * bp * by + gamma * by * ti;
+              z2[i] = z[i] + gamma2 * bp * bz + gamma * bz * ti;
+              t2[i] = gamma * (ti + bp);
+           }
+        }
+
+        /// generic conversion of a collection, vector by vector
+        template <class Coords1, class Coords2>
+        void ConvertCollection(const LorentzVectorCollection<Coords1> & v1, LorentzVectorCollection<Coords2> & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           for (size_t i = 0; i < n; ++i) v2.Set(i, v1[i]);
+        }
+
+        /// conversion of a collection from PtEtaPhiM4D to PxPyPzE4D coordinates
+        template <class T>
+        void ConvertCollection(const LorentzVectorCollection<PtEtaPhiM4D<T> > & v1,
+                               LorentzVectorCollection<PxPyPzE4D<T> > & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           // the energy array is used to store the magnitude of the momentum
+           XYZFromRhoEtaPhi(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2), v2.Coordinates(3));
+           EFromPM(n, v2.Coordinates(3), v1.Coordinates(3), v2.Coordinates(3));
+        }
+
+        /// conversion of a collection from PtEtaPhiE4D to PxPyPzE4D coordinates
+        template <class T>
+        void ConvertCollection(const LorentzVectorCollection<PtEtaPhiE4D<T> > & v1,
+                               LorentzVectorCollection<PxPyPzE4D<T> > & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           XYZFromRhoEtaPhi(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2));
+           std::copy(v1.Coordinates(3), v1.Coordinates(3) + n, v2.Coordinates(3));
+        }
+
+        /// conversion of a collection from PxPyPzE4D to PtEtaPhiM4D coordinates
+        template <class T>
+        void ConvertCollection(const LorentzVectorCollection<PxPyPzE4D<T> > & v1,
+                               LorentzVectorCollection<PtEtaPhiM4D<T> > & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           RhoEtaPhiFromXYZ(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2));
+           const size_t nTachyons = MFromXYZE(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                                              v1.Coordinates(3), v2.Coordinates(3));
+           // report once for the whole collection, as PxPyPzE4D::M() does for each vector
+           if (nTachyons > 0)
+              GenVector::Throw("PxPyPzE4D::M() - Tachyonic:\n"
+                               "    P^2 > E^2 so the mass would be imaginary");
+        }
+
+        /// conversion of a collection from PxPyPzE4D to PtEtaPhiE4D coordinates
+        template <class T>
+        void ConvertCollection(const LorentzVectorCollection<PxPyPzE4D<T> > & v1,
+                               LorentzVectorCollection<PtEtaPhiE4D<T> > & v2) {
+           const size_t n = v1.size();
+           v2.resize(n);
+           RhoEtaPhiFromXYZ(n, v1.Coordinates(0), v1.Coordinates(1), v1.Coordinates(2),
+                            v2.Coordinates(0), v2.Coordinates(1), v2.Coordinates(2));
+           std::copy(v1.Coordinates(3), v1.Coordinates(3) + n, v2.Coordinates(3));
+        }
+
+     } // end namespace Impl
+
+
+//__________________________________________________________________________________________
+    /**
+     Collection of Lorentz vectors, LorentzVector<CoordSystem>, stored as a structure of arrays:
+     the four coordinates of the coordinate system (e.g. px, py, pz, E for PxPyPzE4D or
+     pt, eta, phi, m for PtEtaPhiM4D) are each stored in a contiguous array, so that the loops
+     over the collection (the conversions between coordinate systems and the functions of
+     VectorUtil taking collections) can be vectorized.
+
+     The conversions between PxPyPzE4D and PtEtaPhiM4D or PtEtaPhiE4D are computed with
+     the functions of FastMath.h, the other ones vector by vector.
+
+     @ingroup GenVector
+    */
+    template <class CoordSystem >
+    class LorentzVectorCollection {
+
+    public:
+
+       typedef typename CoordSystem::Scalar Scalar;
+       typedef CoordSystem CoordinateType;
+       typedef LorentzVector<CoordSystem> value_type;
+
+       /**
+          Default constructor: an empty collection
+       */
+       LorentzVectorCollection() {}
+
+       /**
+          Construct a collection of n null vectors
+       */
+       explicit LorentzVectorCollection(size_t n) { resize(n); }
+
+       /**
+          Construct from a collection using another coordinate system
+       */
+       template <class OtherCoords>
+       explicit LorentzVectorCollection(const LorentzVectorCollection<OtherCoords> & v) {
+          Impl::ConvertCollection(v, *this);
+       }
+
+       /**
+          Assign from a collection using another coordinate system
+       */
+       template <class OtherCoords>
+       LorentzVectorCollection & operator=(const LorentzVectorCollection<OtherCoords> & v) {
+          Impl::ConvertCollection(v, *this);
+          return *this;
+       }
+
+       /// number of vectors
+       size_t size() const { return fCoord[0].size(); }
+
+       /// true if the collection is empty
+       bool empty() const { return fCoord[0].empty(); }
+
+       /// change the number of vectors, the new ones are null vectors
+       void resize(size_t n) {
+          for (unsigned int k = 0; k < 4; ++k) fCoord[k].resize(n, Scalar(0));
+       }
+
+       /// reserve the memory for n vectors
+       void reserve(size_t n) {
+          for (unsigned int k = 0; k < 4; ++k) fCoord[k].reserve(n);
+       }
+
+       /// remove all vectors
+       void clear() {
+          for (unsigned int k = 0; k < 4; ++k) fCoord[k].clear();
+       }
+
+       /// return the vector i
+       value_type operator[](size_t i) const {
+          return value_type(fCoord[0][i], fCoord[1][i], fCoord[2][i], fCoord[3][i]);
+       }
+
+       /// set the vector i, converting it to the coordinate system of the collection
+       template <class OtherCoords>
+       void Set(size_t i, const LorentzVector<OtherCoords> & v) {
+          value_type w(v);
+          w.GetCoordinates(fCoord[0][i], fCoord[1][i], fCoord[2][i], fCoord[3][i]);
+       }
+
+       /// add a vector at the end, converting it to the coordinate system of the collection
+       template <class OtherCoords>
+       void push_back(const LorentzVector<OtherCoords> & v) {
+          value_type w(v);
+          for (unsigned int k = 0; k < 4; ++k) fCoord[k].push_back(Scalar(0));
+          w.GetCoordinates(fCoord[0].back(), fCoord[1].back(), fCoord[2].back(), fCoord[3].back());
+       }
+
+       /**
+          Array of the coordinate k (0 to 3) of all vectors, in the order of the
+          coordinate system (e.g. pt, eta, phi, m for PtEtaPhiM4D).
+          The values written in the array are not checked (e.g. phi is not restricted to (-pi, pi])
+       */
+       const Scalar * Coordinates(unsigned int k) const { return fCoord[k].data(); }
+       Scalar * Coordinates(unsigned int k) { return fCoord[k].data(); }
+
+    private:
+
+       std::vector<Scalar> fCoord[4];  // arrays of the coordinates
+
+    };
+
+
+     namespace Impl {
+
+        /// pointers to the eta and phi arrays of a collection, converted to PtEtaPhiE4D if needed
+        template <class T>
+        struct EtaPhiArrays {
+           explicit EtaPhiArrays(const LorentzVectorCollection<PtEtaPhiM4D<T> > & v) :
+              fEta(v.Coordinates(1)), fPhi(v.Coordinates(2)) {}
+           explicit EtaPhiArrays(const LorentzVectorCollection<PtEtaPhiE4D<T> > & v) :
+              fEta(v.Coordinates(1)), fPhi(v.Coordinates(2)) {}
+           template <class Coords>
+           explicit EtaPhiArrays(const LorentzVectorCollection<Coords> & v) :
+              fConverted(v), fEta(fConverted.Coordinates(1)), fPhi(fConverted.Coordinates(2)) {}
+
+           LorentzVectorCollection<PtEtaPhiE4D<T> > fConverted;
+           const T * fEta;
+           const T * fPhi;
+        };
+
+        /// pointers to the px, py, pz and E arrays of a collection, converted to PxPyPzE4D if needed
+        template <class T>
+        struct CartesianArrays {
+           explicit CartesianArrays(const LorentzVectorCollection<PxPyPzE4D<T> > & v) {
+              for (unsigned int k = 0; k < 4; ++k) fX[k] = v.Coordinates(k);
+           }
+           template <class Coords>
+           explicit CartesianArrays(const LorentzVectorCollection<Coords> & v) : fConverted(v) {
+              for (unsigned int k = 0; k < 4; ++k) fX[k] = fConverted.Coordinates(k);
+           }
+
+           LorentzVectorCollection<PxPyPzE4D<T> > fConverted;
+           const T * fX[4];
+        };
+
+     } // end namespace Impl
+
+
+     namespace VectorUtil {
+
+        /**
+           Compute Delta R (see VectorUtil::DeltaR) between the vectors with the same index of
+           two collections of the same size. result must have v1.size() elements.
+        */
+        template <class Coords1, class Coords2>
+        void DeltaR(const LorentzVectorCollection<Coords1> & v1, const LorentzVectorCollection<Coords2> & v2,
+                    typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::EtaPhiArrays<Scalar> a1(v1);
+           Impl::EtaPhiArrays<Scalar> a2(v2);
+           Impl::DeltaRKernel(v1.size(), a1.fEta, a1.fPhi, a2.fEta, a2.fPhi, result);
+        }
+
+        /**
+           Compute Delta R between all the pairs of vectors of two collections.
+           result must have v1.size() * v2.size() elements, result[i * v2.size() + j] is
+           the Delta R between v1[i] and v2[j].
+        */
+        template <class Coords1, class Coords2>
+        void DeltaRPairs(const LorentzVectorCollection<Coords1> & v1, const LorentzVectorCollection<Coords2> & v2,
+                         typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::EtaPhiArrays<Scalar> a1(v1);
+           Impl::EtaPhiArrays<Scalar> a2(v2);
+           Impl::DeltaRPairsKernel(v1.size(), a1.fEta, a1.fPhi, v2.size(), a2.fEta, a2.fPhi, result);
+        }
+
+        /**
+           Compute the invariant mass (see VectorUtil::InvariantMass) of the sum of the vectors with
+           the same index of two collections of the same size. result must have v1.size() elements.
+        */
+        template <class Coords1, class Coords2>
+        void InvariantMass(const LorentzVectorCollection<Coords1> & v1, const LorentzVectorCollection<Coords2> & v2,
+                           typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::CartesianArrays<Scalar> a1(v1);
+           Impl::CartesianArrays<Scalar> a2(v2);
+           Impl::InvariantMassKernel(v1.size(), a1.fX[0], a1.fX[1], a1.fX[2], a1.fX[3],
+                                     a2.fX[0], a2.fX[1], a2.fX[2], a2.fX[3], result);
+        }
+
+        /**
+           Compute the invariant mass of the sum of all the pairs of vectors of two collections.
+           result must have v1.size() * v2.size() elements, result[i * v2.size() + j] is
+           the invariant mass of v1[i] + v2[j].
+        */
+        template <class Coords1, class Coords2>
+        void InvariantMassPairs(const LorentzVectorCollection<Coords1> & v1,
+                                const LorentzVectorCollection<Coords2> & v2,
+                                typename Coords1::Scalar * result) {
+           typedef typename Coords1::Scalar Scalar;
+           Impl::CartesianArrays<Scalar> a1(v1);
+           Impl::CartesianArrays<Scalar> a2(v2);
+           Impl::InvariantMassPairsKernel(v1.size(), a1.fX[0], a1.fX[1], a1.fX[2], a1.fX[3],
+                                          v2.size(), a2.fX[0], a2.fX[1], a2.fX[2], a2.fX[3], result);
+        }
+
+        /**
+           Boost all the vectors of a collection by the velocity b (see VectorUtil::boost).
+           The result is returned in the collection out, which can be the input collection.
+           In case of a velocity b >= 1 (speed of light) GenVector::Throw is called and
+           out contains null vectors.
+        */
+        template <class Coords, class Vector, class T>
+        void boost(const LorentzVectorCollection<Coords> & v, const Vector & b,
+                   LorentzVectorCollection<PxPyPzE4D<T> > & out) {
+           const T bx = b.X();
+           const T by = b.Y();
+           const T bz = b.Z();
+           const size_t n = v.size();
+           if (bx * bx + by * by + bz * bz >= 1) {
+              GenVector::Throw("Beta Vector supplied to set Boost represents speed >= c");
+              out.clear();
+              out.resize(n);
+              return;
+           }
+           Impl::CartesianArrays<T> a(v);
+           out.resize(n);
+           Impl::BoostKernel(n, a.fX[0], a.fX[1], a.fX[2], a.fX[3], bx, by, bz,
+                             out.Coordinates(0), out.Coordinates(1), out.Coordinates(2), out.Coordinates(3));
+        }
+
+     } // end namespace VectorUtil
+
+  } // namespace Math
+
+} // namespace ROOT
+
+#endif /* ROOT_Math_GenVector_LorentzVectorCollection */
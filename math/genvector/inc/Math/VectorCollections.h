@@ -0,0 +1,54 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file defining the typedefs of the collections of vectors
+
+#ifndef ROOT_Math_VectorCollections
+#define ROOT_Math_VectorCollections  1
+
+#include "Math/Vector3D.h"
+#include "Math/Vector4D.h"
+
+#include "Math/GenVector/DisplacementVector3DCollection.h"
+#include "Math/GenVector/LorentzVectorCollection.h"
+
+namespace ROOT {
+
+  namespace Math {
+
+    /**
+       Collection of LorentzVector based on x,y,z,t (or px,py,pz,E) coordinates in double precision
+    */
+    typedef LorentzVectorCollection<PxPyPzE4D<double> > XYZTVectorCollection;
+
+    /**
+       Collection of LorentzVector based on the cylindrical coordinates pt, eta, phi and Mass in double precision
+    */
+    typedef LorentzVectorCollection<PtEtaPhiM4D<double> > PtEtaPhiMVectorCollection;
+
+    /**
+       Collection of LorentzVector based on the cylindrical coordinates pt, eta, phi and E in double precision
+    */
+    typedef LorentzVectorCollection<PtEtaPhiE4D<double> > PtEtaPhiEVectorCollection;
+
+    /**
+       Collection of 3D vectors based on the cartesian coordinates x,y,z in double precision
+    */
+    typedef DisplacementVector3DCollection<Cartesian3D<double> > XYZVectorCollection;
+
+    /**
+       Collection of 3D vectors based on the cylindrical coordinates rho, eta, phi in double precision
+    */
+    typedef DisplacementVector3DCollection<CylindricalEta3D<double> > RhoEtaPhiVectorCollection;
+
+  } // end namespace Math
+
+} // end namespace ROOT
+
+#endif
@@ -22,6 +22,7 @@
 #include "Math/LorentzRotation.h"
 
 #include "Math/VectorUtil.h"
+#include "Math/VectorCollections.h"
 #ifndef NO_SMATRIX
 #include "Math/SMatrix.h"
 #endif
@@ -780,6 +781,86 @@ int testVectorUtil() {
 
 }
 
+int testVectorCollections() {
+
+  std::cout << "testing VectorCollections \t:\t";
+   int iret = 0;
+
+   // vectors with the special cases of the coordinate conversions (pt = 0, large eta)
+   PtEtaPhiMVectorCollection c1;
+   c1.push_back(PtEtaPhiMVector(10., 1.5, 0.3, 0.105));
+   c1.push_back(PtEtaPhiMVector(25., -0.7, -2.9, 91.2));
+   c1.push_back(PtEtaPhiMVector(3., 0., 3.1, 0.));
+   c1.push_back(PtEtaPhiMVector(0., 2., 1., 1.));
+   c1.push_back(PtEtaPhiMVector(1.E-3, -12., -1., 0.5));
+   c1.push_back(XYZTVector(1., -2., 3., 10.));
+
+   XYZTVectorCollection c2(c1);
+   iret |= compare(c2.size(), c1.size(), "size");
+   for (size_t i = 0; i < c1.size(); ++i) {
+      XYZTVector v(c1[i]);
+      iret |= compare(c2[i].X(), v.X(), "x", 100);
+      iret |= compare(c2[i].Y(), v.Y(), "y", 100);
+      iret |= compare(c2[i].Z(), v.Z(), "z", 100);
+      iret |= compare(c2[i].E(), v.E(), "e", 100);
+   }
+
+   PtEtaPhiMVectorCollection c3(c2);
+   for (size_t i = 0; i < c2.size(); ++i) {
+      PtEtaPhiMVector v(c2[i]);
+      iret |= compare(c3[i].Pt(), v.Pt(), "pt", 100);
+      iret |= compare(c3[i].Eta(), v.Eta(), "eta", 100);
+      iret |= compare(c3[i].Phi(), v.Phi(), "phi", 100);
+      iret |= compare(c3[i].M(), v.M(), "m", 1.E8);
+   }
+
+   XYZVectorCollection c4;
+   c4.push_back(XYZVector(1., 2., 3.));
+   c4.push_back(XYZVector(0., 0., -5.));
+   c4.push_back(XYZVector(1.E-9, 0., 1.E3));
+   RhoEtaPhiVectorCollection c5(c4);
+   for (size_t i = 0; i < c4.size(); ++i) {
+      RhoEtaPhiVector v(c4[i]);
+      iret |= compare(c5[i].Rho(), v.Rho(), "rho", 100);
+      iret |= compare(c5[i].Eta(), v.Eta(), "eta", 100);
+      iret |= compare(c5[i].Phi(), v.Phi(), "phi", 100);
+   }
+
+   // functions of VectorUtil
+   const size_t n = c1.size();
+   std::vector<double> dr(n), mass(n), drPairs(n * n), massPairs(n * n);
+   XYZTVectorCollection c6;
+   for (size_t i = 0; i < n; ++i) c6.push_back(c1[n - 1 - i]);
+   DeltaR(c1, c6, dr.data());
+   InvariantMass(c1, c6, mass.data());
+   DeltaRPairs(c1, c6, drPairs.data());
+   InvariantMassPairs(c1, c6, massPairs.data());
+   for (size_t i = 0; i < n; ++i) {
+      iret |= compare(dr[i], DeltaR(c1[i], c6[i]), "DeltaR", 100);
+      iret |= compare(mass[i], InvariantMass(c1[i], c6[i]), "InvariantMass", 100);
+      for (size_t j = 0; j < n; ++j) {
+         iret |= compare(drPairs[i * n + j], DeltaR(c1[i], c6[j]), "DeltaRPairs", 100);
+         iret |= compare(massPairs[i * n + j], InvariantMass(c1[i], c6[j]), "InvariantMassPairs", 100);
+      }
+   }
+
+   XYZVector beta(0.1, -0.3, 0.5);
+   XYZTVectorCollection c7;
+   boost(c1, beta, c7);
+   for (size_t i = 0; i < n; ++i) {
+      XYZTVector v = boost(XYZTVector(c1[i]), beta);
+      iret |= compare(c7[i].X(), v.X(), "boost x", 100);
+      iret |= compare(c7[i].Y(), v.Y(), "boost y", 100);
+      iret |= compare(c7[i].Z(), v.Z(), "boost z", 100);
+      iret |= compare(c7[i].E(), v.E(), "boost e", 100);
+   }
+
+  if (iret == 0) std::cout << "\t\t\tOK\n";
+  else std::cout << "\t\t\t\t\t\tFAILED\n";
+  return iret;
+
+}
+
 int testGenVector() {
 
   int iret = 0;
@@ -794,6 +875,7 @@ int testGenVector() {
   iret |= testTransform3D();
 
   iret |= testVectorUtil();
+  iret |= testVectorCollections();
 
 
   if (iret !=0) std::cout << "\nTest GenVector FAILED!!!!!!!!!\n";
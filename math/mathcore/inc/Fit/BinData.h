@@ -231,6 +231,28 @@ public :
     return &fDataPtr[ipoint];
   }
 
+  /**
+    return the values of all the fit points.
+    Unless the data are wrapped, the memory is aligned and padded up to a multiple of
+    the SIMD vector size (see FitData::CoordData)
+  */
+  std::array_view<double> ValueData() const
+  {
+    return std::array_view<double>(fDataPtr, fNPoints);
+  }
+
+  /**
+    return the stored errors of all the fit points, i.e. what is returned by ErrorPtr:
+    the inverse of the errors for kValueError (when the data are not wrapped) or the errors
+    for kCoordError. An empty view is returned for kNoError and kAsymError
+  */
+  std::array_view<double> ErrorData() const
+  {
+    if ( !fDataErrorPtr )
+      return std::array_view<double>();
+    return std::array_view<double>(fDataErrorPtr, fNPoints);
+  }
+
   /**
     return error on the value for the given fit point
     Safe (but slower) method returning correctly the error on the value
@@ -494,6 +516,18 @@ public :
     return fBinEdge[icoord][ipoint];
   }
 
+  /**
+     return the upper edges of the coordinate icoord for all the bins,
+     or an empty view if the bin edges are not stored
+  */
+  std::array_view<double> BinUpEdgeData( unsigned int icoord ) const
+  {
+    assert( icoord < fDim );
+    if ( !HasBinEdges() )
+      return std::array_view<double>();
+    return std::array_view<double>(&fBinEdge[icoord].front(), fBinEdge[icoord].size());
+  }
+
   /**
      return an array containing the upper edge of the bin for coordinate i
      In case of empty bin they could be merged in a single larger bin
@@ -562,17 +596,17 @@ private:
    * Stores the data values the same way as the coordinates.
    *
   */
-  std::vector< double > fData;
+  DataVector fData;
   const double* fDataPtr;
 
-  std::vector< std::vector< double > > fCoordErrors;
+  std::vector< DataVector > fCoordErrors;
   std::vector< const double* > fCoordErrorsPtr;
   // This vector contains the coordinate errors
   // in the same way as fCoords.
 
-  std::vector< double > fDataError;
-  std::vector< double > fDataErrorHigh;
-  std::vector< double > fDataErrorLow;
+  DataVector fDataError;
+  DataVector fDataErrorHigh;
+  DataVector fDataErrorLow;
   const double*  fDataErrorPtr;
   const double*  fDataErrorHighPtr;
   const double*  fDataErrorLowPtr;
@@ -581,7 +615,7 @@ private:
 
   double* fpTmpCoordErrorVector; // not threadsafe stuff!
 
-  std::vector< std::vector< double > > fBinEdge;
+  std::vector< DataVector > fBinEdge;
   // vector containing the bin upper edge (coordinate will contain low edge)
 
   double* fpTmpBinEdgeVector; // not threadsafe stuff!
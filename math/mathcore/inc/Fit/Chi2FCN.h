@@ -148,8 +148,12 @@ private:
       this->UpdateNCalls();
       if (BaseFCN::Data().HaveCoordErrors() || BaseFCN::Data().HaveAsymErrors())
          return FitUtil::Evaluate<T>::EvalChi2Effective(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
-      else
-         return FitUtil::Evaluate<T>::EvalChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints, fExecutionPolicy);
+      else {
+         if (fExecutionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess && !fWorkers)
+            fWorkers.reset(new FitWorkerPool());
+         return FitUtil::Evaluate<T>::EvalChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints, fExecutionPolicy,
+                                               0, fWorkers.get());
+      }
    }
 
    // for derivatives
@@ -163,6 +167,7 @@ private:
 
    mutable std::vector<double> fGrad; // for derivatives
    ROOT::Fit::ExecutionPolicy fExecutionPolicy;
+   mutable std::unique_ptr<FitWorkerPool> fWorkers; // worker processes (for the kMultiprocess policy)
 
 };
 
@@ -25,10 +25,13 @@ Classes for describing the input data for fitting
 #include "Fit/DataOptions.h"
 #include "Fit/DataRange.h"
 #include "Math/Types.h"
+#include "ROOT/RArrayView.hxx"
 
 #include <vector>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
+#include <new>
 
 
 namespace ROOT {
@@ -46,6 +49,44 @@ namespace ROOT {
          }
       };
 
+      // allocator returning memory aligned to the given number of bytes (by default a cache line,
+      // which is also enough for the widest SIMD registers).
+      // It is used for the data vectors, so that they can be loaded in blocks by the vectorized fit functions
+      template <class T, std::size_t Alignment = 64>
+      struct AlignedAllocator {
+         typedef T value_type;
+
+         template <class U>
+         struct rebind {
+            typedef AlignedAllocator<U, Alignment> other;
+         };
+
+         AlignedAllocator() {}
+
+         template <class U>
+         AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+         T *allocate(std::size_t n)
+         {
+            // allocate enough space to shift the memory block and store before it the original address
+            char *raw = static_cast<char *>(::operator new(n * sizeof(T) + Alignment + sizeof(void *)));
+            std::size_t addr = reinterpret_cast<std::size_t>(raw + sizeof(void *));
+            char *aligned = raw + sizeof(void *) + (Alignment - addr % Alignment) % Alignment;
+            reinterpret_cast<void **>(aligned)[-1] = raw;
+            return reinterpret_cast<T *>(aligned);
+         }
+
+         void deallocate(T *p, std::size_t)
+         {
+            if (p) ::operator delete(reinterpret_cast<void **>(p)[-1]);
+         }
+
+         template <class U>
+         bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+         template <class U>
+         bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+      };
+
       /**
        * Base class for all the fit data types:
        * Stores the coordinates and the DataOptions
@@ -66,6 +107,9 @@ namespace ROOT {
       class FitData {
       public:
 
+         /// type of the vectors storing the data (one for each coordinate, value, error...)
+         typedef std::vector<double, AlignedAllocator<double> > DataVector;
+
          /// construct with default option and data range
          explicit FitData(unsigned int maxpoints = 0, unsigned int dim = 1);
 
@@ -289,6 +333,24 @@ namespace ROOT {
             fNPoints++;
          }
 
+         /**
+           add multi-dim coordinate data where the last coordinate is given separately
+           (used for the weights of the unbinned data)
+         */
+         void Add(const double *x, double w)
+         {
+            assert(!fWrapped);
+            assert(!fCoordsPtr.empty() && fCoordsPtr.size() == fDim);
+            assert(fNPoints < fMaxPoints);
+
+            for (unsigned int i = 0; i + 1 < fDim; i++) {
+               fCoords[i][ fNPoints ] = x[i];
+            }
+            fCoords[fDim - 1][ fNPoints ] = w;
+
+            fNPoints++;
+         }
+
          /**
            return number of fit points
          */
@@ -333,6 +395,17 @@ namespace ROOT {
             return fRange;
          }
 
+         /**
+           return the values of the coordinate icoord for all the fit points.
+           Unless the data are wrapped, the memory is aligned and it is padded up to a multiple of
+           the SIMD vector size, so that it can be loaded in blocks of ROOT::Double_v
+         */
+         std::array_view<double> CoordData(unsigned int icoord) const
+         {
+            assert(icoord < fDim);
+            return std::array_view<double>(fCoordsPtr[icoord], fNPoints);
+         }
+
          /**
            direct access to coord data ptrs
          */
@@ -409,8 +482,12 @@ namespace ROOT {
           * If fWrapped is true, fCoords is empty.
           * the data can only be accessed by using
           * fCoordsPtr.
+          *
+          * The data vectors use the AlignedAllocator. The fit data classes have no I/O
+          * support (see LinkDef3.h): they are built from the histogram, graph or tree
+          * for each fit and are not stored.
          */
-         std::vector< std::vector< double > > fCoords;
+         std::vector< DataVector > fCoords;
          std::vector< const double * > fCoordsPtr;
 
          double *fpTmpCoordVector; // non threadsafe stuff!
@@ -20,14 +20,14 @@
 #include "ROOT/TThreadExecutor.hxx"
 #endif
 
-// #include "ROOT/TProcessExecutor.hxx"
-
 #include "Fit/BinData.h"
 #include "Fit/UnBinData.h"
 #include "Fit/FitExecutionPolicy.h"
+#include "Fit/FitWorkerPool.h"
 
 #include "Math/Integrator.h"
 #include "Math/IntegratorMultiDim.h"
+#include "Math/GaussLegendreIntegrator.h"
 
 #include "TError.h"
 #include "TSystem.h"
@@ -258,6 +258,142 @@ namespace FitUtil {
      ROOT::Math::IMultiGenFunction *fFuncNDim;
   };
 
+#ifdef R__HAS_VECCORE
+  // internal class to evaluate a vectorized model function (and optionally its parameter gradient)
+  // in a SIMD vector of bins, applying the same fit options as the scalar implementation:
+  // the function is evaluated at the bin lower edge, at the bin center multiplied by the bin volume
+  // (option fBinVolume) or is averaged over the bin (option fIntegral).
+  // The average over the bin is computed with a fixed Gauss-Legendre rule (product rule in more
+  // dimensions), which can be evaluated for all the bins of a SIMD vector at the same time
+  // instead of the adaptive integration used in the scalar case
+
+  template <class T>
+  class BinFunctionEvaluator {
+
+  public:
+     // number of Gauss-Legendre points per dimension used for the bin average
+     static const unsigned int kNIntegralPoints = 8;
+
+     BinFunctionEvaluator(const BinData &data)
+        : fData(data), fNDim(data.NDim()), fUseBinIntegral(false), fUseBinVolume(false), fRefVolume(1.)
+     {
+        const DataOptions &fitOpt = data.Opt();
+        fUseBinIntegral = fitOpt.fIntegral && data.HasBinEdges();
+        fUseBinVolume = fitOpt.fBinVolume && data.HasBinEdges();
+        if (fUseBinVolume && fitOpt.fNormBinVolume)
+           fRefVolume /= data.RefVolume();
+        if (fUseBinIntegral) {
+           ROOT::Math::GaussLegendreIntegrator gl(kNIntegralPoints);
+           fXGL.resize(kNIntegralPoints);
+           fWGL.resize(kNIntegralPoints);
+           gl.GetWeightVectors(fXGL.data(), fWGL.data());
+           // the rule is defined in [-1,1]: normalize the weights to get the average in the bin
+           for (auto &w : fWGL)
+              w *= 0.5;
+        }
+     }
+
+     // evaluate the function in the bins [i * vecSize, (i+1) * vecSize)
+     T operator()(const IModelFunctionTempl<T> &func, const double *p, unsigned int i) const
+     {
+        return DoEval(func, nullptr, p, i, nullptr);
+     }
+
+     // evaluate the function and its parameter gradient in the bins [i * vecSize, (i+1) * vecSize)
+     T operator()(const IGradModelFunctionTempl<T> &func, const double *p, unsigned int i, T *grad) const
+     {
+        return DoEval(func, &func, p, i, grad);
+     }
+
+  private:
+     T DoEval(const IModelFunctionTempl<T> &func, const IGradModelFunctionTempl<T> *gfunc, const double *p,
+              unsigned int i, T *grad) const
+     {
+        const unsigned int vecSize = vecCore::VectorSize<T>();
+        const unsigned int ipoint = i * vecSize;
+        std::vector<T> x1(fNDim);
+        for (unsigned int j = 0; j < fNDim; ++j)
+           vecCore::Load<T>(x1[j], fData.GetCoordComponent(ipoint, j));
+
+        if (!fUseBinIntegral && !fUseBinVolume) {
+           if (grad)
+              gfunc->ParameterGradient(x1.data(), p, grad);
+           return func(x1.data(), p);
+        }
+
+        // the upper edges are loaded directly for a full block of bins. They are not padded,
+        // so in the last block the bins after the last one get a unit width
+        std::vector<T> x2(fNDim);
+        const unsigned int nBins = std::min<unsigned int>(vecSize, fData.Size() - ipoint);
+        for (unsigned int j = 0; j < fNDim; ++j) {
+           const auto upEdges = fData.BinUpEdgeData(j);
+           if (nBins == vecSize) {
+              vecCore::Load<T>(x2[j], upEdges.data() + ipoint);
+              continue;
+           }
+           x2[j] = x1[j] + 1.;
+           for (unsigned int k = 0; k < nBins; ++k)
+              vecCore::Set<T>(x2[j], k, upEdges[ipoint + k]);
+        }
+
+        std::vector<T> xc(fNDim);
+        T fval{};
+        if (!fUseBinIntegral) {
+           for (unsigned int j = 0; j < fNDim; ++j)
+              xc[j] = 0.5 * (x1[j] + x2[j]);
+           fval = func(xc.data(), p);
+           if (grad)
+              gfunc->ParameterGradient(xc.data(), p, grad);
+        } else {
+           const unsigned int npar = (grad) ? gfunc->NPar() : 0;
+           std::vector<T> gradPoint(npar);
+           for (unsigned int ipar = 0; ipar < npar; ++ipar)
+              grad[ipar] = 0;
+           // loop on the points of the product rule
+           unsigned int nPoints = 1;
+           for (unsigned int j = 0; j < fNDim; ++j)
+              nPoints *= kNIntegralPoints;
+           for (unsigned int k = 0; k < nPoints; ++k) {
+              double w = 1.;
+              unsigned int kk = k;
+              for (unsigned int j = 0; j < fNDim; ++j) {
+                 const unsigned int l = kk % kNIntegralPoints;
+                 kk /= kNIntegralPoints;
+                 xc[j] = 0.5 * (x1[j] + x2[j]) + (0.5 * fXGL[l]) * (x2[j] - x1[j]);
+                 w *= fWGL[l];
+              }
+              fval += w * func(xc.data(), p);
+              if (grad) {
+                 gfunc->ParameterGradient(xc.data(), p, gradPoint.data());
+                 for (unsigned int ipar = 0; ipar < npar; ++ipar)
+                    grad[ipar] += w * gradPoint[ipar];
+              }
+           }
+        }
+
+        if (fUseBinVolume) {
+           T binVolume = fRefVolume;
+           for (unsigned int j = 0; j < fNDim; ++j)
+              binVolume *= vecCore::math::Abs(x2[j] - x1[j]);
+           fval *= binVolume;
+           if (grad) {
+              for (unsigned int ipar = 0; ipar < gfunc->NPar(); ++ipar)
+                 grad[ipar] *= binVolume;
+           }
+        }
+        return fval;
+     }
+
+     const BinData &fData;
+     unsigned int fNDim;
+     bool fUseBinIntegral;
+     bool fUseBinVolume;
+     double fRefVolume;        // inverse of the reference volume used to normalize the bin volumes
+     std::vector<double> fXGL; // abscissas of the Gauss-Legendre rule in [-1,1]
+     std::vector<double> fWGL; // weights of the rule, normalized to 1
+  };
+#endif
+
   /** Chi2 Functions */
 
   /**
@@ -265,7 +401,8 @@ namespace FitUtil {
       return also nPoints as the effective number of used points in the Chi2 evaluation
   */
   double EvaluateChi2(const IModelFunction &func, const BinData &data, const double *x, unsigned int &nPoints,
-                      ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0);
+                      ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                      FitWorkerPool *workers = nullptr);
 
   /**
       evaluate the effective Chi2 given a model function and the data at the point x.
@@ -288,7 +425,8 @@ namespace FitUtil {
       return also nPoints as the effective number of used points in the LogL evaluation
   */
   double EvaluateLogL(const IModelFunction &func, const UnBinData &data, const double *p, int iWeight, bool extended,
-                      unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0);
+                      unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                      FitWorkerPool *workers = nullptr);
 
   /**
       evaluate the LogL gradient given a model function and the data at the point x.
@@ -312,7 +450,7 @@ namespace FitUtil {
   */
   double EvaluatePoissonLogL(const IModelFunction &func, const BinData &data, const double *x, int iWeight,
                              bool extended, unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy,
-                             unsigned nChunks = 0);
+                             unsigned nChunks = 0, FitWorkerPool *workers = nullptr);
 
   /**
       evaluate the Poisson LogL given a model function and the data at the point x.
@@ -370,7 +508,8 @@ namespace FitUtil {
    struct Evaluate {
 #ifdef R__HAS_VECCORE
       static double EvalChi2(const IModelFunctionTempl<T> &func, const BinData &data, const double *p,
-                             unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                             unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                             FitWorkerPool * = nullptr)
       {
          // evaluate the chi2 given a  vectorized function reference  , the data and returns the value and also in nPoints
          // the actual number of used points
@@ -392,45 +531,37 @@ namespace FitUtil {
 
          // get fit option and check case if using integral of bins
          const DataOptions &fitOpt = data.Opt();
-         if (fitOpt.fBinVolume || fitOpt.fIntegral || fitOpt.fExpErrors)
-            Error("FitUtil::EvaluateChi2", "The vectorized implementation doesn't support Integrals, BinVolume or ExpErrors\n. Aborting operation.");
+         bool useExpErrors = (fitOpt.fExpErrors);
+         // evaluate the function in the bins according to the integral and bin volume options
+         BinFunctionEvaluator<T> binEval(data);
 
          (const_cast<IModelFunctionTempl<T> &>(func)).SetParameters(p);
 
          double maxResValue = std::numeric_limits<double>::max() / n;
-         std::vector<double> ones{1, 1, 1, 1};
          auto vecSize = vecCore::VectorSize<T>();
 
          auto mapFunction = [&](unsigned int i) {
             // in case of no error in y invError=1 is returned
-            T x1, y, invErrorVec;
-            vecCore::Load<T>(x1, data.GetCoordComponent(i * vecSize, 0));
+            T y, invErrorVec;
             vecCore::Load<T>(y, data.ValuePtr(i * vecSize));
             const auto invError = data.ErrorPtr(i * vecSize);
-            auto invErrorptr = (invError != nullptr) ? invError : &ones.front();
-            vecCore::Load<T>(invErrorVec, invErrorptr);
-
-            const T *x;
-            if(data.NDim() > 1) {
-               std::vector<T> xc;
-               xc.resize(data.NDim());
-               xc[0] = x1;
-               for (unsigned int j = 1; j < data.NDim(); ++j)
-                  vecCore::Load<T>(xc[j], data.GetCoordComponent(i * vecSize, j));
-               x = xc.data();
-            } else {
-               x = &x1;
-            }
-
-            T fval{};
+            if (invError != nullptr)
+               vecCore::Load<T>(invErrorVec, invError);
+            else
+               invErrorVec = 1;
 
-#ifdef USE_PARAMCACHE
-            fval = func(x);
-#else
-            fval = func(x, p);
-#endif
+            T fval = binEval(func, p, i);
             nPoints++;
 
+            // expected errors
+            if (useExpErrors) {
+               // weight = sumw2/sumw = error**2/content and expected error = f(x) / weight
+               T invWeight = y * invErrorVec * invErrorVec;
+               T invError2 = 0;
+               vecCore::MaskedAssign<T>(invError2, fval > 0, invWeight / fval);
+               invErrorVec = vecCore::math::Sqrt(invError2);
+            }
+
             T tmp = (y - fval) * invErrorVec;
             T chi2 = tmp * tmp;
 
@@ -443,6 +574,13 @@ namespace FitUtil {
             return chi2;
          };
 
+         // the worker processes are used only for the scalar functions
+         if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+            Warning("FitUtil::EvaluateChi2", "Multiprocess execution policy is not supported for vectorized functions. "
+                                             "Changing to ROOT::Fit::ExecutionPolicy::kSerial.");
+            executionPolicy = ROOT::Fit::ExecutionPolicy::kSerial;
+         }
+
 #ifdef R__USE_IMT
          auto redFunction = [](const std::vector<T> &objs) {
             return std::accumulate(objs.begin(), objs.end(), T{});
@@ -487,7 +625,8 @@ namespace FitUtil {
 
       static double EvalLogL(const IModelFunctionTempl<T> &func, const UnBinData &data, const double *const p,
                              int iWeight, bool extended, unsigned int &nPoints,
-                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                             FitWorkerPool * = nullptr)
       {
          // evaluate the LogLikelihood
          unsigned int n = data.Size();
@@ -602,6 +741,13 @@ namespace FitUtil {
             return LikelihoodAux<T>(logval, W, W2);
          };
 
+         // the worker processes are used only for the scalar functions
+         if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+            Warning("FitUtil::EvaluateLogL", "Multiprocess execution policy is not supported for vectorized functions. "
+                                             "Changing to ROOT::Fit::ExecutionPolicy::kSerial.");
+            executionPolicy = ROOT::Fit::ExecutionPolicy::kSerial;
+         }
+
 #ifdef R__USE_IMT
          auto redFunction = [](const std::vector<LikelihoodAux<T>> &objs) {
             return std::accumulate(objs.begin(), objs.end(), LikelihoodAux<T>(),
@@ -718,7 +864,8 @@ namespace FitUtil {
 
       static double EvalPoissonLogL(const IModelFunctionTempl<T> &func, const BinData &data, const double *p,
                                     int iWeight, bool extended, unsigned int,
-                                    ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                                    ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                                    FitWorkerPool * = nullptr)
       {
          // evaluate the Poisson Log Likelihood
          // for binned likelihood fits
@@ -739,37 +886,14 @@ namespace FitUtil {
          (const_cast<IModelFunctionTempl<T> &>(func)).SetParameters(p);
 #endif
          auto vecSize = vecCore::VectorSize<T>();
-         // get fit option and check case of using integral of bins
-         const DataOptions &fitOpt = data.Opt();
-         if (fitOpt.fExpErrors || fitOpt.fIntegral)
-            Error("FitUtil::EvaluateChi2",
-                  "The vectorized implementation doesn't support Integrals or BinVolume\n. Aborting operation.");
+         // evaluate the function in the bins according to the integral and bin volume options
+         BinFunctionEvaluator<T> binEval(data);
          bool useW2 = (iWeight == 2);
 
          auto mapFunction = [&](unsigned int i) {
             T y;
             vecCore::Load<T>(y, data.ValuePtr(i * vecSize));
-            T fval{};
-
-            if (data.NDim() > 1) {
-               std::vector<T> x(data.NDim());
-               for (unsigned int j = 0; j < data.NDim(); ++j)
-                  vecCore::Load<T>(x[j], data.GetCoordComponent(i * vecSize, j));
-#ifdef USE_PARAMCACHE
-               fval = func(x.data());
-#else
-               fval = func(x.data(), p);
-#endif
-               // one -dim case
-            } else {
-               T x;
-               vecCore::Load<T>(x, data.GetCoordComponent(i * vecSize, 0));
-#ifdef USE_PARAMCACHE
-               fval = func(&x);
-#else
-               fval = func(&x, p);
-#endif
-            }
+            T fval = binEval(func, p, i);
 
             // EvalLog protects against 0 values of fval but don't want to add in the -log sum
             // negative values of fval
@@ -812,6 +936,13 @@ namespace FitUtil {
             return nloglike;
          };
 
+         // the worker processes are used only for the scalar functions
+         if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+            Warning("FitUtil::EvaluatePoissonLogL", "Multiprocess execution policy is not supported for vectorized functions. "
+                                                    "Changing to ROOT::Fit::ExecutionPolicy::kSerial.");
+            executionPolicy = ROOT::Fit::ExecutionPolicy::kSerial;
+         }
+
 #ifdef R__USE_IMT
          auto redFunction = [](const std::vector<T> &objs) { return std::accumulate(objs.begin(), objs.end(), T{}); };
 #else
@@ -903,9 +1034,9 @@ namespace FitUtil {
 #endif
 
          const DataOptions &fitOpt = data.Opt();
-         if (fitOpt.fBinVolume || fitOpt.fIntegral || fitOpt.fExpErrors)
-            Error("FitUtil::EvaluateChi2Gradient", "The vectorized implementation doesn't support Integrals,"
-                                                   "BinVolume or ExpErrors\n. Aborting operation.");
+         bool useExpErrors = (fitOpt.fExpErrors);
+         // evaluate the function in the bins according to the integral and bin volume options
+         BinFunctionEvaluator<T> binEval(data);
 
          unsigned int npar = func.NPar();
          auto vecSize = vecCore::VectorSize<T>();
@@ -920,9 +1051,8 @@ namespace FitUtil {
             std::vector<T> gradFunc(npar);
             std::vector<T> pointContributionVec(npar);
 
-            T x1, y, invError;
+            T y, invError;
 
-            vecCore::Load<T>(x1, data.GetCoordComponent(i * vecSize, 0));
             vecCore::Load<T>(y, data.ValuePtr(i * vecSize));
             const auto invErrorPtr = data.ErrorPtr(i * vecSize);
 
@@ -931,28 +1061,10 @@ namespace FitUtil {
             else
                vecCore::Load<T>(invError, invErrorPtr);
 
-            // TODO: Check error options and invert if needed
-
-            T fval = 0;
-
-            const T *x = nullptr;
-
-            unsigned int ndim = data.NDim();
-            if (ndim > 1) {
-               std::vector<T> xc(ndim);
-               xc[0] = x1;
-               for (unsigned int j = 1; j < ndim; ++j)
-                  vecCore::Load<T>(xc[j], data.GetCoordComponent(i * vecSize, j));
-               x = xc.data();
-            } else {
-               x = &x1;
-            }
-
-            fval = func(x, p);
-            func.ParameterGradient(x, p, &gradFunc[0]);
+            T fval = binEval(func, p, i, gradFunc.data());
 
 #ifdef DEBUG
-            std::cout << x[0] << "  " << y << "  " << 1. / invError << " params : ";
+            std::cout << y << "  " << 1. / invError << " params : ";
             for (unsigned int ipar = 0; ipar < npar; ++ipar)
                std::cout << p[ipar] << "\t";
             std::cout << "\tfval = " << fval << std::endl;
@@ -964,6 +1076,16 @@ namespace FitUtil {
                return pointContributionVec;
             }
 
+            // derivative of the chi2 term with respect to the function value
+            T dChi2 = -2.0 * (y - fval) * invError * invError;
+            if (useExpErrors) {
+               // the expected error depends on the function value: chi2 = (y - f)**2 * invWeight / f
+               T invWeight = y * invError * invError;
+               T resid = (y - fval) / fval;
+               dChi2 = 0;
+               vecCore::MaskedAssign<T>(dChi2, fval > 0, -invWeight * resid * (2. + resid));
+            }
+
             // loop on the parameters
             for (unsigned int ipar = 0; ipar < npar; ++ipar) {
                // avoid singularity in the function (infinity and nan ) in the chi2 sum
@@ -975,8 +1097,7 @@ namespace FitUtil {
                }
 
                // calculate derivative point contribution (only for valid points)
-               vecCore::MaskedAssign(pointContributionVec[ipar], validPointsMasks[i],
-                                     -2.0 * (y - fval) * invError * invError * gradFunc[ipar]);
+               vecCore::MaskedAssign(pointContributionVec[ipar], validPointsMasks[i], dChi2 * gradFunc[ipar]);
             }
 
             return pointContributionVec;
@@ -1094,10 +1215,8 @@ static double EvalPoissonBinPdf(const IModelFunctionTempl<T> &, const BinData &,
 
          const IGradModelFunctionTempl<T> &func = *fg;
 
-         const DataOptions &fitOpt = data.Opt();
-         if (fitOpt.fBinVolume || fitOpt.fIntegral || fitOpt.fExpErrors)
-            Error("FitUtil::EvaluatePoissonLogLGradient", "The vectorized implementation doesn't support Integrals,"
-                                                          "BinVolume or ExpErrors\n. Aborting operation.");
+         // evaluate the function in the bins according to the integral and bin volume options
+         BinFunctionEvaluator<T> binEval(data);
 
          unsigned int npar = func.NPar();
          auto vecSize = vecCore::VectorSize<T>();
@@ -1109,28 +1228,10 @@ static double EvalPoissonBinPdf(const IModelFunctionTempl<T> &, const BinData &,
             std::vector<T> gradFunc(npar);
             std::vector<T> pointContributionVec(npar);
 
-            T x1, y;
-
-            vecCore::Load<T>(x1, data.GetCoordComponent(i * vecSize, 0));
+            T y;
             vecCore::Load<T>(y, data.ValuePtr(i * vecSize));
 
-            T fval = 0;
-
-            const T *x = nullptr;
-
-            unsigned ndim = data.NDim();
-            if (ndim > 1) {
-               std::vector<T> xc(ndim);
-               xc[0] = x1;
-               for (unsigned int j = 1; j < ndim; ++j)
-                  vecCore::Load<T>(xc[j], data.GetCoordComponent(i * vecSize, j));
-               x = xc.data();
-            } else {
-               x = &x1;
-            }
-
-            fval = func(x, p);
-            func.ParameterGradient(x, p, &gradFunc[0]);
+            T fval = binEval(func, p, i, gradFunc.data());
 
             // correct the gradient
             for (unsigned int ipar = 0; ipar < npar; ++ipar) {
@@ -1347,7 +1448,8 @@ static double EvalPoissonBinPdf(const IModelFunctionTempl<T> &, const BinData &,
 #endif
 
       static double EvalChi2(const IModelFunction &func, const BinData &data, const double *p, unsigned int &nPoints,
-                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                             FitWorkerPool *workers = nullptr)
       {
          // evaluate the chi2 given a  function reference, the data and returns the value and also in nPoints
          // the actual number of used points
@@ -1357,21 +1459,23 @@ static double EvalPoissonBinPdf(const IModelFunctionTempl<T> &, const BinData &,
 
          //Info("EvalChi2","Using non-vecorized implementation %d",(int) data.Opt().fIntegral);
 
-         return FitUtil::EvaluateChi2(func, data, p, nPoints, executionPolicy, nChunks);
+         return FitUtil::EvaluateChi2(func, data, p, nPoints, executionPolicy, nChunks, workers);
       }
 
       static double EvalLogL(const IModelFunctionTempl<double> &func, const UnBinData &data, const double *p,
                              int iWeight, bool extended, unsigned int &nPoints,
-                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                             FitWorkerPool *workers = nullptr)
       {
-         return FitUtil::EvaluateLogL(func, data, p, iWeight, extended, nPoints, executionPolicy, nChunks);
+         return FitUtil::EvaluateLogL(func, data, p, iWeight, extended, nPoints, executionPolicy, nChunks, workers);
       }
 
       static double EvalPoissonLogL(const IModelFunctionTempl<double> &func, const BinData &data, const double *p,
                                     int iWeight, bool extended, unsigned int &nPoints,
-                                    ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0)
+                                    ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks = 0,
+                                    FitWorkerPool *workers = nullptr)
       {
-         return FitUtil::EvaluatePoissonLogL(func, data, p, iWeight, extended, nPoints, executionPolicy, nChunks);
+         return FitUtil::EvaluatePoissonLogL(func, data, p, iWeight, extended, nPoints, executionPolicy, nChunks, workers);
       }
 
       static double EvalChi2Effective(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, unsigned int &nPoints)
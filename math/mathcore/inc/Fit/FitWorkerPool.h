@@ -0,0 +1,122 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for class FitWorkerPool
+
+#ifndef ROOT_Fit_FitWorkerPool
+#define ROOT_Fit_FitWorkerPool
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ROOT {
+
+   namespace Fit {
+
+/**
+   Pool of persistent worker processes used to evaluate the fit method functions
+   (chi2, likelihood) with the ROOT::Fit::ExecutionPolicy::kMultiprocess policy.
+
+   The workers are forked when the pool is started. Each worker keeps its own copy
+   of the model function and of the data and is assigned a fixed chunk of the data points.
+   For every evaluation only the parameter values are sent to the workers, which return
+   the partial sums computed on their chunk. The workers are terminated when the pool is
+   stopped or deleted.
+
+   Since the workers are separate processes, the model function does not need to be
+   thread safe (e.g. interpreted functions can be used).
+   The pool is not available on Windows.
+
+   @ingroup FitMain
+*/
+class FitWorkerPool {
+
+public:
+
+   /**
+      Function computing in a worker the partial results for the data points in [begin, end)
+      and the parameter values p. The nResults values must be written in result.
+   */
+   typedef std::function<void(const double *p, unsigned int begin, unsigned int end, double *result)> ChunkFunction;
+
+   /**
+      Create a pool with the given number of workers (default is the number of cores,
+      see SetDefaultNWorkers). The workers are forked only by Start.
+   */
+   explicit FitWorkerPool(unsigned int nWorkers = 0);
+
+   /**
+      Destructor: terminate the workers
+   */
+   ~FitWorkerPool();
+
+   /**
+      Fork the workers. The data points [0, nPoints) are divided in equal chunks and every
+      worker calls func for its chunk when Evaluate is called. The key identifies the
+      configuration of the evaluation (function, data and options); the workers of a previous
+      configuration are stopped. Return false if the workers could not be created, in which
+      case a message is printed and the failure is remembered (see HasFailed).
+      Note that func is executed only in the worker processes: it can refer to objects
+      which stay alive in the worker after the return of the caller.
+   */
+   bool Start(const std::string &key, unsigned int nPoints, unsigned int nPar, unsigned int nResults,
+              const ChunkFunction &func);
+
+   /// Terminate the workers
+   void Stop();
+
+   /// Return true if the workers are running with the given configuration key
+   bool IsRunning(const std::string &key) const { return !fPids.empty() && key == fKey; }
+
+   /**
+      Return true if the workers could not be started for the given configuration key
+      (e.g. on Windows): the caller must then evaluate serially without calling Start again.
+   */
+   bool HasFailed(const std::string &key) const { return fPids.empty() && key == fFailedKey; }
+
+   /**
+      Send the parameter values to the workers and return in result the sum of their
+      nResults partial results. Return false in case of failure, in which case the workers are stopped.
+   */
+   bool Evaluate(const double *p, double *result);
+
+   /// Number of worker processes
+   unsigned int NWorkers() const { return fNWorkers; }
+
+   /// Set the default number of workers (0 means the number of cores)
+   static void SetDefaultNWorkers(unsigned int n);
+
+   /// Return the default number of workers
+   static unsigned int DefaultNWorkers();
+
+private:
+
+   // the workers cannot be shared between pool objects
+   FitWorkerPool(const FitWorkerPool &);
+   FitWorkerPool &operator=(const FitWorkerPool &);
+
+   unsigned int fNWorkers;          // number of workers requested
+   unsigned int fNPar;              // number of parameters sent at each evaluation
+   unsigned int fNResults;          // number of results returned by each worker
+   std::string fKey;                // key of the running configuration
+   std::string fFailedKey;          // key of the configuration for which the workers could not be started
+   std::vector<int> fPids;          // process id of the workers
+   std::vector<int> fRequestFds;    // pipes used to send the parameters
+   std::vector<int> fResultFds;     // pipes used to receive the results
+   std::vector<double> fParams;     // buffer for the parameters
+   std::vector<double> fBuffer;     // buffer for the partial results
+
+};
+
+   } // end namespace Fit
+
+} // end namespace ROOT
+
+#endif /* ROOT_Fit_FitWorkerPool */
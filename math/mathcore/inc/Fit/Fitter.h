@@ -29,6 +29,7 @@ Classes used for fitting (regression analysis) and estimation of parameter value
 #include "Fit/FitResult.h"
 #include "Math/IParamFunction.h"
 #include <memory>
+#include <vector>
 
 namespace ROOT {
 
@@ -214,6 +215,53 @@ public:
       return DoLinearFit();
    }
 
+   /**
+      Fit in parallel a collection of independent binned data sets with the same model function and
+      fit configuration. A least square fit is done, or a binned likelihood fit (extended or not)
+      if likelihood is true.
+      The results are returned in the same order as the data sets.
+      Every fit uses its own copy of the model function and of the configuration: when no parameter
+      settings are defined in the configuration the initial values are taken from the function.
+      The fits are run concurrently on the given number of threads (0 means the default number of
+      the ROOT thread pool), and sequentially if ROOT is built without IMT.
+      The model function must support being cloned and evaluated concurrently: when using a TF1,
+      the wrapper must own a copy of it (see ROOT::Math::WrappedMultiTF1::SetAndCopyFunction).
+      The TMinuit and TFumili minimizers, which use global objects, are replaced by the
+      corresponding Minuit2 algorithms.
+      The minimizers and the objective functions are not kept in the returned results:
+      the Minos errors need to be requested in the configuration (FitConfig::SetMinosErrors).
+   */
+   static std::vector<FitResult> FitMany(const std::vector<std::shared_ptr<BinData> > & data, const IModelFunction & func,
+                                         const FitConfig & config, bool likelihood = false, bool extended = true,
+                                         unsigned int nThreads = 0);
+
+   /**
+      Fit in parallel a collection of independent un-binned data sets with the same model function
+      and fit configuration, using an un-binned likelihood fit (extended or not).
+      See the documentation of the binned version above.
+   */
+   static std::vector<FitResult> FitMany(const std::vector<std::shared_ptr<UnBinData> > & data, const IModelFunction & func,
+                                         const FitConfig & config, bool extended = false, unsigned int nThreads = 0);
+
+   /**
+      Multi-start fit of a binned data set: the fit is repeated in parallel starting from each of the
+      given sets of initial parameter values, using the model function and the configuration set in
+      this Fitter. A least square fit is done, or a binned likelihood fit (extended or not) if
+      likelihood is true.
+      The results of all fits are returned in the order of the starting points, and the Fitter keeps
+      the valid fit with the smallest minimum value, which is then available with Result()
+      and can be used to compute further the errors (e.g. with CalculateMinosErrors).
+      The threads and the function requirements are the same as for FitMany.
+   */
+   std::vector<FitResult> MultiStartFit(const std::shared_ptr<BinData> & data, const std::vector<std::vector<double> > & startValues,
+                                        bool likelihood = false, bool extended = true, unsigned int nThreads = 0);
+
+   /**
+      Multi-start un-binned likelihood fit (extended or not). See the binned version above.
+   */
+   std::vector<FitResult> MultiStartFit(const std::shared_ptr<UnBinData> & data, const std::vector<std::vector<double> > & startValues,
+                                        bool extended = false, unsigned int nThreads = 0);
+
 
    /**
       Fit using the a generic FCN function as a C++ callable object implementing
@@ -438,6 +486,14 @@ protected:
    bool DoUnbinnedLikelihoodFit( bool extended = false, const ROOT::Fit::ExecutionPolicy &executionPolicy = ROOT::Fit::ExecutionPolicy::kSerial);
    /// linear least square fit
    bool DoLinearFit();
+   /// parallel fit of several binned or un-binned data sets
+   template <class Data>
+   static std::vector<FitResult> DoFitMany(const std::vector<std::shared_ptr<Data> > & data, const IModelFunction & func,
+                                           const FitConfig & config, bool likelihood, bool extended, unsigned int nThreads);
+   /// multi-start fit of binned or un-binned data
+   template <class Data>
+   std::vector<FitResult> DoMultiStartFit(const std::shared_ptr<Data> & data, const std::vector<std::vector<double> > & startValues,
+                                          bool likelihood, bool extended, unsigned int nThreads);
 
    // initialize the minimizer
    bool DoInitMinimizer();
@@ -154,7 +154,10 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::Evaluate<T>::EvalLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints, fExecutionPolicy);
+      if (fExecutionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess && !fWorkers)
+         fWorkers.reset(new FitWorkerPool());
+      return FitUtil::Evaluate<T>::EvalLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints,
+                                            fExecutionPolicy, 0, fWorkers.get());
    }
 
    // for derivatives
@@ -174,6 +177,7 @@ private:
    mutable std::vector<double> fGrad; // for derivatives
 
    ROOT::Fit::ExecutionPolicy fExecutionPolicy; // Execution policy
+   mutable std::unique_ptr<FitWorkerPool> fWorkers; // worker processes (for the kMultiprocess policy)
 };
       // define useful typedef's
       // using LogLikelihoodFunction_v = LogLikelihoodFCN<ROOT::Math::IMultiGenFunction, ROOT::Math::IParametricFunctionMultiDimTempl<T>>;
@@ -163,8 +163,10 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
+      if (fExecutionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess && !fWorkers)
+         fWorkers.reset(new FitWorkerPool());
       return FitUtil::Evaluate<T>::EvalPoissonLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended,
-                                                   fNEffPoints, fExecutionPolicy);
+                                                   fNEffPoints, fExecutionPolicy, 0, fWorkers.get());
    }
 
    // for derivatives
@@ -184,6 +186,7 @@ private:
    mutable std::vector<double> fGrad; // for derivatives
 
    ROOT::Fit::ExecutionPolicy fExecutionPolicy; // Execution policy
+   mutable std::unique_ptr<FitWorkerPool> fWorkers; // worker processes (for the kMultiprocess policy)
 };
 
       // define useful typedef's
@@ -244,11 +244,7 @@ public:
   {
     assert( fWeighted );
 
-    std::vector<double> tmpVec(fDim);
-    std::copy( x, x + fDim - 1, tmpVec.begin() );
-    tmpVec[fDim-1] = w;
-
-    FitData::Add( &tmpVec.front() );
+    FitData::Add( x, w );
   }
 
   /**
@@ -262,6 +258,18 @@ public:
     return *GetCoordComponent(ipoint, fDim-1);
   }
 
+  /**
+    return the weights of all the fit points (an empty view for unweighted data).
+    Unless the data are wrapped, the memory is aligned and padded up to a multiple of
+    the SIMD vector size (see FitData::CoordData)
+  */
+  std::array_view<double> WeightData() const
+  {
+    if ( !fWeighted )
+      return std::array_view<double>();
+    return CoordData( fDim-1 );
+  }
+
   const double * WeightsPtr( unsigned int ipoint ) const
   {
     assert( ipoint < fNPoints );
@@ -16,10 +16,12 @@
 
 #pragma link C++ class ROOT::Fit::Fitter;
 #pragma link C++ class ROOT::Fit::FitConfig+;
-#pragma link C++ class ROOT::Fit::FitData+;
-#pragma link C++ class ROOT::Fit::BinData+;
-#pragma link C++ class ROOT::Fit::UnBinData+;
-#pragma link C++ class ROOT::Fit::SparseData+;
+// no I/O for the fit data classes: their buffers use an aligned allocator which cannot be
+// streamed, and the data are built again for each fit (FitResult does not store them)
+#pragma link C++ class ROOT::Fit::FitData;
+#pragma link C++ class ROOT::Fit::BinData;
+#pragma link C++ class ROOT::Fit::UnBinData;
+#pragma link C++ class ROOT::Fit::SparseData;
 #pragma link C++ class ROOT::Fit::FitResult+;
 #pragma link C++ class ROOT::Fit::ParameterSettings+;
 
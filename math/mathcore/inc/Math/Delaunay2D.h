@@ -95,6 +95,8 @@ public:
    /// Return the Interpolated z value corresponding to the (x,y) point
    double  Interpolate(double x, double y);
 
+   void    Interpolate(int n, const double *x, const double *y, double *z);
+
    /// Find all triangles 
    void      FindAllTriangles();
 
@@ -266,10 +268,11 @@ protected:
     * A reference to triangle ABC is added to _all_ grid cells that include ABC's bounding box
     */
 
-   static const int fNCells = 25; //! number of cells to divide the normalized space
+   int fNCells; //! number of cells to divide the normalized space (about the square root of the number of points)
    double fXCellStep; //! inverse denominator to calculate X cell = fNCells / (fXNmax - fXNmin)
    double fYCellStep; //! inverse denominator to calculate X cell = fNCells / (fYNmax - fYNmin)
-   std::set<UInt_t> fCells[(fNCells+1)*(fNCells+1)]; //! grid cells with containing triangles
+   std::vector<UInt_t> fCellStart; //! index in fCellTriangles of the first triangle of each cell
+   std::vector<UInt_t> fCellTriangles; //! triangles overlapping the grid cells, cell after cell
 
    inline unsigned int Cell(UInt_t x, UInt_t y) const {
 	   return x*(fNCells+1) + y;
@@ -24,6 +24,13 @@
 
 #include <algorithm>
 #include <stdlib.h>
+#include <cmath>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
 
 namespace ROOT {
    
@@ -95,8 +102,11 @@ void Delaunay2D::SetInputPoints(int n, const double * x, const double * y, const
 
 
 #ifndef HAS_CGAL
+   fNCells       = 0;
    fXCellStep    = 0.;
    fYCellStep    = 0.;
+   fCellStart.clear();
+   fCellTriangles.clear();
 #endif
 }
 
@@ -124,6 +134,41 @@ double Delaunay2D::Interpolate(double x, double y)
    return zz;
 }
 
+/// Compute the interpolated z[i] of the n points (x[i], y[i]).
+/// The triangles are found once; if implicit multi-threading is enabled
+/// the points are interpolated in parallel.
+void Delaunay2D::Interpolate(int n, const double *x, const double *y, double *z)
+{
+   if (n <= 0) return;
+   FindAllTriangles();
+
+   // same as Interpolate(x,y), without checking the initialization
+   auto interpolateRange = [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+         double xx = Linear_transform(x[i], fOffsetX, fScaleFactorX);
+         double yy = Linear_transform(y[i], fOffsetY, fScaleFactorY);
+         double zz = DoInterpolateNormalized(xx, yy);
+         if (zz==0) zz = DoInterpolateNormalized(xx+0.0001, yy);
+         z[i] = zz;
+      }
+   };
+
+#if defined(R__USE_IMT) && !defined(HAS_CGAL)
+   // the point location with the Triangle backend only reads the triangulation
+   const int chunkSize = 1000;
+   if (ROOT::IsImplicitMTEnabled() && n > 2 * chunkSize) {
+      const unsigned int nChunks = (n + chunkSize - 1) / chunkSize;
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](unsigned int ichunk) {
+         int first = ichunk * chunkSize;
+         interpolateRange(first, std::min(first + chunkSize, n));
+      }, ROOT::TSeqU(nChunks));
+      return;
+   }
+#endif
+   interpolateRange(0, n);
+}
+
 //______________________________________________________________________________
 void Delaunay2D::FindAllTriangles()
 {
@@ -247,6 +292,10 @@ void Delaunay2D::DoNormalizePoints() {
       fYN.push_back(Linear_transform(fY[n], fOffsetY, fScaleFactorY));
    }
 
+   // choose the grid so that a cell overlaps a few triangles (there are
+   // about twice as many triangles as points)
+   fNCells = std::max(25, std::min(1000, int(std::sqrt(double(fNpoints)))));
+
    //also initialize fXCellStep and FYCellStep
    fXCellStep = fNCells / (fXNmax - fXNmin);
    fYCellStep = fNCells / (fYNmax - fYNmin);
@@ -323,6 +372,9 @@ void Delaunay2D::DoFindTriangles() {
 
    triangulate((char *) "zQN", &in, &out, nullptr);
 
+   // bounding boxes of the triangles in cell coordinates
+   std::vector<unsigned int> cellBox(4 * out.numberoftriangles);
+
    fTriangles.resize(out.numberoftriangles);
    for(int t = 0; t < out.numberoftriangles; ++t){
       Triangle tri;
@@ -355,18 +407,28 @@ void Delaunay2D::DoFindTriangles() {
       auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
       auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
 
-      unsigned int cellXmin = CellX(bx.first);
-      unsigned int cellXmax = CellX(bx.second);
-
-      unsigned int cellYmin = CellY(by.first);
-      unsigned int cellYmax = CellY(by.second);
+      cellBox[4*t]   = CellX(bx.first);
+      cellBox[4*t+1] = CellX(bx.second);
+      cellBox[4*t+2] = CellY(by.first);
+      cellBox[4*t+3] = CellY(by.second);
+   }
 
-      for(unsigned int i = cellXmin; i <= cellXmax; ++i) {
-         for(unsigned int j = cellYmin; j <= cellYmax; ++j) {
-            //printf("(%u,%u) = %u\n", i, j, Cell(i,j));
-            fCells[Cell(i,j)].insert(t);
-         }
-      }
+   // store the triangles of each grid cell contiguously: count the
+   // triangles per cell, then fill them in the order of the triangles
+   const unsigned int nCells = (fNCells+1)*(fNCells+1);
+   fCellStart.assign(nCells + 1, 0);
+   for(int t = 0; t < out.numberoftriangles; ++t) {
+      for(unsigned int i = cellBox[4*t]; i <= cellBox[4*t+1]; ++i)
+         for(unsigned int j = cellBox[4*t+2]; j <= cellBox[4*t+3]; ++j)
+            fCellStart[Cell(i,j) + 1]++;
+   }
+   for(unsigned int c = 0; c < nCells; ++c) fCellStart[c+1] += fCellStart[c];
+   fCellTriangles.resize(fCellStart[nCells]);
+   std::vector<UInt_t> next(fCellStart.begin(), fCellStart.end() - 1);
+   for(int t = 0; t < out.numberoftriangles; ++t) {
+      for(unsigned int i = cellBox[4*t]; i <= cellBox[4*t+1]; ++i)
+         for(unsigned int j = cellBox[4*t+2]; j <= cellBox[4*t+3]; ++j)
+            fCellTriangles[next[Cell(i,j)]++] = t;
    }
 
    freeStruct(in); freeStruct(out);
@@ -402,7 +464,9 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
    if(cX < 0 || cX > fNCells || cY < 0 || cY > fNCells)
       return fZout; //TODO some more fancy interpolation here
 
-    for(unsigned int t : fCells[Cell(cX, cY)]){
+    const unsigned int cell = Cell(cX, cY);
+    for(unsigned int k = fCellStart[cell]; k < fCellStart[cell+1]; ++k){
+       const unsigned int t = fCellTriangles[k];
        auto coords = bayCoords(t);
 
        if(inTriangle(coords)){
@@ -425,14 +489,14 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
           //brute force found a triangle -> grid not
           printf("Found triangle %u for (%f,%f) -> (%u,%u)\n", t, xx,yy, cX, cY);
           printf("Triangles in grid cell: ");
-          for(unsigned int x : fCells[Cell(cX, cY)])
-             printf("%u ", x);
+          for(unsigned int k = fCellStart[Cell(cX, cY)]; k < fCellStart[Cell(cX, cY)+1]; ++k)
+             printf("%u ", fCellTriangles[k]);
           printf("\n");
 
           printf("Triangle %u is in cells: ", t);
           for(unsigned int i = 0; i <= fNCells; ++i)
              for(unsigned int j = 0; j <= fNCells; ++j)
-                if(fCells[Cell(i,j)].count(t))
+                if(std::count(fCellTriangles.begin() + fCellStart[Cell(i,j)], fCellTriangles.begin() + fCellStart[Cell(i,j)+1], t))
                    printf("(%u,%u) ", i, j);
           printf("\n");
           for(unsigned int i = 0; i < 3; ++i)
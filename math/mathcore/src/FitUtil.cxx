@@ -31,6 +31,8 @@
 #include <cassert>
 #include <algorithm>
 #include <numeric>
+#include <sstream>
+#include <string>
 //#include <memory>
 
 //#define DEBUG
@@ -211,6 +213,16 @@ namespace ROOT {
             }
          }
 
+         // key identifying the configuration evaluated by the worker processes
+         // (the workers must be restarted when it changes)
+         std::string WorkerKey(const char *method, const void *func, const void *data, unsigned int n,
+                               int iWeight = 0, bool extended = false)
+         {
+            std::ostringstream key;
+            key << method << ' ' << func << ' ' << data << ' ' << n << ' ' << iWeight << ' ' << extended;
+            return key.str();
+         }
+
 
 
       } // end namespace  FitUtil
@@ -222,7 +234,8 @@ namespace ROOT {
 //___________________________________________________________________________________________________________________________
 
       double FitUtil::EvaluateChi2(const IModelFunction &func, const BinData &data, const double *p, unsigned int &,
-                                   ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks)
+                                   ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks,
+                                   FitWorkerPool *workers)
       {
          // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
          // the actual number of used points
@@ -381,11 +394,32 @@ namespace ROOT {
     ROOT::TThreadExecutor pool;
     res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
 #endif
-//   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
-    // ROOT::TProcessExecutor pool;
-    // res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction);
+  } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+    // workers used for this call only if the caller does not keep them
+    FitWorkerPool localWorkers;
+    FitWorkerPool &pool = (workers) ? *workers : localWorkers;
+    auto key = WorkerKey("chi2", &func, &data, n);
+    if (!pool.IsRunning(key) && !pool.HasFailed(key)) {
+      // executed only in the worker processes, which stay in this scope:
+      // the captured variables are private to each worker
+      auto chunkFunction = [&](const double *pw, unsigned int begin, unsigned int end, double *result) {
+        p = pw;
+        (const_cast<IModelFunction &>(func)).SetParameters(p);
+#ifndef USE_PARAMCACHE
+        igEval.SetParameters(p);
+#endif
+        for (unsigned int i = begin; i < end; ++i)
+          result[0] += mapFunction(i);
+      };
+      pool.Start(key, n, func.NPar(), 1, chunkFunction);
+    }
+    if (!pool.Evaluate(p, &res)) {
+      res = 0;
+      for (unsigned int i=0; i<n; ++i)
+        res += mapFunction(i);
+    }
   } else{
-    Error("FitUtil::EvaluateChi2","Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n");
+    Error("FitUtil::EvaluateChi2","Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n ROOT::Fit::ExecutionPolicy::kMultiprocess\n");
   }
 
    return res;
@@ -882,7 +916,7 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 
 double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBinData &data, const double *p,
                              int iWeight, bool extended, unsigned int &nPoints,
-                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks)
+                             ROOT::Fit::ExecutionPolicy executionPolicy, unsigned nChunks, FitWorkerPool *workers)
 {
    // evaluate the LogLikelihood
 
@@ -1037,11 +1071,40 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double> &func, const UnBi
     sumW=resArray.weight;
     sumW2=resArray.weight2;
 #endif
-//   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
-    // ROOT::TProcessExecutor pool;
-    // res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction);
+  } else if(executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+    // workers used for this call only if the caller does not keep them
+    FitWorkerPool localWorkers;
+    FitWorkerPool &pool = (workers) ? *workers : localWorkers;
+    auto key = WorkerKey("logl", &func, &data, n, iWeight, extended);
+    if (!pool.IsRunning(key) && !pool.HasFailed(key)) {
+      // executed only in the worker processes, which stay in this scope:
+      // the captured variables are private to each worker
+      auto chunkFunction = [&](const double *pw, unsigned int begin, unsigned int end, double *result) {
+        p = pw;
+        (const_cast<IModelFunctionTempl<double> &>(func)).SetParameters(p);
+        for (unsigned int i = begin; i < end; ++i) {
+          auto resArray = mapFunction(i);
+          result[0] += resArray.logvalue;
+          result[1] += resArray.weight;
+          result[2] += resArray.weight2;
+        }
+      };
+      pool.Start(key, n, func.NPar(), 3, chunkFunction);
+    }
+    double result[3] = {0, 0, 0};
+    if (!pool.Evaluate(p, result)) {
+      for (unsigned int i=0; i<n; ++i) {
+        auto resArray = mapFunction(i);
+        result[0] += resArray.logvalue;
+        result[1] += resArray.weight;
+        result[2] += resArray.weight2;
+      }
+    }
+    logl = result[0];
+    sumW = result[1];
+    sumW2 = result[2];
   } else{
-    Error("FitUtil::EvaluateLogL","Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n");
+    Error("FitUtil::EvaluateLogL","Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n ROOT::Fit::ExecutionPolicy::kMultiprocess\n");
   }
 
   if (extended) {
@@ -1310,7 +1373,7 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &data, const double *p, int iWeight,
                                     bool extended, unsigned int &nPoints, ROOT::Fit::ExecutionPolicy executionPolicy,
-                                    unsigned nChunks)
+                                    unsigned nChunks, FitWorkerPool *workers)
 {
    // evaluate the Poisson Log Likelihood
    // for binned likelihood fits
@@ -1513,12 +1576,38 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
       ROOT::TThreadExecutor pool;
       res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
 #endif
-      //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
-      // ROOT::TProcessExecutor pool;
-      // res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction);
+   } else if (executionPolicy == ROOT::Fit::ExecutionPolicy::kMultiprocess) {
+      // workers used for this call only if the caller does not keep them
+      FitWorkerPool localWorkers;
+      FitWorkerPool &pool = (workers) ? *workers : localWorkers;
+      auto key = WorkerKey("poissonlogl", &func, &data, n, iWeight, extended);
+      if (!pool.IsRunning(key) && !pool.HasFailed(key)) {
+         // executed only in the worker processes, which stay in this scope:
+         // the captured variables are private to each worker
+         auto chunkFunction = [&](const double *pw, unsigned int begin, unsigned int end, double *result) {
+            p = pw;
+            (const_cast<IModelFunction &>(func)).SetParameters(p);
+#ifndef USE_PARAMCACHE
+            igEval.SetParameters(p);
+#endif
+            nPoints = 0;
+            for (unsigned int i = begin; i < end; ++i)
+               result[0] += mapFunction(i);
+            result[1] = nPoints;
+         };
+         pool.Start(key, n, func.NPar(), 2, chunkFunction);
+      }
+      double result[2] = {0, 0};
+      if (pool.Evaluate(p, result)) {
+         res = result[0];
+         nPoints = result[1];
+      } else {
+         for (unsigned int i = 0; i < n; ++i)
+            res += mapFunction(i);
+      }
    } else {
       Error("FitUtil::EvaluatePoissonLogL",
-            "Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n");
+            "Execution policy unknown. Avalaible choices:\n ROOT::Fit::ExecutionPolicy::kSerial (default)\n ROOT::Fit::ExecutionPolicy::kMultithread (requires IMT)\n ROOT::Fit::ExecutionPolicy::kMultiprocess\n");
    }
 
 #ifdef DEBUG
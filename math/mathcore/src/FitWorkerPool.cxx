@@ -0,0 +1,257 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Implementation file for class FitWorkerPool
+
+#include "Fit/FitWorkerPool.h"
+
+#include "RConfig.h"
+#include "TError.h"
+#include "TSystem.h"
+
+#ifndef R__WIN32
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <set>
+
+namespace {
+
+   unsigned int gDefaultNWorkers = 0;
+
+#ifndef R__WIN32
+   // pipe ends kept by the parent for the workers of all the pools of the process. A forked
+   // worker must close all of them: otherwise the workers of another pool never see the end
+   // of their request pipe when that pool is stopped, and its Stop() waits for them forever.
+   // The mutex is held while forking, so that the set copied in the worker is consistent.
+   std::mutex gPoolFdsMutex;
+   std::set<int> gPoolFds;
+
+   // read or write exactly n bytes, retrying on interruptions
+   bool WriteAll(int fd, const void *buf, size_t n)
+   {
+      const char *p = static_cast<const char *>(buf);
+      while (n > 0) {
+         ssize_t nw = ::write(fd, p, n);
+         if (nw < 0) {
+            if (errno == EINTR) continue;
+            return false;
+         }
+         p += nw;
+         n -= nw;
+      }
+      return true;
+   }
+
+   bool ReadAll(int fd, void *buf, size_t n)
+   {
+      char *p = static_cast<char *>(buf);
+      while (n > 0) {
+         ssize_t nr = ::read(fd, p, n);
+         if (nr < 0) {
+            if (errno == EINTR) continue;
+            return false;
+         }
+         if (nr == 0) return false; // end of file: the other side has been closed
+         p += nr;
+         n -= nr;
+      }
+      return true;
+   }
+#endif
+
+}
+
+namespace ROOT {
+
+   namespace Fit {
+
+FitWorkerPool::FitWorkerPool(unsigned int nWorkers) :
+   fNWorkers(nWorkers > 0 ? nWorkers : DefaultNWorkers()),
+   fNPar(0),
+   fNResults(0)
+{}
+
+FitWorkerPool::~FitWorkerPool()
+{
+   Stop();
+}
+
+void FitWorkerPool::SetDefaultNWorkers(unsigned int n)
+{
+   gDefaultNWorkers = n;
+}
+
+unsigned int FitWorkerPool::DefaultNWorkers()
+{
+   if (gDefaultNWorkers > 0) return gDefaultNWorkers;
+   SysInfo_t si;
+   if (gSystem && gSystem->GetSysInfo(&si) == 0 && si.fCpus > 0) return si.fCpus;
+   return 2;
+}
+
+bool FitWorkerPool::Start(const std::string &key, unsigned int nPoints, unsigned int nPar, unsigned int nResults,
+                          const ChunkFunction &func)
+{
+   Stop();
+#ifdef R__WIN32
+   (void)nPoints; (void)nPar; (void)nResults; (void)func;
+   static bool warned = false;
+   if (!warned)
+      Warning("FitWorkerPool::Start", "Worker processes are not supported on Windows, the evaluation is serial");
+   warned = true;
+   fFailedKey = key;
+   return false;
+#else
+   if (nPoints == 0 || nResults == 0) return false;
+   const unsigned int nWorkers = std::min(fNWorkers, nPoints);
+   fNPar = nPar;
+   fNResults = nResults;
+   // at least one value is sent at each evaluation, also without parameters
+   fParams.assign(std::max(nPar, 1u), 0.);
+   fBuffer.resize(nResults);
+
+   // flush the output buffers, otherwise their content is duplicated in the workers
+   fflush(stdout);
+   fflush(stderr);
+
+   for (unsigned int iw = 0; iw < nWorkers; ++iw) {
+      std::unique_lock<std::mutex> lock(gPoolFdsMutex);
+      int request[2], result[2];
+      const char *failure = nullptr;
+      pid_t pid = -1;
+      if (::pipe(request) != 0) {
+         failure = "Cannot create the pipes for the worker processes";
+      } else if (::pipe(result) != 0) {
+         ::close(request[0]); ::close(request[1]);
+         failure = "Cannot create the pipes for the worker processes";
+      } else if ((pid = ::fork()) < 0) {
+         ::close(request[0]); ::close(request[1]);
+         ::close(result[0]); ::close(result[1]);
+         failure = "Cannot fork the worker processes";
+      }
+      if (failure) {
+         lock.unlock();
+         Error("FitWorkerPool::Start", "%s, the evaluation is serial", failure);
+         Stop();
+         fFailedKey = key;
+         return false;
+      }
+      if (pid == 0) {
+         // worker process: close the pipes of the other workers of all the pools, so that
+         // they see the end of file when the parent closes them. The mutex is never
+         // released in the worker, which has no other thread.
+         for (int fd : gPoolFds) ::close(fd);
+         ::close(request[1]);
+         ::close(result[0]);
+         // the workers are terminated by the parent, ignore interrupts from the terminal
+         ::signal(SIGINT, SIG_IGN);
+         const unsigned int begin = (unsigned long long)nPoints * iw / nWorkers;
+         const unsigned int end = (unsigned long long)nPoints * (iw + 1) / nWorkers;
+         std::vector<double> params(fParams.size());
+         std::vector<double> res(nResults);
+         // an exception must not unwind the worker into the stack frames of the caller:
+         // the parent sees the end of the result pipe and reports the failure
+         try {
+            while (ReadAll(request[0], params.data(), params.size() * sizeof(double))) {
+               std::fill(res.begin(), res.end(), 0.);
+               func(params.data(), begin, end, res.data());
+               if (!WriteAll(result[1], res.data(), nResults * sizeof(double))) break;
+            }
+         } catch (...) {
+            ::_exit(1);
+         }
+         // never return to the caller, and do not run the exit handlers of the parent
+         ::_exit(0);
+      }
+      ::close(request[0]);
+      ::close(result[1]);
+      gPoolFds.insert(request[1]);
+      gPoolFds.insert(result[0]);
+      lock.unlock();
+      fPids.push_back(pid);
+      fRequestFds.push_back(request[1]);
+      fResultFds.push_back(result[0]);
+   }
+   fKey = key;
+   fFailedKey.clear();
+   return true;
+#endif
+}
+
+void FitWorkerPool::Stop()
+{
+#ifndef R__WIN32
+   // closing the pipes terminates the loop of the workers
+   {
+      std::lock_guard<std::mutex> lock(gPoolFdsMutex);
+      for (int fd : fRequestFds) {
+         gPoolFds.erase(fd);
+         ::close(fd);
+      }
+      for (int fd : fResultFds) {
+         gPoolFds.erase(fd);
+         ::close(fd);
+      }
+   }
+   for (int pid : fPids) {
+      int status = 0;
+      while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+   }
+#endif
+   fPids.clear();
+   fRequestFds.clear();
+   fResultFds.clear();
+   fKey.clear();
+}
+
+bool FitWorkerPool::Evaluate(const double *p, double *result)
+{
+   if (fPids.empty()) return false;
+#ifdef R__WIN32
+   (void)p; (void)result;
+   return false;
+#else
+   if (p) std::copy(p, p + fNPar, fParams.begin());
+   // ignore SIGPIPE while writing, so that a dead worker gives an error (EPIPE)
+   // instead of terminating the process
+   struct sigaction ignore, previous;
+   ignore.sa_handler = SIG_IGN;
+   sigemptyset(&ignore.sa_mask);
+   ignore.sa_flags = 0;
+   ::sigaction(SIGPIPE, &ignore, &previous);
+   // send first the parameters to all workers, which then run concurrently
+   bool ok = true;
+   for (unsigned int iw = 0; iw < fPids.size() && ok; ++iw)
+      ok = WriteAll(fRequestFds[iw], fParams.data(), fParams.size() * sizeof(double));
+   ::sigaction(SIGPIPE, &previous, nullptr);
+   for (unsigned int j = 0; j < fNResults; ++j) result[j] = 0;
+   // the partial results are always summed in the same order
+   for (unsigned int iw = 0; iw < fPids.size() && ok; ++iw) {
+      ok = ReadAll(fResultFds[iw], fBuffer.data(), fNResults * sizeof(double));
+      for (unsigned int j = 0; j < fNResults && ok; ++j) result[j] += fBuffer[j];
+   }
+   if (!ok) {
+      Error("FitWorkerPool::Evaluate", "Communication with the worker processes failed");
+      Stop();
+   }
+   return ok;
+#endif
+}
+
+   } // end namespace Fit
+
+} // end namespace ROOT
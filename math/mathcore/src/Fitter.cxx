@@ -27,7 +27,14 @@
 #include "Math/Error.h"
 #include "TF1.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "TROOT.h"
+#endif
+
 #include <memory>
+#include <functional>
+#include <string>
 
 #include "Math/IParamFunction.h"
 
@@ -365,7 +372,7 @@ bool Fitter::DoLeastSquareFit(const ROOT::Fit::ExecutionPolicy &executionPolicy)
             MATH_INFO_MSG("Fitter::DoLeastSquareFit","use gradient from model function");
          std::shared_ptr<IGradModelFunction> gradFun = std::dynamic_pointer_cast<IGradModelFunction>(fFunc);
          if (gradFun) {
-            Chi2FCN<BaseGradFunc> chi2(data,gradFun);
+            Chi2FCN<BaseGradFunc> chi2(data,gradFun, executionPolicy);
             fFitType = chi2.Type();
             return DoMinimization (chi2);
          }
@@ -524,7 +531,7 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended, const ROOT::Fit::ExecutionPo
          if (extended) {
             MATH_WARN_MSG("Fitter::DoUnbinnedLikelihoodFit","Extended unbinned fit with gradient not yet supported - do a not-extended fit");
          }
-         LogLikelihoodFCN<BaseGradFunc> logl(data,gradFun,useWeight, extended);
+         LogLikelihoodFCN<BaseGradFunc> logl(data,gradFun,useWeight, extended, executionPolicy);
          fFitType = logl.Type();
          if (!DoMinimization (logl) ) return false;
          if (useWeight) {
@@ -936,6 +943,178 @@ void Fitter::ExamineFCN()  {
    return;
 }
 
+namespace {
+
+// fit a binned data set with the least square or the likelihood method
+bool FitDataSet(Fitter & fitter, const std::shared_ptr<BinData> & data, bool likelihood, bool extended) {
+   return (likelihood) ? fitter.LikelihoodFit(data, extended) : fitter.Fit(data);
+}
+
+// fit an un-binned data set with the likelihood method
+bool FitDataSet(Fitter & fitter, const std::shared_ptr<UnBinData> & data, bool /* likelihood */, bool extended) {
+   return fitter.LikelihoodFit(data, extended);
+}
+
+// the TMinuit and TFumili minimizers use global objects and cannot be run concurrently:
+// use instead the same algorithm of Minuit2
+void UseThreadSafeMinimizer(FitConfig & config, unsigned int nThreads, const char * location) {
+#ifdef R__USE_IMT
+   if (nThreads == 1) return;
+   const std::string type = config.MinimizerType();
+   std::string algo = config.MinimizerAlgoType();
+   if (type == "Minuit" || type == "TMinuit") {
+      if (algo == "Seek") algo = "Migrad";
+   }
+   else if (type == "Fumili")
+      algo = "Fumili";
+   else
+      return;
+   std::string msg = "The " + type + " minimizer cannot be used in parallel fits - use Minuit2 with the " + algo + " algorithm";
+   MATH_INFO_MSG(location, msg.c_str());
+   config.SetMinimizer("Minuit2", algo.c_str());
+#else
+   (void) config; (void) nThreads; (void) location;
+#endif
+}
+
+// call func(i) for i in [0,n) using the given number of threads (0 is the default of the thread pool)
+void ExecuteTasks(unsigned int n, unsigned int nThreads, const std::function<void(unsigned int)> & func) {
+#ifdef R__USE_IMT
+   if (nThreads != 1 && n > 1) {
+      // the minimizers are created with the plug-in manager
+      ROOT::EnableThreadSafety();
+      if (nThreads > 0) {
+         ROOT::TThreadExecutor pool(nThreads);
+         pool.Foreach(func, ROOT::TSeq<unsigned int>(n));
+      }
+      else {
+         ROOT::TThreadExecutor pool;
+         pool.Foreach(func, ROOT::TSeq<unsigned int>(n));
+      }
+      return;
+   }
+#else
+   (void) nThreads;
+#endif
+   for (unsigned int i = 0; i < n; ++i)
+      func(i);
+}
+
+}
+
+template <class Data>
+std::vector<FitResult> Fitter::DoFitMany(const std::vector<std::shared_ptr<Data> > & data, const IModelFunction & func,
+                                         const FitConfig & config, bool likelihood, bool extended, unsigned int nThreads) {
+   // fit each data set with its own Fitter: the function is cloned by every fitter
+
+   FitConfig fitConfig(config);
+   if (fitConfig.NPar() != func.NPar()) fitConfig.CreateParamsSettings(func);
+   UseThreadSafeMinimizer(fitConfig, nThreads, "Fitter::FitMany");
+   const bool useGradient = (dynamic_cast<const IGradModelFunction *>(&func) != 0);
+
+   std::vector<FitResult> results(data.size());
+   ExecuteTasks(data.size(), nThreads, [&](unsigned int i) {
+      if (!data[i]) return;
+      Fitter fitter;
+      fitter.SetFunction(func, useGradient);
+      fitter.fConfig = fitConfig;
+      FitDataSet(fitter, data[i], likelihood, extended);
+      if (!fitter.fResult) return;
+      results[i] = *fitter.fResult;
+      // do not keep the minimizer and the objective function of all the fits
+      results[i].fMinimizer.reset();
+      results[i].fObjFunc.reset();
+   });
+   return results;
+}
+
+std::vector<FitResult> Fitter::FitMany(const std::vector<std::shared_ptr<BinData> > & data, const IModelFunction & func,
+                                       const FitConfig & config, bool likelihood, bool extended, unsigned int nThreads) {
+   return DoFitMany(data, func, config, likelihood, extended, nThreads);
+}
+
+std::vector<FitResult> Fitter::FitMany(const std::vector<std::shared_ptr<UnBinData> > & data, const IModelFunction & func,
+                                       const FitConfig & config, bool extended, unsigned int nThreads) {
+   return DoFitMany(data, func, config, true, extended, nThreads);
+}
+
+template <class Data>
+std::vector<FitResult> Fitter::DoMultiStartFit(const std::shared_ptr<Data> & data, const std::vector<std::vector<double> > & startValues,
+                                               bool likelihood, bool extended, unsigned int nThreads) {
+   // run a fit for each starting point and keep the state of the best one
+
+   std::vector<FitResult> results;
+   if (!fFunc) {
+      MATH_ERROR_MSG("Fitter::MultiStartFit","Fit model function has not been set");
+      return results;
+   }
+   const unsigned int npar = fFunc->NPar();
+   for (const auto & x : startValues) {
+      if (x.size() != npar) {
+         MATH_ERROR_MSG("Fitter::MultiStartFit","Wrong number of initial parameter values");
+         return results;
+      }
+   }
+
+   FitConfig config(fConfig);
+   if (config.NPar() != npar) config.CreateParamsSettings(*fFunc);
+   UseThreadSafeMinimizer(config, nThreads, "Fitter::MultiStartFit");
+   const bool useGradient = fUseGradient;
+
+   std::vector<std::unique_ptr<Fitter> > fitters(startValues.size());
+   results.resize(startValues.size());
+   ExecuteTasks(startValues.size(), nThreads, [&](unsigned int i) {
+      std::unique_ptr<Fitter> fitter(new Fitter());
+      fitter->SetFunction(*fFunc, useGradient);
+      fitter->fConfig = config;
+      for (unsigned int ipar = 0; ipar < npar; ++ipar)
+         fitter->fConfig.ParSettings(ipar).SetValue(startValues[i][ipar]);
+      FitDataSet(*fitter, data, likelihood, extended);
+      if (fitter->fResult) results[i] = *fitter->fResult;
+      fitters[i] = std::move(fitter);
+   });
+
+   // the best fit is the valid one with the smallest minimum
+   int ibest = -1;
+   for (unsigned int i = 0; i < fitters.size(); ++i) {
+      if (!fitters[i]->fResult) continue;
+      if (ibest >= 0) {
+         const FitResult & best = results[ibest];
+         if (best.IsValid() && !results[i].IsValid()) continue;
+         if (best.IsValid() == results[i].IsValid() && best.MinFcnValue() <= results[i].MinFcnValue()) continue;
+      }
+      ibest = i;
+   }
+   if (ibest < 0) {
+      MATH_ERROR_MSG("Fitter::MultiStartFit","All the fits failed");
+      return results;
+   }
+
+   Fitter & best = *fitters[ibest];
+   fUseGradient = best.fUseGradient;
+   fBinFit = best.fBinFit;
+   fFitType = best.fFitType;
+   fDataSize = best.fDataSize;
+   fConfig = best.fConfig;
+   fFunc = best.fFunc;
+   fFunc_v.reset();
+   fResult = best.fResult;
+   fMinimizer = best.fMinimizer;
+   fData = best.fData;
+   fObjFunction = best.fObjFunction;
+   return results;
+}
+
+std::vector<FitResult> Fitter::MultiStartFit(const std::shared_ptr<BinData> & data, const std::vector<std::vector<double> > & startValues,
+                                             bool likelihood, bool extended, unsigned int nThreads) {
+   return DoMultiStartFit(data, startValues, likelihood, extended, nThreads);
+}
+
+std::vector<FitResult> Fitter::MultiStartFit(const std::shared_ptr<UnBinData> & data, const std::vector<std::vector<double> > & startValues,
+                                             bool extended, unsigned int nThreads) {
+   return DoMultiStartFit(data, startValues, true, extended, nThreads);
+}
+
    } // end namespace Fit
 
 } // end namespace ROOT
@@ -14,10 +14,54 @@
 
 #include "TString.h"
 #include <string.h>
+#include <functional>
 #include <limits>
 
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
 templateClassImp(TKDTree);
 
+namespace {
+
+   // minimum number of points for building the tree with several threads
+   const Int_t kMinParallelBuild = 100000;
+   // number of points searched by each task of the batched searches
+   const Int_t kQueryChunkSize = 256;
+   // number of points of a terminal node whose distances are computed together
+   const Int_t kDistanceBlock = 64;
+
+   // subtree of the kd-tree still to be built
+   struct TKDTreeBuildTask {
+      Int_t fNode;     // index of the top node
+      Int_t fRow;      // row of the top node
+      Int_t fPos;      // position of the first point in the index array
+      Int_t fNPoints;  // number of points
+   };
+
+   // call func(first, last) on consecutive chunks of [0, n), concurrently if the
+   // implicit multi-threading is enabled and there is more than one chunk
+   void ExecuteChunks(Int_t n, const std::function<void(Int_t, Int_t)> &func)
+   {
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && n > kQueryChunkSize) {
+         const UInt_t nChunks = (n + kQueryChunkSize - 1) / kQueryChunkSize;
+         ROOT::TThreadExecutor pool;
+         pool.Foreach([&](UInt_t ichunk) {
+            Int_t first = ichunk * kQueryChunkSize;
+            func(first, TMath::Min(first + kQueryChunkSize, n));
+         }, ROOT::TSeqU(nChunks));
+         return;
+      }
+#endif
+      func(0, n);
+   }
+
+}
+
 
 /**
 \class TKDTree
@@ -29,6 +73,7 @@ Contents:
 3. Using TKDTree
    a. Creating the kd-tree and setting the data
    b. Navigating the kd-tree
+   c. Searching many points
 4. TKDTree implementation - technical details
    a. The order of nodes in internal arrays
    b. Division algorithm
@@ -159,6 +204,19 @@ in the 2 subtrees as close as possible. The following section gives more details
     part of the index array. To find the number of point in the node
     (not only terminal), call TKDTree::GetNpointsNode(Index inode).
 
+#### 3c. Searching many points
+
+    The nearest neighbours and the points in range of many query points can be searched with a
+    single call, giving the query points row-wise (point i starts at points[i*ndim]):
+\code{.cpp}
+    std::vector<Int_t> ind(nquery*k);
+    std::vector<Double_t> dist(nquery*k);
+    kdtree->FindNearestNeighbors(nquery, points, k, ind.data(), dist.data());
+\endcode
+    When the implicit multi-threading is enabled (ROOT::EnableImplicitMT()) the query points are
+    searched concurrently, as well as the subtrees during the building of large trees. The results
+    are the same as with a single thread.
+
 ### 4.  TKDtree implementation details - internal information, not needed to use the kd-tree.
 
 ####  4a. Order of nodes in the node information arrays:
@@ -449,93 +507,138 @@ void TKDTree<Index, Value>::Build()
    //
    //
    //4.
+#ifdef R__USE_IMT
+   // the subtrees use disjoint parts of the index and node arrays: divide the first rows
+   // until there are enough subtrees, then build them concurrently
+   if (fNPoints >= kMinParallelBuild && ROOT::IsImplicitMTEnabled()) {
+      const UInt_t nTasks = 4 * ROOT::GetImplicitMTPoolSize();
+      std::vector<TKDTreeBuildTask> tasks(1);
+      tasks[0].fNode = 0; tasks[0].fRow = 0; tasks[0].fPos = 0; tasks[0].fNPoints = fNPoints;
+      while (!tasks.empty() && tasks.size() < nTasks) {
+         std::vector<TKDTreeBuildTask> next;
+         for (UInt_t i=0; i<tasks.size(); i++){
+            const TKDTreeBuildTask &t = tasks[i];
+            if (t.fNPoints<=fBucketSize) continue; // terminal node
+            Int_t nleft;
+            DivideNode(t.fNode, t.fRow, t.fPos, t.fNPoints, nleft);
+            TKDTreeBuildTask left = {2*t.fNode+1, t.fRow+1, t.fPos, nleft};
+            TKDTreeBuildTask right = {2*t.fNode+2, t.fRow+1, t.fPos+nleft, t.fNPoints-nleft};
+            next.push_back(left);
+            next.push_back(right);
+         }
+         tasks.swap(next);
+      }
+      if (tasks.empty()) return;
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t i) {
+         BuildSubtree(tasks[i].fNode, tasks[i].fRow, tasks[i].fPos, tasks[i].fNPoints);
+      }, ROOT::TSeqU(tasks.size()));
+      return;
+   }
+#endif
+   BuildSubtree(0, 0, 0, fNPoints);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Divide the npoints points starting at position pos of the index array,
+/// belonging to the node of the given row: set the cutting axis and value of the node
+/// and reorder the points such that the nleft first ones belong to the left daughter.
+/// See class description, section 4b for the details of the division algorithm
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints, Int_t &nleft)
+{
+   // divide points
+   Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
+   if (npoints%fBucketSize) nbuckets0++;            //
+   Int_t restRows = fRowT0-crow;                    // rest of fully occupied node row
+   if (restRows<0) restRows =0;
+   for (;nbuckets0>(2<<restRows); restRows++) {}
+   Int_t nfull = 1<<restRows;
+   Int_t nrest = nbuckets0-nfull;
+   Int_t nright =0;
+   nleft =0;
+   //
+   if (nrest>(nfull/2)){
+      nleft  = nfull*fBucketSize;
+      nright = npoints-nleft;
+   }else{
+      nright = nfull*fBucketSize/2;
+      nleft  = npoints-nright;
+   }
+
+   //
+   //find the axis with biggest spread
+   Value maxspread=0;
+   Value tempspread, min, max;
+   Index axspread=0;
+   Value *array;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      array = fData[idim];
+      Spread(npoints, array, fIndPoints+cpos, min, max);
+      tempspread = max - min;
+      if (maxspread < tempspread) {
+         maxspread=tempspread;
+         axspread = idim;
+      }
+      if(cnode) continue;
+      //printf("set %d %6.3f %6.3f\n", idim, min, max);
+      fRange[2*idim] = min; fRange[2*idim+1] = max;
+   }
+   array = fData[axspread];
+   KOrdStat(npoints, array, nleft, fIndPoints+cpos);
+   fAxis[cnode]  = axspread;
+   fValue[cnode] = array[fIndPoints[cpos+nleft]];
+   //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
+   //
+   if (0){
+      // consistency check
+      Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
+      if (nleft<nright) Warning("Build", "Problem Left-Right");
+      if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Non recursive building of the subtree of the given node, containing the npoints points
+/// starting at position pos of the index array
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::BuildSubtree(Int_t node, Int_t row, Int_t pos, Int_t npoints)
+{
    //    stack for non recursive build - size 128 bytes enough
    Int_t rowStack[128];
    Int_t nodeStack[128];
    Int_t npointStack[128];
    Int_t posStack[128];
    Int_t currentIndex = 0;
-   Int_t iter =0;
-   rowStack[0]    = 0;
-   nodeStack[0]   = 0;
-   npointStack[0] = fNPoints;
-   posStack[0]   = 0;
+   rowStack[0]    = row;
+   nodeStack[0]   = node;
+   npointStack[0] = npoints;
+   posStack[0]    = pos;
    //
-   Int_t nbucketsall =0;
    while (currentIndex>=0){
-      iter++;
       //
-      Int_t npoints  = npointStack[currentIndex];
-      if (npoints<=fBucketSize) {
-         //printf("terminal node : index %d iter %d\n", currentIndex, iter);
+      Int_t cpoints  = npointStack[currentIndex];
+      if (cpoints<=fBucketSize) {
          currentIndex--;
-         nbucketsall++;
          continue; // terminal node
       }
       Int_t crow     = rowStack[currentIndex];
       Int_t cpos     = posStack[currentIndex];
       Int_t cnode    = nodeStack[currentIndex];
-      //printf("currentIndex %d npoints %d node %d\n", currentIndex, npoints, cnode);
-      //
-      // divide points
-      Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
-      if (npoints%fBucketSize) nbuckets0++;            //
-      Int_t restRows = fRowT0-rowStack[currentIndex];  // rest of fully occupied node row
-      if (restRows<0) restRows =0;
-      for (;nbuckets0>(2<<restRows); restRows++) {}
-      Int_t nfull = 1<<restRows;
-      Int_t nrest = nbuckets0-nfull;
-      Int_t nleft =0, nright =0;
-      //
-      if (nrest>(nfull/2)){
-         nleft  = nfull*fBucketSize;
-         nright = npoints-nleft;
-      }else{
-         nright = nfull*fBucketSize/2;
-         nleft  = npoints-nright;
-      }
-
-      //
-      //find the axis with biggest spread
-      Value maxspread=0;
-      Value tempspread, min, max;
-      Index axspread=0;
-      Value *array;
-      for (Int_t idim=0; idim<fNDim; idim++){
-         array = fData[idim];
-         Spread(npoints, array, fIndPoints+cpos, min, max);
-         tempspread = max - min;
-         if (maxspread < tempspread) {
-            maxspread=tempspread;
-            axspread = idim;
-         }
-         if(cnode) continue;
-         //printf("set %d %6.3f %6.3f\n", idim, min, max);
-         fRange[2*idim] = min; fRange[2*idim+1] = max;
-      }
-      array = fData[axspread];
-      KOrdStat(npoints, array, nleft, fIndPoints+cpos);
-      fAxis[cnode]  = axspread;
-      fValue[cnode] = array[fIndPoints[cpos+nleft]];
-      //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
-      //
+      Int_t nleft;
+      DivideNode(cnode, crow, cpos, cpoints, nleft);
       //
       npointStack[currentIndex] = nleft;
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos;
       nodeStack[currentIndex]   = cnode*2+1;
       currentIndex++;
-      npointStack[currentIndex] = nright;
+      npointStack[currentIndex] = cpoints-nleft;
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos+nleft;
       nodeStack[currentIndex]   = (cnode*2)+2;
-      //
-      if (0){
-         // consistency check
-         Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
-         if (nleft<nright) Warning("Build", "Problem Left-Right");
-         if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
-      }
    }
 }
 
@@ -561,6 +664,36 @@ void TKDTree<Index, Value>::FindNearestNeighbors(const Value *point, const Int_t
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find the kNN nearest neighbors of each of the npoints points given row-wise in the
+///array points (the point i starts at points[i*GetNDim()])
+///The neighbors of the point i are returned in ind[i*kNN] ... ind[i*kNN+kNN-1] and their
+///distances in the same elements of dist, as for FindNearestNeighbors(point, kNN, ind, dist)
+///Arrays ind and dist are provided by the user and are assumed to be at least npoints*kNN elements long
+///The points are searched concurrently when the implicit multi-threading is enabled
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindNearestNeighbors(Index npoints, const Value *points, const Int_t kNN, Index *ind, Value *dist)
+{
+   if (!ind || !dist) {
+      Error("FindNearestNeighbors", "Working arrays must be allocated by the user!");
+      return;
+   }
+   // the boundaries are built before the concurrent searches, which then only read the tree
+   MakeBoundariesExact();
+   ExecuteChunks(npoints, [&](Int_t first, Int_t last) {
+      for (Int_t ipoint=first; ipoint<last; ipoint++){
+         Index *pind = ind + ipoint*kNN;
+         Value *pdist = dist + ipoint*kNN;
+         for (Int_t i=0; i<kNN; i++){
+            pdist[i]=std::numeric_limits<Value>::max();
+            pind[i]=-1;
+         }
+         UpdateNearestNeighbors(0, points + ipoint*fNDim, kNN, pind, pdist);
+      }
+   });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Update the nearest neighbors values by examining the node inode
 
@@ -575,24 +708,29 @@ void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *poi
       return;
    }
    if (IsTerminal(inode)) {
-      //examine points one by one
+      //examine the points by blocks
       Index f1, l1, f2, l2;
       GetNodePointsIndexes(inode, f1, l1, f2, l2);
-      for (Int_t ipoint=f1; ipoint<=l1; ipoint++){
-         Double_t d = Distance(point, fIndPoints[ipoint]);
-         if (d<dist[kNN-1]){
-            //found a closer point
-            Int_t ishift=0;
-            while(ishift<kNN && d>dist[ishift])
-               ishift++;
-            //replace the neighbor #ishift with the found point
-            //and shift the rest 1 index value to the right
-            for (Int_t i=kNN-1; i>ishift; i--){
-               dist[i]=dist[i-1];
-               ind[i]=ind[i-1];
+      Double_t d2[kDistanceBlock];
+      for (Int_t first=f1; first<=l1; first+=kDistanceBlock){
+         const Int_t n = TMath::Min(kDistanceBlock, l1-first+1);
+         DistancesSquared(point, fIndPoints+first, n, d2);
+         for (Int_t j=0; j<n; j++){
+            Double_t d = TMath::Sqrt(d2[j]);
+            if (d<dist[kNN-1]){
+               //found a closer point
+               Int_t ishift=0;
+               while(ishift<kNN && d>dist[ishift])
+                  ishift++;
+               //replace the neighbor #ishift with the found point
+               //and shift the rest 1 index value to the right
+               for (Int_t i=kNN-1; i>ishift; i--){
+                  dist[i]=dist[i-1];
+                  ind[i]=ind[i-1];
+               }
+               dist[ishift]=d;
+               ind[ishift]=fIndPoints[first+j];
             }
-            dist[ishift]=d;
-            ind[ishift]=fIndPoints[ipoint];
          }
       }
       return;
@@ -607,6 +745,24 @@ void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *poi
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Compute the squared L2 distances between point and the npoints points with indexes ind.
+///The loops over the points are vectorizable, the result is the same as with Distance()
+
+template <typename Index, typename Value>
+void TKDTree<Index, Value>::DistancesSquared(const Value *point, const Index *ind, Int_t npoints, Double_t *dist2) const
+{
+   for (Int_t j=0; j<npoints; j++) dist2[j] = 0;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      const Value *col = fData[idim];
+      const Value p = point[idim];
+      for (Int_t j=0; j<npoints; j++){
+         const Value dx = p-col[ind[j]];
+         dist2[j] += dx*dx;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Find the distance between point of the first argument and the point at index value ind
 ///Type argument specifies the metric: type=2 - L2 metric, type=1 - L1 metric
@@ -757,11 +913,31 @@ void TKDTree<Index, Value>::FindInRange(Value * point, Value range, std::vector<
    UpdateRange(0, point, range, res);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find all points in the sphere of a given radius "range" around each of the npoints points
+///given row-wise in the array points (the point i starts at points[i*GetNDim()])
+///The points found around the point i are returned in res[i], as for FindInRange(point, range, res[i])
+///The points are searched concurrently when the implicit multi-threading is enabled
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindInRange(Index npoints, const Value *points, Value range, std::vector<std::vector<Index> > &res)
+{
+   res.resize(npoints);
+   // the boundaries are built before the concurrent searches, which then only read the tree
+   MakeBoundariesExact();
+   ExecuteChunks(npoints, [&](Int_t first, Int_t last) {
+      for (Int_t ipoint=first; ipoint<last; ipoint++){
+         res[ipoint].clear();
+         UpdateRange(0, points + ipoint*fNDim, range, res[ipoint]);
+      }
+   });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Internal recursive function with the implementation of range searches
 
 template <typename  Index, typename Value>
-void TKDTree<Index, Value>::UpdateRange(Index inode, Value* point, Value range, std::vector<Index> &res)
+void TKDTree<Index, Value>::UpdateRange(Index inode, const Value* point, Value range, std::vector<Index> &res)
 {
    Value min, max;
    DistanceToNode(point, inode, min, max);
@@ -786,14 +962,17 @@ void TKDTree<Index, Value>::UpdateRange(Index inode, Value* point, Value range,
 
    //this node intersects with the range
    if (IsTerminal(inode)){
-      //examine the points one by one
+      //examine the points by blocks
       Index f1, l1, f2, l2;
-      Double_t d;
+      Double_t d2[kDistanceBlock];
       GetNodePointsIndexes(inode, f1, l1, f2, l2);
-      for (Int_t ipoint=f1; ipoint<=l1; ipoint++){
-         d = Distance(point, fIndPoints[ipoint]);
-         if (d <= range){
-            res.push_back(fIndPoints[ipoint]);
+      for (Int_t first=f1; first<=l1; first+=kDistanceBlock){
+         const Int_t n = TMath::Min(kDistanceBlock, l1-first+1);
+         DistancesSquared(point, fIndPoints+first, n, d2);
+         for (Int_t j=0; j<n; j++){
+            if (TMath::Sqrt(d2[j]) <= range){
+               res.push_back(fIndPoints[first+j]);
+            }
          }
       }
       return;
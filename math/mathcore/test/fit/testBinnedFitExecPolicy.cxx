@@ -8,6 +8,11 @@
 #include "TStopwatch.h"
 #include "TROOT.h"
 #include "Math/MinimizerOptions.h"
+#include "Math/WrappedMultiTF1.h"
+#include "Fit/Fitter.h"
+#include "Fit/BinData.h"
+#include "Fit/Chi2FCN.h"
+#include "HFitInterface.h"
 
 #include <chrono>
 
@@ -100,6 +105,83 @@ int main()
    std::cout << "Time for the Mutithreaded Binned Likelihood Fit :" << duration.count() << std::endl;
 #endif
 
+#ifndef R__WIN32
+   std::cout << "\n **FIT: Multiprocess Chi2 **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   start = std::chrono::system_clock::now();
+   auto r5 = h1f.Fit(f, "MULTIPROC S");
+   if ((Int_t)r5 != 0) {
+      Error("testBinnedFitExecPolicy", "Multiprocess Chi2 Fit failed!");
+      return -1;
+   } else {
+      if (!compareResult(r5->MinFcnValue(), r1->MinFcnValue(), "Multiprocess Chi2 Fit: "))
+         return 7;
+   }
+   end =  std::chrono::system_clock::now();
+   duration = end - start;
+   std::cout << "Time for the Multiprocess Chi2 Fit: " << duration.count() << std::endl;
+
+   std::cout << "\n **FIT: Multiprocess Binned Likelihood **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   start = std::chrono::system_clock::now();
+   auto rL5 = h1f.Fit(f, "MULTIPROC S L");
+   if ((Int_t)rL5 != 0) {
+      Error("testBinnedFitExecPolicy", "Multiprocess Binned Likelihood Fit failed!");
+      return -1;
+   } else {
+      if (!compareResult(rL5->MinFcnValue(), rL1->MinFcnValue(), "Multiprocess Binned Likelihood Fit (PoissonLogL): "))
+         return 8;
+   }
+   end =  std::chrono::system_clock::now();
+   duration = end - start;
+   std::cout << "Time for the Multiprocess Binned Likelihood Fit: " << duration.count() << std::endl;
+#endif
+
+   std::cout << "\n **FIT: Parallel fit of many histograms **\n\n";
+   {
+      // split the histogram in independent data sets with the same model function
+      const int nsets = 20;
+      std::vector<std::shared_ptr<ROOT::Fit::BinData>> datasets(nsets);
+      TH1D hs("hs", "Test random numbers", 1280, 100, 200);
+      for (int i = 0; i < nsets; ++i) {
+         hs.Reset();
+         hs.FillRandom("fvCore", 100000);
+         datasets[i] = std::make_shared<ROOT::Fit::BinData>();
+         ROOT::Fit::FillData(*datasets[i], &hs);
+      }
+      f->SetParameters(1, 1000, 7.5, 1.5);
+      // the function is cloned by each fit, thus the wrapper must own a copy of the TF1
+      ROOT::Math::WrappedMultiTF1 wf(*f, 1);
+      wf.SetAndCopyFunction();
+      ROOT::Fit::FitConfig config;
+      config.SetMinimizer("Minuit2");
+      start = std::chrono::system_clock::now();
+      auto results = ROOT::Fit::Fitter::FitMany(datasets, wf, config);
+      end = std::chrono::system_clock::now();
+      duration = end - start;
+      std::cout << "Time for the parallel fit of " << nsets << " histograms: " << duration.count() << std::endl;
+      for (int i = 0; i < nsets; ++i) {
+         ROOT::Fit::Fitter fitter;
+         fitter.Config() = config;
+         fitter.Fit(*datasets[i], wf);
+         if (!results[i].IsValid() || !compareResult(results[i].MinFcnValue(), fitter.Result().MinFcnValue(), "Parallel fit of many histograms: "))
+            return 11;
+      }
+
+      // multi-start fit: the best fit must be kept by the fitter
+      ROOT::Fit::Fitter fitter;
+      fitter.SetFunction(wf);
+      fitter.Config().SetMinimizer("Minuit2");
+      std::vector<std::vector<double>> startValues = {{1, 1000, 7.5, 1.5}, {10, 100, 5., 1.}, {1, 5000, 10., 2.}};
+      auto mresults = fitter.MultiStartFit(datasets[0], startValues);
+      if (mresults.size() != startValues.size() || !fitter.Result().IsValid())
+         return 12;
+      for (const auto &r : mresults) {
+         if (r.IsValid() && r.MinFcnValue() < fitter.Result().MinFcnValue())
+            return 12;
+      }
+   }
+
 #ifdef R__HAS_VECCORE
    TF1 *fvecCore = new TF1("fvCore", func<ROOT::Double_v>, 100, 200, 4);
 
@@ -133,7 +215,130 @@ int main()
    end =  std::chrono::system_clock::now();
    duration = end - start;
    std::cout << "Time for the Vectorized Binned Likelihood Fit: " << duration.count() << std::endl;
-  
+
+   std::cout << "\n **FIT: Vectorized Chi2 with integral of the function in the bins **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto rI1 = h1f.Fit(f, "S I");
+   if ((Int_t)rI1 != 0) {
+      Error("testBinnedFitExecPolicy", "Sequential Chi2 Fit with integral option failed!");
+      return -1;
+   }
+   fvecCore->SetParameters(1, 1000, 7.5, 1.5);
+   start = std::chrono::system_clock::now();
+   auto rI3 = h1f.Fit(fvecCore, "S I");
+   if ((Int_t)rI3 != 0) {
+      Error("testBinnedFitExecPolicy", "Vectorized Chi2 Fit with integral option failed!");
+      return -1;
+   } else {
+      if (!compareResult(rI3->MinFcnValue(), rI1->MinFcnValue(), "Vectorized Chi2 Fit with integral option: "))
+         return 9;
+   }
+   end =  std::chrono::system_clock::now();
+   duration = end - start;
+   std::cout << "Time for the Vectorized Chi2 Fit with integral option: " << duration.count() << std::endl;
+
+   std::cout << "\n **FIT: Vectorized Binned Likelihood with integral of the function in the bins **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto rLI1 = h1f.Fit(f, "S L I");
+   if ((Int_t)rLI1 != 0) {
+      Error("testBinnedFitExecPolicy", "Sequential Binned Likelihood Fit with integral option failed!");
+      return -1;
+   }
+   fvecCore->SetParameters(1, 1000, 7.5, 1.5);
+   start = std::chrono::system_clock::now();
+   auto rLI3 = h1f.Fit(fvecCore, "S L I");
+   if ((Int_t)rLI3 != 0) {
+      Error("testBinnedFitExecPolicy", "Vectorized Binned Likelihood Fit with integral option failed!");
+      return -1;
+   } else {
+      if (!compareResult(rLI3->MinFcnValue(), rLI1->MinFcnValue(),
+                         "Vectorized Binned Likelihood Fit (PoissonLogL) with integral option: "))
+         return 10;
+   }
+   end =  std::chrono::system_clock::now();
+   duration = end - start;
+   std::cout << "Time for the Vectorized Binned Likelihood Fit with integral option: " << duration.count() << std::endl;
+
+   std::cout << "\n **FIT: Vectorized Chi2 with the bin volume **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto rW1 = h1f.Fit(f, "S WIDTH");
+   if ((Int_t)rW1 != 0) {
+      Error("testBinnedFitExecPolicy", "Sequential Chi2 Fit with bin volume option failed!");
+      return -1;
+   }
+   fvecCore->SetParameters(1, 1000, 7.5, 1.5);
+   auto rW3 = h1f.Fit(fvecCore, "S WIDTH");
+   if ((Int_t)rW3 != 0) {
+      Error("testBinnedFitExecPolicy", "Vectorized Chi2 Fit with bin volume option failed!");
+      return -1;
+   } else {
+      if (!compareResult(rW3->MinFcnValue(), rW1->MinFcnValue(), "Vectorized Chi2 Fit with bin volume option: "))
+         return 13;
+   }
+
+   std::cout << "\n **FIT: Vectorized Chi2 with expected errors **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto rP1 = h1f.Fit(f, "S P");
+   if ((Int_t)rP1 != 0) {
+      Error("testBinnedFitExecPolicy", "Sequential Chi2 Fit with expected errors failed!");
+      return -1;
+   }
+   fvecCore->SetParameters(1, 1000, 7.5, 1.5);
+   auto rP3 = h1f.Fit(fvecCore, "S P");
+   if ((Int_t)rP3 != 0) {
+      Error("testBinnedFitExecPolicy", "Vectorized Chi2 Fit with expected errors failed!");
+      return -1;
+   } else {
+      if (!compareResult(rP3->MinFcnValue(), rP1->MinFcnValue(), "Vectorized Chi2 Fit with expected errors: "))
+         return 14;
+   }
+
+   std::cout << "\n **Vectorized Chi2 gradient with the bin volume and with expected errors **\n\n";
+   {
+      typedef ROOT::Math::IGradientFunctionMultiDimTempl<double> GradFunction;
+      const double params[4] = {1, 1000, 7.5, 1.5};
+      ROOT::Math::WrappedMultiTF1 wf(*f, 1);
+      ROOT::Math::WrappedMultiTF1Templ<ROOT::Double_v> wfv(*fvecCore, 1);
+      for (int iopt = 0; iopt < 2; ++iopt) {
+         ROOT::Fit::DataOptions opt;
+         if (iopt == 0) {
+            opt.fBinVolume = true;
+         } else {
+            opt.fExpErrors = true;
+            opt.fUseEmpty = true;
+         }
+         ROOT::Fit::BinData data(opt);
+         ROOT::Fit::FillData(data, &h1f);
+         ROOT::Fit::Chi2FCN<GradFunction> chi2(data, wf);
+         ROOT::Fit::Chi2FCN<GradFunction, ROOT::Math::IParamMultiFunctionTempl<ROOT::Double_v>> chi2v(data, wfv);
+         if (!compareResult(chi2v(params), chi2(params), "Vectorized Chi2 value: ", 1.E-6))
+            return 15;
+
+         double grad[4], gradv[4];
+         chi2v.Gradient(params, gradv);
+         double tol = 1.E-6;
+         if (iopt == 0) {
+            chi2.Gradient(params, grad);
+         } else {
+            // the scalar gradient ignores the expected errors: use a numerical derivative
+            tol = 1.E-3;
+            for (int ipar = 0; ipar < 4; ++ipar) {
+               double p1[4], p2[4];
+               std::copy(params, params + 4, p1);
+               std::copy(params, params + 4, p2);
+               double h = 1.E-5 * std::max(1., std::abs(params[ipar]));
+               p1[ipar] -= h;
+               p2[ipar] += h;
+               grad[ipar] = (chi2(p2) - chi2(p1)) / (2 * h);
+            }
+         }
+         for (int ipar = 0; ipar < 4; ++ipar) {
+            if (!compareResult(gradv[ipar], grad[ipar], "Vectorized Chi2 gradient: ", tol))
+               return 15;
+         }
+      }
+   }
+
 
 #ifdef R__USE_IMT
    std::cout << "\n **FIT: Mutithreaded vectorized Chi2 **\n\n";
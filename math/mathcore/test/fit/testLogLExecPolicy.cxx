@@ -276,8 +276,17 @@ int main()
       return -1;
    }
 
-#if defined(R__USE_IMT) || defined(R__HAS_VECCORE)
    auto seq = test.GetFitter().Result().MinFcnValue();
+
+#ifndef R__WIN32
+   //Multiprocess
+   if (!test.testMPFit()) {
+      Error("testLogLExecPolicy", "Multiprocess Fit failed!");
+      return -1;
+   }
+   auto seqMP = test.GetFitter().Result().MinFcnValue();
+   if (!compareResult(seqMP, seq, "Multiprocess LogL Fit: "))
+      return 4;
 #endif
 
 #ifdef R__USE_IMT
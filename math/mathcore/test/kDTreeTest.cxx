@@ -2,6 +2,7 @@
   Test macro for TKDTree
 
   TestBuild();       // test build function of kdTree for memory leaks
+  TestBatch();       // test the searches of many points with a single call
   TestSpeed();       // test the CPU consumption to build kdTree
   TestkdtreeIF();    // test functionality of the kdTree
   TestSizeIF();      // test the size of kdtree - search application - Alice TPC tracker situation
@@ -15,6 +16,7 @@
 #include "TGraph.h"
 #include "TStopwatch.h"
 #include "TKDTree.h"
+#include "TROOT.h"
 #include "TApplication.h"
 #include "TCanvas.h"
 #include <iostream>
@@ -26,6 +28,7 @@ bool showGraphics = false;
 void TestBuild(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestConstr(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestSpeed(Int_t npower2 = 20, Int_t bsize = 10);
+Int_t TestBatch(Int_t npoints = 100000, Int_t nquery = 10000, Int_t bsize = 10);
 
 //void TestkdtreeIF(Int_t npoints=1000, Int_t bsize=9, Int_t nloop=1000, Int_t mode = 2);
 //void TestSizeIF(Int_t nsec=36, Int_t nrows=159, Int_t npoints=1000,  Int_t bsize=10, Int_t mode=1);
@@ -45,12 +48,14 @@ Float_t Mem()
 ///
 ///
 
-void kDTreeTest()
+Int_t kDTreeTest()
 {
   printf("\n\tTesting kDTree memory usage ...\n");
   TestBuild();
   printf("\n\tTesting kDTree speed ...\n");
   TestSpeed();
+  printf("\n\tTesting kDTree batched searches ...\n");
+  return TestBatch();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -552,6 +557,106 @@ void TestRange()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+///Test the searches of many points with a single call of TKDTree::FindNearestNeighbors()
+///and TKDTree::FindInRange() with the implicit multi-threading enabled. The tree built in
+///parallel must be identical to the one built serially, and the batched searches must give
+///the same results as the searches point by point and as the "brute force" method.
+///Return the number of differences found.
+
+Int_t TestBatch(Int_t npoints, Int_t nquery, Int_t bsize)
+{
+   const Int_t ndim = 3;
+   const Int_t nn = 10;
+   const Double_t range = 5;
+   const Int_t nbrute = TMath::Min(nquery, 200);
+   std::vector<Double_t> data(ndim*npoints);
+   for (Int_t i=0; i<ndim*npoints; i++) data[i] = gRandom->Uniform(-100, 100);
+   std::vector<Double_t> points(ndim*nquery);
+   for (Int_t i=0; i<ndim*nquery; i++) points[i] = gRandom->Uniform(-100, 100);
+
+   // reference tree built serially
+   ROOT::DisableImplicitMT();
+   TKDTreeID *serial = new TKDTreeID(npoints, ndim, bsize);
+   for (Int_t idim=0; idim<ndim; idim++) serial->SetData(idim, &data[idim*npoints]);
+   serial->Build();
+
+   ROOT::EnableImplicitMT();
+   TStopwatch timer;
+   TKDTreeID *kdtree = new TKDTreeID(npoints, ndim, bsize);
+   for (Int_t idim=0; idim<ndim; idim++) kdtree->SetData(idim, &data[idim*npoints]);
+   kdtree->Build();
+   printf("Build of the tree with %d points: %f s\n", npoints, timer.RealTime());
+
+   Int_t ndiffTree = 0;
+   if (kdtree->GetNNodes() != serial->GetNNodes()) ndiffTree++;
+   for (Int_t inode=0; inode<kdtree->GetNNodes(); inode++){
+      if (kdtree->GetNodeAxis(inode) != serial->GetNodeAxis(inode) ||
+          kdtree->GetNodeValue(inode) != serial->GetNodeValue(inode)) ndiffTree++;
+   }
+   for (Int_t i=0; i<npoints; i++){
+      if (kdtree->GetIndPoints()[i] != serial->GetIndPoints()[i]) ndiffTree++;
+   }
+   printf("%d differences found between the trees built in parallel and serially\n", ndiffTree);
+
+   std::vector<Int_t> index(nquery*nn);
+   std::vector<Double_t> dist(nquery*nn);
+   timer.Start();
+   kdtree->FindNearestNeighbors(nquery, points.data(), nn, index.data(), dist.data());
+   printf("Nearest neighbors of %d points: %f s\n", nquery, timer.RealTime());
+
+   std::vector<std::vector<Int_t> > inRange;
+   kdtree->FindInRange(nquery, points.data(), range, inRange);
+
+   Int_t ndiff = 0;
+   std::vector<Int_t> index2(nn);
+   std::vector<Double_t> dist2(nn);
+   std::vector<Int_t> inRange2;
+   for (Int_t i=0; i<nquery; i++){
+      serial->FindNearestNeighbors(&points[ndim*i], nn, index2.data(), dist2.data());
+      for (Int_t inn=0; inn<nn; inn++){
+         if (index[i*nn+inn] != index2[inn] || dist[i*nn+inn] != dist2[inn]) ndiff++;
+      }
+      inRange2.clear();
+      serial->FindInRange(&points[ndim*i], range, inRange2);
+      if (inRange[i] != inRange2) ndiff++;
+   }
+   printf("%d differences found between the batched and the single point searches\n", ndiff);
+
+   // "brute force" method for the first query points
+   Int_t ndiffBrute = 0;
+   std::vector<Double_t> bruteDist(npoints);
+   std::vector<Int_t> bruteIndex(npoints);
+   for (Int_t i=0; i<nbrute; i++){
+      const Double_t *point = &points[ndim*i];
+      for (Int_t ipoint=0; ipoint<npoints; ipoint++){
+         Double_t d = 0;
+         for (Int_t idim=0; idim<ndim; idim++){
+            Double_t dx = data[idim*npoints+ipoint]-point[idim];
+            d += dx*dx;
+         }
+         bruteDist[ipoint] = TMath::Sqrt(d);
+      }
+      TMath::Sort(npoints, bruteDist.data(), bruteIndex.data(), kFALSE);
+      for (Int_t inn=0; inn<nn; inn++){
+         if (index[i*nn+inn] != bruteIndex[inn] ||
+             TMath::Abs(dist[i*nn+inn]-bruteDist[bruteIndex[inn]])>1E-8) ndiffBrute++;
+      }
+      inRange2.clear();
+      for (Int_t ipoint=0; ipoint<npoints && bruteDist[bruteIndex[ipoint]]<=range; ipoint++)
+         inRange2.push_back(bruteIndex[ipoint]);
+      std::sort(inRange2.begin(), inRange2.end());
+      std::vector<Int_t> found(inRange[i]);
+      std::sort(found.begin(), found.end());
+      if (found != inRange2) ndiffBrute++;
+   }
+   printf("%d differences found between \"brute force\" method and the batched searches\n", ndiffBrute);
+
+   delete kdtree;
+   delete serial;
+   return ndiffTree + ndiff + ndiffBrute;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char **argv) {
@@ -579,7 +684,7 @@ int main(int argc, char **argv) {
    if ( showGraphics )
       theApp = new TApplication("App",&argc,argv);
 
-   kDTreeTest();
+   Int_t ndiff = kDTreeTest();
 
    if ( showGraphics )
    {
@@ -588,5 +693,5 @@ int main(int argc, char **argv) {
       theApp = 0;
    }
 
-   return 0;
+   return ndiff != 0;
 }
@@ -0,0 +1,212 @@
+// @(#)root/test:$Id$
+
+// Tests of the memory layout of the fit data classes: the owned buffers must be aligned
+// to 64 bytes and padded up to a multiple of the SIMD vector size, and the block accessors
+// (CoordData, ValueData, ErrorData, BinUpEdgeData, WeightData) must return the same values as
+// the per-point accessors, both for owned and for wrapped data.
+
+#include "Fit/BinData.h"
+#include "Fit/FitData.h"
+#include "Fit/UnBinData.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+using ROOT::Fit::BinData;
+using ROOT::Fit::FitData;
+using ROOT::Fit::UnBinData;
+
+// give access to the padding computed by the fit data classes
+struct FitDataPadding : public FitData {
+   using FitData::VectorPadding;
+};
+
+static bool IsAligned(const double *p, std::size_t alignment = 64)
+{
+   return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+// check that the owned buffer seen through the view is aligned and that the padding after the
+// last point can be read (it is zero initialized)
+static void CheckOwnedBuffer(std::array_view<double> view, unsigned int npoints)
+{
+   ASSERT_EQ(view.size(), npoints);
+   EXPECT_TRUE(IsAligned(view.data()));
+   const unsigned int padding = FitDataPadding::VectorPadding(npoints);
+   for (unsigned int i = npoints; i < npoints + padding; ++i)
+      EXPECT_EQ(0., view.data()[i]);
+}
+
+TEST(FitData, AlignedAllocator)
+{
+   ROOT::Fit::AlignedAllocator<double> alloc;
+   for (std::size_t n : {1, 3, 7, 8, 13, 64, 1001}) {
+      double *p = alloc.allocate(n);
+      EXPECT_TRUE(IsAligned(p)) << "n = " << n;
+      // the whole block must be writable
+      for (std::size_t i = 0; i < n; ++i)
+         p[i] = i;
+      alloc.deallocate(p, n);
+   }
+
+   ROOT::Fit::AlignedAllocator<char, 128> alloc128;
+   char *c = alloc128.allocate(5);
+   EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(c) % 128);
+   alloc128.deallocate(c, 5);
+
+   // the vectors keep the alignment when growing
+   FitData::DataVector v;
+   for (int i = 0; i < 1000; ++i) {
+      v.push_back(i);
+      ASSERT_TRUE(IsAligned(v.data())) << "size = " << v.size();
+   }
+}
+
+TEST(FitData, BinDataOwned)
+{
+   const unsigned int n = 13; // not a multiple of any SIMD vector size
+   BinData data(n, 2, BinData::kCoordError);
+   for (unsigned int i = 0; i < n; ++i) {
+      const double x[2] = {0.5 * i, -1. * i};
+      const double ex[2] = {0.1 + i, 0.2 + i};
+      data.Add(x, 10. + i, ex, 1. + 0.5 * i);
+   }
+   ASSERT_EQ(n, data.NPoints());
+
+   for (unsigned int icoord = 0; icoord < 2; ++icoord) {
+      auto coords = data.CoordData(icoord);
+      CheckOwnedBuffer(coords, n);
+      for (unsigned int i = 0; i < n; ++i)
+         EXPECT_EQ(data.Coords(i)[icoord], coords[i]);
+   }
+
+   auto values = data.ValueData();
+   CheckOwnedBuffer(values, n);
+   auto errors = data.ErrorData();
+   CheckOwnedBuffer(errors, n);
+   for (unsigned int i = 0; i < n; ++i) {
+      EXPECT_EQ(data.Value(i), values[i]);
+      // kCoordError stores the errors themselves
+      EXPECT_EQ(data.Error(i), errors[i]);
+      EXPECT_EQ(*data.ErrorPtr(i), errors[i]);
+   }
+}
+
+TEST(FitData, BinDataValueError)
+{
+   const unsigned int n = 9;
+   BinData data(n, 1, BinData::kValueError);
+   for (unsigned int i = 0; i < n; ++i)
+      data.Add(1. * i, 2. * i, 0.25 * (i + 1));
+
+   auto errors = data.ErrorData();
+   CheckOwnedBuffer(errors, n);
+   for (unsigned int i = 0; i < n; ++i) {
+      // kValueError stores the inverse of the errors
+      EXPECT_EQ(data.InvError(i), errors[i]);
+      EXPECT_DOUBLE_EQ(data.Error(i), 1. / errors[i]);
+   }
+
+   BinData noError(n, 1, BinData::kNoError);
+   for (unsigned int i = 0; i < n; ++i)
+      noError.Add(1. * i, 2. * i);
+   EXPECT_TRUE(noError.ErrorData().empty());
+   EXPECT_TRUE(noError.BinUpEdgeData(0).empty());
+}
+
+TEST(FitData, BinDataBinEdges)
+{
+   const unsigned int n = 11;
+   BinData data(n, 1, BinData::kNoError);
+   for (unsigned int i = 0; i < n; ++i) {
+      data.Add(1. * i, 3. * i);
+      const double xup = i + 1.;
+      data.AddBinUpEdge(&xup);
+   }
+   ASSERT_TRUE(data.HasBinEdges());
+
+   auto edges = data.BinUpEdgeData(0);
+   ASSERT_EQ(n, edges.size());
+   EXPECT_TRUE(IsAligned(edges.data()));
+   for (unsigned int i = 0; i < n; ++i) {
+      EXPECT_EQ(data.BinUpEdge(i)[0], edges[i]);
+      EXPECT_EQ(data.GetBinUpEdgeComponent(i, 0), edges[i]);
+   }
+}
+
+TEST(FitData, BinDataWrapped)
+{
+   const unsigned int n = 7;
+   std::vector<double> x(n), y(n), val(n), ex(n), ey(n), eval(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      x[i] = i;
+      y[i] = 2. * i;
+      val[i] = 5. + i;
+      ex[i] = 0.1;
+      ey[i] = 0.2;
+      eval[i] = 1. + i;
+   }
+   BinData data(n, x.data(), y.data(), val.data(), ex.data(), ey.data(), eval.data());
+   ASSERT_EQ(n, data.NPoints());
+
+   // the views point to the user memory, which is neither copied nor realigned
+   EXPECT_EQ(x.data(), data.CoordData(0).data());
+   EXPECT_EQ(y.data(), data.CoordData(1).data());
+   EXPECT_EQ(val.data(), data.ValueData().data());
+   EXPECT_EQ(eval.data(), data.ErrorData().data());
+
+   for (unsigned int i = 0; i < n; ++i) {
+      EXPECT_EQ(data.Coords(i)[0], data.CoordData(0)[i]);
+      EXPECT_EQ(data.Coords(i)[1], data.CoordData(1)[i]);
+      EXPECT_EQ(data.Value(i), data.ValueData()[i]);
+      EXPECT_EQ(data.Error(i), data.ErrorData()[i]);
+   }
+}
+
+TEST(FitData, UnBinDataOwned)
+{
+   const unsigned int n = 17;
+   UnBinData data(n, 2, /*isWeighted=*/true);
+   for (unsigned int i = 0; i < n; ++i) {
+      const double x[2] = {0.5 * i, -0.5 * i};
+      data.Add(x, 1. + i);
+   }
+   ASSERT_EQ(n, data.NPoints());
+   ASSERT_EQ(2u, data.NDim());
+
+   for (unsigned int icoord = 0; icoord < 2; ++icoord) {
+      auto coords = data.CoordData(icoord);
+      CheckOwnedBuffer(coords, n);
+      for (unsigned int i = 0; i < n; ++i)
+         EXPECT_EQ(data.Coords(i)[icoord], coords[i]);
+   }
+   auto weights = data.WeightData();
+   CheckOwnedBuffer(weights, n);
+   for (unsigned int i = 0; i < n; ++i)
+      EXPECT_EQ(data.Weight(i), weights[i]);
+
+   UnBinData unweighted(n, 1);
+   for (unsigned int i = 0; i < n; ++i)
+      unweighted.Add(1. * i);
+   CheckOwnedBuffer(unweighted.CoordData(0), n);
+   EXPECT_TRUE(unweighted.WeightData().empty());
+}
+
+TEST(FitData, UnBinDataWrapped)
+{
+   const unsigned int n = 5;
+   std::vector<double> x(n), y(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      x[i] = i;
+      y[i] = -0.5 * i;
+   }
+   UnBinData data(n, x.data(), y.data());
+   EXPECT_EQ(x.data(), data.CoordData(0).data());
+   EXPECT_EQ(y.data(), data.CoordData(1).data());
+   for (unsigned int i = 0; i < n; ++i) {
+      EXPECT_EQ(data.Coords(i)[0], data.CoordData(0)[i]);
+      EXPECT_EQ(data.Coords(i)[1], data.CoordData(1)[i]);
+   }
+}
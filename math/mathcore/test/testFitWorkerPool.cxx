@@ -0,0 +1,60 @@
+// @(#)root/test:$Id$
+
+// Tests of the worker processes of the kMultiprocess execution policy: several pools can live
+// in the same process (e.g. one per fit method function) and each one can be stopped
+// independently of the others.
+
+#include "Fit/FitWorkerPool.h"
+
+#include "gtest/gtest.h"
+
+using ROOT::Fit::FitWorkerPool;
+
+#ifndef _WIN32
+
+// sum of p[0] * i for i in [begin, end)
+static void SumChunk(const double *p, unsigned int begin, unsigned int end, double *result)
+{
+   for (unsigned int i = begin; i < end; ++i)
+      result[0] += p[0] * i;
+}
+
+TEST(FitWorkerPool, Evaluate)
+{
+   FitWorkerPool pool(3);
+   ASSERT_TRUE(pool.Start("sum", 100, 1, 1, SumChunk));
+   EXPECT_TRUE(pool.IsRunning("sum"));
+   EXPECT_FALSE(pool.IsRunning("other"));
+   EXPECT_FALSE(pool.HasFailed("sum"));
+   for (double p : {1., 2., -0.5}) {
+      double result = 0;
+      ASSERT_TRUE(pool.Evaluate(&p, &result));
+      EXPECT_EQ(p * 4950, result);
+   }
+   pool.Stop();
+   EXPECT_FALSE(pool.IsRunning("sum"));
+}
+
+// The workers of a pool inherit the pipes of the pools started before: stopping the first pool
+// must not wait for workers which are still kept alive by the pipes of the second one
+TEST(FitWorkerPool, SeveralPools)
+{
+   FitWorkerPool first(2), second(3);
+   ASSERT_TRUE(first.Start("first", 50, 1, 1, SumChunk));
+   ASSERT_TRUE(second.Start("second", 100, 1, 1, SumChunk));
+   double p = 2, result = 0;
+   ASSERT_TRUE(first.Evaluate(&p, &result));
+   EXPECT_EQ(2 * 1225, result);
+
+   first.Stop();
+   ASSERT_TRUE(second.Evaluate(&p, &result));
+   EXPECT_EQ(2 * 4950, result);
+
+   // and the other way round
+   ASSERT_TRUE(first.Start("first", 50, 1, 1, SumChunk));
+   second.Stop();
+   ASSERT_TRUE(first.Evaluate(&p, &result));
+   EXPECT_EQ(2 * 1225, result);
+}
+
+#endif
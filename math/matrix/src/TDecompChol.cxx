@@ -26,6 +26,7 @@
 
 #include "TDecompChol.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 ClassImp(TDecompChol);
 
@@ -112,7 +113,7 @@ Bool_t TDecompChol::Decompose()
       return kFALSE;
    }
 
-   Int_t i,j,icol,irow;
+   Int_t icol,irow;
    const Int_t     n  = fU.GetNrows();
          Double_t *pU = fU.GetMatrixArray();
    for (icol = 0; icol < n; icol++) {
@@ -132,14 +133,20 @@ Bool_t TDecompChol::Decompose()
       pU[rowOff+icol] = ujj;
 
       if (icol < n-1) {
-         for (j = icol+1; j < n; j++) {
-            for (i = 0; i < icol; i++) {
-               const Int_t rowOff2 = i*n;
-               pU[rowOff+j] -= pU[rowOff2+j]*pU[rowOff2+icol];
+         // the elements of the row are independent: the inner loop runs over
+         // contiguous elements and the row can be split among threads
+         Double_t * const pRow = pU+rowOff+icol+1;
+         auto updateRow = [&](Int_t jBegin,Int_t jEnd) {
+            for (Int_t i = 0; i < icol; i++) {
+               const Double_t * const pRow2 = pU+i*n+icol+1;
+               const Double_t u_ij = pU[i*n+icol];
+               for (Int_t j = jBegin; j < jEnd; j++)
+                  pRow[j] -= pRow2[j]*u_ij;
             }
-         }
-         for (j = icol+1; j < n; j++)
-            pU[rowOff+j] /= ujj;
+            for (Int_t j = jBegin; j < jEnd; j++)
+               pRow[j] /= ujj;
+         };
+         TMatrixTParallel::For(n-icol-1,Double_t(n-icol-1)*icol,updateRow);
       }
    }
 
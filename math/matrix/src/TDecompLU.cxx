@@ -11,6 +11,7 @@
 
 #include "TDecompLU.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 ClassImp(TDecompLU);
 
@@ -603,11 +604,14 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
    Double_t *pLU   = lu.GetMatrixArray();
 
    Double_t work[kWorkMax];
+   Double_t workc[kWorkMax];
    Bool_t isAllocated = kFALSE;
    Double_t *scale = work;
+   Double_t *col   = workc;
    if (n > kWorkMax) {
       isAllocated = kTRUE;
       scale = new Double_t[n];
+      col   = new Double_t[n];
    }
 
    sign    = 1.0;
@@ -626,33 +630,41 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
 
    for (Int_t j = 0; j < n; j++) {
       const Int_t off_j = j*n;
+      // Work on a contiguous copy of the jth column
+      for (Int_t i = 0; i < n; i++)
+         col[i] = pLU[i*n+j];
+
       // Run down jth column from top to diag, to form the elements of U.
       for (Int_t i = 0; i < j; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < i; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
+         const Double_t * const pRow = pLU+i*n;
+         Double_t r = col[i];
+         for (Int_t k = 0; k < i; k++)
+            r -= pRow[k]*col[k];
+         col[i] = r;
       }
 
       // Run down jth subdiag to form the residuals after the elimination of
       // the first j-1 subdiags.  These residuals divided by the appropriate
       // diagonal term will become the multipliers in the elimination of the jth.
-      // subdiag. Find fIndex of largest scaled term in imax.
+      // subdiag. The rows are independent and can be split among threads.
+      auto residuals = [&](Int_t iBegin,Int_t iEnd) {
+         for (Int_t i = j+iBegin; i < j+iEnd; i++) {
+            const Double_t * const pRow = pLU+i*n;
+            Double_t r = col[i];
+            for (Int_t k = 0; k < j; k++)
+               r -= pRow[k]*col[k];
+            col[i] = r;
+         }
+      };
+      TMatrixTParallel::For(n-j,Double_t(n-j)*j,residuals);
 
+      // Find fIndex of largest scaled term in imax.
       Double_t max = 0.0;
       Int_t imax = 0;
-      for (Int_t i = j; i < n; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < j; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-         const Double_t tmp = scale[i]*TMath::Abs(r);
+      for (Int_t i = 0; i < n; i++) {
+         pLU[i*n+j] = col[i];
+         if (i < j) continue;
+         const Double_t tmp = scale[i]*TMath::Abs(col[i]);
          if (tmp >= max) {
             max = tmp;
             imax = i;
@@ -685,13 +697,18 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
          }
       } else {
          ::Error("TDecompLU::DecomposeLUCrout","matrix is singular");
-         if (isAllocated)  delete [] scale;
+         if (isAllocated) {
+            delete [] scale;
+            delete [] col;
+         }
          return kFALSE;
       }
    }
 
-   if (isAllocated)
+   if (isAllocated) {
       delete [] scale;
+      delete [] col;
+   }
 
    return kTRUE;
 }
@@ -749,17 +766,21 @@ Bool_t TDecompLU::DecomposeLUGauss(TMatrixD &lu,Int_t *index,Double_t &sign,
       if (mLUjj != 0.0) {
          if (TMath::Abs(mLUjj) < tol)
             nrZeros++;
-         for (Int_t i = j+1; i < n; i++) {
-            const Int_t off_i = i*n;
-            const Double_t mLUij = pLU[off_i+j]/mLUjj;
-            pLU[off_i+j] = mLUij;
-
-            for (Int_t k = j+1; k < n; k++) {
-               const Double_t mLUik = pLU[off_i+k];
-               const Double_t mLUjk = pLU[off_j+k];
-               pLU[off_i+k] = mLUik-mLUij*mLUjk;
+         // the rows below the pivot are updated independently
+         auto eliminate = [&](Int_t iBegin,Int_t iEnd) {
+            for (Int_t i = j+1+iBegin; i < j+1+iEnd; i++) {
+               const Int_t off_i = i*n;
+               const Double_t mLUij = pLU[off_i+j]/mLUjj;
+               pLU[off_i+j] = mLUij;
+
+               for (Int_t k = j+1; k < n; k++) {
+                  const Double_t mLUik = pLU[off_i+k];
+                  const Double_t mLUjk = pLU[off_j+k];
+                  pLU[off_i+k] = mLUik-mLUij*mLUjk;
+               }
             }
-         }
+         };
+         TMatrixTParallel::For(n-j-1,Double_t(n-j-1)*(n-j-1),eliminate);
       } else {
          ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
          return kFALSE;
@@ -864,18 +885,22 @@ Bool_t TDecompLU::InvertLU(TMatrixD &lu,Double_t tol,Double_t *det)
       // Compute current column of inv(A).
 
       if (j < n-1) {
-         const Double_t *mp = pLU+j+1;  // Matrix row ptr
-         Double_t *tp = pLU+j;          // Target vector ptr
-
-         for (Int_t irow = 0; irow < n; irow++) {
-            Double_t sum = 0.;
-            const Double_t *sp = pWorkd+j+1; // Source vector ptr
-            for (Int_t icol = 0; icol < n-1-j ; icol++)
-               sum += *mp++ * *sp++;
-            *tp = -sum + *tp;
-            mp += j+1;
-            tp += n;
-         }
+         // the rows are independent
+         auto solveRows = [&](Int_t rowBegin,Int_t rowEnd) {
+            const Double_t *mp = pLU+rowBegin*n+j+1;  // Matrix row ptr
+            Double_t *tp = pLU+rowBegin*n+j;          // Target vector ptr
+
+            for (Int_t irow = rowBegin; irow < rowEnd; irow++) {
+               Double_t sum = 0.;
+               const Double_t *sp = pWorkd+j+1; // Source vector ptr
+               for (Int_t icol = 0; icol < n-1-j ; icol++)
+                  sum += *mp++ * *sp++;
+               *tp = -sum + *tp;
+               mp += j+1;
+               tp += n;
+            }
+         };
+         TMatrixTParallel::For(n,Double_t(n)*(n-1-j),solveRows);
       }
    }
 
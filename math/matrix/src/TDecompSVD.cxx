@@ -43,6 +43,7 @@
 #include "TDecompSVD.h"
 #include "TMath.h"
 #include "TArrayD.h"
+#include "TMatrixTParallel.h"
 
 ClassImp(TDecompSVD);
 
@@ -208,18 +209,23 @@ Bool_t TDecompSVD::Bidiagonalize(TMatrixD &v,TMatrixD &u,TVectorD &sDiag,TVector
          //  return kFALSE;
          DefHouseHolder(vc_i,i,i+1,up,beta);
 
-         // Apply q(i) to v
-         for (Int_t j = i; j < nCol_v; j++) {
-            TMatrixDColumn vc_j = TMatrixDColumn(v,j);
-            ApplyHouseHolder(vc_i,up,beta,i,i+1,vc_j);
-         }
+         // Apply q(i) to v, the columns are transformed independently
+         auto applyV = [&](Int_t jBegin,Int_t jEnd) {
+            for (Int_t j = i+jBegin; j < i+jEnd; j++) {
+               TMatrixDColumn vc_j = TMatrixDColumn(v,j);
+               ApplyHouseHolder(vc_i,up,beta,i,i+1,vc_j);
+            }
+         };
+         TMatrixTParallel::For(nCol_v-i,Double_t(nCol_v-i)*(nRow_v-i),applyV);
 
          // Apply q(i) to u
-         for (Int_t j = 0; j < nCol_u; j++)
-         {
-            TMatrixDColumn uc_j = TMatrixDColumn(u,j);
-            ApplyHouseHolder(vc_i,up,beta,i,i+1,uc_j);
-         }
+         auto applyU = [&](Int_t jBegin,Int_t jEnd) {
+            for (Int_t j = jBegin; j < jEnd; j++) {
+               TMatrixDColumn uc_j = TMatrixDColumn(u,j);
+               ApplyHouseHolder(vc_i,up,beta,i,i+1,uc_j);
+            }
+         };
+         TMatrixTParallel::For(nCol_u,Double_t(nCol_u)*(nRow_v-i),applyU);
       }
       if (i < nCol_v-2) {
          // set up Householder Transformation h(i)
@@ -233,17 +239,20 @@ Bool_t TDecompSVD::Bidiagonalize(TMatrixD &v,TMatrixD &u,TVectorD &sDiag,TVector
          ups[i]   = up;
          betas[i] = beta;
 
-         // apply h(i) to v
-         for (Int_t j = i; j < nRow_v; j++) {
-            TMatrixDRow vr_j = TMatrixDRow(v,j);
-            ApplyHouseHolder(vr_i,up,beta,i+1,i+2,vr_j);
+         // apply h(i) to v, the rows are transformed independently
+         auto applyRows = [&](Int_t jBegin,Int_t jEnd) {
+            for (Int_t j = i+jBegin; j < i+jEnd; j++) {
+               TMatrixDRow vr_j = TMatrixDRow(v,j);
+               ApplyHouseHolder(vr_i,up,beta,i+1,i+2,vr_j);
 
-            // save elements i+2,...in row j of matrix v
-            if (j == i) {
-               for (Int_t k = i+2; k < nCol_v; k++)
-                  vr_j(k) = vr_i(k);
+               // save elements i+2,...in row j of matrix v
+               if (j == i) {
+                  for (Int_t k = i+2; k < nCol_v; k++)
+                     vr_j(k) = vr_i(k);
+               }
             }
-         }
+         };
+         TMatrixTParallel::For(nRow_v-i,Double_t(nRow_v-i)*(nCol_v-i),applyRows);
       }
    }
 
@@ -265,11 +274,14 @@ Bool_t TDecompSVD::Bidiagonalize(TMatrixD &v,TMatrixD &u,TVectorD &sDiag,TVector
       v(i,i) = 1.;
 
       if (i < nCol_v-2) {
-         for (Int_t k = i; k < nCol_v; k++) {
-            // householder transformation on k-th column
-            TMatrixDColumn vc_k = TMatrixDColumn(v,k);
-            ApplyHouseHolder(vr_i,ups[i],betas[i],i+1,i+2,vc_k);
-         }
+         auto applyColumns = [&](Int_t kBegin,Int_t kEnd) {
+            for (Int_t k = i+kBegin; k < i+kEnd; k++) {
+               // householder transformation on k-th column
+               TMatrixDColumn vc_k = TMatrixDColumn(v,k);
+               ApplyHouseHolder(vr_i,ups[i],betas[i],i+1,i+2,vc_k);
+            }
+         };
+         TMatrixTParallel::For(nCol_v-i,Double_t(nCol_v-i)*(nCol_v-i),applyColumns);
       }
    }
 
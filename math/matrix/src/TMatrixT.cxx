@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <typeinfo>
+#include <vector>
 
 #include "TMatrixT.h"
 #include "TBuffer.h"
@@ -29,6 +30,7 @@
 #include "TMatrixDEigen.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 templateClassImp(TMatrixT);
 
@@ -3070,60 +3072,129 @@ TMatrixT<Element> &ElementDiv(TMatrixT<Element> &target,const TMatrixTSym<Elemen
    return target;
 }
 
+namespace {
+
+// tile sizes of the matrix multiplication: a tile of kTileK rows and kTileJ columns of B
+// (128 kB in double precision) stays in the cache while it is used for all the rows of A
+const Int_t kTileK = 64;
+const Int_t kTileJ = 256;
+// length of the innermost loops, which is constant so that they are vectorized
+const Int_t kVecJ  = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the rows [rowBegin,rowEnd) of C = A*B, with A(i,k) = ap[i*incRowA+k*incColA],
+/// B a (nk x ncolsb) matrix and C a (. x ncolsb) matrix. The loops are tiled and the
+/// innermost one runs over contiguous elements of B and C.
+/// As in the simple loops, each element of C is summed in the order of increasing k.
+
+template<class Element>
+void MultRows(const Element * const ap,Int_t incRowA,Int_t incColA,
+              const Element * const bp,Int_t nk,Int_t ncolsb,Element *cp,Int_t rowBegin,Int_t rowEnd)
+{
+   // partial sums of a row of the tile, in a local array which cannot alias A or B
+   Element ctile[kTileJ];
+
+   for (Int_t i = rowBegin; i < rowEnd; i++) {
+      Element *crp = cp+i*ncolsb;
+      for (Int_t j = 0; j < ncolsb; j++)
+         crp[j] = 0;
+   }
+
+   for (Int_t k0 = 0; k0 < nk; k0 += kTileK) {
+      const Int_t k1 = TMath::Min(k0+kTileK,nk);
+      for (Int_t j0 = 0; j0 < ncolsb; j0 += kTileJ) {
+         const Int_t nj = TMath::Min(kTileJ,ncolsb-j0);
+         for (Int_t i = rowBegin; i < rowEnd; i++) {
+                  Element *       crp = cp+i*ncolsb+j0;   // Pointer to  C[i,j0]
+            const Element * const arp = ap+i*incRowA;     // Pointer to  A[i,0]
+            for (Int_t j = 0; j < nj; j++)
+               ctile[j] = crp[j];
+            for (Int_t k = k0; k < k1; k++) {
+               const Element aik = arp[k*incColA];
+               const Element * const brp = bp+k*ncolsb+j0;  // Pointer to  B[k,j0]
+               Int_t j = 0;
+               for (; j+kVecJ <= nj; j += kVecJ) {
+                        Element * const ctp = ctile+j;
+                  const Element * const btp = brp+j;
+                  for (Int_t jv = 0; jv < kVecJ; jv++)
+                     ctp[jv] += aik*btp[jv];
+               }
+               for (; j < nj; j++)
+                  ctile[j] += aik*brp[j];
+            }
+            for (Int_t j = 0; j < nj; j++)
+               crp[j] = ctile[j];
+         }
+      }
+   }
+}
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A*B
+///
+/// The rows of the product are computed in parallel when the implicit
+/// multi-threading is enabled (see ROOT::EnableImplicitMT) and the matrices are large.
 
 template<class Element>
 void AMultB(const Element * const ap,Int_t na,Int_t ncolsa,
             const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
-   const Element *arp0 = ap;                     // Pointer to  A[i,0];
-   while (arp0 < ap+na) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
-         const Element *arp = arp0;                       // Pointer to the i-th row of A, reset to A[i,0]
-         Element cij = 0;
-         while (bcp < bp+nb) {                     // Scan the i-th row of A and
-            cij += *arp++ * *bcp;                   // the j-th col of B
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                              // Set bcp to the (j+1)-th col
-      }
-      arp0 += ncolsa;                             // Set ap to the (i+1)-th row
-   }
+   if (ncolsa == 0 || ncolsb == 0) return;
+   const Int_t nrowsa = na/ncolsa;
+   const Int_t nk     = nb/ncolsb;
+   auto multRows = [&](Int_t rowBegin,Int_t rowEnd) {
+      MultRows(ap,ncolsa,1,bp,nk,ncolsb,cp,rowBegin,rowEnd);
+   };
+   TMatrixTParallel::For(nrowsa,Double_t(nrowsa)*nk*ncolsb,multRows);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A^T*B
+///
+/// The rows of the product are computed in parallel when the implicit
+/// multi-threading is enabled (see ROOT::EnableImplicitMT) and the matrices are large.
 
 template<class Element>
 void AtMultB(const Element * const ap,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
-   const Element *acp0 = ap;           // Pointer to  A[i,0];
-   while (acp0 < ap+ncolsa) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
-         const Element *acp = acp0;                       // Pointer to the i-th column of A, reset to A[0,i]
-         Element cij = 0;
-         while (bcp < bp+nb) {           // Scan the i-th column of A and
-            cij += *acp * *bcp;           // the j-th col of B
-            acp += ncolsa;
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                    // Set bcp to the (j+1)-th col
-      }
-      acp0++;                           // Set acp0 to the (i+1)-th col
-   }
+   if (ncolsb == 0) return;
+   const Int_t nk = nb/ncolsb;
+   auto multRows = [&](Int_t rowBegin,Int_t rowEnd) {
+      MultRows(ap,1,ncolsa,bp,nk,ncolsb,cp,rowBegin,rowEnd);
+   };
+   TMatrixTParallel::For(ncolsa,Double_t(ncolsa)*nk*ncolsb,multRows);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A*B^T
+///
+/// For large matrices B is transposed and the product is computed like A*B, with the
+/// rows computed in parallel when the implicit multi-threading is enabled
+/// (see ROOT::EnableImplicitMT).
 
 template<class Element>
 void AMultBt(const Element * const ap,Int_t na,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
+   if (ncolsa == 0) return;
+   const Int_t nrowsa = na/ncolsa;
+   const Int_t nrowsb = nb/ncolsb;
+
+   if (Double_t(nrowsa)*nrowsb*ncolsa >= Double_t(kTileK)*kTileK*kTileK) {
+      std::vector<Element> bt(nb);
+      for (Int_t j = 0; j < nrowsb; j++)
+         for (Int_t k = 0; k < ncolsb; k++)
+            bt[k*nrowsb+j] = bp[j*ncolsb+k];
+      auto multRows = [&](Int_t rowBegin,Int_t rowEnd) {
+         MultRows(ap,ncolsa,1,bt.data(),ncolsb,nrowsb,cp,rowBegin,rowEnd);
+      };
+      TMatrixTParallel::For(nrowsa,Double_t(nrowsa)*nrowsb*ncolsa,multRows);
+      return;
+   }
+
    const Element *arp0 = ap;                    // Pointer to  A[i,0];
    while (arp0 < ap+na) {
       const Element *brp0 = bp;                  // Pointer to  B[j,0];
@@ -0,0 +1,51 @@
+// @(#)root/matrix:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TMatrixTParallel.h"
+#include "RConfigure.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include "TROOT.h"
+#endif
+
+namespace {
+   // below this number of multiply-add operations the loops are not split among threads
+   const Double_t kMinParallelOps = 1.0e6;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call func(begin,end) on consecutive ranges covering [0,n), concurrently if the
+/// implicit multi-threading is enabled and the loop is large enough.
+
+void TMatrixTParallel::For(Int_t n,Double_t nOps,const std::function<void(Int_t,Int_t)> &func)
+{
+   if (n <= 0) return;
+#ifdef R__USE_IMT
+   if (n > 1 && nOps >= kMinParallelOps && ROOT::IsImplicitMTEnabled()) {
+      // a few ranges per thread to balance the load, each with enough work
+      Double_t nRanges = 4*ROOT::GetImplicitMTPoolSize();
+      if (nRanges > nOps/kMinParallelOps*16) nRanges = nOps/kMinParallelOps*16;
+      const Int_t nr = (nRanges < n) ? (Int_t)nRanges : n;
+      if (nr > 1) {
+         ROOT::TThreadExecutor pool;
+         auto range = [&](Int_t ir) {
+            func((Long64_t)n*ir/nr,(Long64_t)n*(ir+1)/nr);
+         };
+         pool.Foreach(range,ROOT::TSeq<Int_t>(nr));
+         return;
+      }
+   }
+#else
+   (void)nOps;
+#endif
+   func(0,n);
+}
@@ -0,0 +1,31 @@
+// @(#)root/matrix:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMatrixTParallel
+#define ROOT_TMatrixTParallel
+
+// Internal helper used by the matrix operations and decompositions to split
+// independent loops among the threads of the ROOT implicit multi-threading pool
+
+#include "Rtypes.h"
+
+#include <functional>
+
+namespace TMatrixTParallel {
+
+   // Call func(begin,end) for consecutive ranges covering [0,n). The ranges are processed
+   // concurrently when the implicit multi-threading is enabled and the number of
+   // multiply-add operations of the loop (nOps) is large enough, otherwise func(0,n) is called.
+   // The ranges must be independent of each other.
+   void For(Int_t n,Double_t nOps,const std::function<void(Int_t,Int_t)> &func);
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "TMatrixD.h"
+#include "TMatrixDSym.h"
+#include "TVectorD.h"
+#include "TDecompChol.h"
+#include "TDecompLU.h"
+#include "TDecompSVD.h"
+#include "TROOT.h"
+
+#include "gtest/gtest.h"
+
+#include <functional>
+#include <vector>
+
+// The matrix products and the decompositions split their loops among the threads of the
+// implicit multi-threading pool when they need more than 1e6 operations. Each element is
+// computed in the same order by a single thread, so the results must be bit-identical to
+// the ones obtained without the implicit multi-threading.
+
+// Return the elements of the matrices computed by func with the implicit multi-threading
+// disabled and enabled
+static void ComputeSerialAndParallel(const std::function<std::vector<Double_t>()> &func,
+                                     std::vector<Double_t> &serial, std::vector<Double_t> &parallel)
+{
+   ROOT::DisableImplicitMT();
+   serial = func();
+   ROOT::EnableImplicitMT(4);
+   parallel = func();
+   ROOT::DisableImplicitMT();
+}
+
+static void ExpectIdentical(const std::function<std::vector<Double_t>()> &func)
+{
+   std::vector<Double_t> serial, parallel;
+   ComputeSerialAndParallel(func, serial, parallel);
+   ASSERT_EQ(serial.size(), parallel.size());
+   Int_t ndiff = 0;
+   for (size_t i = 0; i < serial.size(); ++i) {
+      if (serial[i] != parallel[i]) ++ndiff;
+   }
+   EXPECT_EQ(0, ndiff);
+}
+
+static void Append(std::vector<Double_t> &v, const TMatrixD &m)
+{
+   v.insert(v.end(), m.GetMatrixArray(), m.GetMatrixArray() + m.GetNoElements());
+}
+
+static TMatrixD RandomMatrix(Int_t nrows, Int_t ncols, Double_t seed)
+{
+   TMatrixD m(nrows, ncols);
+   m.Randomize(-1., 1., seed);
+   return m;
+}
+
+TEST(TMatrixImt, Mult)
+{
+   // above the size where A*B^T transposes B and above the multi-threading threshold
+   const TMatrixD a = RandomMatrix(300, 200, 1);
+   const TMatrixD b = RandomMatrix(200, 250, 2);
+   const TMatrixD at = RandomMatrix(200, 300, 3);
+   const TMatrixD bt = RandomMatrix(250, 200, 4);
+
+   ExpectIdentical([&]() {
+      std::vector<Double_t> v;
+      Append(v, TMatrixD(a, TMatrixD::kMult, b));
+      return v;
+   });
+   ExpectIdentical([&]() {
+      std::vector<Double_t> v;
+      Append(v, TMatrixD(at, TMatrixD::kTransposeMult, b));
+      return v;
+   });
+   ExpectIdentical([&]() {
+      std::vector<Double_t> v;
+      Append(v, TMatrixD(a, TMatrixD::kMultTranspose, bt));
+      return v;
+   });
+
+   // the products are still the products
+   TMatrixD ab(a, TMatrixD::kMult, b);
+   Double_t expected = 0;
+   for (Int_t k = 0; k < a.GetNcols(); ++k) expected += a(7, k) * b(k, 11);
+   EXPECT_NEAR(expected, ab(7, 11), 1.E-12);
+}
+
+TEST(TMatrixImt, Cholesky)
+{
+   // the row updates need (n-i)*i operations: above the threshold for n >= 2000
+   const Int_t n = 2048;
+   TMatrixDSym m(n);
+   Double_t seed = 5;
+   m.Randomize(-1., 1., seed);
+   for (Int_t i = 0; i < n; ++i) m(i, i) += n;
+
+   ExpectIdentical([&]() {
+      TDecompChol chol(m);
+      EXPECT_TRUE(chol.Decompose());
+      std::vector<Double_t> v;
+      Append(v, chol.GetU());
+      return v;
+   });
+}
+
+TEST(TMatrixImt, LU)
+{
+   // Crout needs n >= 2000 to be above the threshold, Gauss and the inversion n > 1000
+   const TMatrixD mCrout = RandomMatrix(2048, 2048, 6);
+   const TMatrixD m = RandomMatrix(1100, 1100, 7);
+
+   ExpectIdentical([&]() {
+      TDecompLU lu(mCrout, 0., 1);
+      EXPECT_TRUE(lu.Decompose());
+      std::vector<Double_t> v;
+      Append(v, lu.GetLU());
+      return v;
+   });
+   ExpectIdentical([&]() {
+      TDecompLU lu(m, 0., 0);
+      EXPECT_TRUE(lu.Decompose());
+      std::vector<Double_t> v;
+      Append(v, lu.GetLU());
+      return v;
+   });
+   ExpectIdentical([&]() {
+      TMatrixD inv(m);
+      EXPECT_TRUE(TDecompLU::InvertLU(inv, 0.));
+      std::vector<Double_t> v;
+      Append(v, inv);
+      return v;
+   });
+}
+
+TEST(TMatrixImt, SVD)
+{
+   // the Householder reflections need about nrows*ncols operations
+   const TMatrixD m = RandomMatrix(1200, 900, 8);
+
+   ExpectIdentical([&]() {
+      TDecompSVD svd(m);
+      EXPECT_TRUE(svd.Decompose());
+      std::vector<Double_t> v;
+      Append(v, svd.GetU());
+      Append(v, svd.GetV());
+      const TVectorD &sig = svd.GetSig();
+      v.insert(v.end(), sig.GetMatrixArray(), sig.GetMatrixArray() + sig.GetNoElements());
+      return v;
+   });
+}
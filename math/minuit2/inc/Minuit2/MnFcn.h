@@ -13,6 +13,7 @@
 #include "Minuit2/MnConfig.h"
 #include "Minuit2/MnMatrix.h"
 
+#include <atomic>
 #include <vector>
 
 namespace ROOT {
@@ -26,7 +27,8 @@ class FCNBase;
    Apply conversion from calling the function from a Minuit Vector (MnAlgebraicVector) to a std::vector  for
    the function coordinates.
    The class counts also the number of function calls. By default counter strart from zero, but a different value
-   might be given if the class is  instantiated later on, for example for a set of different minimizaitons
+   might be given if the class is  instantiated later on, for example for a set of different minimizaitons.
+   The counter is atomic, since the function can be called concurrently by the numerical derivative calculators
    Normally the derived class MnUserFCN should be instantiated with performs in addition the transformatiopn
    internal-> external parameters
  */
@@ -56,7 +58,7 @@ private:
 
 protected:
 
-  mutable int fNumCall;
+  mutable std::atomic<int> fNumCall;
 };
 
   }  // namespace Minuit2
@@ -0,0 +1,50 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnParallelLoop
+#define ROOT_Minuit2_MnParallelLoop
+
+#include <functional>
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+/**
+   Helper class to execute concurrently the iterations of the loops on the parameters
+   used in the numerical derivative calculations (Numerical2PGradientCalculator,
+   HessianGradientCalculator and MnHesse). The iterations are executed in the ROOT thread pool
+   (TThreadExecutor) when the number of threads is larger than one and ROOT has been built
+   with IMT support; otherwise they are executed sequentially. The thread pool is created by
+   the first parallel loop and reused by the following ones.
+   The iterations call the FCN concurrently, which must then be thread safe.
+ */
+class MnParallelLoop {
+
+public:
+
+   explicit MnParallelLoop(unsigned int nthreads) : fNThreads(nthreads) {}
+
+   ~MnParallelLoop() {}
+
+   /// return true if a loop of n iterations is executed concurrently
+   bool IsParallel(unsigned int n) const;
+
+   /// call func(i) for i in [0, n)
+   void Execute(unsigned int n, const std::function<void(unsigned int)> &func) const;
+
+private:
+
+   unsigned int fNThreads;
+};
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnParallelLoop
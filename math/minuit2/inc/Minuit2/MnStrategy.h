@@ -49,6 +49,8 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   unsigned int DerivativeNThreads() const { return fDerivNThreads; }
+
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
    bool IsHigh() const {return fStrategy >= 2;}
@@ -69,6 +71,11 @@ public:
    // set storage level of iteration quantities
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // set the number of threads used to compute concurrently the numerical derivatives
+   // (gradient and Hessian) for the different parameters: 0 or 1 = sequential (default)
+   // the FCN must be thread safe. It requires a ROOT build with IMT support
+   void SetDerivativeNThreads(unsigned int n) { fDerivNThreads = n; }
 private:
 
    unsigned int fStrategy;
@@ -81,6 +88,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   unsigned int fDerivNThreads;
 };
 
   }  // namespace Minuit2
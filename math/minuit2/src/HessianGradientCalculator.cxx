@@ -15,6 +15,7 @@
 #include "Minuit2/MinimumParameters.h"
 #include "Minuit2/FunctionGradient.h"
 #include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnParallelLoop.h"
 
 #include <math.h>
 
@@ -85,12 +86,10 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    unsigned int n = x.size();
    MnAlgebraicVector dgrd(n);
 
-   MPIProcess mpiproc(n,0);
-   // initial starting values
-   unsigned int startElementIndex = mpiproc.StartElementIndex();
-   unsigned int endElementIndex = mpiproc.EndElementIndex();
-
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
+   // compute the derivative for the parameter i. Only the component i of x is modified
+   // (and restored at the end), so the different parameters can be computed concurrently
+   // using a different copy of x
+   auto derivative = [&](unsigned int i, MnAlgebraicVector &x) {
       double xtf = x(i);
       double dmin = 4.*Precision().Eps2()*(xtf + Precision().Eps2());
       double epspri = Precision().Eps2() + fabs(grd(i)*Precision().Eps2());
@@ -135,8 +134,26 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
       std::cout << "HGC Param : " << i << "\t new g1 = " << grd(i) << " gstep = " << d << " dgrd = " << dgrd(i) << std::endl;
 #endif
 
+   };
+
+   // use the thread pool if requested (see MnStrategy::SetDerivativeNThreads)
+   MnParallelLoop loop(Strategy().DerivativeNThreads());
+   if (loop.IsParallel(n)) {
+      loop.Execute(n, [&](unsigned int i) {
+         MnAlgebraicVector xi = par.Vec();
+         derivative(i, xi);
+      });
+      return std::pair<FunctionGradient, MnAlgebraicVector>(FunctionGradient(grd, g2, gstep), dgrd);
    }
 
+   MPIProcess mpiproc(n,0);
+   // initial starting values
+   unsigned int startElementIndex = mpiproc.StartElementIndex();
+   unsigned int endElementIndex = mpiproc.EndElementIndex();
+
+   for(unsigned int i = startElementIndex; i < endElementIndex; i++)
+      derivative(i, x);
+
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
    mpiproc.SyncVector(dgrd);
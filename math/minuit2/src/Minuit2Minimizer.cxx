@@ -440,6 +440,8 @@ bool Minuit2Minimizer::Minimize() {
       double hessStepTol = strategy.HessianStepTolerance();
       double hessG2Tol = strategy.HessianG2Tolerance();
 
+      int nDerivThreads = strategy.DerivativeNThreads();
+
       minuit2Opt->GetValue("GradientNCycles",nGradCycles);
       minuit2Opt->GetValue("HessianNCycles",nHessCycles);
       minuit2Opt->GetValue("HessianGradientNCycles",nHessGradCycles);
@@ -449,6 +451,8 @@ bool Minuit2Minimizer::Minimize() {
       minuit2Opt->GetValue("HessianStepTolerance",hessStepTol);
       minuit2Opt->GetValue("HessianG2Tolerance",hessG2Tol);
 
+      minuit2Opt->GetValue("DerivativeNThreads",nDerivThreads);
+
       strategy.SetGradientNCycles(nGradCycles);
       strategy.SetHessianNCycles(nHessCycles);
       strategy.SetHessianGradientNCycles(nHessGradCycles);
@@ -458,6 +462,8 @@ bool Minuit2Minimizer::Minimize() {
       strategy.SetHessianStepTolerance(hessStepTol);
       strategy.SetHessianG2Tolerance(hessStepTol);
 
+      strategy.SetDerivativeNThreads(nDerivThreads > 0 ? nDerivThreads : 0);
+
       int storageLevel = 1;
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
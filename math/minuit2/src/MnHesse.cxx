@@ -18,6 +18,7 @@
 #include "Minuit2/MinimumState.h"
 #include "Minuit2/VariableMetricEDMEstimator.h"
 #include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnParallelLoop.h"
 
 //#define DEBUG
 
@@ -30,6 +31,8 @@
 
 #include "Minuit2/MPIProcess.h"
 
+#include <algorithm>
+
 namespace ROOT {
 
    namespace Minuit2 {
@@ -130,7 +133,10 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
 #endif
 
 
-   for(unsigned int i = 0; i < n; i++) {
+   // compute the second derivative for the parameter i, return false if it is found to be zero.
+   // Only the component i of x is modified (and restored at the end), so the different
+   // parameters can be computed concurrently using a different copy of x
+   auto diagonal = [&](unsigned int i, MnAlgebraicVector &x) -> bool {
 
       double xtf = x(i);
       double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
@@ -146,6 +152,7 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
          double sag = 0.;
          double fs1 = 0.;
          double fs2 = 0.;
+         bool sagFound = false;
          for(unsigned int multpy = 0; multpy < 5; multpy++) {
             x(i) = xtf + d;
             fs1 = mfcn(x);
@@ -158,9 +165,12 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
             std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
 #endif
             //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
+            if (sag != 0) {
+               sagFound = true;
+               break;
+            }
             if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
+               if(d > 0.5) break;
                d *= 10.;
                if(d > 0.5) d = 0.51;
                continue;
@@ -168,27 +178,21 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
             d *= 10.;
          }
 
-L26:
+         if (!sagFound) {
 #ifdef WARNINGMSG
 
-         // get parameter name for i
-         // (need separate scope for avoiding compl error when declaring name)
-         {
-            const char * name = trafo.Name( trafo.ExtOfInt(i));
-            MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
-            MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
-         }
+            // get parameter name for i
+            // (need separate scope for avoiding compl error when declaring name)
+            {
+               const char * name = trafo.Name( trafo.ExtOfInt(i));
+               MN_INFO_VAL2("MnHesse: 2nd derivative zero for Parameter ", name);
+               MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
+            }
 #endif
-
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
+            return false;
          }
 
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
-
-L30:
-            double g2bfor = g2(i);
+         double g2bfor = g2(i);
          g2(i) = 2.*sag/(d*d);
          grd(i) = (fs1-fs2)/(2.*d);
          gst(i) = d;
@@ -212,22 +216,47 @@ L30:
          d = std::max(d, 0.1*dlast);
       }
       vhmat(i,i) = g2(i);
-      if(mfcn.NumOfCalls()  > maxcalls) {
+      return true;
+   };
 
-#ifdef WARNINGMSG
-         //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
-         MN_INFO_MSG("MnHesse: maximum number of allowed function calls exhausted.");
-         MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
-#endif
+   // in case of failure return a diagonal matrix
+   auto diagonalFailed = [&]() {
+      for(unsigned int j = 0; j < n; j++) {
+         double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
+         vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
+      }
 
-         for(unsigned int j = 0; j < n; j++) {
-            double tmp = g2(j) < prec.Eps2() ? 1. : 1./g2(j);
-            vhmat(j,j) = tmp < prec.Eps2() ? 1. : tmp;
-         }
+      return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+   };
 
-         return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
+   // check the maximum number of function calls
+   auto callsExhausted = [&]() {
+      if(mfcn.NumOfCalls() <= maxcalls) return false;
+#ifdef WARNINGMSG
+      //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
+      MN_INFO_MSG("MnHesse: maximum number of allowed function calls exhausted.");
+      MN_INFO_MSG("MnHesse fails and will return diagonal matrix ");
+#endif
+      return true;
+   };
+
+   // use the thread pool if requested (see MnStrategy::SetDerivativeNThreads)
+   // in this case the number of calls is checked only after computing all the parameters
+   MnParallelLoop loop(fStrategy.DerivativeNThreads());
+   if (loop.IsParallel(n)) {
+      std::vector<int> isValid(n);
+      loop.Execute(n, [&](unsigned int i) {
+         MnAlgebraicVector xi = x;
+         isValid[i] = diagonal(i, xi);
+      });
+      if (std::find(isValid.begin(), isValid.end(), 0) != isValid.end() || callsExhausted())
+         return diagonalFailed();
+   }
+   else {
+      for(unsigned int i = 0; i < n; i++) {
+         if (!diagonal(i, x) || callsExhausted())
+            return diagonalFailed();
       }
-
    }
 
 #ifdef DEBUG
@@ -244,39 +273,54 @@ L30:
    }
 
    //off-diagonal Elements
-   // initial starting values
-   MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
-   unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
-   unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
+   if (loop.IsParallel(n-1)) {
+      // each row i is computed in a different task, with its own copy of x
+      loop.Execute(n-1, [&](unsigned int i) {
+         MnAlgebraicVector xi = x;
+         xi(i) += dirin(i);
+         for (unsigned int j = i+1; j < n; j++) {
+            xi(j) += dirin(j);
+            double fs1 = mfcn(xi);
+            double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+            vhmat(i,j) = elem;
+            xi(j) -= dirin(j);
+         }
+      });
+   } else {
+      // initial starting values
+      MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
+      unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
+      unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
 
-   unsigned int offsetVect = 0;
-   for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
-      if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
+      unsigned int offsetVect = 0;
+      for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
+         if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
 
-   for (unsigned int in = startParIndexOffDiagonal;
-        in<endParIndexOffDiagonal; in++) {
+      for (unsigned int in = startParIndexOffDiagonal;
+           in<endParIndexOffDiagonal; in++) {
 
-      int i = (in+offsetVect)/(n-1);
-      if ((in+offsetVect)%(n-1)==0) offsetVect += i;
-      int j = (in+offsetVect)%(n-1)+1;
+         int i = (in+offsetVect)/(n-1);
+         if ((in+offsetVect)%(n-1)==0) offsetVect += i;
+         int j = (in+offsetVect)%(n-1)+1;
 
-      if ((i+1)==j || in==startParIndexOffDiagonal)
-         x(i) += dirin(i);
+         if ((i+1)==j || in==startParIndexOffDiagonal)
+            x(i) += dirin(i);
 
-      x(j) += dirin(j);
+         x(j) += dirin(j);
 
-      double fs1 = mfcn(x);
-      double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
-      vhmat(i,j) = elem;
+         double fs1 = mfcn(x);
+         double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+         vhmat(i,j) = elem;
 
-      x(j) -= dirin(j);
+         x(j) -= dirin(j);
 
-      if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
-         x(i) -= dirin(i);
+         if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
+            x(i) -= dirin(i);
 
-   }
+      }
 
-   mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
+      mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
+   }
 
    //verify if matrix pos-def (still 2nd derivative)
 
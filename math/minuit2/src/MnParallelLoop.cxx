@@ -0,0 +1,71 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#include "Minuit2/MnParallelLoop.h"
+
+// the thread pool is available only when building within ROOT
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h"
+#endif
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#include <memory>
+#include <mutex>
+#endif
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+#ifdef R__USE_IMT
+static std::shared_ptr<ROOT::TThreadExecutor> GetThreadExecutor(unsigned int nthreads) {
+   // the executor is created by the first parallel loop and kept for the following ones,
+   // instead of starting the threads at each gradient or Hessian calculation. It is
+   // created again only if a different number of threads is requested. When the implicit
+   // multi-threading is enabled the executor uses the ROOT thread pool.
+   static std::mutex mutex;
+   static std::shared_ptr<ROOT::TThreadExecutor> executor;
+   static unsigned int executorNThreads = 0;
+   std::lock_guard<std::mutex> lock(mutex);
+   if (!executor || executorNThreads != nthreads) {
+      executor.reset();
+      executor = std::make_shared<ROOT::TThreadExecutor>(nthreads);
+      executorNThreads = nthreads;
+   }
+   return executor;
+}
+#endif
+
+
+bool MnParallelLoop::IsParallel(unsigned int n) const {
+#ifdef R__USE_IMT
+   return fNThreads > 1 && n > 1;
+#else
+   (void)n;
+   return false;
+#endif
+}
+
+void MnParallelLoop::Execute(unsigned int n, const std::function<void(unsigned int)> &func) const {
+   // execute the loop in the thread pool shared by all the loops
+#ifdef R__USE_IMT
+   if (IsParallel(n)) {
+      std::shared_ptr<ROOT::TThreadExecutor> pool = GetThreadExecutor(fNThreads);
+      pool->Foreach(func, ROOT::TSeq<unsigned int>(0, n));
+      return;
+   }
+#endif
+   for (unsigned int i = 0; i < n; ++i)
+      func(i);
+}
+
+   }  // namespace Minuit2
+
+}  // namespace ROOT
@@ -0,0 +1,111 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2017 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+// Test that the numerical gradient and Hessian computed with several threads
+// (MnStrategy::SetDerivativeNThreads) are the same as the sequential ones
+
+#include "Minuit2/FCNBase.h"
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnPrint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ROOT::Minuit2;
+
+// extended Rosenbrock function
+class RosenbrockFcn : public FCNBase {
+
+public:
+
+   double operator()(const std::vector<double>& par) const {
+      double f = 0;
+      for (unsigned int i = 0; i + 1 < par.size(); i += 2) {
+         double a = par[i+1] - par[i]*par[i];
+         double b = 1. - par[i];
+         f += 100.*a*a + b*b;
+      }
+      return f;
+   }
+
+   double Up() const {return 1.;}
+};
+
+bool Equal(double a, double b, double tol) {
+   return std::fabs(a - b) <= tol * std::max(std::fabs(a), 1.);
+}
+
+// count the differences between two parameter states larger than tol (relative for the values above 1)
+int Compare(const MnUserParameterState& s1, const MnUserParameterState& s2, double tol) {
+   int ndiff = 0;
+   if (!Equal(s1.Fval(), s2.Fval(), tol) || s1.NFcn() != s2.NFcn()) ndiff++;
+   for (unsigned int i = 0; i < s1.Params().size(); ++i) {
+      if (!Equal(s1.Value(i), s2.Value(i), tol) || !Equal(s1.Error(i), s2.Error(i), tol)) ndiff++;
+   }
+   if (s1.HasCovariance() != s2.HasCovariance()) return ndiff + 1;
+   if (!s1.HasCovariance()) return ndiff;
+   const MnUserCovariance& c1 = s1.Covariance();
+   const MnUserCovariance& c2 = s2.Covariance();
+   for (unsigned int i = 0; i < c1.Nrow(); ++i) {
+      for (unsigned int j = 0; j <= i; ++j) {
+         // compare the correlations, the covariance of independent parameters is not exactly zero
+         double scale = std::sqrt(c1(i,i) * c1(j,j));
+         if (!Equal(c1(i,j) / scale, c2(i,j) / scale, tol)) ndiff++;
+      }
+   }
+   return ndiff;
+}
+
+int main() {
+
+   RosenbrockFcn fcn;
+
+   MnUserParameters upar;
+   for (unsigned int i = 0; i < 8; ++i)
+      upar.Add("x" + std::to_string(i), (i % 2 == 0) ? -1.2 : 1., 0.1);
+
+   std::vector<MnUserParameterState> minima;
+   std::vector<MnUserParameterState> hessians;
+   for (unsigned int nthreads : {0u, 4u}) {
+      MnStrategy strategy(1);
+      strategy.SetDerivativeNThreads(nthreads);
+
+      // Migrad uses the numerical gradient (Numerical2PGradientCalculator)
+      MnMigrad migrad(fcn, MnUserParameterState(upar), strategy);
+      FunctionMinimum min = migrad();
+      if (!min.IsValid()) {
+         std::cout << "minimization with " << nthreads << " threads failed: " << min << std::endl;
+         return 1;
+      }
+      minima.push_back(min.UserState());
+
+      // Hessian at the starting point and at the minimum
+      MnHesse hesse(strategy);
+      hessians.push_back(hesse(fcn, upar));
+      hessians.push_back(hesse(fcn, min.UserParameters()));
+   }
+
+   // the gradients are computed with the same operations, so the minimization is identical
+   int ndiff = Compare(minima[0], minima[1], 0.);
+   // the sequential computation of the off-diagonal elements of the Hessian shifts and
+   // restores the parameters in place, which can change them by one unit in the last place
+   // from a row to the next, while each row starts from the original values in parallel
+   ndiff += Compare(hessians[0], hessians[2], 1.E-8);
+   ndiff += Compare(hessians[1], hessians[3], 1.E-8);
+   std::cout << "minimum: " << minima[1] << std::endl;
+   std::cout << ndiff << " differences found between the sequential and the parallel derivatives" << std::endl;
+
+   return ndiff != 0;
+}
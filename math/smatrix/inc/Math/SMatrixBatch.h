@@ -0,0 +1,441 @@
+// @(#)root/smatrix:$Id$
+
+#ifndef ROOT_Math_SMatrixBatch
+#define ROOT_Math_SMatrixBatch
+
+/** @file
+ * header file containing the class SMatrixBatch, a container of many small
+ * matrices of the same type, and the functions (products, similarity
+ * transformations, Cholesky inversion) applied to all of them at once
+ */
+
+#include "Math/SMatrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace ROOT {
+
+namespace Math {
+
+/// helpers for SMatrixBatch
+namespace SMatrixBatchHelpers {
+
+   /// number of matrices of a block of SMatrixBatch
+   const unsigned int kLanes = 16;
+
+   /// position of the element (i,j) in the storage of a matrix representation
+   template <class R> struct RepOffset;
+
+   template <class T, unsigned int D1, unsigned int D2> struct RepOffset<MatRepStd<T, D1, D2> > {
+      static constexpr unsigned int Apply(unsigned int i, unsigned int j) { return i * D2 + j; }
+   };
+
+   template <class T, unsigned int D> struct RepOffset<MatRepSym<T, D> > {
+      static constexpr unsigned int Apply(unsigned int i, unsigned int j)
+      {
+         return j < i ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+      }
+   };
+
+   /// position of the element (i,j) of the transposed matrix
+   template <class O> struct TransposedOffset {
+      static constexpr unsigned int Apply(unsigned int i, unsigned int j) { return O::Apply(j, i); }
+   };
+
+   /// sum over K0 <= k < K of A(I,k) * B(k,J) for the matrix m of a block
+   /// (the loops over the elements are unrolled at compile time, see LaneMult)
+   template <class OA, class OB, unsigned int I, unsigned int J, unsigned int K, unsigned int K0 = 0>
+   struct LaneDot {
+      template <class T> static T Apply(const T *a, const T *b, unsigned int m)
+      {
+         return LaneDot<OA, OB, I, J, K - 1, K0>::Apply(a, b, m) +
+                a[OA::Apply(I, K - 1) * kLanes + m] * b[OB::Apply(K - 1, J) * kLanes + m];
+      }
+   };
+
+   template <class OA, class OB, unsigned int I, unsigned int J, unsigned int K0> struct LaneDot<OA, OB, I, J, K0, K0> {
+      template <class T> static T Apply(const T *, const T *, unsigned int) { return T(0); }
+   };
+
+   /// product C = A * B of the N1 x K matrices A and the K x N2 matrices B of a block,
+   /// computing only the lower triangle of C if Lower is true.
+   /// The loop over the matrices of the block is the innermost one, so that it is vectorized.
+   template <class OC, class OA, class OB, unsigned int N1, unsigned int N2, unsigned int K, bool Lower,
+             unsigned int IJ = N1 * N2>
+   struct LaneMult {
+      template <class T> static void Apply(T *c, const T *a, const T *b)
+      {
+         LaneMult<OC, OA, OB, N1, N2, K, Lower, IJ - 1>::Apply(c, a, b);
+         const unsigned int I = (IJ - 1) / N2;
+         const unsigned int J = (IJ - 1) % N2;
+         if (Lower && J > I) return;
+         T *cij = c + OC::Apply(I, J) * kLanes;
+         for (unsigned int m = 0; m < kLanes; ++m)
+            cij[m] = LaneDot<OA, OB, I, J, K>::Apply(a, b, m);
+      }
+   };
+
+   template <class OC, class OA, class OB, unsigned int N1, unsigned int N2, unsigned int K, bool Lower>
+   struct LaneMult<OC, OA, OB, N1, N2, K, Lower, 0> {
+      template <class T> static void Apply(T *, const T *, const T *) {}
+   };
+
+   /// row of the element t of a packed lower triangle
+   constexpr unsigned int PackedRow(unsigned int t, unsigned int i = 0)
+   {
+      return t <= i ? i : PackedRow(t - i - 1, i + 1);
+   }
+
+   /// Cholesky decomposition M = L L^T of the symmetric N x N matrices of a block, computed
+   /// element by element in the packed order of L (see CholeskyDecomp, the diagonal of L
+   /// is stored inverted). For the matrices which are not positive definite fail is set to 1.
+   template <class OM, unsigned int N, unsigned int E = 0, unsigned int NE = N * (N + 1) / 2>
+   struct LaneCholDecomp {
+      template <class T> static void Apply(T *l, const T *mat, T *fail)
+      {
+         typedef RepOffset<MatRepSym<T, N> > OL;
+         const unsigned int I = PackedRow(E);
+         const unsigned int J = E - I * (I + 1) / 2;
+         T *lij = l + OL::Apply(I, J) * kLanes;
+         const T *mij = mat + OM::Apply(I, J) * kLanes;
+         if (J < I) {
+            const T *ljj = l + OL::Apply(J, J) * kLanes;
+            for (unsigned int m = 0; m < kLanes; ++m)
+               lij[m] = (mij[m] - LaneDot<OL, TransposedOffset<OL>, I, J, J>::Apply(l, l, m)) * ljj[m];
+         } else {
+            for (unsigned int m = 0; m < kLanes; ++m) {
+               const T d = mij[m] - LaneDot<OL, TransposedOffset<OL>, I, I, I>::Apply(l, l, m);
+               // continue with a dummy value for the matrices which are not positive definite
+               fail[m] = (d > T(0)) ? fail[m] : T(1);
+               lij[m] = (d > T(0)) ? d : T(1);
+            }
+            for (unsigned int m = 0; m < kLanes; ++m)
+               lij[m] = std::sqrt(T(1) / lij[m]);
+         }
+         LaneCholDecomp<OM, N, E + 1, NE>::Apply(l, mat, fail);
+      }
+   };
+
+   template <class OM, unsigned int N, unsigned int NE> struct LaneCholDecomp<OM, N, NE, NE> {
+      template <class T> static void Apply(T *, const T *, T *) {}
+   };
+
+   /// inversion of the off-diagonal part of the Cholesky factors L of a block, in place
+   template <unsigned int N, unsigned int E = 1, unsigned int NE = N * (N + 1) / 2>
+   struct LaneCholInvertL {
+      template <class T> static void Apply(T *l)
+      {
+         typedef RepOffset<MatRepSym<T, N> > OL;
+         const unsigned int I = PackedRow(E);
+         const unsigned int J = E - I * (I + 1) / 2;
+         if (J < I) {
+            T *lij = l + OL::Apply(I, J) * kLanes;
+            const T *lii = l + OL::Apply(I, I) * kLanes;
+            for (unsigned int m = 0; m < kLanes; ++m)
+               lij[m] = -LaneDot<OL, OL, I, J, I, J>::Apply(l, l, m) * lii[m];
+         }
+         LaneCholInvertL<N, E + 1, NE>::Apply(l);
+      }
+   };
+
+   template <unsigned int N, unsigned int NE> struct LaneCholInvertL<N, NE, NE> {
+      template <class T> static void Apply(T *) {}
+   };
+
+   /// inverse M^(-1) = Li^T Li of the matrices of a block from the inverted Cholesky factors Li
+   template <class OM, unsigned int N, unsigned int E = 0, unsigned int NE = N * (N + 1) / 2>
+   struct LaneCholInverse {
+      template <class T> static void Apply(T *mat, const T *l)
+      {
+         typedef RepOffset<MatRepSym<T, N> > OL;
+         const unsigned int I = PackedRow(E);
+         const unsigned int J = E - I * (I + 1) / 2;
+         T *mij = mat + OM::Apply(I, J) * kLanes;
+         for (unsigned int m = 0; m < kLanes; ++m)
+            mij[m] = LaneDot<TransposedOffset<OL>, OL, I, J, N, I>::Apply(l, l, m);
+         if (OM::Apply(I, J) != OM::Apply(J, I))
+            std::copy(mij, mij + kLanes, mat + OM::Apply(J, I) * kLanes);
+         LaneCholInverse<OM, N, E + 1, NE>::Apply(mat, l);
+      }
+   };
+
+   template <class OM, unsigned int N, unsigned int NE> struct LaneCholInverse<OM, N, NE, NE> {
+      template <class T> static void Apply(T *, const T *) {}
+   };
+}
+
+//__________________________________________________________________________
+/**
+   SMatrixBatch: container of N matrices of the same type SMatrix<T,D1,D2,R>,
+   stored as a structure of arrays to apply the same operation to all the matrices
+   with SIMD instructions (e.g. the covariance matrices of the tracks in a Kalman filter).
+
+   The matrices are grouped in blocks of kLanes matrices. In a block, the kLanes
+   values of the same matrix element are contiguous in memory, and the functions
+   acting on the batch (Mult, Similarity, SimilarityT, InvertChol) loop over them
+   in their innermost loop, which has a constant length and is vectorized by the compiler.
+   The storage order of the elements of a matrix is the one of the representation R
+   (see MatRepStd and MatRepSym), so that symmetric matrices need kSize = D*(D+1)/2 values.
+   Vectors can be stored as matrices with a single column.
+
+   Usage example:
+   @code
+   // covariance matrices and projection matrix of many tracks
+   SMatrixBatch<double, 5, 5, MatRepSym<double, 5> > cov(ntracks);
+   SMatrixBatch<double, 2, 5> proj(ntracks);
+   for (unsigned int i = 0; i < ntracks; ++i) {
+      cov.Set(i, tracks[i].Covariance());
+      proj.Set(i, tracks[i].Projection());
+   }
+   // covariance matrices of the residuals, and their inverse
+   SMatrixBatch<double, 2, 2, MatRepSym<double, 2> > res;
+   Similarity(proj, cov, res);
+   res += errors;
+   res.InvertChol();
+   @endcode
+
+   @ingroup SMatrixSVector
+*/
+template <class T, unsigned int D1, unsigned int D2 = D1, class R = MatRepStd<T, D1, D2> >
+class SMatrixBatch {
+
+public:
+
+   /** contained scalar type */
+   typedef T value_type;
+
+   /** storage representation type of the matrices */
+   typedef R rep_type;
+
+   /** type of the single matrices */
+   typedef SMatrix<T, D1, D2, R> matrix_type;
+
+   enum {
+      /// number of rows
+      kRows = D1,
+      /// number of columns
+      kCols = D2,
+      /// number of values stored for each matrix
+      kSize = R::kSize,
+      /// number of matrices of a block, processed together
+      kLanes = SMatrixBatchHelpers::kLanes
+   };
+
+   /**
+      construct a batch of n matrices, all elements are zero
+   */
+   explicit SMatrixBatch(unsigned int n = 0) : fN(0) { Resize(n); }
+
+   /// number of matrices
+   unsigned int Size() const { return fN; }
+
+   /// number of blocks of kLanes matrices (the last one can be partially filled)
+   unsigned int NBlocks() const { return (fN + kLanes - 1) / kLanes; }
+
+   /// change the number of matrices, the new ones are zero
+   void Resize(unsigned int n)
+   {
+      const unsigned int nOld = fN;
+      fN = n;
+      fData.resize(NBlocks() * kSize * kLanes, T(0));
+      // clear the removed matrices which are still in the last block
+      for (unsigned int i = n; i < nOld && i < NBlocks() * kLanes; ++i)
+         for (unsigned int k = 0; k < kSize; ++k)
+            fData[Index(i, k)] = T(0);
+   }
+
+   /// return the matrix i
+   matrix_type Get(unsigned int i) const
+   {
+      matrix_type m;
+      for (unsigned int k = 0; k < kSize; ++k)
+         m.Array()[k] = fData[Index(i, k)];
+      return m;
+   }
+
+   /// set the matrix i
+   void Set(unsigned int i, const matrix_type &m)
+   {
+      for (unsigned int k = 0; k < kSize; ++k)
+         fData[Index(i, k)] = m.Array()[k];
+   }
+
+   /// read access to the element (irow, icol) of the matrix i
+   const T &operator()(unsigned int i, unsigned int irow, unsigned int icol) const
+   {
+      return fData[Index(i, Offset(irow, icol))];
+   }
+
+   /// write access to the element (irow, icol) of the matrix i
+   T &operator()(unsigned int i, unsigned int irow, unsigned int icol)
+   {
+      return fData[Index(i, Offset(irow, icol))];
+   }
+
+   /// pointer to the kLanes values of the stored element k of the matrices in the block ib
+   const T *Lanes(unsigned int ib, unsigned int k) const { return &fData[(ib * kSize + k) * kLanes]; }
+
+   /// pointer to the kLanes values of the stored element k of the matrices in the block ib
+   T *Lanes(unsigned int ib, unsigned int k) { return &fData[(ib * kSize + k) * kLanes]; }
+
+   /// position of the element (irow, icol) in the storage of a matrix
+   static constexpr unsigned int Offset(unsigned int irow, unsigned int icol)
+   {
+      return SMatrixBatchHelpers::RepOffset<R>::Apply(irow, icol);
+   }
+
+   /// add to all matrices the corresponding matrices of rhs (of the same size)
+   SMatrixBatch &operator+=(const SMatrixBatch &rhs)
+   {
+      assert(rhs.fN == fN);
+      for (unsigned int i = 0; i < fData.size(); ++i)
+         fData[i] += rhs.fData[i];
+      return *this;
+   }
+
+   /// subtract from all matrices the corresponding matrices of rhs (of the same size)
+   SMatrixBatch &operator-=(const SMatrixBatch &rhs)
+   {
+      assert(rhs.fN == fN);
+      for (unsigned int i = 0; i < fData.size(); ++i)
+         fData[i] -= rhs.fData[i];
+      return *this;
+   }
+
+   /**
+      Invert all the matrices, which must be symmetric and positive definite,
+      with the Cholesky decomposition (see ROOT::Math::CholeskyDecomp).
+      The matrices which cannot be inverted are left unchanged and, if ifail is not null,
+      ifail[i] is set to 1 for them and to 0 for the others (ifail must have Size() elements).
+      Only the lower triangle of the matrices is used.
+      Return true if all the matrices have been inverted.
+   */
+   bool InvertChol(int *ifail = 0);
+
+private:
+
+   unsigned int Index(unsigned int i, unsigned int k) const
+   {
+      return ((i / kLanes) * kSize + k) * kLanes + i % kLanes;
+   }
+
+   unsigned int fN;         // number of matrices
+   std::vector<T> fData;    // values, in blocks of kSize*kLanes
+};
+
+template <class T, unsigned int D1, unsigned int D2, class R>
+bool SMatrixBatch<T, D1, D2, R>::InvertChol(int *ifail)
+{
+   STATIC_CHECK(D1 == D2, SMatrixBatch_not_square);
+   using namespace SMatrixBatchHelpers;
+   typedef RepOffset<R> OM;
+   // Cholesky factors L (lower triangle, packed) with the inverted diagonal, as in CholeskyDecomp
+   T l[D1 * (D1 + 1) / 2 * kLanes];
+   T inv[kSize * kLanes];
+   // 1 for the matrices which are not positive definite (of type T for the vectorization)
+   T fail[kLanes];
+   bool allOk = true;
+   for (unsigned int ib = 0; ib < NBlocks(); ++ib) {
+      std::fill(fail, fail + kLanes, T(0));
+      LaneCholDecomp<OM, D1>::Apply(l, Lanes(ib, 0), fail);
+      LaneCholInvertL<D1>::Apply(l);
+      LaneCholInverse<OM, D1>::Apply(inv, l);
+
+      // the matrices which cannot be inverted are not changed
+      for (unsigned int k = 0; k < kSize; ++k) {
+         T *dst = Lanes(ib, k);
+         for (unsigned int m = 0; m < kLanes; ++m)
+            dst[m] = (fail[m] == T(0)) ? inv[k * kLanes + m] : dst[m];
+      }
+      const unsigned int nInBlock = std::min<unsigned int>(kLanes, fN - ib * kLanes);
+      for (unsigned int m = 0; m < nInBlock; ++m) {
+         if (fail[m] != T(0)) allOk = false;
+         if (ifail) ifail[ib * kLanes + m] = (fail[m] != T(0)) ? 1 : 0;
+      }
+   }
+   return allOk;
+}
+
+/**
+   Matrix product of all the matrices of two batches of the same size: C[i] = A[i] * B[i].
+   The result C is resized to the size of A and can be one of the inputs.
+
+   @ingroup MatrixFunctions
+*/
+template <class T, unsigned int D1, unsigned int D, unsigned int D2, class R1, class R2>
+void Mult(const SMatrixBatch<T, D1, D, R1> &a, const SMatrixBatch<T, D, D2, R2> &b, SMatrixBatch<T, D1, D2> &c)
+{
+   using namespace SMatrixBatchHelpers;
+   typedef RepOffset<MatRepStd<T, D1, D2> > OC;
+   assert(a.Size() == b.Size());
+   c.Resize(a.Size());
+   // the block of the result is computed in a local array, which cannot alias the inputs
+   T res[D1 * D2 * kLanes];
+   for (unsigned int ib = 0; ib < a.NBlocks(); ++ib) {
+      LaneMult<OC, RepOffset<R1>, RepOffset<R2>, D1, D2, D, false>::Apply(res, a.Lanes(ib, 0), b.Lanes(ib, 0));
+      std::copy(res, res + D1 * D2 * kLanes, c.Lanes(ib, 0));
+   }
+}
+
+/**
+   Similarity transformation of all the matrices of two batches of the same size:
+   B[i] = A[i] * C[i] * A[i]^T, with C[i] symmetric.
+   The result B is resized to the size of A.
+
+   @ingroup MatrixFunctions
+*/
+template <class T, unsigned int D1, unsigned int D2, class R>
+void Similarity(const SMatrixBatch<T, D1, D2, R> &a, const SMatrixBatch<T, D2, D2, MatRepSym<T, D2> > &c,
+                SMatrixBatch<T, D1, D1, MatRepSym<T, D1> > &b)
+{
+   using namespace SMatrixBatchHelpers;
+   typedef RepOffset<MatRepStd<T, D1, D2> > OAC;
+   typedef RepOffset<MatRepSym<T, D1> > OB;
+   assert(a.Size() == c.Size());
+   b.Resize(a.Size());
+   T ac[D1 * D2 * kLanes];
+   T res[D1 * (D1 + 1) / 2 * kLanes];
+   for (unsigned int ib = 0; ib < a.NBlocks(); ++ib) {
+      // A * C, then (A * C) * A^T
+      LaneMult<OAC, RepOffset<R>, RepOffset<MatRepSym<T, D2> >, D1, D2, D2, false>::Apply(ac, a.Lanes(ib, 0),
+                                                                                            c.Lanes(ib, 0));
+      LaneMult<OB, OAC, TransposedOffset<RepOffset<R> >, D1, D1, D2, true>::Apply(res, ac, a.Lanes(ib, 0));
+      std::copy(res, res + D1 * (D1 + 1) / 2 * kLanes, b.Lanes(ib, 0));
+   }
+}
+
+/**
+   Transpose similarity transformation of all the matrices of two batches of the same size:
+   B[i] = A[i]^T * C[i] * A[i], with C[i] symmetric.
+   The result B is resized to the size of A.
+
+   @ingroup MatrixFunctions
+*/
+template <class T, unsigned int D1, unsigned int D2, class R>
+void SimilarityT(const SMatrixBatch<T, D1, D2, R> &a, const SMatrixBatch<T, D1, D1, MatRepSym<T, D1> > &c,
+                 SMatrixBatch<T, D2, D2, MatRepSym<T, D2> > &b)
+{
+   using namespace SMatrixBatchHelpers;
+   typedef RepOffset<MatRepStd<T, D1, D2> > OCA;
+   typedef RepOffset<MatRepSym<T, D2> > OB;
+   assert(a.Size() == c.Size());
+   b.Resize(a.Size());
+   T ca[D1 * D2 * kLanes];
+   T res[D2 * (D2 + 1) / 2 * kLanes];
+   for (unsigned int ib = 0; ib < a.NBlocks(); ++ib) {
+      // C * A, then A^T * (C * A)
+      LaneMult<OCA, RepOffset<MatRepSym<T, D1> >, RepOffset<R>, D1, D2, D1, false>::Apply(ca, c.Lanes(ib, 0),
+                                                                                           a.Lanes(ib, 0));
+      LaneMult<OB, TransposedOffset<RepOffset<R> >, OCA, D2, D2, D1, true>::Apply(res, a.Lanes(ib, 0), ca);
+      std::copy(res, res + D2 * (D2 + 1) / 2 * kLanes, b.Lanes(ib, 0));
+   }
+}
+
+} // namespace Math
+
+} // namespace ROOT
+
+#endif // ROOT_Math_SMatrixBatch
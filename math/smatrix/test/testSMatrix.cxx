@@ -1,6 +1,7 @@
 #include <cmath>
 #include "Math/SVector.h"
 #include "Math/SMatrix.h"
+#include "Math/SMatrixBatch.h"
 
 #include <iomanip>
 #include <iostream>
@@ -1431,6 +1432,74 @@ int test25()
    return iret;
 }
 
+int test26()
+{
+   // batched operations on many matrices, compared with the operations on single matrices
+   typedef SMatrix<double, 5, 5, MatRepSym<double, 5>> SMatrixSym5;
+   typedef SMatrix<double, 2, 5> SMatrix25;
+   const unsigned int n = 37; // not a multiple of the block size
+
+   SMatrixBatch<double, 5, 5, MatRepSym<double, 5>> cov(n);
+   SMatrixBatch<double, 2, 5> proj(n);
+   SMatrixBatch<double, 5, 2> projT(n);
+   std::vector<SMatrixSym5> vcov(n);
+   std::vector<SMatrix25> vproj(n);
+   for (unsigned int k = 0; k < n; ++k) {
+      // positive definite matrix
+      for (int i = 0; i < 5; ++i) {
+         for (int j = 0; j < i; ++j)
+            vcov[k](i, j) = 2 * double(std::rand()) / (RAND_MAX)-1; // generate between -1,1
+         vcov[k](i, i) = 10 + 10 * double(std::rand()) / (RAND_MAX);
+         for (int j = 0; j < 2 && i < 5; ++j)
+            vproj[k](j, i) = 2 * double(std::rand()) / (RAND_MAX)-1;
+      }
+      cov.Set(k, vcov[k]);
+      proj.Set(k, vproj[k]);
+      projT.Set(k, Transpose(vproj[k]));
+   }
+   // a matrix which is not positive definite
+   vcov[n - 2](2, 2) = -1;
+   cov(n - 2, 2, 2) = -1;
+
+   int iret = 0;
+   iret |= compare(cov.Get(3) == vcov[3], true);
+
+   SMatrixBatch<double, 2, 2, MatRepSym<double, 2>> res;
+   Similarity(proj, cov, res);
+   SMatrixBatch<double, 5, 5, MatRepSym<double, 5>> back;
+   SimilarityT(proj, res, back);
+   SMatrixBatch<double, 2, 2> prod;
+   Mult(proj, projT, prod);
+   for (unsigned int k = 0; k < n; ++k) {
+      SMatrix<double, 2, 2, MatRepSym<double, 2>> r = Similarity(vproj[k], vcov[k]);
+      SMatrixSym5 b = SimilarityT(vproj[k], r);
+      SMatrix<double, 2, 2> p = vproj[k] * Transpose(vproj[k]);
+      for (int i = 0; i < 2; ++i)
+         for (int j = 0; j < 2; ++j) {
+            iret |= compare(res(k, i, j), r(i, j), "batch similarity", 100);
+            iret |= compare(prod(k, i, j), p(i, j), "batch product", 100);
+         }
+      for (int i = 0; i < 5; ++i)
+         for (int j = 0; j < 5; ++j)
+            iret |= compare(back(k, i, j), b(i, j), "batch similarityT", 100);
+   }
+
+   std::vector<int> ifail(n);
+   iret |= compare(cov.InvertChol(&ifail[0]), false);
+   for (unsigned int k = 0; k < n; ++k) {
+      SMatrixSym5 inv = vcov[k];
+      bool ok = inv.InvertChol();
+      iret |= compare(ifail[k], ok ? 0 : 1);
+      // the matrices which cannot be inverted are not changed
+      for (int i = 0; i < 5; ++i)
+         for (int j = 0; j < 5; ++j)
+            iret |= compare(cov(k, i, j), ok ? inv(i, j) : vcov[k](i, j), "batch Cholesky inversion", 100);
+   }
+   iret |= compare(ifail[n - 2], 1);
+
+   return iret;
+}
+
 #define TEST(N)                                                   \
    itest = N;                                                     \
    if (test##N() == 0)                                            \
@@ -1470,6 +1539,7 @@ int testSMatrix()
    TEST(23);
    TEST(24);
    TEST(25);
+   TEST(26);
 
    return iret;
 }
@@ -30,6 +30,12 @@ class TEntryList;
 class TEventList;
 class TCollection;
 
+namespace ROOT {
+namespace Internal {
+class TChainFilePrefetcher;
+}
+}
+
 class TChain : public TTree {
 
 protected:
@@ -43,6 +49,8 @@ protected:
    TObjArray   *fFiles;            ///< -> List of file names containing the trees (TChainElement, owned)
    TList       *fStatus;           ///< -> List of active/inactive branches (TChainElement, owned)
    TChain      *fProofChain;       ///<! chain proxy when going to be processed by PROOF
+   Int_t        fPrefetchFiles;    ///<! Number of files opened ahead of the current one
+   ROOT::Internal::TChainFilePrefetcher *fPrefetcher; ///<! Pending opens of the next files (owned)
 
 private:
    TChain(const TChain&);            // not implemented
@@ -93,6 +101,7 @@ public:
    virtual Long64_t  GetChainEntryNumber(Long64_t entry) const;
    virtual TClusterIterator GetClusterIterator(Long64_t firstentry);
            Int_t     GetNtrees() const { return fNtrees; }
+           Int_t     GetPrefetchFiles() const { return fPrefetchFiles; }
    virtual Long64_t  GetEntries() const;
    virtual Long64_t  GetEntries(const char *sel) { return TTree::GetEntries(sel); }
    virtual Int_t     GetEntry(Long64_t entry=0, Int_t getall=0);
@@ -159,6 +168,8 @@ public:
    virtual void      SetEventList(TEventList *evlist);
    virtual void      SetMakeClass(Int_t make) { TTree::SetMakeClass(make); if (fTree) fTree->SetMakeClass(make);}
    virtual void      SetPacketSize(Int_t size = 100);
+   virtual void      SetPerfStats(TVirtualPerfStats *perf) { TTree::SetPerfStats(perf); if (fTree) fTree->SetPerfStats(perf); }
+   virtual void      SetPrefetchFiles(Int_t nfiles = 2);
    virtual void      SetProof(Bool_t on = kTRUE, Bool_t refresh = kFALSE, Bool_t gettreeheader = kFALSE);
    virtual void      SetWeight(Double_t w=1, Option_t *option="");
    virtual void      UseCache(Int_t maxCacheSize = 10, Int_t pageSize = 0);
@@ -78,6 +78,8 @@ class TEntryList: public TNamed
    virtual Int_t       GetTreeNumber() const { return fTreeNumber; }
    virtual Bool_t      GetReapplyCut() const { return fReapply; };
 
+   virtual void        Intersect(const TEntryList *elist);
+
    Bool_t IsValid() const
    {
       if ((fLists || fBlocks)) return kTRUE;
@@ -152,7 +152,7 @@ protected:
    Long64_t         GetCacheAutoSize(Bool_t withDefault = kFALSE) const;
    char             GetNewlineValue(std::istream &inputStream);
    TTreeCache      *GetReadCache(TFile *file, Bool_t create = kFALSE);
-   void             ImportClusterRanges(TTree *fromtree);
+   void             ImportClusterRanges(TTree *fromtree, Long64_t first = 0, Long64_t last = -1);
    void             MoveReadCache(TFile *src, TDirectory *dir);
    Int_t            SetCacheSizeAux(Bool_t autocache = kTRUE, Long64_t cacheSize = 0);
 
@@ -59,6 +59,8 @@ class TTreeCloner {
 
    UInt_t     fCloneMethod;      ///< Indicates which cloning method was selected.
    Long64_t   fToStartEntries;   ///< Number of entries in the target tree before any addition.
+   Long64_t   fFirstEntry;       ///< First entry of the input tree to be copied.
+   Long64_t   fLastEntry;        ///< One past the last entry of the input tree to be copied (-1 for all).
 
    Int_t           fCacheSize;   ///< Requested size of the file cache
    TFileCacheRead *fFileCache;   ///< File Cache used to reduce the number of individual reads
@@ -90,8 +92,9 @@ class TTreeCloner {
 
    void ImportClusterRanges();
    void CreateCache();
-   UInt_t FillCache(UInt_t from);
+   UInt_t FillCache(UInt_t from, Bool_t secondBlock = kFALSE);
    void RestoreCache();
+   Bool_t IsPartialCopy() const;
 
 private:
    TTreeCloner(const TTreeCloner&) = delete;
@@ -118,9 +121,11 @@ public:
    void   CopyProcessIds();
    const char *GetWarning() const { return fWarningMsg; }
    Bool_t Exec();
+   Long64_t FindBasketBoundary(Long64_t entry, Bool_t upward = kFALSE);
    Bool_t IsValid() { return fIsValid; }
    Bool_t NeedConversion() { return fNeedConversion; }
    void   SetCacheSize(Int_t size);
+   Bool_t SetEntryRange(Long64_t first, Long64_t last);
    void   SortBaskets();
    void   WriteBaskets();
 
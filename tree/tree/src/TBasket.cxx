@@ -438,6 +438,14 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    char *rawUncompressedBuffer, *rawCompressedBuffer;
    Int_t uncompressedBufferLen;
 
+   // Optional monitor of the read and unzip time of this branch.
+   TVirtualPerfStats *perfStats = fBranch->GetTree()->GetPerfStats();
+   Double_t readStart = 0;
+   Bool_t cached = kFALSE;
+   if (R__unlikely(perfStats)) {
+      readStart = TTimeStamp();
+   }
+
    // See if the cache has already unzipped the buffer for us.
    TFileCacheRead *pf = nullptr;
    {
@@ -450,6 +458,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       char *buffer = nullptr;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
+         if (R__unlikely(perfStats)) {
+            perfStats->BasketReadEvent(fBranch, len, readStart, kTRUE);
+         }
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
          // Note that in the kNotDecompressed case, the above function will return 0;
          // In such a case, we should stop processing
@@ -488,7 +499,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
       if (st < 0) {
          return 1;
-      } else if (st == 0) {
+      } else if (st > 0) {
+         cached = kTRUE;
+      } else {
          // Read directly from file, not from the cache
          // If we are using a TTreeCache, disable reading from the default cache
          // temporarily, to force reading directly from file
@@ -515,6 +528,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
       else gPerfStats = temp;
    }
+   if (R__unlikely(perfStats)) {
+      perfStats->BasketReadEvent(fBranch, len, readStart, cached);
+   }
    Streamer(*readBufferRef);
    if (IsZombie()) {
       return 1;
@@ -560,7 +576,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
       // Optional monitor for zip time profiling.
       Double_t start = 0;
-      if (R__unlikely(gPerfStats)) {
+      if (R__unlikely(gPerfStats || perfStats)) {
          start = TTimeStamp();
       }
 
@@ -605,6 +621,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
       }
       gPerfStats = temp;
+      if (R__unlikely(perfStats)) {
+         perfStats->BasketUnzipEvent(fBranch,start,nintot,fObjlen);
+      }
    } else {
       // Nothing is compressed - copy over wholesale.
       memcpy(rawUncompressedBuffer, rawCompressedBuffer, len);
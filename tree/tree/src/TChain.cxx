@@ -55,8 +55,131 @@ the trees in the chain.
 #include "TFilePrefetch.h"
 #include "TVirtualMutex.h"
 
+#ifdef R__USE_IMT
+#include "ROOT/TFuture.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <map>
+#include <memory>
+#include <vector>
+
 ClassImp(TChain);
 
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class TChainFilePrefetcher
+/// Opens the files of a TChain ahead of their use by TChain::LoadTree().
+///
+/// When implicit multi-threading is enabled the file is opened and the TTree
+/// header is read in a task of the ROOT thread pool; the TTree is kept in
+/// memory by the file and found there by the TFile::Get() in LoadTree().
+/// Otherwise the request goes through TFile::AsyncOpen(), which is
+/// asynchronous for the protocols supporting it (e.g. xrootd).
+
+class TChainFilePrefetcher {
+private:
+   struct TRequest {
+#ifdef R__USE_IMT
+      std::unique_ptr<ROOT::Experimental::TFuture<TFile *>> fFuture;
+#endif
+      TFileOpenHandle *fHandle = nullptr;
+      TFile *fFile = nullptr; ///< File already opened by the chain (see Add)
+   };
+   std::map<Int_t, TRequest> fRequests; ///< Pending requests, indexed by tree number
+
+   static TFile *Complete(TRequest &req)
+   {
+      if (req.fFile)
+         return req.fFile;
+#ifdef R__USE_IMT
+      if (req.fFuture)
+         return req.fFuture->get();
+#endif
+      if (req.fHandle) {
+         TDirectory::TContext ctxt;
+         return TFile::Open(req.fHandle);
+      }
+      return nullptr;
+   }
+
+public:
+   ~TChainFilePrefetcher() { Clear(); }
+
+   /// Wait for all pending requests and close the corresponding files.
+   void Clear()
+   {
+      for (auto &req : fRequests)
+         delete Complete(req.second);
+      fRequests.clear();
+   }
+
+   /// Start opening the file of tree `treenum`, unless already requested.
+   void Request(Int_t treenum, TChainElement *element)
+   {
+      if (fRequests.count(treenum))
+         return;
+      TRequest &req = fRequests[treenum];
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled()) {
+         TString filename = element->GetTitle();
+         TString treename = element->GetName();
+         auto open = [filename, treename]() -> TFile * {
+            TDirectory::TContext ctxt;
+            TFile *file = TFile::Open(filename);
+            if (file && !file->IsZombie())
+               file->Get(treename);
+            return file;
+         };
+         req.fFuture.reset(new ROOT::Experimental::TFuture<TFile *>(ROOT::Experimental::Async(open)));
+         return;
+      }
+#endif
+      req.fHandle = TFile::AsyncOpen(element->GetTitle());
+   }
+
+   /// Keep the file of tree `treenum`, already opened by the caller, until
+   /// LoadTree() reaches it. The prefetcher takes the ownership of the file.
+   void Add(Int_t treenum, TFile *file)
+   {
+      if (fRequests.count(treenum)) {
+         delete file;
+         return;
+      }
+      fRequests[treenum].fFile = file;
+   }
+
+   /// Return the file of tree `treenum` if it was requested, 0 otherwise.
+   /// The caller owns the returned file.
+   TFile *Take(Int_t treenum)
+   {
+      auto it = fRequests.find(treenum);
+      if (it == fRequests.end())
+         return nullptr;
+      TFile *file = Complete(it->second);
+      fRequests.erase(it);
+      return file;
+   }
+
+   /// Close the files requested for trees outside [first, last].
+   void Discard(Int_t first, Int_t last)
+   {
+      for (auto it = fRequests.begin(); it != fRequests.end();) {
+         if (it->first < first || it->first > last) {
+            delete Complete(it->second);
+            it = fRequests.erase(it);
+         } else {
+            ++it;
+         }
+      }
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor.
 
@@ -72,6 +195,8 @@ TChain::TChain()
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fPrefetchFiles(0)
+, fPrefetcher(0)
 {
    fTreeOffset = new Long64_t[fTreeOffsetLen];
    fFiles = new TObjArray(fTreeOffsetLen);
@@ -146,6 +271,8 @@ TChain::TChain(const char* name, const char* title)
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fPrefetchFiles(0)
+, fPrefetcher(0)
 {
    //
    //*-*
@@ -182,6 +309,8 @@ TChain::~TChain()
    }
 
    SafeDelete(fProofChain);
+   delete fPrefetcher;
+   fPrefetcher = 0;
    fStatus->Delete();
    delete fStatus;
    fStatus = 0;
@@ -927,6 +1056,53 @@ Long64_t TChain::GetEntries() const
                                " run TChain::SetProof(kTRUE, kTRUE) first");
       return fProofChain->GetEntries();
    }
+#ifdef R__USE_IMT
+   if (fEntries == TTree::kMaxEntries && fPrefetchFiles > 0 && ROOT::IsImplicitMTEnabled()) {
+      // Count the entries of the trees not yet opened concurrently.
+      std::vector<Int_t> unknown;
+      for (Int_t i = 0; i < fNtrees; ++i) {
+         TChainElement *element = (TChainElement*) fFiles->UncheckedAt(i);
+         if (element->GetEntries() == TTree::kMaxEntries) unknown.push_back(i);
+      }
+      std::vector<TFile*> files(unknown.size(), nullptr);
+      auto countEntries = [this, &unknown, &files](UInt_t i) -> Long64_t {
+         TChainElement *element = (TChainElement*) fFiles->UncheckedAt(unknown[i]);
+         TDirectory::TContext ctxt;
+         std::unique_ptr<TFile> file(TFile::Open(element->GetTitle()));
+         if (!file || file->IsZombie()) return -1;
+         TTree *tree = dynamic_cast<TTree*>(file->Get(element->GetName()));
+         if (!tree) return -1;
+         files[i] = file.release();
+         return tree->GetEntries();
+      };
+      ROOT::TThreadExecutor pool;
+      auto nentries = pool.Map(countEntries, ROOT::TSeqU(unknown.size()));
+      // The files of the next trees to be loaded are kept open, with their
+      // tree header, for LoadTree; the others are opened again ahead of use.
+      Int_t next = fTreeNumber < 0 ? 0 : fTreeNumber + 1;
+      for (UInt_t i = 0; i < unknown.size(); ++i) {
+         // Failures are left to LoadTree below, which reports them.
+         if (nentries[i] >= 0) {
+            ((TChainElement*) fFiles->UncheckedAt(unknown[i]))->SetNumberEntries(nentries[i]);
+         }
+         if (files[i] && unknown[i] >= next && unknown[i] <= next + fPrefetchFiles) {
+            fPrefetcher->Add(unknown[i], files[i]);
+         } else {
+            delete files[i];
+         }
+      }
+      // Rebuild the offset table up to the first tree still unknown.
+      for (Int_t i = 0; i < fNtrees; ++i) {
+         Long64_t n = ((TChainElement*) fFiles->UncheckedAt(i))->GetEntries();
+         if (fTreeOffset[i] == TTree::kMaxEntries || n == TTree::kMaxEntries) {
+            fTreeOffset[i+1] = TTree::kMaxEntries;
+         } else {
+            fTreeOffset[i+1] = fTreeOffset[i] + n;
+         }
+      }
+      const_cast<TChain*>(this)->fEntries = fTreeOffset[fNtrees];
+   }
+#endif
    if (fEntries == TTree::kMaxEntries) {
       const_cast<TChain*>(this)->LoadTree(TTree::kMaxEntries-1);
    }
@@ -1460,7 +1636,16 @@ Long64_t TChain::LoadTree(Long64_t entry)
    //        if we did not delete it above.
    {
       TDirectory::TContext ctxt;
-      fFile = TFile::Open(element->GetTitle());
+      if (fPrefetcher) {
+         // Use the file if it was opened ahead and start opening the next ones.
+         fFile = fPrefetcher->Take(treenum);
+         Int_t last = TMath::Min(treenum + fPrefetchFiles, fNtrees - 1);
+         fPrefetcher->Discard(treenum + 1, last);
+         for (Int_t i = treenum + 1; i <= last; ++i) {
+            fPrefetcher->Request(i, (TChainElement*) fFiles->At(i));
+         }
+      }
+      if (!fFile) fFile = TFile::Open(element->GetTitle());
       if (fFile) fFile->SetBit(kMustCleanup);
    }
 
@@ -1613,6 +1798,8 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    fTree->SetMakeClass(fMakeClass);
    fTree->SetMaxVirtualSize(fMaxVirtualSize);
+   // the baskets and the cache of the tree report to the perf stats of the chain
+   fTree->SetPerfStats(GetPerfStats());
 
    SetChainOffset(fTreeOffset[fTreeNumber]);
 
@@ -2237,6 +2424,7 @@ void TChain::RemoveFriend(TTree* oldFriend)
 
 void TChain::Reset(Option_t*)
 {
+   if (fPrefetcher) fPrefetcher->Clear();
    delete fFile;
    fFile = 0;
    fNtrees         = 0;
@@ -2738,6 +2926,33 @@ void TChain::SetPacketSize(Int_t size)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Open the next `nfiles` files of the chain ahead of their use.
+///
+/// Each time LoadTree() switches to a new file, the opening of the following
+/// `nfiles` files is started while the current one is processed. With
+/// implicit multi-threading enabled (ROOT::EnableImplicitMT()) the files are
+/// opened and their TTree header is read in the thread pool, and GetEntries()
+/// counts the entries of the files not yet opened concurrently, keeping open
+/// the files of the next `nfiles`+1 trees to be loaded. Without it,
+/// TFile::AsyncOpen() is used, which overlaps the opening of remote files.
+///
+/// This is useful for long chains of remote files, where the file opening
+/// latency is a large fraction of the processing time. Note that up to
+/// `nfiles`+1 files are kept open at the same time. Use `nfiles` = 0 to
+/// switch this mode off.
+
+void TChain::SetPrefetchFiles(Int_t nfiles)
+{
+   fPrefetchFiles = nfiles > 0 ? nfiles : 0;
+   if (fPrefetchFiles > 0) {
+      if (!fPrefetcher) fPrefetcher = new ROOT::Internal::TChainFilePrefetcher();
+   } else {
+      delete fPrefetcher;
+      fPrefetcher = 0;
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Enable/Disable PROOF processing on the current default Proof (gProof).
 ///
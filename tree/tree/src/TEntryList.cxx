@@ -55,6 +55,9 @@ End_Macro
 - __Subtract__() - if the lists are for the same TTree, removes the entries of the second
                list from the first list. If the lists are for TChains, loops over all
                sub-lists
+- __Intersect__() - if the lists are for the same TTree, keeps only the entries of the
+               first list that are also in the second list. If the lists are for TChains,
+               loops over all sub-lists
 - __GetEntry(n)__ - returns the n-th entry number
 - __Next__()      - returns next entry number. Note, that this function is
                 much faster than GetEntry, and it's called when GetEntry() is called
@@ -1229,13 +1232,21 @@ void TEntryList::Subtract(const TEntryList *elist)
          //second list is also only for 1 tree
          if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
              !strcmp(elist->fFileName.Data(),fFileName.Data())){
-            //same tree
-            Long64_t n2 = elist->GetN();
-            Long64_t entry;
-            for (Int_t i=0; i<n2; i++){
-               entry = (const_cast<TEntryList*>(elist))->GetEntry(i);
-               Remove(entry);
+            //same tree, subtract block by block
+            if (!elist->fBlocks) return;
+            TEntryListBlock *block1 = 0;
+            TEntryListBlock *block2 = 0;
+            Int_t nmin = TMath::Min(fNBlocks, elist->fNBlocks);
+            Long64_t nnew, nold;
+            for (Int_t i=0; i<nmin; i++){
+               block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+               block2 = (TEntryListBlock*)elist->fBlocks->UncheckedAt(i);
+               nold = block1->GetNPassed();
+               nnew = block1->Subtract(block2);
+               fN = fN - nold + nnew;
             }
+            fLastIndexQueried = -1;
+            fLastIndexReturned = 0;
          } else {
             //different trees
             return;
@@ -1270,6 +1281,76 @@ void TEntryList::Subtract(const TEntryList *elist)
    return;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Keep only the entries of this entry list that are also contained in elist
+
+void TEntryList::Intersect(const TEntryList *elist)
+{
+   TEntryList *templist = 0;
+   if (!fLists){
+      if (!fBlocks) return;
+      TEntryListBlock empty;
+      TEntryListBlock *block1 = 0;
+      TEntryListBlock *block2 = 0;
+      Int_t i;
+      if (!elist->fLists){
+         //second list is also only for 1 tree
+         Int_t nmin = 0;
+         if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
+             !strcmp(elist->fFileName.Data(),fFileName.Data()) && elist->fBlocks){
+            //same tree, intersect block by block
+            nmin = TMath::Min(fNBlocks, elist->fNBlocks);
+            for (i=0; i<nmin; i++){
+               block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+               block2 = (TEntryListBlock*)elist->fBlocks->UncheckedAt(i);
+               block1->Intersect(block2);
+            }
+         }
+         //blocks not present in the second list become empty
+         for (i=nmin; i<fNBlocks; i++){
+            block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+            block1->Intersect(&empty);
+         }
+      } else {
+         //second list has sublists, try to find one for the same tree as this list
+         TIter next1(elist->GetLists());
+         templist = 0;
+         Bool_t found = kFALSE;
+         while ((templist = (TEntryList*)next1())){
+            if (!strcmp(templist->fTreeName.Data(),fTreeName.Data()) &&
+                !strcmp(templist->fFileName.Data(),fFileName.Data())){
+               found = kTRUE;
+               break;
+            }
+         }
+         if (found) {
+            Intersect(templist);
+            return;
+         }
+         for (i=0; i<fNBlocks; i++){
+            block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+            block1->Intersect(&empty);
+         }
+      }
+      fN = 0;
+      for (i=0; i<fNBlocks; i++)
+         fN += ((TEntryListBlock*)fBlocks->UncheckedAt(i))->GetNPassed();
+      fLastIndexQueried = -1;
+      fLastIndexReturned = 0;
+   } else {
+      //this list has sublists
+      TIter next2(fLists);
+      templist = 0;
+      Long64_t oldn=0;
+      while ((templist = (TEntryList*)next2())){
+         oldn = templist->GetN();
+         templist->Intersect(elist);
+         fN = fN - oldn + templist->GetN();
+      }
+   }
+   return;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 TEntryList operator||(TEntryList &elist1, TEntryList &elist2)
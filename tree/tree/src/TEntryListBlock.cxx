@@ -38,16 +38,40 @@ End_Macro
  - __Merge__() - adds all entries from one block to the other. If the first block
              uses array representation, it's changed to bits representation only
              if the total number of passing entries is still less than kBlockSize
+ - __Subtract__() - removes all entries of the other block from this block
+ - __Intersect__() - keeps only the entries that are also in the other block
  - __GetEntry(n)__ - returns n-th non-zero entry.
  - __Next__()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
+
+Set operations between blocks stored as lists of passing entries work directly
+on the sorted arrays; otherwise they are done 16 entries at a time on the bits
+representation, which keeps Add() and Subtract() of large entry lists cheap.
 */
 
 #include "TEntryListBlock.h"
 #include "TString.h"
 
+#include <cstring>
+
 ClassImp(TEntryListBlock);
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of bits set in a 16-bit word
+
+inline Int_t BitCount(UShort_t word)
+{
+   UInt_t w = word;
+   w = w - ((w >> 1) & 0x5555);
+   w = (w & 0x3333) + ((w >> 2) & 0x3333);
+   w = (w + (w >> 4)) & 0x0F0F;
+   return (w + (w >> 8)) & 0x1F;
+}
+
+} // anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default c-tor
 
@@ -239,124 +263,156 @@ Int_t TEntryListBlock::Contains(Int_t entry)
 ////////////////////////////////////////////////////////////////////////////////
 /// Merge with the other block
 /// Returns the resulting number of entries in the block
+///
+/// Two sparse lists of passing entries are merged as sorted arrays; in all
+/// other cases the union is computed word by word on the bits representation.
 
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
-   Int_t i, j;
+   Int_t i;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
+      if (fIndices)
+         delete [] fIndices;
       fN = block->fN;
-      fIndices = new UShort_t[fN];
-      for (i=0; i<fN; i++)
-         fIndices[i] = block->fIndices[i];
+      if (block->fIndices) {
+         fIndices = new UShort_t[fN];
+         for (i=0; i<fN; i++)
+            fIndices[i] = block->fIndices[i];
+      } else {
+         fIndices = 0;
+      }
       fNPassed = block->fNPassed;
       fType = block->fType;
       fPassing = block->fPassing;
       fCurrent = block->fCurrent;
       fLastIndexReturned = -1;
       fLastIndexQueried = -1;
-      return fNPassed;
+      return GetNPassed();
    }
-   if (fType==0){
-      //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
-         }
-      } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
+   if (fType==1 && fPassing && block->fType==1 && block->fPassing &&
+       GetNPassed() + block->GetNPassed() <= kBlockSize){
+      //both blocks are short lists of passing entries: make a bigger list
+      Int_t en = block->fNPassed;
+      Int_t newsize = fNPassed + en;
+      UShort_t *newlist = new UShort_t[newsize];
+      UShort_t *elst = block->fIndices;
+      Int_t newpos, elpos;
+      newpos = elpos = 0;
+      for (i=0; i<fNPassed; i++) {
+         while (elpos < en && fIndices[i] > elst[elpos]) {
+            newlist[newpos] = elst[elpos];
+            newpos++;
+            elpos++;
          }
+         if (elpos < en && fIndices[i] == elst[elpos]) elpos++;
+         newlist[newpos] = fIndices[i];
+         newpos++;
       }
+      while (elpos < en) {
+         newlist[newpos] = elst[elpos];
+         newpos++;
+         elpos++;
+      }
+      delete [] fIndices;
+      fIndices = newlist;
+      fNPassed = newpos;
+      fN = fNPassed;
    } else {
-      //stored as a list
-      if (GetNPassed() + block->GetNPassed() > kBlockSize){
-         //change to bits
-         UShort_t *bits = new UShort_t[kBlockSize];
-         Transform(1, bits);
-         Merge(block);
+      //union of the bits representations
+      UShort_t buffer[kBlockSize];
+      const UShort_t *bits = block->GetBits(buffer);
+      ToBits();
+      Int_t npassed = 0;
+      for (i=0; i<kBlockSize; i++){
+         fIndices[i] |= bits[i];
+         npassed += BitCount(fIndices[i]);
+      }
+      fNPassed = npassed;
+   }
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of the other block from this block
+/// Returns the resulting number of entries in the block
+///
+/// A list of passing entries is filtered in place, otherwise the difference
+/// is computed word by word on the bits representation.
+
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   Int_t i;
+   if (GetNPassed() == 0 || block->GetNPassed() == 0) return GetNPassed();
+   UShort_t buffer[kBlockSize];
+   const UShort_t *bits = block->GetBits(buffer);
+   if (fType==1 && fPassing){
+      Int_t npassed = 0;
+      for (i=0; i<fNPassed; i++){
+         if ((bits[fIndices[i]>>4] & (1<<(fIndices[i] & 15)))==0)
+            fIndices[npassed++] = fIndices[i];
+      }
+      fNPassed = npassed;
+      fN = fNPassed;
+   } else {
+      ToBits();
+      Int_t npassed = 0;
+      for (i=0; i<kBlockSize; i++){
+         fIndices[i] &= ~bits[i];
+         npassed += BitCount(fIndices[i]);
+      }
+      fNPassed = npassed;
+   }
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keep only the entries of this block that are also in the other block
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Intersect(TEntryListBlock *block)
+{
+   Int_t i;
+   if (GetNPassed() == 0) return 0;
+   if (block->GetNPassed() == 0){
+      //the result is empty
+      if (fIndices)
+         delete [] fIndices;
+      fIndices = 0;
+      fN = kBlockSize;
+      fNPassed = 0;
+      fType = -1;
+      fPassing = 1;
+   } else {
+      UShort_t buffer[kBlockSize];
+      const UShort_t *bits = block->GetBits(buffer);
+      if (fType==1 && fPassing){
+         Int_t npassed = 0;
+         for (i=0; i<fNPassed; i++){
+            if ((bits[fIndices[i]>>4] & (1<<(fIndices[i] & 15)))!=0)
+               fIndices[npassed++] = fIndices[i];
+         }
+         fNPassed = npassed;
+         fN = fNPassed;
       } else {
-         //this is only possible if fPassing=1 in both blocks
-         if (block->fType==1){
-            //second block stored as a list
-            //make a bigger list
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            UShort_t *elst = block->fIndices;
-            Int_t newpos, elpos;
-            newpos = elpos = 0;
-            for (i=0; i<fNPassed; i++) {
-               while (elpos < en && fIndices[i] > elst[elpos]) {
-                  newlist[newpos] = elst[elpos];
-                  newpos++;
-                  elpos++;
-               }
-               if (fIndices[i] == elst[elpos]) elpos++;
-               newlist[newpos] = fIndices[i];
-               newpos++;
-            }
-            while (elpos < en) {
-               newlist[newpos] = elst[elpos];
-               newpos++;
-               elpos++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         } else {
-            //second block is stored as bits
-
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            Int_t newpos, current;
-            newpos = current = 0;
-            for (i=0; i<kBlockSize*16; i++){
-               if (!block->Contains(i)) continue;
-               while(current < fNPassed && fIndices[current]<i){
-                  newlist[newpos] = fIndices[current];
-                  current++;
-                  newpos++;
-               }
-               if (fIndices[current]==i) current++;
-               newlist[newpos] = i;
-               newpos++;
-            }
-            while(current<fNPassed){
-               newlist[newpos] = fIndices[current];
-               newpos++;
-               current++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
+         ToBits();
+         Int_t npassed = 0;
+         for (i=0; i<kBlockSize; i++){
+            fIndices[i] &= bits[i];
+            npassed += BitCount(fIndices[i]);
          }
+         fNPassed = npassed;
       }
    }
+   fCurrent = 0;
    fLastIndexQueried = -1;
    fLastIndexReturned = -1;
    OptimizeStorage();
@@ -382,18 +438,22 @@ Int_t TEntryListBlock::GetNPassed()
 Int_t TEntryListBlock::GetEntry(Int_t entry)
 {
    if (entry > kBlockSize*16) return -1;
-   if (entry > GetNPassed()) return -1;
+   if (entry >= GetNPassed()) return -1;
    if (entry == fLastIndexQueried+1) return Next();
    else {
       Int_t i=0; Int_t j=0; Int_t entries_found=0;
       if (fType==0){
-         if ((fIndices[i] & (1<<j))!=0)
-            entries_found++;
-         while (entries_found<entry+1){
-            if (j==15){i++; j=0;}
-            else j++;
-            if ((fIndices[i] & (1<<j))!=0)
+         //skip whole words, then look for the bit inside the word
+         Int_t nbits;
+         while (entries_found + (nbits = BitCount(fIndices[i])) < entry+1){
+            entries_found += nbits;
+            i++;
+         }
+         for (j=0; j<16; j++){
+            if ((fIndices[i] & (1<<j))!=0){
                entries_found++;
+               if (entries_found==entry+1) break;
+            }
          }
          fLastIndexQueried = entry;
          fLastIndexReturned = i*16+j;
@@ -459,12 +519,15 @@ Int_t TEntryListBlock::Next()
       fLastIndexReturned++;
       i = fLastIndexReturned>>4;
       j = fLastIndexReturned & 15;
-      Bool_t result=(fIndices[i] & (1<<j))!=0;
-      while (result==0){
-         if (j==15) {j=0; i++;}
-         else j++;
-         result = (fIndices[i] & (1<<j))!=0;
+      //mask the bits already returned and skip the empty words
+      UInt_t word = fIndices[i] & (0xFFFF << j);
+      while (word==0){
+         i++;
+         word = fIndices[i];
       }
+      j = 0;
+      while ((word & (1<<j))==0)
+         j++;
       fLastIndexReturned = i*16+j;
       fLastIndexQueried++;
       return fLastIndexReturned;
@@ -618,3 +681,48 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
    fPassing = 1;
    return;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Switch to the bits representation, whatever the current one is
+
+void TEntryListBlock::ToBits()
+{
+   if (fType==0 && fIndices) return;
+   Int_t npassed = GetNPassed();
+   UShort_t *bits = new UShort_t[kBlockSize];
+   GetBits(bits);
+   if (fIndices)
+      delete [] fIndices;
+   fIndices = bits;
+   fType = 0;
+   fN = kBlockSize;
+   fPassing = 1;
+   fNPassed = npassed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the entries of this block as bits.
+/// If the block is already stored as bits, its own array is returned,
+/// otherwise the bits are written into buffer (kBlockSize UShort_ts), which
+/// is returned.
+
+const UShort_t *TEntryListBlock::GetBits(UShort_t *buffer) const
+{
+   if (fType==0 && fIndices) return fIndices;
+   Int_t i;
+   if (fPassing){
+      memset(buffer, 0, kBlockSize*sizeof(UShort_t));
+      if (fIndices){
+         for (i=0; i<fNPassed; i++)
+            buffer[fIndices[i]>>4] |= 1<<(fIndices[i] & 15);
+      }
+   } else {
+      for (i=0; i<kBlockSize; i++)
+         buffer[i] = 0xFFFF;
+      if (fIndices){
+         for (i=0; i<fNPassed; i++)
+            buffer[fIndices[i]>>4] &= ~(1<<(fIndices[i] & 15));
+      }
+   }
+   return buffer;
+}
@@ -405,6 +405,7 @@ End_Macro
 #include <stdio.h>
 #include <limits.h>
 #include <algorithm>
+#include <vector>
 
 #ifdef R__USE_IMT
 #include "ROOT/TThreadExecutor.hxx"
@@ -3344,9 +3345,12 @@ namespace {
 ///
 /// Returns number of bytes copied to this tree.
 ///
-/// If 'option' contains the word 'fast' and nentries is -1, the cloning will be
-/// done without unzipping or unstreaming the baskets (i.e., a direct copy of the
-/// raw bytes on disk).
+/// If 'option' contains the word 'fast', the cloning will be done without
+/// unzipping or unstreaming the baskets (i.e., a direct copy of the raw bytes
+/// on disk). If only the first nentries are requested, the baskets up to the
+/// last basket boundary common to all the branches (usually a cluster boundary)
+/// before nentries are copied as is, and only the remaining entries are
+/// unzipped, unstreamed and filled.
 ///
 /// When 'fast' is specified, 'option' can also contains a sorting order for the
 /// baskets in the output file.
@@ -3417,13 +3421,15 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
       nentries = treeEntries;
    }
 
-   if (fastClone && (nentries < 0 || nentries == tree->GetEntriesFast())) {
+   if (fastClone) {
       // Quickly copy the basket without decompression and streaming.
       Long64_t totbytes = GetTotBytes();
       for (Long64_t i = 0; i < nentries; i += tree->GetTree()->GetEntries()) {
          if (tree->LoadTree(i) < 0) {
             break;
          }
+         // Number of entries of the current tree to be copied.
+         Long64_t localEntries = TMath::Min(tree->GetTree()->GetEntries(), nentries - i);
          if ( withIndex ) {
             withIndex = R__HandleIndex( onIndexError, this, tree );
          }
@@ -3437,9 +3443,25 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
          }
          TTreeCloner cloner(tree->GetTree(), this, option, TTreeCloner::kNoWarnings);
          if (cloner.IsValid()) {
-            this->SetEntries(this->GetEntries() + tree->GetTree()->GetEntries());
-            if (cacheSize != -1) cloner.SetCacheSize(cacheSize);
-            cloner.Exec();
+            Long64_t ncloned = localEntries;
+            if (localEntries < tree->GetTree()->GetEntries()) {
+               // Only the beginning of this tree is needed: copy the baskets up
+               // to the last common basket boundary, fill the rest one by one.
+               ncloned = cloner.FindBasketBoundary(localEntries);
+               cloner.SetEntryRange(0, ncloned);
+            }
+            if (ncloned > 0) {
+               this->SetEntries(this->GetEntries() + ncloned);
+               if (cacheSize != -1) cloner.SetCacheSize(cacheSize);
+               cloner.Exec();
+            }
+            TTree *localtree = tree->GetTree();
+            for (Long64_t ii = ncloned; ii < localEntries; ii++) {
+               if (localtree->GetEntry(ii) <= 0) {
+                  break;
+               }
+               this->Fill();
+            }
          } else {
             if (i == 0) {
                Warning("CopyEntries","%s",cloner.GetWarning());
@@ -3449,8 +3471,7 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
             } else {
                if (cloner.NeedConversion()) {
                   TTree *localtree = tree->GetTree();
-                  Long64_t tentries = localtree->GetEntries();
-                  for (Long64_t ii = 0; ii < tentries; ii++) {
+                  for (Long64_t ii = 0; ii < localEntries; ii++) {
                      if (localtree->GetEntry(ii) <= 0) {
                         break;
                      }
@@ -6035,12 +6056,57 @@ TList* TTree::GetUserInfo()
 ///
 /// This is used when doing a fast cloning (by TTreeCloner).
 /// See also fAutoFlush and fAutoSave if needed.
+/// \param fromtree tree whose entries are appended to this tree
+/// \param first first entry of fromtree appended to this tree
+/// \param last one past the last entry of fromtree appended to this tree
+///        (-1 for all the entries)
+/// Only the clusters of [first, last) are imported; a cluster cut by 'first'
+/// becomes a range of its own.
 
-void TTree::ImportClusterRanges(TTree *fromtree)
+void TTree::ImportClusterRanges(TTree *fromtree, Long64_t first /* = 0 */, Long64_t last /* = -1 */)
 {
    Long64_t autoflush = fromtree->GetAutoFlush();
-   if (fNClusterRange || fromtree->fNClusterRange) {
-      Int_t newsize = fNClusterRange + 1 + fromtree->fNClusterRange;
+   if (first < 0) first = 0;
+   if (last < 0 || last > fromtree->GetEntries()) last = fromtree->GetEntries();
+
+   // Inclusive end (in fromtree) and cluster size of the ranges to be imported
+   // and cluster size of the last, open, range.
+   std::vector<Long64_t> rangeEnd;
+   std::vector<Long64_t> clusterSize;
+   Long64_t lastSize = autoflush;
+   Long64_t pedestal = 0;
+   for (Int_t i = 0; i <= fromtree->fNClusterRange; ++i) {
+      Bool_t open = (i == fromtree->fNClusterRange);
+      Long64_t rangeStart = pedestal;
+      Long64_t end = open ? last - 1 : fromtree->fClusterRangeEnd[i];
+      Long64_t size = open ? autoflush : fromtree->fClusterSize[i];
+      pedestal = end + 1;
+      Long64_t start = TMath::Max(rangeStart, first);
+      if (start > TMath::Min(end, last - 1)) {
+         if (start >= last) break;
+         continue;
+      }
+      Long64_t cut = size > 0 ? (start - rangeStart) % size : 0;
+      if (cut) {
+         Long64_t cutEnd = TMath::Min(start - cut + size - 1, end);
+         if (cutEnd >= last - 1) {
+            lastSize = size;
+            break;
+         }
+         rangeEnd.push_back(cutEnd);
+         clusterSize.push_back(size);
+         if (cutEnd == end) continue;
+      }
+      if (open || end >= last) {
+         lastSize = size;
+         break;
+      }
+      rangeEnd.push_back(end);
+      clusterSize.push_back(size);
+   }
+
+   if (fNClusterRange || !rangeEnd.empty()) {
+      Int_t newsize = fNClusterRange + 1 + rangeEnd.size();
       if (newsize > fMaxClusterRange) {
          if (fMaxClusterRange) {
             fClusterRangeEnd = (Long64_t*)TStorage::ReAlloc(fClusterRangeEnd,
@@ -6057,18 +6123,18 @@ void TTree::ImportClusterRanges(TTree *fromtree)
       fClusterRangeEnd[fNClusterRange] = fEntries - 1;
       fClusterSize[fNClusterRange] = fAutoFlush<0 ? 0 : fAutoFlush;
       ++fNClusterRange;
-      for (Int_t i = 0 ; i < fromtree->fNClusterRange; ++i) {
-         fClusterRangeEnd[fNClusterRange] = fEntries + fromtree->fClusterRangeEnd[i];
-         fClusterSize[fNClusterRange] = fromtree->fClusterSize[i];
+      for (UInt_t i = 0 ; i < rangeEnd.size(); ++i) {
+         fClusterRangeEnd[fNClusterRange] = fEntries + rangeEnd[i] - first;
+         fClusterSize[fNClusterRange] = clusterSize[i];
          ++fNClusterRange;
       }
-      fAutoFlush = autoflush;
+      fAutoFlush = lastSize;
    } else {
-      SetAutoFlush( autoflush );
+      SetAutoFlush( lastSize );
    }
    Long64_t autosave = GetAutoSave();
-   if (autoflush > 0 && autosave > 0) {
-      SetAutoSave( autoflush*(autosave/autoflush) );
+   if (lastSize > 0 && autosave > 0) {
+      SetAutoSave( lastSize*(autosave/lastSize) );
    }
 }
 
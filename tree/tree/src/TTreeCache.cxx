@@ -240,6 +240,7 @@ of effective system reads for a given file with a code like
 #include "TLeaf.h"
 #include "TFriendElement.h"
 #include "TFile.h"
+#include "TVirtualPerfStats.h"
 #include <limits.h>
 
 Int_t TTreeCache::fgLearnEntries = 100;
@@ -852,6 +853,9 @@ Bool_t TTreeCache::FillBuffer()
                   TFileCacheRead::Prefetch(pos,len);
                   fNtotCurrentBuf = fNtot;
                }
+               if (R__unlikely(b->GetTree()->GetPerfStats())) {
+                  b->GetTree()->GetPerfStats()->BasketPrefetchEvent(b, len);
+               }
                if ( ( j < (nb-1) ) && entries[j+1] > maxReadEntry ) {
                   maxReadEntry = entries[j+1];
                }
@@ -99,6 +99,9 @@ Bool_t TTreeCloner::CompareEntry::operator()(UInt_t i1, UInt_t i2)
 /// This means that on the file the baskets will be in the order
 /// in which they will be needed when reading the whole tree
 /// sequentially.
+///
+/// By default all the entries of 'from' are copied; see SetEntryRange
+/// to copy only a range of entries aligned on basket boundaries.
 
 TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options) :
    fWarningMsg(),
@@ -119,6 +122,8 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fPidOffset(0),
    fCloneMethod(TTreeCloner::kDefault),
    fToStartEntries(0),
+   fFirstEntry(0),
+   fLastEntry(-1),
    fCacheSize(0LL),
    fFileCache(nullptr),
    fPrevCache(nullptr)
@@ -462,18 +467,28 @@ UInt_t TTreeCloner::CollectBranches()
 void TTreeCloner::CollectBaskets()
 {
    UInt_t len = fFromBranches.GetEntries();
+   Bool_t partial = IsPartialCopy();
 
-   for(UInt_t i=0,bi=0; i<len; ++i) {
+   UInt_t bi = 0;
+   for(UInt_t i=0; i<len; ++i) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt(i);
-      for(Int_t b=0; b<from->GetWriteBasket(); ++b,++bi) {
+      for(Int_t b=0; b<from->GetWriteBasket(); ++b) {
+         if (partial && (from->GetBasketEntry()[b] < fFirstEntry || from->GetBasketEntry()[b] >= fLastEntry)) {
+            // The range is aligned on basket boundaries, so a basket is
+            // either completely inside or completely outside of it.
+            continue;
+         }
          fBasketBranchNum[bi] = i;
          fBasketNum[bi] = b;
          fBasketSeek[bi] = from->GetBasketSeek(b);
          //fprintf(stderr,"For %s %d %lld\n",from->GetName(),bi,fBasketSeek[bi]);
          fBasketEntry[bi] = from->GetBasketEntry()[b];
          fBasketIndex[bi] = bi;
+         ++bi;
       }
    }
+   // Only the selected baskets are sorted and written.
+   fMaxBaskets = bi;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -524,22 +539,34 @@ void TTreeCloner::CopyStreamerInfos()
 void TTreeCloner::CopyMemoryBaskets()
 {
    TBasket *basket = 0;
+   // The basket in memory holds the last entries, it is needed only if the
+   // copied range extends to the end of the input tree.
+   Bool_t toEnd = fLastEntry < 0 || fLastEntry >= fFromTree->GetEntries();
+   Long64_t offset = fToStartEntries - fFirstEntry;
    for(Int_t i=0; i<fToBranches.GetEntries(); ++i) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( i );
       TBranch *to   = (TBranch*)fToBranches.UncheckedAt( i );
 
-      basket = from->GetListOfBaskets()->GetEntries() ? from->GetBasket(from->GetWriteBasket()) : 0;
-      if (basket) {
-         basket = (TBasket*)basket->Clone();
-         basket->SetBranch(to);
-         to->AddBasket(*basket, kFALSE, fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()]);
+      Long64_t ncopied;
+      if (toEnd) {
+         basket = from->GetListOfBaskets()->GetEntries() ? from->GetBasket(from->GetWriteBasket()) : 0;
+         if (basket) {
+            basket = (TBasket*)basket->Clone();
+            basket->SetBranch(to);
+            to->AddBasket(*basket, kFALSE, offset+from->GetBasketEntry()[from->GetWriteBasket()]);
+         } else {
+            to->AddLastBasket( offset+from->GetBasketEntry()[from->GetWriteBasket()] );
+         }
+         ncopied = from->GetEntries() - fFirstEntry;
       } else {
-         to->AddLastBasket(  fToStartEntries+from->GetBasketEntry()[from->GetWriteBasket()] );
+         basket = 0;
+         to->AddLastBasket( offset+fLastEntry );
+         ncopied = fLastEntry - fFirstEntry;
       }
       // In older files, if the branch is a TBranchElement non-terminal 'object' branch, it's basket will contain 0
       // events, in newer file in the same case, the write basket will be missing.
       if (from->GetEntries()!=0 && from->GetWriteBasket()==0 && (basket==0 || basket->GetNevBuf()==0)) {
-         to->SetEntries(to->GetEntries()+from->GetEntries());
+         to->SetEntries(to->GetEntries()+ncopied);
       }
    }
 }
@@ -613,6 +640,9 @@ void TTreeCloner::CreateCache()
       // Remove the previous cache if any.
       if (prev) f->SetCacheRead(nullptr, fFromTree);
       // The constructor attach the new cache.
+      // When it enables the asynchronous prefetching (TFile.AsyncPrefetching,
+      // for remote files only), the next set of baskets is read while the
+      // current one is written (see WriteBaskets).
       fFileCache = new TFileCacheRead(f, fCacheSize, fFromTree);
    }
 }
@@ -629,18 +659,23 @@ void TTreeCloner::RestoreCache() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Set the entries and import the cluster range of the
+/// Set the entries and import the cluster range of the copied entries of the
+/// input tree.
 
 void TTreeCloner::ImportClusterRanges()
 {
+   TTree *fromtree = fFromTree->GetTree();
+   Long64_t last = fLastEntry < 0 ? fromtree->GetEntries() : TMath::Min(fLastEntry, fromtree->GetEntries());
+   Long64_t ncopied = last - fFirstEntry;
+
    // First undo, the external call to SetEntries
    // We could improve the interface to optional tell the TTreeCloner that the
    // SetEntries was not done.
-   fToTree->SetEntries(fToTree->GetEntries() - fFromTree->GetTree()->GetEntries());
+   fToTree->SetEntries(fToTree->GetEntries() - ncopied);
 
-   fToTree->ImportClusterRanges( fFromTree->GetTree() );
+   fToTree->ImportClusterRanges( fromtree, fFirstEntry, last );
 
-   fToTree->SetEntries(fToTree->GetEntries() + fFromTree->GetTree()->GetEntries());
+   fToTree->SetEntries(fToTree->GetEntries() + ncopied);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -664,6 +699,97 @@ void TTreeCloner::SetCacheSize(Int_t size)
    // beginning of Exec.
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Restrict the copy to the entries [first, last) of the input tree.
+///
+/// Both ends must be basket boundaries common to all the copied branches
+/// (see FindBasketBoundary), which is usually the case for the cluster
+/// boundaries of a TTree written with AutoFlush. The copied entries are
+/// appended to the output tree; as for a complete copy, the caller is
+/// expected to increase its number of entries by last-first.
+/// \param first first entry to be copied
+/// \param last one past the last entry to be copied, -1 for all the entries
+/// \return false (and leave the range unchanged) if the range is not aligned.
+
+Bool_t TTreeCloner::SetEntryRange(Long64_t first, Long64_t last)
+{
+   if (!IsValid()) return kFALSE;
+   Long64_t nentries = fFromTree->GetEntries();
+   if (last < 0 || last > nentries) last = nentries;
+   if (first < 0) first = 0;
+   if (first > last || FindBasketBoundary(first) != first || FindBasketBoundary(last) != last) {
+      fWarningMsg.Form("The entry range [%lld, %lld) of %s is not aligned on the basket boundaries.",
+                       first, last, fFromTree->GetName());
+      if (!(fOptions & kNoWarnings)) {
+         Warning("TTreeCloner::SetEntryRange", "%s", fWarningMsg.Data());
+      }
+      return kFALSE;
+   }
+   fFirstEntry = first;
+   fLastEntry = last;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the closest entry number to 'entry' which starts a basket (or ends
+/// the data) in all the branches to be copied.
+///
+/// \param entry entry number to start the search from
+/// \param upward if true look for the boundary at or after 'entry', otherwise
+///               at or before it
+/// Branches without any data do not constrain the result.
+
+Long64_t TTreeCloner::FindBasketBoundary(Long64_t entry, Bool_t upward)
+{
+   if (!fFromTree) return 0;
+   Long64_t nentries = fFromTree->GetEntries();
+   if (entry <= 0) return 0;
+   if (entry >= nentries) return nentries;
+
+   Long64_t boundary = entry;
+   Bool_t changed = kTRUE;
+   while (changed) {
+      changed = kFALSE;
+      for (Int_t i = 0; i < fFromBranches.GetEntries(); ++i) {
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt(i);
+         Int_t nbaskets = from->GetWriteBasket();
+         if (nbaskets == 0) {
+            TBasket *basket = from->GetListOfBaskets()->GetEntries() ? from->GetBasket(0) : 0;
+            if (!basket || basket->GetNevBuf() == 0) continue;
+         }
+         // The baskets start at fBasketEntry[0..nbaskets] (the last one
+         // being the basket in memory) and the data ends at GetEntries().
+         Long64_t *basketEntry = from->GetBasketEntry();
+         Long64_t end = from->GetEntries();
+         if (boundary >= end) {
+            if (boundary > end && !upward) {
+               boundary = end;
+               changed = kTRUE;
+            }
+            continue;
+         }
+         Long64_t loc = TMath::BinarySearch((Long64_t)nbaskets+1, basketEntry, boundary);
+         if (loc >= 0 && basketEntry[loc] == boundary) continue;
+         if (upward) {
+            while (loc+1 <= nbaskets && basketEntry[loc+1] <= boundary) ++loc;
+            boundary = (loc+1 <= nbaskets) ? basketEntry[loc+1] : end;
+         } else {
+            boundary = loc >= 0 ? basketEntry[loc] : 0;
+         }
+         changed = kTRUE;
+      }
+   }
+   return boundary;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if only a part of the input tree is copied.
+
+Bool_t TTreeCloner::IsPartialCopy() const
+{
+   return fFirstEntry > 0 || (fLastEntry >= 0 && fLastEntry < fFromTree->GetEntries());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sort the basket according to the user request.
 
@@ -694,12 +820,14 @@ void TTreeCloner::SortBaskets()
 /// Fill the file cache with the next set of basket.
 ///
 /// \param from index of the first lement of fFromBranches to start caching
+/// \param secondBlock if true, fill the second block of a prefetching cache
 /// \return The index of first element of fFromBranches that is not in the cache
-UInt_t TTreeCloner::FillCache(UInt_t from)
+UInt_t TTreeCloner::FillCache(UInt_t from, Bool_t secondBlock)
 {
    if (!fFileCache) return 0;
    // Reset the cache
-   fFileCache->Prefetch(0, 0);
+   if (secondBlock) fFileCache->SecondPrefetch(0, 0);
+   else fFileCache->Prefetch(0, 0);
    Long64_t size = 0;
    for (UInt_t j = from; j < fMaxBaskets; ++j) {
       TBranch *frombr = (TBranch *) fFromBranches.UncheckedAt(fBasketBranchNum[fBasketIndex[j]]);
@@ -713,7 +841,8 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
          if (size > fFileCache->GetBufferSize()) {
             return j;
          }
-         fFileCache->Prefetch(pos,len);
+         if (secondBlock) fFileCache->SecondPrefetch(pos,len);
+         else fFileCache->Prefetch(pos,len);
       }
    }
    return fMaxBaskets;
@@ -725,6 +854,12 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
 void TTreeCloner::WriteBaskets()
 {
    TBasket *basket = new TBasket();
+   // When the cache prefetches asynchronously, its two blocks are used in
+   // turn: the baskets up to 'ahead' are read in the background while the
+   // ones up to 'notCached' are written.
+   Bool_t prefetching = fFileCache && fFileCache->IsEnablePrefetching();
+   Bool_t secondBlock = kFALSE;
+   UInt_t ahead = 0;
    for(UInt_t j = 0, notCached = 0; j<fMaxBaskets; ++j) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
       TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
@@ -737,7 +872,17 @@ void TTreeCloner::WriteBaskets()
       Long64_t pos = from->GetBasketSeek(index);
       if (pos!=0) {
          if (fFileCache && j >= notCached) {
-            notCached = FillCache(notCached);
+            if (!prefetching) {
+               notCached = FillCache(notCached);
+            } else {
+               if (j >= ahead) {
+                  notCached = FillCache(j, secondBlock);
+               } else {
+                  notCached = ahead;
+                  secondBlock = !secondBlock;
+               }
+               ahead = FillCache(notCached, !secondBlock);
+            }
          }
          if (from->GetBasketBytes()[index] == 0) {
             from->GetBasketBytes()[index] = basket->ReadBasketBytes(pos, fromfile);
@@ -747,13 +892,13 @@ void TTreeCloner::WriteBaskets()
          basket->LoadBasketBuffers(pos,len,fromfile,fFromTree);
          basket->IncrementPidOffset(fPidOffset);
          basket->CopyTo(tofile);
-         to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+         to->AddBasket(*basket,kTRUE,fToStartEntries - fFirstEntry + from->GetBasketEntry()[index]);
       } else {
          TBasket *frombasket = from->GetBasket( index );
          if (frombasket && frombasket->GetNevBuf()>0) {
             TBasket *tobasket = (TBasket*)frombasket->Clone();
             tobasket->SetBranch(to);
-            to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
+            to->AddBasket(*tobasket, kFALSE, fToStartEntries - fFirstEntry + from->GetBasketEntry()[index]);
             to->FlushOneBasket(to->GetWriteBasket());
          }
       }
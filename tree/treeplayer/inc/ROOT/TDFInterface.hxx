@@ -22,6 +22,7 @@
 #include "TInterpreter.h"
 #include "TProfile.h"   // For Histo actions
 #include "TProfile2D.h" // For Histo actions
+#include "TQuantileSketch.h" // For QuantileSketch action
 #include "TRegexp.h"
 #include "TROOT.h" // IsImplicitMTEnabled
 #include "TTreeReader.h"
@@ -1074,6 +1075,29 @@ public:
       return CreateAction<TDFInternal::ActionTypes::Mean, T>(userColumns, meanV);
    }
 
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief Return a TQuantileSketch filled with the processed column values (*lazy action*)
+   /// \tparam T The type of the branch/column.
+   /// \param[in] columnName The name of the branch/column to be treated.
+   /// \param[in] compression The compression parameter of the sketch, see TQuantileSketch.
+   ///
+   /// The sketch estimates the quantiles of the column values (e.g. median and tails) with a fixed amount of memory,
+   /// whatever the number of entries. In multi-thread event loops each slot fills its own sketch and the sketches are
+   /// merged at the end of the loop.
+   ///
+   /// If T is not specified, TDataFrame will infer it from the data and just-in-time compile the correct
+   /// template specialization of this method.
+   ///
+   /// This action is *lazy*: upon invocation of this method the calculation is
+   /// booked but not executed. See TResultProxy documentation.
+   template <typename T = TDFDetail::TInferType>
+   TResultProxy<::TQuantileSketch> QuantileSketch(std::string_view columnName = "", double compression = 100)
+   {
+      const auto userColumns = columnName.empty() ? ColumnNames_t() : ColumnNames_t({std::string(columnName)});
+      auto sketch = std::make_shared<::TQuantileSketch>("", "", compression);
+      return CreateAction<TDFInternal::ActionTypes::Fill, T>(userColumns, sketch);
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    /// \brief Print filtering statistics on screen
    ///
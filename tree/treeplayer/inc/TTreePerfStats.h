@@ -24,6 +24,10 @@
 #include "TVirtualPerfStats.h"
 #include "TString.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 
 class TBrowser;
 class TFile;
@@ -35,6 +39,25 @@ class TGaxis;
 class TText;
 class TTreePerfStats : public TVirtualPerfStats {
 
+public:
+   /// I/O statistics of one branch.
+   struct BranchInfo {
+      TString  fName;                  ///< Name of the branch
+      Int_t    fBasketsRead = 0;       ///< Number of baskets read
+      Int_t    fCacheHits = 0;         ///< Number of baskets found in the TTreeCache
+      Int_t    fCacheMisses = 0;       ///< Number of baskets read directly from the file
+      Long64_t fBytesRead = 0;         ///< Number of zipped bytes of the baskets read
+      Long64_t fBytesCached = 0;       ///< Number of zipped bytes found in the TTreeCache
+      Long64_t fBytesPrefetched = 0;   ///< Number of zipped bytes loaded in the TTreeCache
+      Long64_t fBytesUnzipped = 0;     ///< Number of bytes after decompression
+      Double_t fReadTime = 0;          ///< Real time spent reading the baskets
+      Double_t fUnzipTime = 0;         ///< Real time spent decompressing the baskets
+      Double_t fUnstreamTime = 0;      ///< Real time spent unstreaming the entries
+
+      /// Number of bytes loaded in the TTreeCache but never used.
+      Long64_t GetBytesWasted() const { return fBytesPrefetched > fBytesCached ? fBytesPrefetched - fBytesCached : 0; }
+   };
+
 protected:
    Int_t         fTreeCacheSize; //TTreeCache buffer size
    Int_t         fNleaves;       //Number of leaves in the tree
@@ -58,6 +81,12 @@ protected:
    TStopwatch   *fWatch;         //TStopwatch pointer
    TGaxis       *fRealTimeAxis;  //pointer to TGaxis object showing real-time
    TText        *fHostInfoText;  //Graphics Text object with the fHostInfo data
+   std::vector<BranchInfo> fBranchInfo; //I/O statistics per branch
+   std::unordered_map<const TObject*, Int_t> fBranchIndex; //!index in fBranchInfo of the branches of fCurrentTree
+   TTree        *fCurrentTree;   //!tree the branches in fBranchIndex belong to
+   std::mutex    fBranchMutex;   //!protect the per-branch statistics against the concurrent reads of the branches
+
+   BranchInfo      *GetBranchInfo(TObject *branch);
 
 public:
    TTreePerfStats();
@@ -96,6 +125,14 @@ public:
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
+   virtual void     BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cached);
+   virtual void     BasketUnzipEvent(TObject *branch, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BasketUnstreamEvent(TObject *branch, Double_t start);
+   virtual void     BasketPrefetchEvent(TObject *branch, Int_t len);
+
+   const std::vector<BranchInfo> &GetBranchInfo() const { return fBranchInfo; }
+   virtual void     PrintBranchInfo(Option_t *option="") const;
+   virtual void     SaveBranchInfo(std::ostream &out, Option_t *option="") const;
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
    virtual void     SavePrimitive(std::ostream &out, Option_t *option = "");
@@ -117,7 +154,7 @@ public:
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,6)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,7)  // TTree I/O performance measurement
 };
 
 #endif
@@ -521,6 +521,7 @@ branch2, ...). |
 | Mean | Return the mean of processed branch values. |
 | Min | Return the minimum of processed branch values. |
 | Profile{1D,2D} | Fill a {one,two}-dimensional profile with the branch values that passed all filters. |
+| QuantileSketch | Fill a TQuantileSketch, which estimates the quantiles of the processed branch values in a fixed amount of memory. |
 | Reduce | Reduce (e.g. sum, merge) entries using the function (lambda, functor...) passed as argument. The function
 must have signature `T(T,T)` where `T` is the type of the branch. Return the final result of the reduction operation. An
 optional parameter allows initialization of the result object to non-default values. |
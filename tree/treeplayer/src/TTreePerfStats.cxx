@@ -77,6 +77,28 @@ ReadTotal +ReadTotal*Readextra/100. Same for ReadSize.
 A consequence of NOTE1, the Disk I/O speed corresponds to the effective
 number of bytes returned to the application per second.
 The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
+
+ ### Statistics per branch
+In addition, the time and bytes are accounted for each branch (see
+TTreePerfStats::BranchInfo):
+ -  Baskets   = Number of baskets read
+ -  Hits      = Number of baskets found in the TTreeCache
+ -  Misses    = Number of baskets read directly from the file
+ -  ReadBytes = Zipped bytes of the baskets read
+ -  Wasted    = Bytes loaded in the TTreeCache for this branch but never used
+ -  UnzBytes  = Bytes after decompression
+ -  ReadTime  = Real time spent getting the baskets (file or cache)
+ -  UnzipTime = Real time spent decompressing the baskets
+ -  StrmTime  = Real time spent unstreaming the entries
+This table is printed with `Print("branches")` and can be exported
+in a machine readable format with SaveBranchInfo() or by saving
+to a `.csv` or `.tsv` file:
+~~~{.cpp}
+   ps->SaveAs("cmsperf.csv");
+~~~
+The branches with a large UnzipTime compared to their ReadBytes are
+candidates for a faster compression algorithm, the ones with a large
+Wasted count are read by the cache but not used by the analysis.
 */
 
 #include "TTreePerfStats.h"
@@ -96,6 +118,8 @@ The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
 #include "TDatime.h"
 #include "TMath.h"
 
+#include <fstream>
+
 ClassImp(TTreePerfStats);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,6 +149,7 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fCompress      = 0;
    fRealTimeAxis  = 0;
    fHostInfoText  = 0;
+   fCurrentTree   = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +196,7 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    TDatime dt;
    fHostInfo += TString::Format(" %s",dt.AsString());
    fHostInfoText   = 0;
+   fCurrentTree    = 0;
 
    gPerfStats = this;
 }
@@ -182,6 +208,7 @@ TTreePerfStats::~TTreePerfStats()
 {
    fTree = 0;
    fFile = 0;
+   fCurrentTree = 0;
    delete fGraphIO;
    delete fGraphTime;
    delete fPave;
@@ -311,6 +338,91 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statistics of branch, creating them at the first call.
+/// The statistics of the branches with the same name in the different
+/// trees of a TChain are accumulated.
+
+TTreePerfStats::BranchInfo *TTreePerfStats::GetBranchInfo(TObject *branch)
+{
+   // The branches are identified by their address, which is only valid
+   // as long as the current tree of the chain does not change.
+   TTree *tree = fTree ? fTree->GetTree() : 0;
+   if (tree != fCurrentTree) {
+      fBranchIndex.clear();
+      fCurrentTree = tree;
+   }
+   auto it = fBranchIndex.find(branch);
+   if (it != fBranchIndex.end()) return &fBranchInfo[it->second];
+
+   const char *name = branch->GetName();
+   Int_t index = 0, n = fBranchInfo.size();
+   while (index < n && fBranchInfo[index].fName != name) ++index;
+   if (index == n) {
+      fBranchInfo.emplace_back();
+      fBranchInfo.back().fName = name;
+   }
+   fBranchIndex[branch] = index;
+   return &fBranchInfo[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the read of a basket of branch.
+/// -  len is the number of zipped bytes of the basket
+/// -  start is the TimeStamp before reading
+/// -  cached is true if the basket was found in the TTreeCache
+
+void TTreePerfStats::BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cached)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   BranchInfo *info = GetBranchInfo(branch);
+   info->fBasketsRead++;
+   info->fBytesRead += len;
+   if (cached) {
+      info->fCacheHits++;
+      info->fBytesCached += len;
+   } else {
+      info->fCacheMisses++;
+   }
+   info->fReadTime += tnow-start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the decompression of a basket of branch.
+/// -  start is the TimeStamp before unzip
+/// -  complen is the length of the compressed buffer
+/// -  objlen is the length of the de-compressed buffer
+
+void TTreePerfStats::BasketUnzipEvent(TObject *branch, Double_t start, Int_t /* complen */, Int_t objlen)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   BranchInfo *info = GetBranchInfo(branch);
+   info->fBytesUnzipped += objlen;
+   info->fUnzipTime += tnow-start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the unstreaming of an entry of branch.
+/// -  start is the TimeStamp before unstreaming
+
+void TTreePerfStats::BasketUnstreamEvent(TObject *branch, Double_t start)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   GetBranchInfo(branch)->fUnstreamTime += tnow-start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the request by the TTreeCache of len bytes of a basket of branch.
+
+void TTreePerfStats::BasketPrefetchEvent(TObject *branch, Int_t len)
+{
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   GetBranchInfo(branch)->fBytesPrefetched += len;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
@@ -457,15 +569,69 @@ void TTreePerfStats::Print(Option_t * option) const
       printf("ReadStrCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/(fCpuTime-fUnzipTime));
       printf("ReadZipCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fUnzipTime);
    }
+   if (opts.Contains("branch")) {
+      printf("\n");
+      PrintBranchInfo(option);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Save this object to filename
+/// Print the I/O statistics of each branch, see the class description.
+
+void TTreePerfStats::PrintBranchInfo(Option_t * /*option*/) const
+{
+   Int_t width = 6;
+   for (const auto &info : fBranchInfo) {
+      if (info.fName.Length() > width) width = info.fName.Length();
+   }
+   printf("%-*s %8s %8s %8s %12s %12s %12s %9s %9s %9s\n",width,"Branch","Baskets","Hits","Misses",
+          "ReadBytes","Wasted","UnzBytes","ReadTime","UnzipTime","StrmTime");
+   for (const auto &info : fBranchInfo) {
+      printf("%-*s %8d %8d %8d %12lld %12lld %12lld %9.3f %9.3f %9.3f\n",width,info.fName.Data(),
+             info.fBasketsRead,info.fCacheHits,info.fCacheMisses,info.fBytesRead,info.GetBytesWasted(),
+             info.fBytesUnzipped,info.fReadTime,info.fUnzipTime,info.fUnstreamTime);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the I/O statistics of each branch as a table to out, one line per
+/// branch preceded by a header line. The columns are separated by commas,
+/// or by tabulations if option contains "tsv". Times are in seconds.
+
+void TTreePerfStats::SaveBranchInfo(std::ostream &out, Option_t *option) const
+{
+   TString opt = option;
+   opt.ToLower();
+   const char sep = opt.Contains("tsv") ? '\t' : ',';
+   out<<"branch"<<sep<<"baskets"<<sep<<"cache_hits"<<sep<<"cache_misses"<<sep
+      <<"bytes_read"<<sep<<"bytes_cached"<<sep<<"bytes_prefetched"<<sep<<"bytes_wasted"<<sep
+      <<"bytes_unzipped"<<sep<<"read_time"<<sep<<"unzip_time"<<sep<<"unstream_time"<<std::endl;
+   for (const auto &info : fBranchInfo) {
+      out<<info.fName<<sep<<info.fBasketsRead<<sep<<info.fCacheHits<<sep<<info.fCacheMisses<<sep
+         <<info.fBytesRead<<sep<<info.fBytesCached<<sep<<info.fBytesPrefetched<<sep<<info.GetBytesWasted()<<sep
+         <<info.fBytesUnzipped<<sep<<info.fReadTime<<sep<<info.fUnzipTime<<sep<<info.fUnstreamTime<<std::endl;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save this object to filename.
+/// If filename ends with ".csv" or ".tsv", the statistics per branch are
+/// written as a table instead, see SaveBranchInfo().
 
 void TTreePerfStats::SaveAs(const char *filename, Option_t * /*option*/) const
 {
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
+   TString fname = filename;
+   if (fname.EndsWith(".csv") || fname.EndsWith(".tsv")) {
+      std::ofstream out(fname.Data());
+      if (!out.good()) {
+         Error("SaveAs", "cannot open file %s", fname.Data());
+         return;
+      }
+      SaveBranchInfo(out, fname.EndsWith(".tsv") ? "tsv" : "csv");
+      return;
+   }
    ps->TObject::SaveAs(filename);
 }
 
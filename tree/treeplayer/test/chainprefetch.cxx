@@ -0,0 +1,196 @@
+#include "TChain.h"
+#include "TChainElement.h"
+#include "TError.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+static const Int_t kPrefetchNFiles = 4;
+
+static std::string PrefetchFileName(Int_t i)
+{
+   return "chainprefetch_" + std::to_string(i) + ".root";
+}
+
+// Write kPrefetchNFiles files with a tree T of 100*(i+1) entries, x = 10000*i + entry
+static void WritePrefetchFiles()
+{
+   for (Int_t i = 0; i < kPrefetchNFiles; ++i) {
+      TFile f(PrefetchFileName(i).c_str(), "RECREATE");
+      TTree t("T", "chain prefetch test tree");
+      Int_t x = 0;
+      t.Branch("x", &x, "x/I");
+      for (Int_t j = 0; j < 100 * (i + 1); ++j) {
+         x = 10000 * i + j;
+         t.Fill();
+      }
+      t.Write();
+   }
+}
+
+static void RemovePrefetchFiles()
+{
+   for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+      gSystem->Unlink(PrefetchFileName(i).c_str());
+}
+
+// Read all the entries of the chain, in order
+static std::vector<Int_t> ReadChain(TChain &chain)
+{
+   std::vector<Int_t> values;
+   Int_t x = -1;
+   chain.SetBranchAddress("x", &x);
+   const Long64_t n = chain.GetEntries();
+   for (Long64_t i = 0; i < n; ++i) {
+      if (chain.GetEntry(i) <= 0)
+         break;
+      values.push_back(x);
+   }
+   chain.ResetBranchAddresses();
+   return values;
+}
+
+static std::vector<Int_t> ExpectedValues(const std::vector<Int_t> &files)
+{
+   std::vector<Int_t> values;
+   for (Int_t i : files)
+      for (Int_t j = 0; j < 100 * (i + 1); ++j)
+         values.push_back(10000 * i + j);
+   return values;
+}
+
+static void CheckReadAll()
+{
+   const std::vector<Int_t> expected = ExpectedValues({0, 1, 2, 3});
+   for (Int_t nprefetch : {0, 1, 2, 10}) {
+      SCOPED_TRACE("prefetched files: " + std::to_string(nprefetch));
+      const Int_t nopen = gROOT->GetListOfFiles()->GetSize();
+      {
+         TChain chain("T");
+         for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+            chain.Add(PrefetchFileName(i).c_str());
+         chain.SetPrefetchFiles(nprefetch);
+         EXPECT_EQ(nprefetch, chain.GetPrefetchFiles());
+         EXPECT_EQ((Long64_t)expected.size(), chain.GetEntries());
+         EXPECT_EQ(expected, ReadChain(chain));
+         EXPECT_EQ(kPrefetchNFiles - 1, chain.GetTreeNumber());
+      }
+      // the files opened ahead are closed with the chain
+      EXPECT_EQ(nopen, gROOT->GetListOfFiles()->GetSize());
+   }
+}
+
+// A file of the chain is missing: the chain must skip it as without prefetching
+static void CheckMissingFile()
+{
+   const std::vector<Int_t> expected = ExpectedValues({0, 1, 3});
+   const Int_t nopen = gROOT->GetListOfFiles()->GetSize();
+   const Int_t level = gErrorIgnoreLevel;
+   gErrorIgnoreLevel = kFatal;
+   for (Int_t nprefetch : {0, 2}) {
+      SCOPED_TRACE("prefetched files: " + std::to_string(nprefetch));
+      TChain chain("T");
+      chain.Add(PrefetchFileName(0).c_str());
+      chain.Add(PrefetchFileName(1).c_str());
+      chain.Add("chainprefetch_missing.root");
+      chain.Add(PrefetchFileName(3).c_str());
+      chain.SetPrefetchFiles(nprefetch);
+      EXPECT_EQ((Long64_t)expected.size(), chain.GetEntries());
+      EXPECT_EQ(expected, ReadChain(chain));
+      auto missing = (TChainElement *)chain.GetListOfFiles()->At(2);
+      EXPECT_EQ(-3, missing->GetLoadResult());
+      EXPECT_EQ(0, missing->GetEntries());
+   }
+   gErrorIgnoreLevel = level;
+   EXPECT_EQ(nopen, gROOT->GetListOfFiles()->GetSize());
+}
+
+// Only the first file is read: the files opened ahead are never used and must be closed
+// when the chain is reset or deleted
+static void CheckNextFileNotNeeded()
+{
+   const Int_t nopen = gROOT->GetListOfFiles()->GetSize();
+   {
+      TChain chain("T");
+      for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+         chain.Add(PrefetchFileName(i).c_str());
+      chain.SetPrefetchFiles(2);
+      Int_t x = -1;
+      chain.SetBranchAddress("x", &x);
+      for (Long64_t i = 0; i < 10; ++i) {
+         ASSERT_GT(chain.GetEntry(i), 0);
+         EXPECT_EQ(i, x);
+      }
+      EXPECT_EQ(0, chain.GetTreeNumber());
+      chain.ResetBranchAddresses();
+   }
+   EXPECT_EQ(nopen, gROOT->GetListOfFiles()->GetSize());
+
+   TChain chain("T");
+   for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+      chain.Add(PrefetchFileName(i).c_str());
+   chain.SetPrefetchFiles(2);
+   chain.LoadTree(0);
+   chain.Reset();
+   EXPECT_EQ(nopen, gROOT->GetListOfFiles()->GetSize());
+
+   // switching the mode off closes the pending files too
+   TChain chain2("T");
+   for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+      chain2.Add(PrefetchFileName(i).c_str());
+   chain2.SetPrefetchFiles(2);
+   chain2.LoadTree(0);
+   chain2.SetPrefetchFiles(0);
+   EXPECT_EQ(0, chain2.GetPrefetchFiles());
+   EXPECT_EQ(nopen + 1, gROOT->GetListOfFiles()->GetSize());
+}
+
+TEST(TChain, PrefetchFiles)
+{
+   WritePrefetchFiles();
+   CheckReadAll();
+   CheckMissingFile();
+   CheckNextFileNotNeeded();
+   RemovePrefetchFiles();
+}
+
+#ifdef R__USE_IMT
+// GetEntries() opens all the files to count their entries with the implicit multi-threading:
+// the files of the next trees to be loaded are kept open for LoadTree, the others are closed
+static void CheckGetEntriesKeepsFiles()
+{
+   const Int_t nopen = gROOT->GetListOfFiles()->GetSize();
+   {
+      TChain chain("T");
+      for (Int_t i = 0; i < kPrefetchNFiles; ++i)
+         chain.Add(PrefetchFileName(i).c_str());
+      chain.SetPrefetchFiles(1);
+      EXPECT_EQ((Long64_t)ExpectedValues({0, 1, 2, 3}).size(), chain.GetEntries());
+      EXPECT_EQ(nopen + 2, gROOT->GetListOfFiles()->GetSize());
+      // the first file is not opened again, the second one stays open for the next tree
+      EXPECT_EQ(0, chain.LoadTree(0));
+      EXPECT_EQ(nopen + 2, gROOT->GetListOfFiles()->GetSize());
+   }
+   EXPECT_EQ(nopen, gROOT->GetListOfFiles()->GetSize());
+}
+
+// With the implicit multi-threading the files are opened in the thread pool and
+// GetEntries() counts the entries of the files concurrently
+TEST(TChain, PrefetchFilesIMT)
+{
+   WritePrefetchFiles();
+   ROOT::EnableImplicitMT(4);
+   CheckReadAll();
+   CheckMissingFile();
+   CheckNextFileNotNeeded();
+   CheckGetEntriesKeepsFiles();
+   ROOT::DisableImplicitMT();
+   RemovePrefetchFiles();
+}
+#endif
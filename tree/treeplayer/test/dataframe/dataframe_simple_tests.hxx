@@ -300,6 +300,25 @@ TEST(TEST_CATEGORY, Snapshot_action_with_options)
    }
 }
 
+TEST(TEST_CATEGORY, QuantileSketch)
+{
+   auto filename = "dataframe_simple_3.root";
+   auto treename = "t";
+#ifndef testTDF_simple_3_CREATED
+#define testTDF_simple_3_CREATED
+   TEST_CATEGORY::FillTree(filename, treename, 1001);
+#endif
+   TDataFrame tdf(treename, filename);
+   auto s = tdf.QuantileSketch<double>("b1");
+   auto sj = tdf.QuantileSketch("b1", 200);
+   EXPECT_EQ(1001, s->GetEntries());
+   EXPECT_EQ(0., s->GetMin());
+   EXPECT_EQ(1000., s->GetMax());
+   EXPECT_NEAR(500., s->GetQuantile(0.5), 5.);
+   EXPECT_NEAR(10., s->GetQuantile(0.01), 1.);
+   EXPECT_NEAR(990., sj->GetQuantile(0.99), 1.);
+}
+
 // This tests the interface but we need to run it both w/ and w/o implicit mt
 #ifdef R__USE_IMT
 TEST(TEST_CATEGORY, GetNSlots)
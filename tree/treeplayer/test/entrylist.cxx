@@ -0,0 +1,200 @@
+#include "TEntryList.h"
+#include "TEntryListBlock.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+// A block holds kBlockSize*16 entries. It is stored either as bits (type 0) or as a
+// list (type 1) of the passing entries, or of the non passing entries when almost all pass.
+static const Int_t kBlockEntries = TEntryListBlock::kBlockSize * 16;
+
+enum class EBlockRepr { kBits, kPassingList, kFailingList };
+
+static const char *ReprName(EBlockRepr repr)
+{
+   switch (repr) {
+   case EBlockRepr::kBits: return "bits";
+   case EBlockRepr::kPassingList: return "passing list";
+   case EBlockRepr::kFailingList: return "failing list";
+   }
+   return "";
+}
+
+// Entries of the block in the given representation: every step-th entry starting from offset,
+// with a step giving the density that OptimizeStorage() maps to each representation.
+static std::set<Int_t> MakeEntries(EBlockRepr repr, Int_t offset)
+{
+   std::set<Int_t> entries;
+   if (repr == EBlockRepr::kFailingList) {
+      // more than 15/16 of the entries pass
+      for (Int_t i = 0; i < kBlockEntries; ++i)
+         if ((i + offset) % 37 != 0)
+            entries.insert(i);
+   } else {
+      // less than 1/16 of the entries for the list, about 1/3 for the bits
+      const Int_t step = repr == EBlockRepr::kPassingList ? 23 : 3;
+      for (Int_t i = offset % step; i < kBlockEntries; i += step)
+         entries.insert(i);
+   }
+   return entries;
+}
+
+static void FillBlock(TEntryListBlock &block, EBlockRepr repr, const std::set<Int_t> &entries)
+{
+   for (Int_t e : entries)
+      block.Enter(e);
+   block.OptimizeStorage();
+   ASSERT_EQ(repr == EBlockRepr::kBits ? 0 : 1, block.GetType()) << ReprName(repr);
+}
+
+// Compare the content of the block with the expected entries, through Contains(),
+// GetNPassed(), Next() and GetEntry()
+static void CheckBlock(TEntryListBlock &block, const std::set<Int_t> &expected, const char *what)
+{
+   SCOPED_TRACE(what);
+   ASSERT_EQ((Int_t)expected.size(), block.GetNPassed());
+   for (Int_t i = 0; i < kBlockEntries; ++i)
+      ASSERT_EQ(expected.count(i) != 0, block.Contains(i) != 0) << "entry " << i;
+
+   block.ResetIndices();
+   for (Int_t e : expected)
+      ASSERT_EQ(e, block.Next());
+   EXPECT_EQ(-1, block.Next());
+
+   // random access, out of order
+   std::vector<Int_t> sorted(expected.begin(), expected.end());
+   for (Int_t n = (Int_t)sorted.size() - 1; n >= 0; n -= 97)
+      ASSERT_EQ(sorted[n], block.GetEntry(n)) << "GetEntry(" << n << ")";
+   block.ResetIndices();
+}
+
+static const EBlockRepr kAllRepr[] = {EBlockRepr::kBits, EBlockRepr::kPassingList, EBlockRepr::kFailingList};
+
+TEST(TEntryListBlock, ContainsRemove)
+{
+   for (EBlockRepr repr : kAllRepr) {
+      SCOPED_TRACE(ReprName(repr));
+      std::set<Int_t> expected = MakeEntries(repr, 1);
+      TEntryListBlock block;
+      FillBlock(block, repr, expected);
+      CheckBlock(block, expected, "filled");
+
+      // removing an entry that is not there changes nothing
+      Int_t absent = 0;
+      while (expected.count(absent))
+         ++absent;
+      EXPECT_FALSE(block.Remove(absent));
+
+      Int_t removed = 0;
+      for (auto it = expected.begin(); it != expected.end(); ++removed) {
+         EXPECT_TRUE(block.Remove(*it));
+         it = expected.erase(it);
+         // skip a few entries
+         for (int k = 0; k < 5 && it != expected.end(); ++k)
+            ++it;
+      }
+      ASSERT_GT(removed, 0);
+      CheckBlock(block, expected, "after Remove");
+   }
+}
+
+TEST(TEntryListBlock, SetOperations)
+{
+   for (EBlockRepr reprA : kAllRepr) {
+      for (EBlockRepr reprB : kAllRepr) {
+         SCOPED_TRACE(std::string(ReprName(reprA)) + " with " + ReprName(reprB));
+         const std::set<Int_t> a = MakeEntries(reprA, 0);
+         const std::set<Int_t> b = MakeEntries(reprB, 5);
+
+         std::set<Int_t> expected;
+         TEntryListBlock blockB;
+         FillBlock(blockB, reprB, b);
+
+         TEntryListBlock merged;
+         FillBlock(merged, reprA, a);
+         std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+         EXPECT_EQ((Int_t)expected.size(), merged.Merge(&blockB));
+         CheckBlock(merged, expected, "Merge");
+
+         TEntryListBlock subtracted;
+         FillBlock(subtracted, reprA, a);
+         expected.clear();
+         std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+         EXPECT_EQ((Int_t)expected.size(), subtracted.Subtract(&blockB));
+         CheckBlock(subtracted, expected, "Subtract");
+
+         TEntryListBlock intersected;
+         FillBlock(intersected, reprA, a);
+         expected.clear();
+         std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+         EXPECT_EQ((Int_t)expected.size(), intersected.Intersect(&blockB));
+         CheckBlock(intersected, expected, "Intersect");
+
+         // the other block is left untouched
+         CheckBlock(blockB, b, "other block");
+      }
+   }
+}
+
+TEST(TEntryListBlock, EmptyBlocks)
+{
+   for (EBlockRepr repr : kAllRepr) {
+      SCOPED_TRACE(ReprName(repr));
+      const std::set<Int_t> entries = MakeEntries(repr, 2);
+      TEntryListBlock empty;
+
+      TEntryListBlock block;
+      FillBlock(block, repr, entries);
+      EXPECT_EQ((Int_t)entries.size(), block.Merge(&empty));
+      EXPECT_EQ((Int_t)entries.size(), block.Subtract(&empty));
+      CheckBlock(block, entries, "with empty");
+
+      TEntryListBlock merged;
+      EXPECT_EQ((Int_t)entries.size(), merged.Merge(&block));
+      CheckBlock(merged, entries, "empty merged");
+
+      EXPECT_EQ(0, block.Intersect(&empty));
+      CheckBlock(block, std::set<Int_t>(), "intersected with empty");
+   }
+}
+
+TEST(TEntryList, SubtractIntersect)
+{
+   // a list spanning several blocks, with blocks of each representation
+   const Long64_t n = 5 * kBlockEntries;
+   TEntryList a, b;
+   std::set<Long64_t> sa, sb;
+   for (Long64_t i = 0; i < n; ++i) {
+      const Int_t block = i / kBlockEntries;
+      if (block % 3 == 0 ? i % 3 == 0 : (block % 3 == 1 ? i % 29 == 0 : i % 41 != 0)) {
+         a.Enter(i);
+         sa.insert(i);
+      }
+      if (i % 7 == 0) {
+         b.Enter(i);
+         sb.insert(i);
+      }
+   }
+   a.OptimizeStorage();
+   b.OptimizeStorage();
+
+   TEntryList diff(a);
+   diff.Subtract(&b);
+   std::vector<Long64_t> expected;
+   std::set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+   ASSERT_EQ((Long64_t)expected.size(), diff.GetN());
+   for (Long64_t i = 0; i < (Long64_t)expected.size(); ++i)
+      ASSERT_EQ(expected[i], diff.GetEntry(i));
+
+   TEntryList inter(a);
+   inter.Intersect(&b);
+   expected.clear();
+   std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(expected));
+   ASSERT_EQ((Long64_t)expected.size(), inter.GetN());
+   for (Long64_t i = 0; i < (Long64_t)expected.size(); ++i)
+      ASSERT_EQ(expected[i], inter.GetEntry(i));
+}
@@ -0,0 +1,265 @@
+#include "TChain.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TFileCacheRead.h"
+#include "TMemFile.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCloner.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+static const Int_t kFastCloneEntries = 10000;
+static const Int_t kFastCloneCluster = 1000;
+
+struct FastCloneEntry {
+   Int_t fI;
+   Double_t fX;
+   Int_t fN;
+   Float_t fV[5];
+};
+
+static void SetFastCloneAddresses(TTree *tree, FastCloneEntry &e)
+{
+   tree->SetBranchAddress("i", &e.fI);
+   tree->SetBranchAddress("x", &e.fX);
+   tree->SetBranchAddress("n", &e.fN);
+   tree->SetBranchAddress("v", e.fV);
+}
+
+// Write a tree with a cluster (and so a basket per branch) every kFastCloneCluster entries,
+// and every kFastCloneCluster/2 entries from the entry clusterChange if it is given
+static void WriteFastCloneFile(const char *name, Int_t offset, Int_t clusterChange = -1)
+{
+   TFile f(name, "RECREATE");
+   TTree t("T", "fast clone test tree");
+   FastCloneEntry e;
+   t.Branch("i", &e.fI, "i/I");
+   t.Branch("x", &e.fX, "x/D");
+   t.Branch("n", &e.fN, "n/I");
+   t.Branch("v", e.fV, "v[n]/F");
+   t.SetAutoFlush(kFastCloneCluster);
+   for (Int_t entry = 0; entry < kFastCloneEntries; ++entry) {
+      if (entry == clusterChange) t.SetAutoFlush(kFastCloneCluster / 2);
+      e.fI = entry + offset;
+      e.fX = 0.5 * e.fI + 1.;
+      e.fN = entry % 5;
+      for (Int_t k = 0; k < e.fN; ++k) e.fV[k] = 0.25f * e.fI + k;
+      t.Fill();
+   }
+   t.Write();
+}
+
+// Compare the nentries entries of the tree T in the file name with the entries
+// of from starting at first
+static void ExpectSameEntries(TTree *from, Long64_t first, const char *name, Long64_t nentries)
+{
+   std::unique_ptr<TFile> f(TFile::Open(name));
+   ASSERT_TRUE(f && !f->IsZombie());
+   TTree *to = nullptr;
+   f->GetObject("T", to);
+   ASSERT_NE(nullptr, to);
+   ASSERT_EQ(nentries, to->GetEntries());
+
+   FastCloneEntry e1, e2;
+   SetFastCloneAddresses(from, e1);
+   SetFastCloneAddresses(to, e2);
+   Int_t ndiff = 0;
+   for (Long64_t entry = 0; entry < nentries; ++entry) {
+      ASSERT_GT(from->GetEntry(first + entry), 0);
+      ASSERT_GT(to->GetEntry(entry), 0);
+      Bool_t same = e1.fI == e2.fI && e1.fX == e2.fX && e1.fN == e2.fN;
+      for (Int_t k = 0; same && k < e1.fN; ++k) same = e1.fV[k] == e2.fV[k];
+      if (!same) ++ndiff;
+   }
+   EXPECT_EQ(0, ndiff);
+   from->ResetBranchAddresses();
+}
+
+// Copy the beginning of a tree: the baskets up to the last cluster boundary are
+// copied, the remaining entries are filled one by one
+TEST(TTreeCloner, CopyEntriesFast)
+{
+   WriteFastCloneFile("fastclone_in1.root", 0);
+   {
+      std::unique_ptr<TFile> in(TFile::Open("fastclone_in1.root"));
+      TTree *tree = nullptr;
+      in->GetObject("T", tree);
+      ASSERT_NE(nullptr, tree);
+      {
+         TFile out("fastclone_out.root", "RECREATE");
+         TTree *clone = tree->CloneTree(0);
+         EXPECT_GT(clone->CopyEntries(tree, 4500, "fast"), 0);
+         EXPECT_EQ(4500, clone->GetEntries());
+         clone->Write();
+      }
+      ExpectSameEntries(tree, 0, "fastclone_out.root", 4500);
+   }
+   gSystem->Unlink("fastclone_out.root");
+   gSystem->Unlink("fastclone_in1.root");
+}
+
+// Copy a range of clusters with TTreeCloner
+TEST(TTreeCloner, EntryRange)
+{
+   WriteFastCloneFile("fastclone_in1.root", 0);
+   {
+      std::unique_ptr<TFile> in(TFile::Open("fastclone_in1.root"));
+      TTree *tree = nullptr;
+      in->GetObject("T", tree);
+      ASSERT_NE(nullptr, tree);
+      Long64_t first = 0, last = 0;
+      {
+         TFile out("fastclone_out.root", "RECREATE");
+         TTree *clone = tree->CloneTree(0);
+         TTreeCloner cloner(tree, clone, "", TTreeCloner::kNoWarnings);
+         ASSERT_TRUE(cloner.IsValid());
+         EXPECT_EQ(2000, cloner.FindBasketBoundary(2500));
+         EXPECT_EQ(3000, cloner.FindBasketBoundary(2500, kTRUE));
+         EXPECT_EQ(kFastCloneEntries, cloner.FindBasketBoundary(kFastCloneEntries + 10, kTRUE));
+         // a range which is not aligned on the basket boundaries is refused
+         EXPECT_FALSE(cloner.SetEntryRange(2500, 7000));
+         first = cloner.FindBasketBoundary(2500, kTRUE);
+         last = cloner.FindBasketBoundary(7500);
+         ASSERT_TRUE(cloner.SetEntryRange(first, last));
+         clone->SetEntries(clone->GetEntries() + last - first);
+         ASSERT_TRUE(cloner.Exec());
+         clone->Write();
+      }
+      ExpectSameEntries(tree, first, "fastclone_out.root", last - first);
+   }
+   gSystem->Unlink("fastclone_out.root");
+   gSystem->Unlink("fastclone_in1.root");
+}
+
+// Copy a range of clusters of a tree whose cluster size changes: the cluster ranges
+// of the copied entries are imported in the output tree
+TEST(TTreeCloner, EntryRangeClusters)
+{
+   WriteFastCloneFile("fastclone_in1.root", 0, 4000);
+   {
+      std::unique_ptr<TFile> in(TFile::Open("fastclone_in1.root"));
+      TTree *tree = nullptr;
+      in->GetObject("T", tree);
+      ASSERT_NE(nullptr, tree);
+      {
+         TFile out("fastclone_out.root", "RECREATE");
+         TTree *clone = tree->CloneTree(0);
+         TTreeCloner cloner(tree, clone, "", TTreeCloner::kNoWarnings);
+         ASSERT_TRUE(cloner.IsValid());
+         ASSERT_TRUE(cloner.SetEntryRange(2000, 6000));
+         clone->SetEntries(clone->GetEntries() + 4000);
+         ASSERT_TRUE(cloner.Exec());
+         ASSERT_EQ(4000, clone->GetEntries());
+
+         std::vector<Long64_t> starts;
+         TTree::TClusterIterator clusters = clone->GetClusterIterator(0);
+         for (Long64_t start = clusters(); start < clone->GetEntries(); start = clusters()) {
+            starts.push_back(start);
+         }
+         std::vector<Long64_t> expected = {0, 1000, 2000, 2500, 3000, 3500};
+         EXPECT_EQ(expected, starts);
+         clone->Write();
+      }
+      ExpectSameEntries(tree, 2000, "fastclone_out.root", 4000);
+   }
+   gSystem->Unlink("fastclone_out.root");
+   gSystem->Unlink("fastclone_in1.root");
+}
+
+// TFileCacheRead prefetches asynchronously only the remote files: serve the content of
+// a local file from memory under a http url. The prefetching thread reads the baskets
+// from a copy of the content which is never modified.
+class TRemoteLikeFile : public TMemFile {
+   std::vector<char> fContent;
+
+public:
+   TRemoteLikeFile(const char *url, std::vector<char> content)
+      : TMemFile(url, content.data(), content.size(), "READ"), fContent(std::move(content))
+   {
+   }
+
+   Bool_t ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf) override
+   {
+      if (!buf) return TMemFile::ReadBuffers(buf, pos, len, nbuf);
+      for (Int_t i = 0; i < nbuf; buf += len[i++]) {
+         if (pos[i] < 0 || pos[i] + len[i] > (Long64_t)fContent.size()) return kTRUE;
+         memcpy(buf, fContent.data() + pos[i], len[i]);
+      }
+      return kFALSE;
+   }
+};
+
+// Copy a range of clusters while the next baskets are prefetched: the reading of the
+// baskets overlaps with their writing in TTreeCloner::WriteBaskets
+TEST(TTreeCloner, EntryRangePrefetching)
+{
+   WriteFastCloneFile("fastclone_in1.root", 0);
+   std::ifstream input("fastclone_in1.root", std::ios::binary);
+   std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+   input.close();
+   gSystem->Unlink("fastclone_in1.root");
+   ASSERT_FALSE(content.empty());
+
+   gEnv->SetValue("TFile.AsyncPrefetching", 1);
+   {
+      TRemoteLikeFile in("http://localhost/fastclone_in1.root", std::move(content));
+      ASSERT_FALSE(in.IsZombie());
+      TTree *tree = nullptr;
+      in.GetObject("T", tree);
+      ASSERT_NE(nullptr, tree);
+      {
+         // the cache created by the cloner has the same settings
+         TFileCacheRead cache(&in, 10000, tree);
+         EXPECT_TRUE(cache.IsEnablePrefetching());
+         in.SetCacheRead(nullptr, tree);
+      }
+      {
+         TFile out("fastclone_out.root", "RECREATE");
+         TTree *clone = tree->CloneTree(0);
+         TTreeCloner cloner(tree, clone, "", TTreeCloner::kNoWarnings);
+         ASSERT_TRUE(cloner.IsValid());
+         // a small cache, so that the baskets are read in many blocks
+         cloner.SetCacheSize(20000);
+         ASSERT_TRUE(cloner.SetEntryRange(1000, 9000));
+         clone->SetEntries(clone->GetEntries() + 8000);
+         ASSERT_TRUE(cloner.Exec());
+         clone->Write();
+      }
+      ExpectSameEntries(tree, 1000, "fastclone_out.root", 8000);
+   }
+   gEnv->SetValue("TFile.AsyncPrefetching", 0);
+   gSystem->Unlink("fastclone_out.root");
+}
+
+// Copy the beginning of a chain: the first tree is copied completely, the beginning
+// of the second one by clusters and the last entries one by one
+TEST(TTreeCloner, CopyEntriesFastChain)
+{
+   WriteFastCloneFile("fastclone_in1.root", 0);
+   WriteFastCloneFile("fastclone_in2.root", kFastCloneEntries);
+   {
+      TChain chain("T");
+      chain.Add("fastclone_in1.root");
+      chain.Add("fastclone_in2.root");
+      const Long64_t nentries = kFastCloneEntries + 4500;
+      {
+         TFile out("fastclone_out.root", "RECREATE");
+         chain.LoadTree(0);
+         TTree *clone = chain.CloneTree(0);
+         EXPECT_GT(clone->CopyEntries(&chain, nentries, "fast"), 0);
+         EXPECT_EQ(nentries, clone->GetEntries());
+         clone->Write();
+      }
+      ExpectSameEntries(&chain, 0, "fastclone_out.root", nentries);
+   }
+   gSystem->Unlink("fastclone_out.root");
+   gSystem->Unlink("fastclone_in1.root");
+   gSystem->Unlink("fastclone_in2.root");
+}
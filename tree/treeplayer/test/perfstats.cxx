@@ -0,0 +1,143 @@
+#include "TBranch.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreePerfStats.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+static const char *kPerfStatsFile = "perfstats_branches.root";
+static const Int_t kPerfStatsEntries = 20000;
+
+// Write a tree with two branches and small baskets, so that each branch has many baskets
+static void WritePerfStatsFile()
+{
+   TFile f(kPerfStatsFile, "RECREATE");
+   TTree t("T", "perf stats test tree");
+   Int_t a = 0;
+   Double_t b = 0;
+   t.Branch("a", &a, "a/I", 4000);
+   t.Branch("b", &b, "b/D", 4000);
+   for (Int_t i = 0; i < kPerfStatsEntries; ++i) {
+      a = i * 7 % 1013;
+      b = 0.5 * i + a;
+      t.Fill();
+   }
+   t.Write();
+}
+
+// Check the statistics of one branch after all its baskets have been read once in each of ntrees
+// copies of the tree
+static void CheckBranchInfo(const TTreePerfStats &ps, TTree *tree, const char *name, Bool_t cached, Int_t ntrees = 1)
+{
+   TBranch *branch = tree->GetBranch(name);
+   ASSERT_NE(nullptr, branch);
+   Int_t nbaskets = branch->GetWriteBasket();
+   Long64_t nbytes = 0;
+   for (Int_t i = 0; i < nbaskets; ++i) nbytes += branch->GetBasketBytes()[i];
+   ASSERT_GT(nbaskets, 1);
+   nbaskets *= ntrees;
+   nbytes *= ntrees;
+
+   const TTreePerfStats::BranchInfo *info = nullptr;
+   for (const auto &i : ps.GetBranchInfo()) {
+      if (i.fName == name) info = &i;
+   }
+   ASSERT_NE(nullptr, info) << "no statistics for branch " << name;
+   EXPECT_EQ(nbaskets, info->fBasketsRead);
+   EXPECT_EQ(nbytes, info->fBytesRead);
+   EXPECT_EQ(info->fBasketsRead, info->fCacheHits + info->fCacheMisses);
+   EXPECT_GT(info->fBytesUnzipped, 0);
+   EXPECT_GE(info->fReadTime, 0.);
+   EXPECT_GE(info->fUnzipTime, 0.);
+   EXPECT_GE(info->fUnstreamTime, 0.);
+   if (cached) {
+      EXPECT_GT(info->fCacheHits, 0);
+      EXPECT_GT(info->fBytesCached, 0);
+      EXPECT_GE(info->fBytesPrefetched, info->fBytesCached);
+   } else {
+      EXPECT_EQ(nbaskets, info->fCacheMisses);
+      EXPECT_EQ(0, info->fBytesCached);
+      EXPECT_EQ(0, info->fBytesPrefetched);
+   }
+}
+
+// Read all the entries of the tree with the per-branch statistics and check them
+static void ReadAndCheck(Long64_t cacheSize)
+{
+   std::unique_ptr<TFile> f(TFile::Open(kPerfStatsFile));
+   ASSERT_TRUE(f && !f->IsZombie());
+   TTree *tree = nullptr;
+   f->GetObject("T", tree);
+   ASSERT_NE(nullptr, tree);
+   tree->SetCacheSize(cacheSize);
+   if (cacheSize > 0) tree->AddBranchToCache("*", kTRUE);
+
+   TTreePerfStats ps("ioperf", tree);
+   for (Long64_t i = 0; i < tree->GetEntries(); ++i) tree->GetEntry(i);
+   tree->SetPerfStats(nullptr);
+
+   ASSERT_EQ(2u, ps.GetBranchInfo().size());
+   CheckBranchInfo(ps, tree, "a", cacheSize > 0);
+   CheckBranchInfo(ps, tree, "b", cacheSize > 0);
+}
+
+// Same with a chain of two copies of the file: the perf stats attached to the chain must
+// receive the statistics of the branches of each tree it loads
+static void ReadChainAndCheck(Long64_t cacheSize)
+{
+   TChain chain("T");
+   chain.Add(kPerfStatsFile);
+   chain.Add(kPerfStatsFile);
+   chain.SetCacheSize(cacheSize);
+   // TTreePerfStats needs the current file of the chain
+   ASSERT_EQ(0, chain.LoadTree(0));
+   if (cacheSize > 0) chain.AddBranchToCache("*", kTRUE);
+
+   TTreePerfStats ps("ioperf", &chain);
+   const Long64_t nentries = chain.GetEntries();
+   ASSERT_EQ(2 * kPerfStatsEntries, nentries);
+   for (Long64_t i = 0; i < nentries; ++i) chain.GetEntry(i);
+   ASSERT_EQ(1, chain.GetTreeNumber());
+   EXPECT_EQ(&ps, chain.GetTree()->GetPerfStats());
+   chain.SetPerfStats(nullptr);
+   EXPECT_EQ(nullptr, chain.GetTree()->GetPerfStats());
+
+   ASSERT_EQ(2u, ps.GetBranchInfo().size());
+   CheckBranchInfo(ps, chain.GetTree(), "a", cacheSize > 0, 2);
+   CheckBranchInfo(ps, chain.GetTree(), "b", cacheSize > 0, 2);
+}
+
+TEST(TTreePerfStats, BranchInfo)
+{
+   WritePerfStatsFile();
+   ReadAndCheck(0);
+   ReadAndCheck(10000000);
+   gSystem->Unlink(kPerfStatsFile);
+}
+
+TEST(TTreePerfStats, BranchInfoChain)
+{
+   WritePerfStatsFile();
+   ReadChainAndCheck(0);
+   ReadChainAndCheck(10000000);
+   gSystem->Unlink(kPerfStatsFile);
+}
+
+#ifdef R__USE_IMT
+// The branches are read concurrently by TTree::GetEntry with the implicit multi-threading:
+// the counters must be the same as in the sequential read
+TEST(TTreePerfStats, BranchInfoIMT)
+{
+   WritePerfStatsFile();
+   ROOT::EnableImplicitMT(4);
+   ReadAndCheck(0);
+   ReadAndCheck(10000000);
+   ROOT::DisableImplicitMT();
+   gSystem->Unlink(kPerfStatsFile);
+}
+#endif